@@ -50,8 +50,11 @@
 @implementation NSMutableAttributedString (ColorRegExMatches)
 
 - (void)applyColor:(NSColor*)color toRegexPatternMatches:(NSString*)regExPattern {
-    NSArray *matches = [self.string matchesWithDetails:RX(regExPattern)];
-    for (RxMatch *match in matches) {
+    NSString *string = self.string;
+    NSArray *matches = [RX(regExPattern) matchesInString:string
+                                                 options:0
+                                                   range:NSMakeRange(0, string.length)];
+    for (NSTextCheckingResult *match in matches) {
         [self addAttribute:NSForegroundColorAttributeName
                    value:color
                    range:match.range];
@@ -58,18 +58,80 @@
 
 
 /**
- * Creates a macro (alias) for NSRegularExpression named `Rx`.
+ * Creates a macro `RX()` that returns a compiled NSRegularExpression
+ * for a pattern. Expressions are compiled once and shared through
+ * RxCache, so using RX() inside a loop does not recompile the pattern.
  *
  * ie.
- * NSRegularExpression* rx = [[Rx alloc] initWithPattern:@"\d+" options:0 error:nil];
+ * NSRegularExpression* rx = RX(@"\d+");
  */
 
 #ifndef DisableRegExCategoriesMacros
-#define RX(pattern) [[NSRegularExpression alloc] initWithPattern:pattern]
+#define RX(pattern) [NSRegularExpression rx:pattern]
 #endif
 
 
 
+/********************************************************/
+/******************* PATTERN CACHE **********************/
+/********************************************************/
+
+/**
+ * RxCache is a process-wide registry of compiled regular expressions,
+ * keyed by pattern and options. NSRegularExpression objects are immutable
+ * and thread safe, so one compiled instance is shared by every caller.
+ * All methods may be called from any thread.
+ *
+ * RX(), +rx:, +rx:ignoreCase:, +rx:options: and the NSString toRx helpers
+ * all go through this cache. -initWithPattern: still compiles a new
+ * expression every time.
+ *
+ * ie.
+ * NSRegularExpression* rx = [RxCache regexWithPattern:@"\d+" options:0];
+ */
+
+@interface RxCache : NSObject
+
+/**
+ * Returns the cached expression for the pattern and options, compiling
+ * and caching it on first use. Returns nil if the pattern is nil or does
+ * not compile; invalid patterns are not cached.
+ */
+
++ (NSRegularExpression*) regexWithPattern:(NSString*)pattern options:(NSRegularExpressionOptions)options;
+
+
+/**
+ * The number of lookups answered from the cache.
+ */
+
++ (NSUInteger) hitCount;
+
+
+/**
+ * The number of lookups that had to compile the pattern.
+ */
+
++ (NSUInteger) missCount;
+
+
+/**
+ * The number of compiled expressions currently held by the cache.
+ */
+
++ (NSUInteger) count;
+
+
+/**
+ * Empties the cache and resets the hit and miss counters.
+ */
+
++ (void) removeAllObjects;
+
+@end
+
+
+
 /********************************************************/
 /******************* MATCH OBJECTS **********************/
 /********************************************************/
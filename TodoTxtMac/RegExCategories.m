@@ -28,6 +28,95 @@
 //
 
 #import "RegExCategories.h"
+#import <pthread.h>
+
+// Outer dictionary is keyed by options, inner by pattern.
+static NSMutableDictionary* RxCacheStore = nil;
+static NSUInteger RxCacheHits = 0;
+static NSUInteger RxCacheMisses = 0;
+static pthread_mutex_t RxCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+@implementation RxCache
+
++ (NSRegularExpression*) regexWithPattern:(NSString*)pattern options:(NSRegularExpressionOptions)options
+{
+    if (pattern == nil)
+        return nil;
+    
+    NSNumber* optionsKey = @(options);
+    
+    pthread_mutex_lock(&RxCacheLock);
+    NSRegularExpression* rx = RxCacheStore[optionsKey][pattern];
+    if (rx != nil) {
+        RxCacheHits++;
+        pthread_mutex_unlock(&RxCacheLock);
+        return rx;
+    }
+    RxCacheMisses++;
+    pthread_mutex_unlock(&RxCacheLock);
+    
+    // Compile outside the lock; if two threads race on the same pattern the
+    // first one stored wins and both get back equivalent expressions.
+    rx = [[NSRegularExpression alloc] initWithPattern:pattern options:options error:nil];
+    if (rx == nil)
+        return nil;
+    
+    pthread_mutex_lock(&RxCacheLock);
+    if (RxCacheStore == nil)
+        RxCacheStore = [NSMutableDictionary dictionary];
+    NSMutableDictionary* patterns = RxCacheStore[optionsKey];
+    if (patterns == nil) {
+        patterns = [NSMutableDictionary dictionary];
+        RxCacheStore[optionsKey] = patterns;
+    }
+    NSRegularExpression* existing = patterns[pattern];
+    if (existing != nil)
+        rx = existing;
+    else
+        patterns[[pattern copy]] = rx;
+    pthread_mutex_unlock(&RxCacheLock);
+    
+    return rx;
+}
+
++ (NSUInteger) hitCount
+{
+    pthread_mutex_lock(&RxCacheLock);
+    NSUInteger hits = RxCacheHits;
+    pthread_mutex_unlock(&RxCacheLock);
+    return hits;
+}
+
++ (NSUInteger) missCount
+{
+    pthread_mutex_lock(&RxCacheLock);
+    NSUInteger misses = RxCacheMisses;
+    pthread_mutex_unlock(&RxCacheLock);
+    return misses;
+}
+
++ (NSUInteger) count
+{
+    pthread_mutex_lock(&RxCacheLock);
+    NSUInteger count = 0;
+    for (NSDictionary* patterns in [RxCacheStore objectEnumerator])
+        count += patterns.count;
+    pthread_mutex_unlock(&RxCacheLock);
+    return count;
+}
+
++ (void) removeAllObjects
+{
+    pthread_mutex_lock(&RxCacheLock);
+    [RxCacheStore removeAllObjects];
+    RxCacheHits = 0;
+    RxCacheMisses = 0;
+    pthread_mutex_unlock(&RxCacheLock);
+}
+
+@end
+
+
 
 @implementation NSRegularExpression (ObjectiveCRegexCategories)
 
@@ -38,17 +127,17 @@
 
 + (NSRegularExpression*) rx:(NSString*)pattern
 {
-    return [[self alloc] initWithPattern:pattern];
+    return [RxCache regexWithPattern:pattern options:0];
 }
 
 + (NSRegularExpression*) rx:(NSString*)pattern ignoreCase:(BOOL)ignoreCase
 {
-    return [[self alloc] initWithPattern:pattern options:ignoreCase?NSRegularExpressionCaseInsensitive:0 error:nil];
+    return [RxCache regexWithPattern:pattern options:ignoreCase?NSRegularExpressionCaseInsensitive:0];
 }
 
 + (NSRegularExpression*) rx:(NSString*)pattern options:(NSRegularExpressionOptions)options
 {
-    return [[self alloc] initWithPattern:pattern options:options error:nil];
+    return [RxCache regexWithPattern:pattern options:options];
 }
 
 - (BOOL) isMatch:(NSString*)matchee
@@ -220,7 +309,7 @@
 
 - (NSRegularExpression*) toRx
 {
-    return [[NSRegularExpression alloc] initWithPattern:self];
+    return [NSRegularExpression rx:self];
 }
 
 - (NSRegularExpression*) toRxIgnoreCase:(BOOL)ignoreCase
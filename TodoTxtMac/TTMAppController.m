@@ -102,10 +102,12 @@ static NSDictionary *defaultValues() {
                 @YES, @"showStatusBar",
                 [TTMDocumentStatusBarText defaultFormat], @"statusBarFormat",
                 @0, @"levelsOfUndo",
+                @64, @"undoMemoryLimit",
                 @YES, @"allowUndoOfArchiveCommand",
                 @NO, @"hideFutureTasks",
                 @NO, @"closingLastWindowClosesApplication",
                 @NO, @"hideHiddenTasks",
+                @YES, @"useParsedStateCache",
                 nil];
     }
     return dict;
@@ -0,0 +1,118 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*! Posted after the current collator is replaced because the user's locale changed. */
+extern NSString * const TTMCollatorDidChangeNotification;
+
+/*!
+ * @class TTMCollator
+ * @abstract TTMCollator turns strings into binary collation keys.
+ * @discussion Keys are ICU sort keys for the user's locale at secondary strength, which
+ * ignores case but not accents, as localizedCaseInsensitiveCompare: does. Two strings
+ * compare the same way their keys compare byte by byte, so a string that is compared
+ * many times only has to be collated once. A collator never changes; when the user's
+ * locale changes, currentCollator is replaced by a collator with a new generation, and
+ * keys made by the old one must be made again. All methods may be called from any thread.
+ */
+@interface TTMCollator : NSObject
+
+/*! The locale that strings are collated for. */
+@property (nonatomic, readonly) NSLocale *locale;
+
+/*! A number that is different for every collator currentCollator has returned. */
+@property (nonatomic, readonly) NSUInteger generation;
+
+/*!
+ * @method currentCollator
+ * @abstract Returns the collator for the user's current locale.
+ * @return The current collator.
+ */
++ (TTMCollator*)currentCollator;
+
+/*!
+ * @method initWithLocale:
+ * @abstract Initializes a collator for a locale, with a new generation.
+ * @param locale The locale to collate strings for.
+ * @result Returns the new collator.
+ */
+- (id)initWithLocale:(NSLocale*)locale;
+
+/*!
+ * @method collationKeyForString:
+ * @abstract Makes the collation key of a string.
+ * @param string The string, which may be nil.
+ * @return The collation key. A nil string has an empty key, which sorts first.
+ */
+- (NSData*)collationKeyForString:(NSString*)string;
+
+/*!
+ * @method cachedCollationKeyForString:
+ * @abstract Returns the collation key of a string, making it only the first time.
+ * @discussion Use this for strings that many tasks share, such as projects and contexts.
+ * The cache is emptied when it grows past a few thousand keys.
+ * @param string The string, which may be nil.
+ * @return The collation key.
+ */
+- (NSData*)cachedCollationKeyForString:(NSString*)string;
+
+/*!
+ * @method sortedStrings:
+ * @abstract Sorts strings by their cached collation keys.
+ * @param strings The strings to sort.
+ * @return The strings in the order localizedCaseInsensitiveCompare: puts them in.
+ */
+- (NSArray*)sortedStrings:(NSArray*)strings;
+
+/*!
+ * @method compareCollationKey:toCollationKey:
+ * @abstract Compares two collation keys byte by byte.
+ * @return The order of the strings the keys were made from.
+ */
++ (NSComparisonResult)compareCollationKey:(NSData*)key toCollationKey:(NSData*)otherKey;
+
+@end
@@ -0,0 +1,228 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMCollator.h"
+#import <pthread.h>
+#import <stdatomic.h>
+
+// libicucore ships with OS X without its headers, so the few functions used here are
+// declared here. OS X builds ICU without renaming its functions by version.
+typedef struct UCollator UCollator;
+typedef uint16_t UChar;
+typedef int UErrorCode;
+typedef int UCollationStrength;
+static const UErrorCode U_ZERO_ERROR = 0;
+static const UCollationStrength UCOL_SECONDARY = 1;
+extern UCollator *ucol_open(const char *locale, UErrorCode *status);
+extern void ucol_close(UCollator *collator);
+extern void ucol_setStrength(UCollator *collator, UCollationStrength strength);
+extern int32_t ucol_getSortKey(const UCollator *collator, const UChar *source,
+                               int32_t sourceLength, uint8_t *result, int32_t resultLength);
+
+NSString * const TTMCollatorDidChangeNotification = @"TTMCollatorDidChangeNotification";
+
+// Most strings are collated without allocating anything but the key.
+static const NSUInteger StackCharacterCount = 256;
+static const int32_t StackKeyLength = 512;
+
+// Projects and contexts are few, so the cache is only emptied when something else,
+// such as a long run of distinct strings, fills it.
+static const NSUInteger CachedKeyLimit = 4096;
+
+static pthread_mutex_t CurrentCollatorLock = PTHREAD_MUTEX_INITIALIZER;
+static TTMCollator *CurrentCollator = nil;
+static _Atomic(NSUInteger) LastGeneration = 0;
+
+@interface TTMCollator () {
+    UCollator *_collator;
+    pthread_mutex_t _lock;
+}
+
+@property (nonatomic) NSMutableDictionary *cachedKeys;
+
+@end
+
+@implementation TTMCollator
+
++ (TTMCollator*)currentCollator {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        [[NSNotificationCenter defaultCenter]
+         addObserverForName:NSCurrentLocaleDidChangeNotification
+         object:nil
+         queue:nil
+         usingBlock:^(NSNotification *notification) {
+             pthread_mutex_lock(&CurrentCollatorLock);
+             CurrentCollator = nil;
+             pthread_mutex_unlock(&CurrentCollatorLock);
+             [[NSNotificationCenter defaultCenter]
+              postNotificationName:TTMCollatorDidChangeNotification object:nil];
+         }];
+    });
+    
+    pthread_mutex_lock(&CurrentCollatorLock);
+    if (CurrentCollator == nil) {
+        CurrentCollator = [[TTMCollator alloc] initWithLocale:[NSLocale currentLocale]];
+    }
+    TTMCollator *collator = CurrentCollator;
+    pthread_mutex_unlock(&CurrentCollatorLock);
+    return collator;
+}
+
+- (id)initWithLocale:(NSLocale*)locale {
+    self = [super init];
+    if (self) {
+        pthread_mutex_init(&_lock, NULL);
+        _locale = locale;
+        _generation = atomic_fetch_add_explicit(&LastGeneration, 1, memory_order_relaxed) + 1;
+        _cachedKeys = [[NSMutableDictionary alloc] init];
+        
+        UErrorCode status = U_ZERO_ERROR;
+        _collator = ucol_open([locale.localeIdentifier UTF8String], &status);
+        if (status > U_ZERO_ERROR) {
+            if (_collator != NULL) {
+                ucol_close(_collator);
+            }
+            _collator = NULL;
+        } else {
+            ucol_setStrength(_collator, UCOL_SECONDARY);
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_collator != NULL) {
+        ucol_close(_collator);
+    }
+    pthread_mutex_destroy(&_lock);
+}
+
+#pragma mark - Collation Key Methods
+
+- (NSData*)collationKeyForString:(NSString*)string {
+    NSUInteger length = string.length;
+    if (length == 0) {
+        return [NSData data];
+    }
+    if (_collator == NULL) {
+        // Without ICU, fall back to comparing lowercased UTF-16 code units.
+        return [[string lowercaseString] dataUsingEncoding:NSUTF16BigEndianStringEncoding];
+    }
+    
+    UChar characterBuffer[StackCharacterCount];
+    UChar *allocatedCharacters = NULL;
+    const UChar *characters = (const UChar*)CFStringGetCharactersPtr((__bridge CFStringRef)string);
+    if (characters == NULL) {
+        UChar *copiedCharacters = characterBuffer;
+        if (length > StackCharacterCount) {
+            copiedCharacters = allocatedCharacters = malloc(length * sizeof(UChar));
+        }
+        [string getCharacters:copiedCharacters range:NSMakeRange(0, length)];
+        characters = copiedCharacters;
+    }
+    
+    // ICU sort keys are only compared byte by byte, so the trailing zero is harmless.
+    uint8_t keyBuffer[StackKeyLength];
+    int32_t keyLength = ucol_getSortKey(_collator, characters, (int32_t)length,
+                                        keyBuffer, StackKeyLength);
+    NSData *key;
+    if (keyLength <= StackKeyLength) {
+        key = [NSData dataWithBytes:keyBuffer length:(NSUInteger)keyLength];
+    } else {
+        uint8_t *keyBytes = malloc((size_t)keyLength);
+        ucol_getSortKey(_collator, characters, (int32_t)length, keyBytes, keyLength);
+        key = [NSData dataWithBytesNoCopy:keyBytes length:(NSUInteger)keyLength freeWhenDone:YES];
+    }
+    free(allocatedCharacters);
+    return key;
+}
+
+- (NSData*)cachedCollationKeyForString:(NSString*)string {
+    if (string == nil) {
+        return [NSData data];
+    }
+    pthread_mutex_lock(&_lock);
+    NSData *key = self.cachedKeys[string];
+    pthread_mutex_unlock(&_lock);
+    if (key == nil) {
+        key = [self collationKeyForString:string];
+        pthread_mutex_lock(&_lock);
+        if (self.cachedKeys.count >= CachedKeyLimit) {
+            [self.cachedKeys removeAllObjects];
+        }
+        self.cachedKeys[[string copy]] = key;
+        pthread_mutex_unlock(&_lock);
+    }
+    return key;
+}
+
+- (NSArray*)sortedStrings:(NSArray*)strings {
+    if (strings.count < 2) {
+        return strings;
+    }
+    return [strings sortedArrayUsingComparator:^NSComparisonResult(NSString *string1,
+                                                                   NSString *string2) {
+        return [TTMCollator compareCollationKey:[self cachedCollationKeyForString:string1]
+                                 toCollationKey:[self cachedCollationKeyForString:string2]];
+    }];
+}
+
++ (NSComparisonResult)compareCollationKey:(NSData*)key toCollationKey:(NSData*)otherKey {
+    NSUInteger length = key.length;
+    NSUInteger otherLength = otherKey.length;
+    NSUInteger commonLength = MIN(length, otherLength);
+    int result = (commonLength > 0) ? memcmp(key.bytes, otherKey.bytes, commonLength) : 0;
+    if (result != 0) {
+        return (result < 0) ? NSOrderedAscending : NSOrderedDescending;
+    }
+    if (length == otherLength) {
+        return NSOrderedSame;
+    }
+    return (length < otherLength) ? NSOrderedAscending : NSOrderedDescending;
+}
+
+@end
@@ -0,0 +1,146 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+@class TTMTask;
+@class TTMTaskIndex;
+
+/*!
+ * @class TTMCompiledPredicate
+ * @abstract TTMCompiledPredicate evaluates a filter predicate against tasks natively.
+ * @discussion The predicate tree is compiled once into a tree of blocks. Comparisons of
+ * task properties with constants, which is what the filter row templates build, read the
+ * properties through their getters instead of key-value coding. String constants are
+ * folded for case- and diacritic-insensitive comparisons when the predicate is compiled,
+ * and raw text is searched through the task's cached foldedRawText. Date comparisons
+ * compare day numbers. Any part of the predicate that is not understood, such as MATCHES,
+ * LIKE, IN, or key paths that are not task properties, is evaluated by NSPredicate, as are
+ * comparisons whose task property is nil.
+ *
+ * When it is compiled with a task index, parts of the predicate that only test which
+ * projects and contexts tasks have are answered by the index's bitsets, once per call to
+ * filteredTasks:, instead of by searching each task's projects or contexts string. Raw
+ * text searches like the search field's are narrowed to the tasks that have every trigram
+ * of the text searched for, and only those tasks' text is searched.
+ */
+@interface TTMCompiledPredicate : NSObject
+
+/*! The predicate that was compiled. */
+@property (nonatomic, readonly) NSPredicate *predicate;
+
+/*! The index that answers project, context and text comparisons, if any. */
+@property (nonatomic, readonly) TTMTaskIndex *taskIndex;
+
+/*! YES if no part of the predicate is evaluated by NSPredicate. */
+@property (nonatomic, readonly) BOOL isFullyCompiled;
+
+/*! YES if some part of the predicate is answered by the task index. */
+@property (nonatomic, readonly) BOOL usesTaskIndex;
+
+/*!
+ * @method initWithPredicate:
+ * @abstract Compiles a predicate.
+ * @param predicate The predicate to compile.
+ * @result Returns the compiled predicate.
+ */
+- (id)initWithPredicate:(NSPredicate*)predicate;
+
+/*!
+ * @method initWithPredicate:taskIndex:
+ * @abstract Compiles a predicate to filter the tasks in a task index.
+ * @discussion The tasks passed to filteredTasks: must be in the index.
+ * @param predicate The predicate to compile.
+ * @param taskIndex The index of the tasks that will be filtered, or nil.
+ * @result Returns the compiled predicate.
+ */
+- (id)initWithPredicate:(NSPredicate*)predicate taskIndex:(TTMTaskIndex*)taskIndex;
+
+/*!
+ * @method predicate:refinesPredicate:
+ * @abstract Tells whether every task one predicate is true for is one the other is true for.
+ * @discussion Recognizes equal predicates, AND and OR compounds, and a case- and
+ * diacritic-insensitive string search for a string that contains the other's string, such
+ * as the search field makes when a character is typed. It may answer NO for predicates
+ * that do refine the other.
+ * @param predicate The narrower predicate.
+ * @param otherPredicate The broader predicate.
+ * @return YES if the predicate is known to refine the other.
+ */
++ (BOOL)predicate:(NSPredicate*)predicate refinesPredicate:(NSPredicate*)otherPredicate;
+
+/*!
+ * @method evaluateWithTask:
+ * @abstract Evaluates the predicate against a task.
+ * @param task The task to evaluate.
+ * @return The result of [predicate evaluateWithObject:task].
+ */
+- (BOOL)evaluateWithTask:(TTMTask*)task;
+
+/*!
+ * @method lookUpIndexedTasks
+ * @abstract Asks the task index now for the tasks the parts of the predicate it answers
+ * are true for, and keeps them until forgetIndexedTasks is called.
+ * @discussion The index may only be used on the thread that updates it. Once the tasks
+ * are looked up, evaluateWithTask: and filteredTasks: use them without the index, so
+ * they can be called on another thread, with tasks whose text has not changed since.
+ */
+- (void)lookUpIndexedTasks;
+
+/*!
+ * @method forgetIndexedTasks
+ * @abstract Drops the tasks lookUpIndexedTasks looked up.
+ */
+- (void)forgetIndexedTasks;
+
+/*!
+ * @method filteredTasks:
+ * @abstract Filters tasks like filteredArrayUsingPredicate: does.
+ * @param tasks The tasks to filter.
+ * @return The tasks the predicate is true for, in their original order.
+ */
+- (NSArray*)filteredTasks:(NSArray*)tasks;
+
+@end
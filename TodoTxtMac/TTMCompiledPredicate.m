@@ -0,0 +1,807 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMCompiledPredicate.h"
+#import "TTMDateUtility.h"
+#import "TTMTask.h"
+#import "TTMTaskBitset.h"
+#import "TTMTaskIndex.h"
+
+typedef BOOL (^TTMTaskEvaluator)(TTMTask *task);
+typedef TTMTaskBitset* (^TTMTaskSetEvaluator)(TTMTaskIndex *taskIndex);
+typedef NSString* (^TTMTaskStringGetter)(TTMTask *task);
+typedef double (^TTMTaskNumberGetter)(TTMTask *task);
+typedef TTMDayNumber (^TTMTaskDayGetter)(TTMTask *task);
+
+static const NSStringCompareOptions CaseAndDiacriticInsensitive =
+    NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch;
+
+#pragma mark - Task Property Getters
+
+// The task properties that compile, by the key path that names them in a predicate.
+
+static NSDictionary *StringGetters(void) {
+    static NSDictionary *getters = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        getters = @{
+            @"rawText" : ^NSString*(TTMTask *task) { return task.rawText; },
+            @"projects" : ^NSString*(TTMTask *task) { return task.projects; },
+            @"contexts" : ^NSString*(TTMTask *task) { return task.contexts; },
+            @"priorityText" : ^NSString*(TTMTask *task) { return task.priorityText; },
+            @"fullPriorityText" : ^NSString*(TTMTask *task) { return task.fullPriorityText; },
+            @"dueDateText" : ^NSString*(TTMTask *task) { return task.dueDateText; },
+            @"creationDateText" : ^NSString*(TTMTask *task) { return task.creationDateText; },
+            @"completionDateText" : ^NSString*(TTMTask *task) { return task.completionDateText; },
+            @"thresholdDateText" : ^NSString*(TTMTask *task) { return task.thresholdDateText; },
+            @"recurrencePattern" : ^NSString*(TTMTask *task) { return task.recurrencePattern; }
+        };
+    });
+    return getters;
+}
+
+static NSDictionary *NumberGetters(void) {
+    static NSDictionary *getters = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        TTMTaskNumberGetter isCompleted = ^double(TTMTask *task) { return task.isCompleted; };
+        getters = @{
+            // The Completed row template names isCompleted by its key-value coding key.
+            @"completed" : isCompleted,
+            @"isCompleted" : isCompleted,
+            @"isHidden" : ^double(TTMTask *task) { return task.isHidden; },
+            @"isPrioritized" : ^double(TTMTask *task) { return task.isPrioritized; },
+            @"isBlank" : ^double(TTMTask *task) { return task.isBlank; },
+            @"isRecurring" : ^double(TTMTask *task) { return task.isRecurring; },
+            @"hasProjects" : ^double(TTMTask *task) { return task.hasProjects; },
+            @"hasContexts" : ^double(TTMTask *task) { return task.hasContexts; },
+            @"dueState" : ^double(TTMTask *task) { return task.dueState; },
+            @"thresholdState" : ^double(TTMTask *task) { return task.thresholdState; },
+            @"priority" : ^double(TTMTask *task) { return task.priority; },
+            @"taskId" : ^double(TTMTask *task) { return task.taskId; }
+        };
+    });
+    return getters;
+}
+
+static NSDictionary *DayGetters(void) {
+    static NSDictionary *getters = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        getters = @{
+            @"dueDate" : ^TTMDayNumber(TTMTask *task) { return task.dueDay; },
+            @"creationDate" : ^TTMDayNumber(TTMTask *task) { return task.creationDay; },
+            @"completionDate" : ^TTMDayNumber(TTMTask *task) { return task.completionDay; },
+            @"thresholdDate" : ^TTMDayNumber(TTMTask *task) { return task.thresholdDay; }
+        };
+    });
+    return getters;
+}
+
+#pragma mark - Comparison Helpers
+
+static BOOL IsOrderOperator(NSPredicateOperatorType operatorType) {
+    return operatorType <= NSNotEqualToPredicateOperatorType;
+}
+
+static BOOL OrderSatisfiesOperator(NSComparisonResult order, NSPredicateOperatorType operatorType) {
+    switch (operatorType) {
+        case NSLessThanPredicateOperatorType:
+            return order == NSOrderedAscending;
+        case NSLessThanOrEqualToPredicateOperatorType:
+            return order != NSOrderedDescending;
+        case NSGreaterThanPredicateOperatorType:
+            return order == NSOrderedDescending;
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+            return order != NSOrderedAscending;
+        case NSEqualToPredicateOperatorType:
+            return order == NSOrderedSame;
+        case NSNotEqualToPredicateOperatorType:
+            return order != NSOrderedSame;
+        default:
+            return NO;
+    }
+}
+
+static NSComparisonResult CompareNumbers(double number, double otherNumber) {
+    if (number < otherNumber) {
+        return NSOrderedAscending;
+    }
+    return (number > otherNumber) ? NSOrderedDescending : NSOrderedSame;
+}
+
+/*! A part of the predicate that the task index answers for a whole list of tasks. */
+@interface TTMIndexedSubpredicate : NSObject
+
+@property (nonatomic, copy) TTMTaskSetEvaluator setEvaluator;
+// The tasks the subpredicate is true for, while filteredTasks: is filtering.
+@property (nonatomic) TTMTaskBitset *tasks;
+
+@end
+
+@implementation TTMIndexedSubpredicate
+
+@end
+
+@interface TTMCompiledPredicate ()
+
+@property (nonatomic, readwrite) NSPredicate *predicate;
+@property (nonatomic, readwrite) TTMTaskIndex *taskIndex;
+@property (nonatomic, readwrite) BOOL isFullyCompiled;
+@property (nonatomic, copy) TTMTaskEvaluator evaluator;
+@property (nonatomic) NSMutableArray *indexedSubpredicates;
+// Set while a subpredicate the index answers is compiled for evaluateWithTask:.
+@property (nonatomic) BOOL isCompilingIndexedSubpredicate;
+// Set between lookUpIndexedTasks and forgetIndexedTasks.
+@property (nonatomic) BOOL hasLookedUpIndexedTasks;
+
+@end
+
+@implementation TTMCompiledPredicate
+
+#pragma mark - Init Methods
+
+- (id)initWithPredicate:(NSPredicate*)predicate {
+    return [self initWithPredicate:predicate taskIndex:nil];
+}
+
+- (id)initWithPredicate:(NSPredicate*)predicate taskIndex:(TTMTaskIndex*)taskIndex {
+    self = [super init];
+    if (self) {
+        _predicate = predicate;
+        _taskIndex = taskIndex;
+        _isFullyCompiled = YES;
+        _indexedSubpredicates = [[NSMutableArray alloc] init];
+        _evaluator = (predicate == nil) ? ^BOOL(TTMTask *task) { return YES; } :
+                                          [self evaluatorForPredicate:predicate];
+    }
+    return self;
+}
+
+#pragma mark - Evaluation Methods
+
+- (BOOL)evaluateWithTask:(TTMTask*)task {
+    return _evaluator(task);
+}
+
+- (BOOL)usesTaskIndex {
+    return self.indexedSubpredicates.count > 0;
+}
+
+- (void)lookUpIndexedTasks {
+    for (TTMIndexedSubpredicate *subpredicate in self.indexedSubpredicates) {
+        subpredicate.tasks = subpredicate.setEvaluator(self.taskIndex);
+    }
+    self.hasLookedUpIndexedTasks = YES;
+}
+
+- (void)forgetIndexedTasks {
+    for (TTMIndexedSubpredicate *subpredicate in self.indexedSubpredicates) {
+        subpredicate.tasks = nil;
+    }
+    self.hasLookedUpIndexedTasks = NO;
+}
+
+- (NSArray*)filteredTasks:(NSArray*)tasks {
+    // Each subpredicate the index answers is looked up once for all the tasks.
+    BOOL looksUpIndexedTasks = !self.hasLookedUpIndexedTasks;
+    if (looksUpIndexedTasks) {
+        [self lookUpIndexedTasks];
+    }
+    TTMTaskEvaluator evaluator = _evaluator;
+    NSMutableArray *filteredTasks = [NSMutableArray arrayWithCapacity:tasks.count];
+    for (TTMTask *task in tasks) {
+        if (evaluator(task)) {
+            [filteredTasks addObject:task];
+        }
+    }
+    if (looksUpIndexedTasks) {
+        [self forgetIndexedTasks];
+    }
+    return filteredTasks;
+}
+
+#pragma mark - Refinement Methods
+
+static BOOL IsCompoundOfType(NSPredicate *predicate, NSCompoundPredicateType compoundType) {
+    return [predicate isKindOfClass:[NSCompoundPredicate class]] &&
+           ((NSCompoundPredicate*)predicate).compoundPredicateType == compoundType;
+}
+
++ (BOOL)predicate:(NSPredicate*)predicate refinesPredicate:(NSPredicate*)otherPredicate {
+    if ([predicate isEqual:otherPredicate]) {
+        return YES;
+    }
+    // Tasks that pass an AND pass each of its subpredicates.
+    if (IsCompoundOfType(predicate, NSAndPredicateType)) {
+        for (NSPredicate *subpredicate in ((NSCompoundPredicate*)predicate).subpredicates) {
+            if ([self predicate:subpredicate refinesPredicate:otherPredicate]) {
+                return YES;
+            }
+        }
+    }
+    if (IsCompoundOfType(otherPredicate, NSAndPredicateType)) {
+        BOOL refinesEverySubpredicate = YES;
+        for (NSPredicate *subpredicate in ((NSCompoundPredicate*)otherPredicate).subpredicates) {
+            if (![self predicate:predicate refinesPredicate:subpredicate]) {
+                refinesEverySubpredicate = NO;
+                break;
+            }
+        }
+        if (refinesEverySubpredicate) {
+            return YES;
+        }
+    }
+    // Tasks that pass any subpredicate of an OR pass the OR.
+    if (IsCompoundOfType(otherPredicate, NSOrPredicateType)) {
+        for (NSPredicate *subpredicate in ((NSCompoundPredicate*)otherPredicate).subpredicates) {
+            if ([self predicate:predicate refinesPredicate:subpredicate]) {
+                return YES;
+            }
+        }
+    }
+    if (IsCompoundOfType(predicate, NSOrPredicateType)) {
+        NSArray *subpredicates = ((NSCompoundPredicate*)predicate).subpredicates;
+        BOOL everySubpredicateRefines = (subpredicates.count > 0);
+        for (NSPredicate *subpredicate in subpredicates) {
+            if (![self predicate:subpredicate refinesPredicate:otherPredicate]) {
+                everySubpredicateRefines = NO;
+                break;
+            }
+        }
+        if (everySubpredicateRefines) {
+            return YES;
+        }
+    }
+    if ([predicate isKindOfClass:[NSComparisonPredicate class]] &&
+        [otherPredicate isKindOfClass:[NSComparisonPredicate class]]) {
+        return [self comparison:(NSComparisonPredicate*)predicate
+              refinesComparison:(NSComparisonPredicate*)otherPredicate];
+    }
+    return NO;
+}
+
++ (BOOL)comparison:(NSComparisonPredicate*)comparison
+ refinesComparison:(NSComparisonPredicate*)otherComparison {
+    // Only diacritic-insensitive searches of the same property are compared. Their folded
+    // strings are searched literally, so a string found in a task's text contains every
+    // string it contains.
+    if (comparison.comparisonPredicateModifier != NSDirectPredicateModifier ||
+        otherComparison.comparisonPredicateModifier != NSDirectPredicateModifier ||
+        comparison.leftExpression.expressionType != NSKeyPathExpressionType ||
+        otherComparison.leftExpression.expressionType != NSKeyPathExpressionType ||
+        ![comparison.leftExpression.keyPath isEqualToString:otherComparison.leftExpression.keyPath] ||
+        comparison.rightExpression.expressionType != NSConstantValueExpressionType ||
+        otherComparison.rightExpression.expressionType != NSConstantValueExpressionType ||
+        ![comparison.rightExpression.constantValue isKindOfClass:[NSString class]] ||
+        ![otherComparison.rightExpression.constantValue isKindOfClass:[NSString class]] ||
+        comparison.options != otherComparison.options ||
+        !(comparison.options & NSDiacriticInsensitivePredicateOption)) {
+        return NO;
+    }
+    NSStringCompareOptions foldOptions = NSDiacriticInsensitiveSearch;
+    if (comparison.options & NSCaseInsensitivePredicateOption) {
+        foldOptions |= NSCaseInsensitiveSearch;
+    }
+    NSString *string = [comparison.rightExpression.constantValue
+                        stringByFoldingWithOptions:foldOptions locale:nil];
+    NSString *otherString = [otherComparison.rightExpression.constantValue
+                             stringByFoldingWithOptions:foldOptions locale:nil];
+    if (otherString.length == 0) {
+        // NSPredicate finds no empty string, so "contains ''" is not a broader search.
+        return NO;
+    }
+    
+    NSPredicateOperatorType operatorType = comparison.predicateOperatorType;
+    switch (otherComparison.predicateOperatorType) {
+        case NSContainsPredicateOperatorType:
+            if (operatorType != NSContainsPredicateOperatorType &&
+                operatorType != NSBeginsWithPredicateOperatorType &&
+                operatorType != NSEndsWithPredicateOperatorType) {
+                return NO;
+            }
+            return [string rangeOfString:otherString options:NSLiteralSearch].location != NSNotFound;
+        case NSBeginsWithPredicateOperatorType:
+            return operatorType == NSBeginsWithPredicateOperatorType && [string hasPrefix:otherString];
+        case NSEndsWithPredicateOperatorType:
+            return operatorType == NSEndsWithPredicateOperatorType && [string hasSuffix:otherString];
+        default:
+            return NO;
+    }
+}
+
+#pragma mark - Compiler Methods
+
+- (TTMTaskEvaluator)evaluatorForPredicate:(NSPredicate*)predicate {
+    if (self.taskIndex != nil && !self.isCompilingIndexedSubpredicate) {
+        BOOL isExact = NO;
+        TTMTaskSetEvaluator setEvaluator = [self setEvaluatorForPredicate:predicate
+                                                                  isExact:&isExact];
+        if (setEvaluator != nil) {
+            return [self evaluatorForIndexedPredicate:predicate
+                                         setEvaluator:setEvaluator
+                                              isExact:isExact];
+        }
+    }
+    
+    TTMTaskEvaluator evaluator = nil;
+    if ([predicate isKindOfClass:[NSCompoundPredicate class]]) {
+        evaluator = [self evaluatorForCompoundPredicate:(NSCompoundPredicate*)predicate];
+    } else if ([predicate isKindOfClass:[NSComparisonPredicate class]]) {
+        evaluator = [self evaluatorForComparisonPredicate:(NSComparisonPredicate*)predicate];
+    } else if ([predicate isEqual:[NSPredicate predicateWithValue:YES]]) {
+        evaluator = ^BOOL(TTMTask *task) { return YES; };
+    } else if ([predicate isEqual:[NSPredicate predicateWithValue:NO]]) {
+        evaluator = ^BOOL(TTMTask *task) { return NO; };
+    }
+    return (evaluator != nil) ? evaluator : [self fallbackEvaluatorForPredicate:predicate];
+}
+
+- (TTMTaskEvaluator)fallbackEvaluatorForPredicate:(NSPredicate*)predicate {
+    self.isFullyCompiled = NO;
+    return ^BOOL(TTMTask *task) {
+        return [predicate evaluateWithObject:task];
+    };
+}
+
+- (TTMTaskEvaluator)evaluatorForCompoundPredicate:(NSCompoundPredicate*)compound {
+    NSCompoundPredicateType compoundType = compound.compoundPredicateType;
+    if (compoundType == NSNotPredicateType && compound.subpredicates.count != 1) {
+        return nil;
+    }
+    
+    // Subpredicates the index answers are cheap to evaluate, so they are tried first.
+    NSMutableArray *subpredicates = [compound.subpredicates mutableCopy];
+    if (self.taskIndex != nil && !self.isCompilingIndexedSubpredicate) {
+        NSIndexSet *indexedRows = [subpredicates indexesOfObjectsPassingTest:
+                                   ^BOOL(NSPredicate *subpredicate, NSUInteger row, BOOL *stop) {
+            BOOL isExact = NO;
+            return [self setEvaluatorForPredicate:subpredicate isExact:&isExact] != nil;
+        }];
+        NSArray *indexedSubpredicates = [subpredicates objectsAtIndexes:indexedRows];
+        [subpredicates removeObjectsAtIndexes:indexedRows];
+        [subpredicates insertObjects:indexedSubpredicates
+                           atIndexes:[NSIndexSet indexSetWithIndexesInRange:
+                                      NSMakeRange(0, indexedSubpredicates.count)]];
+    }
+    
+    NSMutableArray *evaluators = [NSMutableArray arrayWithCapacity:subpredicates.count];
+    for (NSPredicate *subpredicate in subpredicates) {
+        [evaluators addObject:[self evaluatorForPredicate:subpredicate]];
+    }
+    
+    switch (compoundType) {
+        case NSNotPredicateType: {
+            TTMTaskEvaluator evaluator = evaluators[0];
+            return ^BOOL(TTMTask *task) {
+                return !evaluator(task);
+            };
+        }
+        case NSAndPredicateType:
+            if (evaluators.count == 0) {
+                return ^BOOL(TTMTask *task) { return YES; };
+            }
+            if (evaluators.count == 1) {
+                return evaluators[0];
+            }
+            return ^BOOL(TTMTask *task) {
+                for (TTMTaskEvaluator evaluator in evaluators) {
+                    if (!evaluator(task)) {
+                        return NO;
+                    }
+                }
+                return YES;
+            };
+        case NSOrPredicateType:
+            if (evaluators.count == 0) {
+                return ^BOOL(TTMTask *task) { return NO; };
+            }
+            if (evaluators.count == 1) {
+                return evaluators[0];
+            }
+            return ^BOOL(TTMTask *task) {
+                for (TTMTaskEvaluator evaluator in evaluators) {
+                    if (evaluator(task)) {
+                        return YES;
+                    }
+                }
+                return NO;
+            };
+        default:
+            return nil;
+    }
+}
+
+- (TTMTaskEvaluator)evaluatorForComparisonPredicate:(NSComparisonPredicate*)comparison {
+    // Only "keyPath operator constant" compiles, which is the form the row templates build.
+    if (comparison.comparisonPredicateModifier != NSDirectPredicateModifier ||
+        comparison.predicateOperatorType == NSCustomSelectorPredicateOperatorType ||
+        comparison.leftExpression.expressionType != NSKeyPathExpressionType ||
+        comparison.rightExpression.expressionType != NSConstantValueExpressionType) {
+        return nil;
+    }
+    
+    NSString *keyPath = comparison.leftExpression.keyPath;
+    TTMTaskStringGetter stringGetter = StringGetters()[keyPath];
+    if (stringGetter != nil) {
+        return [self evaluatorForStringComparison:comparison
+                                          keyPath:keyPath
+                                           getter:stringGetter];
+    }
+    TTMTaskNumberGetter numberGetter = NumberGetters()[keyPath];
+    if (numberGetter != nil) {
+        return [self evaluatorForNumberComparison:comparison getter:numberGetter];
+    }
+    TTMTaskDayGetter dayGetter = DayGetters()[keyPath];
+    if (dayGetter != nil) {
+        return [self evaluatorForDateComparison:comparison getter:dayGetter];
+    }
+    return nil;
+}
+
+- (TTMTaskEvaluator)evaluatorForStringComparison:(NSComparisonPredicate*)comparison
+                                         keyPath:(NSString*)keyPath
+                                          getter:(TTMTaskStringGetter)getter {
+    id constant = comparison.rightExpression.constantValue;
+    if (![constant isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    NSString *operand = constant;
+    NSPredicateOperatorType operatorType = comparison.predicateOperatorType;
+    NSStringCompareOptions foldOptions = 0;
+    if (comparison.options & NSCaseInsensitivePredicateOption) {
+        foldOptions |= NSCaseInsensitiveSearch;
+    }
+    if (comparison.options & NSDiacriticInsensitivePredicateOption) {
+        foldOptions |= NSDiacriticInsensitiveSearch;
+    }
+    
+    // Ordering comparisons compare the unfolded strings, as NSPredicate does.
+    if (IsOrderOperator(operatorType) &&
+        operatorType != NSEqualToPredicateOperatorType &&
+        operatorType != NSNotEqualToPredicateOperatorType) {
+        return ^BOOL(TTMTask *task) {
+            NSString *string = getter(task);
+            if (string == nil) {
+                return [comparison evaluateWithObject:task];
+            }
+            return OrderSatisfiesOperator([string compare:operand options:foldOptions],
+                                          operatorType);
+        };
+    }
+    
+    // Everything else compares the folded operand with the folded task property.
+    NSString *foldedOperand = (foldOptions == 0) ?
+        operand : [operand stringByFoldingWithOptions:foldOptions locale:nil];
+    TTMTaskStringGetter foldedGetter = getter;
+    if ([keyPath isEqualToString:@"rawText"] && foldOptions == CaseAndDiacriticInsensitive) {
+        foldedGetter = ^NSString*(TTMTask *task) { return task.foldedRawText; };
+    } else if (foldOptions != 0) {
+        foldedGetter = ^NSString*(TTMTask *task) {
+            return [getter(task) stringByFoldingWithOptions:foldOptions locale:nil];
+        };
+    }
+    // With the diacritics folded away, composed and decomposed characters look the same,
+    // so the folded strings can be compared literally.
+    NSStringCompareOptions searchOptions =
+        (foldOptions & NSDiacriticInsensitiveSearch) ? NSLiteralSearch : 0;
+    
+    switch (operatorType) {
+        case NSEqualToPredicateOperatorType:
+        case NSNotEqualToPredicateOperatorType: {
+            BOOL wantsEqual = (operatorType == NSEqualToPredicateOperatorType);
+            return ^BOOL(TTMTask *task) {
+                NSString *string = foldedGetter(task);
+                if (string == nil) {
+                    return [comparison evaluateWithObject:task];
+                }
+                BOOL isEqual = [string compare:foldedOperand options:searchOptions] == NSOrderedSame;
+                return isEqual == wantsEqual;
+            };
+        }
+        case NSContainsPredicateOperatorType:
+            break;
+        case NSBeginsWithPredicateOperatorType:
+            searchOptions |= NSAnchoredSearch;
+            break;
+        case NSEndsWithPredicateOperatorType:
+            searchOptions |= NSAnchoredSearch | NSBackwardsSearch;
+            break;
+        default:
+            return nil;
+    }
+    
+    if (foldedOperand.length == 0) {
+        // The default filter is "rawText contains ''". NSString finds no empty string, so
+        // NSPredicate's answers for an empty and a non-empty property are asked for once.
+        BOOL matchesEmptyString = [comparison evaluateWithObject:@{keyPath : @""}];
+        BOOL matchesNonEmptyString = [comparison evaluateWithObject:@{keyPath : @"-"}];
+        return ^BOOL(TTMTask *task) {
+            NSString *string = getter(task);
+            if (string == nil) {
+                return [comparison evaluateWithObject:task];
+            }
+            return (string.length == 0) ? matchesEmptyString : matchesNonEmptyString;
+        };
+    }
+    return ^BOOL(TTMTask *task) {
+        NSString *string = foldedGetter(task);
+        if (string == nil) {
+            return [comparison evaluateWithObject:task];
+        }
+        return [string rangeOfString:foldedOperand options:searchOptions].location != NSNotFound;
+    };
+}
+
+- (TTMTaskEvaluator)evaluatorForNumberComparison:(NSComparisonPredicate*)comparison
+                                          getter:(TTMTaskNumberGetter)getter {
+    id constant = comparison.rightExpression.constantValue;
+    NSPredicateOperatorType operatorType = comparison.predicateOperatorType;
+    if (![constant isKindOfClass:[NSNumber class]] || !IsOrderOperator(operatorType)) {
+        return nil;
+    }
+    double operand = [constant doubleValue];
+    return ^BOOL(TTMTask *task) {
+        return OrderSatisfiesOperator(CompareNumbers(getter(task), operand), operatorType);
+    };
+}
+
+- (TTMTaskEvaluator)evaluatorForDateComparison:(NSComparisonPredicate*)comparison
+                                        getter:(TTMTaskDayGetter)getter {
+    id constant = comparison.rightExpression.constantValue;
+    NSPredicateOperatorType operatorType = comparison.predicateOperatorType;
+    if (![constant isKindOfClass:[NSDate class]] || !IsOrderOperator(operatorType)) {
+        return nil;
+    }
+    
+    // Task dates are local midnights, so they are compared as day numbers. The Date row
+    // template strips the time from its dates, but older presets may have kept it; a date
+    // after midnight sorts between its day and the next, so days are counted in halves.
+    NSDate *date = constant;
+    TTMDayNumber day = [TTMDateUtility dayNumberFromDate:date];
+    NSComparisonResult midnightOrder = [date compare:[TTMDateUtility dateFromDayNumber:day]];
+    if (midnightOrder == NSOrderedAscending) {
+        return nil;
+    }
+    double operand = 2.0 * day + ((midnightOrder == NSOrderedSame) ? 0 : 1);
+    return ^BOOL(TTMTask *task) {
+        TTMDayNumber taskDay = getter(task);
+        if (taskDay == TTMNoDayNumber) {
+            return [comparison evaluateWithObject:task];
+        }
+        return OrderSatisfiesOperator(CompareNumbers(2.0 * taskDay, operand), operatorType);
+    };
+}
+
+#pragma mark - Task Index Methods
+
+- (TTMTaskEvaluator)evaluatorForIndexedPredicate:(NSPredicate*)predicate
+                                    setEvaluator:(TTMTaskSetEvaluator)setEvaluator
+                                         isExact:(BOOL)isExact {
+    // Single tasks passed to evaluateWithTask: are still evaluated one by one.
+    self.isCompilingIndexedSubpredicate = YES;
+    TTMTaskEvaluator taskEvaluator = [self evaluatorForPredicate:predicate];
+    self.isCompilingIndexedSubpredicate = NO;
+    
+    TTMIndexedSubpredicate *subpredicate = [[TTMIndexedSubpredicate alloc] init];
+    subpredicate.setEvaluator = setEvaluator;
+    [self.indexedSubpredicates addObject:subpredicate];
+    if (isExact) {
+        return ^BOOL(TTMTask *task) {
+            TTMTaskBitset *tasks = subpredicate.tasks;
+            if (tasks != nil) {
+                return [tasks containsIndex:(uint32_t)task.uniqueId];
+            }
+            return taskEvaluator(task);
+        };
+    }
+    // The index only found candidates, so those are checked too.
+    return ^BOOL(TTMTask *task) {
+        TTMTaskBitset *tasks = subpredicate.tasks;
+        if (tasks != nil && ![tasks containsIndex:(uint32_t)task.uniqueId]) {
+            return NO;
+        }
+        return taskEvaluator(task);
+    };
+}
+
+// Returns nil if the index cannot answer the predicate. Otherwise isExact is set to NO if
+// the set evaluator only finds candidates, a superset of the tasks the predicate is true for.
+- (TTMTaskSetEvaluator)setEvaluatorForPredicate:(NSPredicate*)predicate isExact:(BOOL*)isExact {
+    if ([predicate isKindOfClass:[NSCompoundPredicate class]]) {
+        return [self setEvaluatorForCompoundPredicate:(NSCompoundPredicate*)predicate
+                                              isExact:isExact];
+    }
+    if ([predicate isKindOfClass:[NSComparisonPredicate class]]) {
+        return [self setEvaluatorForComparisonPredicate:(NSComparisonPredicate*)predicate
+                                                isExact:isExact];
+    }
+    return nil;
+}
+
+- (TTMTaskSetEvaluator)setEvaluatorForCompoundPredicate:(NSCompoundPredicate*)compound
+                                                isExact:(BOOL*)isExact {
+    NSCompoundPredicateType compoundType = compound.compoundPredicateType;
+    if (compound.subpredicates.count == 0 ||
+        (compoundType == NSNotPredicateType && compound.subpredicates.count != 1)) {
+        return nil;
+    }
+    
+    // A compound is only answered by the index if all of its subpredicates are, and is
+    // only answered exactly if they all are.
+    NSMutableArray *setEvaluators = [NSMutableArray arrayWithCapacity:compound.subpredicates.count];
+    *isExact = YES;
+    for (NSPredicate *subpredicate in compound.subpredicates) {
+        BOOL isSubpredicateExact = NO;
+        TTMTaskSetEvaluator setEvaluator = [self setEvaluatorForPredicate:subpredicate
+                                                                  isExact:&isSubpredicateExact];
+        if (setEvaluator == nil) {
+            return nil;
+        }
+        [setEvaluators addObject:setEvaluator];
+        *isExact = *isExact && isSubpredicateExact;
+    }
+    
+    switch (compoundType) {
+        case NSNotPredicateType: {
+            // The complement of candidates is not a set of candidates.
+            if (!*isExact) {
+                return nil;
+            }
+            TTMTaskSetEvaluator setEvaluator = setEvaluators[0];
+            return ^TTMTaskBitset*(TTMTaskIndex *taskIndex) {
+                TTMTaskBitset *tasks = [taskIndex allTasks];
+                [tasks subtractBitset:setEvaluator(taskIndex)];
+                return tasks;
+            };
+        }
+        case NSAndPredicateType:
+            return ^TTMTaskBitset*(TTMTaskIndex *taskIndex) {
+                TTMTaskBitset *tasks = nil;
+                for (TTMTaskSetEvaluator setEvaluator in setEvaluators) {
+                    if (tasks == nil) {
+                        tasks = setEvaluator(taskIndex);
+                    } else if (tasks.count > 0) {
+                        [tasks intersectWithBitset:setEvaluator(taskIndex)];
+                    }
+                }
+                return tasks;
+            };
+        case NSOrPredicateType:
+            return ^TTMTaskBitset*(TTMTaskIndex *taskIndex) {
+                TTMTaskBitset *tasks = [[TTMTaskBitset alloc] init];
+                for (TTMTaskSetEvaluator setEvaluator in setEvaluators) {
+                    [tasks unionWithBitset:setEvaluator(taskIndex)];
+                }
+                return tasks;
+            };
+        default:
+            return nil;
+    }
+}
+
+- (TTMTaskSetEvaluator)setEvaluatorForComparisonPredicate:(NSComparisonPredicate*)comparison
+                                                  isExact:(BOOL*)isExact {
+    if (comparison.comparisonPredicateModifier != NSDirectPredicateModifier ||
+        comparison.leftExpression.expressionType != NSKeyPathExpressionType ||
+        comparison.rightExpression.expressionType != NSConstantValueExpressionType ||
+        ![comparison.rightExpression.constantValue isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    NSString *keyPath = comparison.leftExpression.keyPath;
+    if ([keyPath isEqualToString:@"projects"]) {
+        *isExact = YES;
+        return [self setEvaluatorForTokenComparison:comparison kind:TTMTaskIndexProject];
+    }
+    if ([keyPath isEqualToString:@"contexts"]) {
+        *isExact = YES;
+        return [self setEvaluatorForTokenComparison:comparison kind:TTMTaskIndexContext];
+    }
+    if ([keyPath isEqualToString:@"rawText"]) {
+        *isExact = NO;
+        return [self setEvaluatorForTextComparison:comparison];
+    }
+    return nil;
+}
+
+- (TTMTaskSetEvaluator)setEvaluatorForTokenComparison:(NSComparisonPredicate*)comparison
+                                                 kind:(TTMTaskIndexTokenKind)kind {
+    // The Project and Context row templates build "projects contains[cd] 'word'".
+    if (comparison.predicateOperatorType != NSContainsPredicateOperatorType) {
+        return nil;
+    }
+    NSStringCompareOptions foldOptions = 0;
+    if (comparison.options & NSCaseInsensitivePredicateOption) {
+        foldOptions |= NSCaseInsensitiveSearch;
+    }
+    if (comparison.options & NSDiacriticInsensitivePredicateOption) {
+        foldOptions |= NSDiacriticInsensitiveSearch;
+    }
+    
+    // The property joins the tokens with ", ", so a string that has neither a comma nor
+    // whitespace is contained in the property exactly when it is contained in a token.
+    NSString *operand = comparison.rightExpression.constantValue;
+    NSString *foldedOperand = (foldOptions == 0) ?
+        operand : [operand stringByFoldingWithOptions:foldOptions locale:nil];
+    static NSCharacterSet *separatorCharacters = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableCharacterSet *characters = [NSMutableCharacterSet whitespaceAndNewlineCharacterSet];
+        [characters addCharactersInString:@","];
+        separatorCharacters = [characters copy];
+    });
+    if (foldedOperand.length == 0 ||
+        [foldedOperand rangeOfCharacterFromSet:separatorCharacters].location != NSNotFound) {
+        return nil;
+    }
+    
+    return ^TTMTaskBitset*(TTMTaskIndex *taskIndex) {
+        return [taskIndex tasksWithTokenOfKind:kind containing:operand options:foldOptions];
+    };
+}
+
+- (TTMTaskSetEvaluator)setEvaluatorForTextComparison:(NSComparisonPredicate*)comparison {
+    // The search field builds "rawText contains[cd] 'text'". Text that contains, begins or
+    // ends with the string, folded, has every trigram of the folded string.
+    NSPredicateOperatorType operatorType = comparison.predicateOperatorType;
+    NSComparisonPredicateOptions foldOptions =
+        NSCaseInsensitivePredicateOption | NSDiacriticInsensitivePredicateOption;
+    if ((comparison.options & foldOptions) != foldOptions ||
+        (operatorType != NSContainsPredicateOperatorType &&
+         operatorType != NSBeginsWithPredicateOperatorType &&
+         operatorType != NSEndsWithPredicateOperatorType)) {
+        return nil;
+    }
+    NSString *operand = comparison.rightExpression.constantValue;
+    if (![TTMTaskIndex canNarrowTextSearchForString:operand]) {
+        return nil;
+    }
+    return ^TTMTaskBitset*(TTMTaskIndex *taskIndex) {
+        return [taskIndex candidateTasksWithTextContaining:operand];
+    };
+}
+
+@end
@@ -46,6 +46,24 @@
 
 #import <Foundation/Foundation.h>
 
+/*!
+ * @typedef TTMDayNumber
+ * @abstract A calendar date stored as the number of days since 1970-01-01.
+ * @discussion Day numbers use the proleptic Gregorian calendar and carry no time or time
+ * zone, so they can be compared and subtracted as plain integers. An NSDate for a day
+ * number is local midnight of that day.
+ */
+typedef int32_t TTMDayNumber;
+
+/*! Represents the absence of a date. Sorts before every real date. */
+static const TTMDayNumber TTMNoDayNumber = INT32_MIN;
+
+/*! Day number of 9999-12-31, the date used for missing due, creation, and completion dates. */
+static const TTMDayNumber TTMHighDayNumber = 2932896;
+
+/*! Day number of 1900-01-01, the date used for missing threshold dates. */
+static const TTMDayNumber TTMLowDayNumber = -25567;
+
 @interface TTMDateUtility : NSObject
 
 /*!
@@ -132,4 +150,56 @@
 
 + (NSInteger)daysBetweenDate:(NSDate*)startDate andEndDate:(NSDate*)endDate;
 
+#pragma mark - Day Number Methods
+
+/*!
+ * @method dayNumberFromString:
+ * @abstract This method converts a string in "yyyy-MM-dd" format to a day number.
+ * @param dateString An NSString in "yyyy-MM-dd" format.
+ * @return The day number, or TTMNoDayNumber if the string is not a valid date.
+ */
++ (TTMDayNumber)dayNumberFromString:(NSString*)dateString;
+
+/*!
+ * @method dayNumberFromString:range:
+ * @abstract This method converts a "yyyy-MM-dd" substring to a day number without
+ * creating the substring.
+ * @param string The string containing the date.
+ * @param range The range of the date within the string. May have location NSNotFound.
+ * @return The day number, or TTMNoDayNumber if the range is not a valid date.
+ */
++ (TTMDayNumber)dayNumberFromString:(NSString*)string range:(NSRange)range;
+
+/*!
+ * @method dayNumberFromDate:
+ * @abstract This method returns the day number of the local calendar day containing the date.
+ * @param date The date to convert.
+ * @return The day number, or TTMNoDayNumber if date is nil.
+ */
++ (TTMDayNumber)dayNumberFromDate:(NSDate*)date;
+
+/*!
+ * @method dateFromDayNumber:
+ * @abstract This method returns local midnight of the day number.
+ * @param dayNumber The day number to convert.
+ * @return A date as of 00:00:00, or nil if dayNumber is TTMNoDayNumber.
+ */
++ (NSDate*)dateFromDayNumber:(TTMDayNumber)dayNumber;
+
+/*!
+ * @method stringFromDayNumber:
+ * @abstract This method converts a day number to a string in "yyyy-MM-dd" format.
+ * @param dayNumber The day number to convert.
+ * @return The day number as a string in "yyyy-MM-dd" format, or nil if dayNumber is
+ * TTMNoDayNumber.
+ */
++ (NSString*)stringFromDayNumber:(TTMDayNumber)dayNumber;
+
+/*!
+ * @method todayDayNumber
+ * @abstract This method returns today's date as a day number.
+ * @return Today's day number.
+ */
++ (TTMDayNumber)todayDayNumber;
+
 @end
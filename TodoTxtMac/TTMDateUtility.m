@@ -49,11 +49,85 @@
 
 @implementation TTMDateUtility
 
+static const NSTimeInterval SecondsPerDay = 86400.0;
+
+// Days from 1970-01-01 to the civil date y-m-d (proleptic Gregorian).
+static inline TTMDayNumber DaysFromCivil(NSInteger y, NSInteger m, NSInteger d) {
+    y -= (m <= 2);
+    NSInteger era = (y >= 0 ? y : y - 399) / 400;
+    NSInteger yoe = y - era * 400;
+    NSInteger doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    NSInteger doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (TTMDayNumber)(era * 146097 + doe - 719468);
+}
+
+// Inverse of DaysFromCivil.
+static inline void CivilFromDays(TTMDayNumber dayNumber, NSInteger *y, NSInteger *m, NSInteger *d) {
+    NSInteger z = (NSInteger)dayNumber + 719468;
+    NSInteger era = (z >= 0 ? z : z - 146096) / 146097;
+    NSInteger doe = z - era * 146097;
+    NSInteger yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    NSInteger doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    NSInteger mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp + (mp < 10 ? 3 : -9);
+    *y = yoe + era * 400 + (*m <= 2);
+}
+
+static inline NSInteger DaysInMonth(NSInteger y, NSInteger m) {
+    static const NSInteger days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m == 2 && (y % 4 == 0) && ((y % 100 != 0) || (y % 400 == 0))) {
+        return 29;
+    }
+    return days[m - 1];
+}
+
+static inline BOOL IsASCIIDigit(unichar c) {
+    return c >= '0' && c <= '9';
+}
+
+// Parses "yyyy-MM-dd" written with ASCII digits.
+// Returns NO if the characters are not in that form; *dayNumber is TTMNoDayNumber
+// when they are in that form but do not name a real date.
+static BOOL ParseASCIIDate(const unichar *c, TTMDayNumber *dayNumber) {
+    for (NSUInteger i = 0; i < 10; i++) {
+        if (i == 4 || i == 7) {
+            if (c[i] != '-') {
+                return NO;
+            }
+        } else if (!IsASCIIDigit(c[i])) {
+            return NO;
+        }
+    }
+    NSInteger y = (c[0] - '0') * 1000 + (c[1] - '0') * 100 + (c[2] - '0') * 10 + (c[3] - '0');
+    NSInteger m = (c[5] - '0') * 10 + (c[6] - '0');
+    NSInteger d = (c[8] - '0') * 10 + (c[9] - '0');
+    if (y < 1 || m < 1 || m > 12 || d < 1 || d > DaysInMonth(y, m)) {
+        *dayNumber = TTMNoDayNumber;
+    } else {
+        *dayNumber = DaysFromCivil(y, m, d);
+    }
+    return YES;
+}
+
 + (NSDate*)convertStringToDate:(NSString*)dateString {
     if (!dateString) {
         return nil;
     }
     
+    if (dateString.length == 10) {
+        unichar characters[10];
+        [dateString getCharacters:characters range:NSMakeRange(0, 10)];
+        TTMDayNumber dayNumber;
+        if (ParseASCIIDate(characters, &dayNumber)) {
+            return [self dateFromDayNumber:dayNumber];
+        }
+    }
+    
+    return [self dateFromStringUsingFormatter:dateString];
+}
+
++ (NSDate*)dateFromStringUsingFormatter:(NSString*)dateString {
     // dateString must not contain a time element.
     // We add a time element to it to set the time to midnight.
     NSString *dateTimeString = [dateString stringByAppendingString:@" 00:00:00"];
@@ -77,16 +151,15 @@
     if (!date) {
         return nil;
     }
-    NSDateFormatter *dateFormatter = [self dateFormatter];
-    return [dateFormatter stringFromDate:date];
+    return [self stringFromDayNumber:[self dayNumberFromDate:date]];
 }
 
 + (NSDate*)today {
-    return [self dateWithoutTime:[NSDate date]];
+    return [self dateFromDayNumber:[self todayDayNumber]];
 }
 
 + (NSString*)todayAsString {
-    return [self convertDateToString:[self today]];
+    return [self stringFromDayNumber:[self todayDayNumber]];
 }
 
 + (NSDate*)addDays:(NSInteger)days toDate:(NSDate*)date {
@@ -215,4 +288,62 @@
     return components.day;
 }
 
+#pragma mark - Day Number Methods
+
++ (TTMDayNumber)dayNumberFromString:(NSString*)dateString {
+    return [self dayNumberFromString:dateString range:NSMakeRange(0, dateString.length)];
+}
+
++ (TTMDayNumber)dayNumberFromString:(NSString*)string range:(NSRange)range {
+    if (string == nil || range.location == NSNotFound || range.length != 10) {
+        return TTMNoDayNumber;
+    }
+    
+    unichar characters[10];
+    [string getCharacters:characters range:range];
+    TTMDayNumber dayNumber;
+    if (ParseASCIIDate(characters, &dayNumber)) {
+        return dayNumber;
+    }
+    
+    // Dates written with non-ASCII digits are left to NSDateFormatter.
+    NSDate *date = [self dateFromStringUsingFormatter:[string substringWithRange:range]];
+    return [self dayNumberFromDate:date];
+}
+
++ (TTMDayNumber)dayNumberFromDate:(NSDate*)date {
+    if (date == nil) {
+        return TTMNoDayNumber;
+    }
+    CFTimeZoneRef timeZone = (__bridge CFTimeZoneRef)[NSTimeZone defaultTimeZone];
+    NSTimeInterval offset = CFTimeZoneGetSecondsFromGMT(timeZone, date.timeIntervalSinceReferenceDate);
+    return (TTMDayNumber)floor((date.timeIntervalSince1970 + offset) / SecondsPerDay);
+}
+
++ (NSDate*)dateFromDayNumber:(TTMDayNumber)dayNumber {
+    if (dayNumber == TTMNoDayNumber) {
+        return nil;
+    }
+    // Local midnight is UTC midnight minus the time zone offset in effect at local midnight.
+    // The offset is looked up twice so that days on which the offset changes come out right.
+    CFTimeZoneRef timeZone = (__bridge CFTimeZoneRef)[NSTimeZone defaultTimeZone];
+    CFAbsoluteTime utcMidnight = dayNumber * SecondsPerDay - kCFAbsoluteTimeIntervalSince1970;
+    CFAbsoluteTime localMidnight = utcMidnight - CFTimeZoneGetSecondsFromGMT(timeZone, utcMidnight);
+    localMidnight = utcMidnight - CFTimeZoneGetSecondsFromGMT(timeZone, localMidnight);
+    return [NSDate dateWithTimeIntervalSinceReferenceDate:localMidnight];
+}
+
++ (NSString*)stringFromDayNumber:(TTMDayNumber)dayNumber {
+    if (dayNumber == TTMNoDayNumber) {
+        return nil;
+    }
+    NSInteger y, m, d;
+    CivilFromDays(dayNumber, &y, &m, &d);
+    return [NSString stringWithFormat:@"%04ld-%02ld-%02ld", (long)y, (long)m, (long)d];
+}
+
++ (TTMDayNumber)todayDayNumber {
+    return [self dayNumberFromDate:[NSDate date]];
+}
+
 @end
\ No newline at end of file
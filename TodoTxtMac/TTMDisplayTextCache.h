@@ -0,0 +1,113 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+@class TTMTask;
+
+/*!
+ * @class TTMDisplayTextCache
+ * @abstract TTMDisplayTextCache holds the attributed display text of recently drawn tasks.
+ * @discussion Each task has one text for its selected row and one for its unselected row.
+ * A text is used only while the task's raw text revision, the font, the color scheme
+ * generation and the day are the ones it was made with; the day matters because due tasks
+ * are colored. The least recently used texts are dropped when the texts hold more bytes
+ * than the limit.
+ */
+@interface TTMDisplayTextCache : NSObject
+
+/*! The most bytes the texts may hold. Zero holds no texts. */
+@property (nonatomic) NSUInteger byteLimit;
+
+/*! The approximate bytes held by the texts. */
+@property (nonatomic, readonly) NSUInteger byteCount;
+
+/*! The number of texts held. */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ * @method initWithByteLimit:
+ * @abstract Makes an empty cache.
+ * @param byteLimit The most bytes the texts may hold.
+ * @result Returns the newly initialized cache.
+ */
+- (id)initWithByteLimit:(NSUInteger)byteLimit;
+
+/*!
+ * @method displayTextOfTask:selected:font:colorSchemeGeneration:
+ * @abstract Finds the display text of a task, if it is still valid.
+ * @param task The task.
+ * @param selected Whether the task's row is selected.
+ * @param font The font the text is drawn in.
+ * @param colorSchemeGeneration A number that changes whenever the highlight colors change.
+ * @return The display text, or nil if none is held for these arguments.
+ */
+- (NSAttributedString*)displayTextOfTask:(TTMTask*)task
+                                selected:(BOOL)selected
+                                    font:(NSFont*)font
+                   colorSchemeGeneration:(NSUInteger)colorSchemeGeneration;
+
+/*!
+ * @method setDisplayText:ofTask:selected:font:colorSchemeGeneration:
+ * @abstract Holds the display text of a task, replacing any text held for the same row.
+ * @param displayText The display text, made from the task as it is now.
+ * @param task The task.
+ * @param selected Whether the task's row is selected.
+ * @param font The font the text is drawn in.
+ * @param colorSchemeGeneration A number that changes whenever the highlight colors change.
+ */
+- (void)setDisplayText:(NSAttributedString*)displayText
+                ofTask:(TTMTask*)task
+              selected:(BOOL)selected
+                  font:(NSFont*)font
+ colorSchemeGeneration:(NSUInteger)colorSchemeGeneration;
+
+/*!
+ * @method removeAllDisplayTexts
+ * @abstract Drops every text.
+ */
+- (void)removeAllDisplayTexts;
+
+@end
@@ -0,0 +1,209 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMDisplayTextCache.h"
+#import "TTMTask.h"
+#import "TTMDateUtility.h"
+
+// Approximate bytes held by a display text beyond its characters: the entry, the string
+// objects and its attribute runs.
+static const NSUInteger DisplayTextOverhead = 512;
+
+/*! One held display text, linked into the cache's list from most to least recently used. */
+@interface TTMDisplayTextEntry : NSObject
+
+@property (nonatomic) NSNumber *key;
+@property (nonatomic) NSAttributedString *displayText;
+@property (nonatomic) NSUInteger rawTextRevision;
+@property (nonatomic) NSFont *font;
+@property (nonatomic) NSUInteger colorSchemeGeneration;
+@property (nonatomic) TTMDayNumber day;
+@property (nonatomic) NSUInteger byteCount;
+@property (nonatomic, weak) TTMDisplayTextEntry *previous;
+@property (nonatomic) TTMDisplayTextEntry *next;
+
+@end
+
+@implementation TTMDisplayTextEntry
+
+@end
+
+@interface TTMDisplayTextCache ()
+
+// The entries, keyed by task unique ID and selection.
+@property (nonatomic) NSMutableDictionary *entries;
+
+// The most and least recently used entries.
+@property (nonatomic) TTMDisplayTextEntry *newestEntry;
+@property (nonatomic, weak) TTMDisplayTextEntry *oldestEntry;
+
+@end
+
+@implementation TTMDisplayTextCache
+
+#pragma mark - Init Methods
+
+- (id)initWithByteLimit:(NSUInteger)byteLimit {
+    self = [super init];
+    if (self) {
+        _byteLimit = byteLimit;
+        _entries = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+#pragma mark - Cache Methods
+
+- (NSUInteger)count {
+    return self.entries.count;
+}
+
+- (NSNumber*)keyOfTask:(TTMTask*)task selected:(BOOL)selected {
+    return @((task.uniqueId << 1) | (selected ? 1 : 0));
+}
+
+- (NSAttributedString*)displayTextOfTask:(TTMTask*)task
+                                selected:(BOOL)selected
+                                    font:(NSFont*)font
+                   colorSchemeGeneration:(NSUInteger)colorSchemeGeneration {
+    TTMDisplayTextEntry *entry = self.entries[[self keyOfTask:task selected:selected]];
+    if (entry == nil ||
+        entry.rawTextRevision != task.rawTextRevision ||
+        entry.colorSchemeGeneration != colorSchemeGeneration ||
+        (entry.font != font && ![entry.font isEqual:font]) ||
+        entry.day != [TTMDateUtility todayDayNumber]) {
+        return nil;
+    }
+    [self unlinkEntry:entry];
+    [self linkNewestEntry:entry];
+    return entry.displayText;
+}
+
+- (void)setDisplayText:(NSAttributedString*)displayText
+                ofTask:(TTMTask*)task
+              selected:(BOOL)selected
+                  font:(NSFont*)font
+ colorSchemeGeneration:(NSUInteger)colorSchemeGeneration {
+    NSNumber *key = [self keyOfTask:task selected:selected];
+    [self removeEntry:self.entries[key]];
+    
+    TTMDisplayTextEntry *entry = [[TTMDisplayTextEntry alloc] init];
+    entry.key = key;
+    entry.displayText = displayText;
+    entry.rawTextRevision = task.rawTextRevision;
+    entry.font = font;
+    entry.colorSchemeGeneration = colorSchemeGeneration;
+    entry.day = [TTMDateUtility todayDayNumber];
+    entry.byteCount = displayText.length * sizeof(unichar) + DisplayTextOverhead;
+    if (entry.byteCount > self.byteLimit) {
+        return;
+    }
+    self.entries[key] = entry;
+    [self linkNewestEntry:entry];
+    _byteCount += entry.byteCount;
+    
+    // Drop the least recently used texts over the limit.
+    while (_byteCount > self.byteLimit) {
+        [self removeEntry:self.oldestEntry];
+    }
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit {
+    _byteLimit = byteLimit;
+    while (_byteCount > _byteLimit) {
+        [self removeEntry:self.oldestEntry];
+    }
+}
+
+- (void)removeAllDisplayTexts {
+    [self.entries removeAllObjects];
+    
+    // Unlink the entries one at a time, rather than releasing a long chain recursively.
+    while (self.oldestEntry != nil) {
+        [self unlinkEntry:self.oldestEntry];
+    }
+    _byteCount = 0;
+}
+
+#pragma mark - List Methods
+
+- (void)removeEntry:(TTMDisplayTextEntry*)entry {
+    if (entry == nil) {
+        return;
+    }
+    _byteCount -= entry.byteCount;
+    [self unlinkEntry:entry];
+    [self.entries removeObjectForKey:entry.key];
+}
+
+- (void)linkNewestEntry:(TTMDisplayTextEntry*)entry {
+    entry.previous = nil;
+    entry.next = self.newestEntry;
+    self.newestEntry.previous = entry;
+    self.newestEntry = entry;
+    if (self.oldestEntry == nil) {
+        self.oldestEntry = entry;
+    }
+}
+
+- (void)unlinkEntry:(TTMDisplayTextEntry*)entry {
+    TTMDisplayTextEntry *previous = entry.previous;
+    TTMDisplayTextEntry *next = entry.next;
+    if (previous != nil) {
+        previous.next = next;
+    } else {
+        self.newestEntry = next;
+    }
+    if (next != nil) {
+        next.previous = previous;
+    } else {
+        self.oldestEntry = previous;
+    }
+    entry.previous = nil;
+    entry.next = nil;
+}
+
+@end
@@ -45,10 +45,14 @@
  */
 
 #import <Cocoa/Cocoa.h>
+#import "TTMTaskArrayController.h"
 @class TTMAppController;
 @class TTMFieldEditor;
 @class TTMTask;
 @class TTMTasklistMetadata;
+@class TTMSymbolTable;
+@class TTMUndoBudget;
+@class TTMLatencyHistogram;
 @class TTMTableView;
 @class TTMTableViewDelegate;
 
@@ -58,18 +62,6 @@
 #define STATUSBARMENUITEMTAG 6000
 #define COPYTASKTONEWTASKMENUTAG 7000
 
-typedef enum : NSUInteger {
-    TTMSortOrderInFile,
-    TTMSortPriority,
-    TTMSortProject,
-    TTMSortContext,
-    TTMSortDueDate,
-    TTMSortCreationDate,
-    TTMSortCompletionDate,
-    TTMSortThresholdDate,
-    TTMSortAlphabetical
-} TTMTaskListSortType;
-
 @interface TTMDocument : NSDocument
 
 #pragma mark - Properties
@@ -78,6 +70,13 @@ typedef enum : NSUInteger {
 @property (nonatomic, copy) NSMutableArray *taskList;
 @property (nonatomic) BOOL usesWindowsLineEndings;
 @property (nonatomic, copy) NSString *preferredLineEnding;
+/*! Interns the projects and contexts of every task in this document. */
+@property (nonatomic, readonly) TTMSymbolTable *symbolTable;
+/*! Tracks the memory held by undo, and discards the oldest undo actions over the limit set
+ *  in preferences. */
+@property (nonatomic, readonly) TTMUndoBudget *undoBudget;
+/*! The time from the first keystroke in the search field to its filtered tasks being shown. */
+@property (nonatomic, readonly) TTMLatencyHistogram *searchLatencies;
 
 // Window controls
 @property (nonatomic, retain) IBOutlet NSTextField *textField;
@@ -85,7 +84,7 @@ typedef enum : NSUInteger {
 @property (nonatomic, retain) IBOutlet NSPredicate *searchFieldPredicate;
 @property (nonatomic, retain) IBOutlet TTMTableView *tableView;
 @property (nonatomic, retain) IBOutlet TTMTableViewDelegate *tableViewDelegate;
-@property (nonatomic, retain) IBOutlet NSArrayController *arrayController;
+@property (nonatomic, retain) IBOutlet TTMTaskArrayController *arrayController;
 @property (nonatomic, retain) IBOutlet NSCell *rawTextCell;
 @property (nonatomic, retain) TTMFieldEditor *customFieldEditor;
 @property (nonatomic, retain) IBOutlet NSTextField *statusBarTextField;
@@ -111,8 +110,9 @@ typedef enum : NSUInteger {
 @property (nonatomic, retain) TTMTasklistMetadata *filteredTasklistMetadata;
 @property (nonatomic, retain) IBOutlet NSWindow *tasklistMetadataSheet;
 
-// Task objects for undo/redo of task edits
+// Tasks being edited, and their raw text before the edit, for undo/redo of task edits
 @property (nonatomic, copy) NSArray *originalTasks;
+@property (nonatomic, copy) NSArray *originalRawTexts;
 
 @property (nonatomic, retain) NSDate *lastInternalModificationDate;
 
@@ -121,10 +121,20 @@ typedef enum : NSUInteger {
 
 /*!
  * @method reloadFile:
- * @abstract Reloads the task list file.
+ * @abstract Reloads the task list file. Only the lines that changed are parsed and
+ * applied to the task list, unless too many lines changed.
  */
 - (IBAction)reloadFile:(id)sender;
 
+/*!
+ * @method reloadFileIncrementally
+ * @abstract Diffs the task list file against the task list, and applies only the
+ * inserted, deleted, and changed lines as one undoable change.
+ * @return Returns NO without changing the task list if the file cannot be read, is not
+ * UTF-8, or differs from the task list by too many lines.
+ */
+- (BOOL)reloadFileIncrementally;
+
 /*!
  * @method getTaskListSelections
  * @abstract This method gets/saves selected items in the task list before the reload:
@@ -140,22 +150,42 @@ typedef enum : NSUInteger {
  * method reloads the task list file, to allow for selections to be retained (as much as possible)
  * after the user reloads the file. This method makes a best effort to select the same tasks as
  * were selected before (which are to be returned by the getTaskListSelections: method prior to
- * reloading the file. Tasks that change (i.e., are completed or otherwise modified) or removed 
- * from the list will not be selected after reload. For duplicate tasks (those with identical
- * raw text), the first of the duplicate tasks will be selected.
+ * reloading the file. Tasks are found by their unique IDs, so edited and moved tasks stay
+ * selected. Tasks replaced by a full reload are matched by raw text instead; for duplicate
+ * tasks (those with identical raw text), the first of the duplicate tasks will be selected.
+ * Tasks removed from the list will not be selected after reload.
  */
 - (void)setTaskListSelections:(NSArray*)taskListSelectedItems;
 
+/*!
+ * @method taskWithUniqueId:
+ * @abstract Looks up a task in the task list by its unique ID.
+ * @param uniqueId The unique ID of the task.
+ * @return The task, or nil if no task in the task list has the ID.
+ */
+- (TTMTask*)taskWithUniqueId:(NSUInteger)uniqueId;
+
 #pragma mark - Undo/Redo Methods
 
 /*!
- * @method replaceTasks:withTasks:
- * @abstract This method replaces one array of tasks with another in the task list.
- * It is used for undo/redo operations, namely to undo the reload file command.
+ * @method replaceAllTasks:
+ * @abstract This method replaces every task in the task list with the given tasks.
+ * It is used to undo the reload file command, and restores the replaced task objects so
+ * that their unique IDs still match earlier undo actions.
  */
 
 - (void)replaceAllTasks:(NSArray*)newTasks;
 
+/*!
+ * @method setRawTexts:ofTasksWithUniqueIds:
+ * @abstract This method sets the raw text of tasks found by unique ID. It is used to undo and
+ * redo task edits, which record only the edited tasks' IDs and raw text.
+ * @param rawTexts The raw text to give each task.
+ * @param uniqueIds The unique IDs of the tasks, as NSNumbers. Tasks no longer in the task list
+ * are skipped.
+ */
+- (void)setRawTexts:(NSArray*)rawTexts ofTasksWithUniqueIds:(NSArray*)uniqueIds;
+
 /*!
  * @method replaceTasks:withTasks:
  * @abstract This method replaces one array of tasks with another in the task list. 
@@ -163,6 +193,23 @@ typedef enum : NSUInteger {
  */
 - (void)replaceTasks:(NSArray*)oldTasks withTasks:(NSArray*)newTasks;
 
+/*!
+ * @method replaceTasksAtIndexes:withTasks:atIndexes:changingTasks:toRawTexts:
+ * @abstract Applies one set of changes to the task list, in file order, and registers the
+ * reverse changes for undo. It is used to apply and undo incremental file reloads.
+ * Tasks are renumbered by their new positions.
+ * @param removedIndexes The indexes of tasks to remove from the task list.
+ * @param insertedTasks Tasks to insert after the removal.
+ * @param insertedIndexes The indexes of the inserted tasks in the resulting task list.
+ * @param changedTasks Tasks whose raw text is replaced in place.
+ * @param rawTexts The new raw text of each changed task.
+ */
+- (void)replaceTasksAtIndexes:(NSIndexSet*)removedIndexes
+                    withTasks:(NSArray*)insertedTasks
+                    atIndexes:(NSIndexSet*)insertedIndexes
+                changingTasks:(NSArray*)changedTasks
+                   toRawTexts:(NSArray*)rawTexts;
+
 /*!
  * @method addTasks:
  * @abstract This method adds an array of tasks to the task list.
@@ -207,6 +254,14 @@ typedef enum : NSUInteger {
  */
 - (void)removeAllTasks;
 
+/*!
+ * @method replaceAllTasksWithLoadedTasks:
+ * @abstract Replaces the task list with tasks loaded from a todo.txt file.
+ * @param loadedTasks The tasks, which are added to the task list in one batch.
+ * @discussion This method does not register an undo action.
+ */
+- (void)replaceAllTasksWithLoadedTasks:(NSArray*)loadedTasks;
+
 /*!
  * @method addTasksFromArray:removeAllTasksFirst:undoActionName
  * @abstract Add tasks from an array to the task list.
@@ -270,6 +325,17 @@ typedef enum : NSUInteger {
  */
 - (void)refreshTaskListWithSave:(BOOL)saveToFile;
 
+/*!
+ * @method refreshTaskListForChangedTasks:withSave:
+ * @abstract Refreshes the task list after some tasks were edited in place.
+ * @discussion Unlike refreshTaskListWithSave:, this does not sort and filter the whole task
+ * list again. It moves the changed tasks to their new rows and reloads only the rows in
+ * between.
+ * @param changedTasks The tasks that were edited. None may have been added or removed.
+ * @param saveToFile Set to YES to save the file before the refresh.
+ */
+- (void)refreshTaskListForChangedTasks:(NSArray*)changedTasks withSave:(BOOL)saveToFile;
+
 /*!
  * @method visualRefreshOnly:
  * @abstract Refreshes the tableView control to apply color changes, etc., only.
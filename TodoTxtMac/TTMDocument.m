@@ -54,12 +54,50 @@
 #import "RegExCategories.h"
 #import "TTMTasklistMetadata.h"
 #import "TTMDocumentStatusBarText.h"
+#import "TTMSymbolTable.h"
+#import "TTMTaskLoader.h"
+#import "TTMLineIndex.h"
+#import "TTMParseCache.h"
+#import "TTMLineDiff.h"
+#import "TTMUndoBudget.h"
+#import "TTMTaskIndex.h"
+#import "TTMLatencyHistogram.h"
+
+@interface TTMDocument ()
+
+/*! Parsed state of the tasks in the file being saved, stored in the parse cache once the
+ *  file is written. */
+@property (nonatomic) TTMParseCacheEntry *pendingParseCacheEntry;
+
+/*! The tasks in the task list, keyed by unique ID. */
+@property (nonatomic) NSMutableDictionary *tasksByUniqueId;
+
+/*! The projects, contexts and tags of the tasks in the task list. */
+@property (nonatomic) TTMTaskIndex *taskIndex;
+
+/*! Makes the status bar text from the status bar format preference. */
+@property (nonatomic) TTMDocumentStatusBarText *statusBarTextMaker;
+
+/*! The undo memory in bytes when the status bar text was last made. */
+@property (nonatomic) NSUInteger statusBarUndoByteCount;
+
+/*! When the search field last changed, if its filter has not been shown yet. */
+@property (nonatomic) NSDate *searchFieldChangeDate;
+
+@end
 
 @implementation TTMDocument
 
 #pragma mark - Instance Variables
 
 static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
+// Reloads that insert or delete more lines than this read the whole file instead.
+static const NSUInteger MaxIncrementalReloadEdits = 1000;
+// Approximate bytes held by an undo invocation, and by a task beyond its raw text.
+static const NSUInteger UndoInvocationByteCount = 128;
+static const NSUInteger UndoTaskByteCount = 512;
+// Seconds to wait for another keystroke in the search field before filtering.
+static const NSTimeInterval SearchFieldDebounceInterval = 0.1;
 
 #pragma mark - init Methods
 
@@ -69,12 +107,18 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     if (self) {
         [[self undoManager] disableUndoRegistration];
         _taskList = [[NSMutableArray alloc] init];
-        _arrayController = [[NSArrayController alloc] initWithContent:_taskList];
+        _tasksByUniqueId = [[NSMutableDictionary alloc] init];
+        _taskIndex = [[TTMTaskIndex alloc] init];
+        _tasklistMetadata = [[TTMTasklistMetadata alloc] init];
+        _filteredTasklistMetadata = [[TTMTasklistMetadata alloc] init];
+        _symbolTable = [[TTMSymbolTable alloc] init];
+        _arrayController = [[TTMTaskArrayController alloc] initWithContent:_taskList];
         _preferredLineEnding = @"\n";
         _usesWindowsLineEndings = NO;
         _activeFilterPredicateNumber = [TTMFilterPredicates activeFilterPredicatePresetNumber];
-        [self.undoManager setLevelsOfUndo:[[NSUserDefaults standardUserDefaults]
-                                           integerForKey:@"levelsOfUndo"]];
+        _undoBudget = [[TTMUndoBudget alloc] initWithUndoManager:self.undoManager];
+        _searchLatencies = [[TTMLatencyHistogram alloc] init];
+        [self updateUndoLimits];
         [[self undoManager] enableUndoRegistration];
 
         _lastInternalModificationDate = nil;
@@ -84,6 +128,18 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 - (void)awakeFromNib {
+    // Tasks loaded before the nib was loaded were added straight to the task list, without
+    // going through its indexed accessors, so index them now.
+    [self.tasksByUniqueId removeAllObjects];
+    for (TTMTask *task in self.taskList) {
+        [self.tasksByUniqueId setObject:task forKey:@(task.uniqueId)];
+    }
+    [self.taskIndex removeAllTasks];
+    [self.taskIndex addTasks:self.taskList];
+    self.arrayController.taskIndex = self.taskIndex;
+    // The task list metadata is counted from scratch the first time it is updated.
+    [self.tasklistMetadata removeAllTasks];
+    
     // Set custom field editor.
     
     // Set arrayController sort type.
@@ -106,12 +162,25 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     
     // Observe self to update search field filter
     [self addObserver:self forKeyPath:@"searchFieldPredicate" options:NSKeyValueObservingOptionNew context:nil];
+
+    // Filter in the background from now on, once the initial filter has been applied, and
+    // update the status bar when the filtered tasks are shown.
+    self.arrayController.arrangesInBackground = YES;
+    [[NSNotificationCenter defaultCenter]
+     addObserver:self
+     selector:@selector(arrayControllerDidArrangeInBackground:)
+     name:TTMTaskArrayControllerDidArrangeInBackgroundNotification
+     object:self.arrayController];
     
     // Observe NSUserDefaults to update undo-related preferences
     [[NSUserDefaults standardUserDefaults] addObserver:self
                                             forKeyPath:@"levelsOfUndo"
                                                options:NSKeyValueObservingOptionNew
                                                context:nil];
+    [[NSUserDefaults standardUserDefaults] addObserver:self
+                                            forKeyPath:@"undoMemoryLimit"
+                                               options:NSKeyValueObservingOptionNew
+                                               context:nil];
 
     // Observe NSUserDefaults to update filter-related preferences
     [[NSUserDefaults standardUserDefaults] addObserver:self
@@ -169,6 +238,11 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
         self.customFieldEditor = [[TTMFieldEditor alloc] init];
     }
     [self.customFieldEditor setFieldEditor:YES];
+    if (self.tasklistMetadata.needsFullCount) {
+        [self updateTaskListMetadata];
+    } else {
+        [self.tasklistMetadata updateChangedTasks];
+    }
     self.customFieldEditor.projectsArray = self.tasklistMetadata.projectsArray;
     self.customFieldEditor.contextsArray = self.tasklistMetadata.contextsArray;
     self.customFieldEditor.drawsBackground = YES;
@@ -181,6 +255,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 - (NSData *)dataOfType:(NSString *)typeName error:(NSError **)outError {
     // Prepare file contents to save.
     NSMutableString *fileData = [[NSMutableString alloc] init];
+    NSMutableArray *savedTasks = [[NSMutableArray alloc] initWithCapacity:[self.taskList count]];
     for (int i = 0; i < [self.taskList count]; i++) {
         if ([[self.taskList objectAtIndex:i] isKindOfClass:[TTMTask class]]) {
             NSString *line = [[self.taskList objectAtIndex:i] rawText];
@@ -190,15 +265,86 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
                 [fileData appendString:line];
                 [fileData appendString:self.preferredLineEnding];
             }
+            if (line.length > 0) {
+                [savedTasks addObject:[self.taskList objectAtIndex:i]];
+            }
+        }
+    }
+    NSData *data = [fileData dataUsingEncoding:NSUTF8StringEncoding];
+    
+    // Capture the saved tasks' parsed state now, because the tasks can change while the
+    // file is written in the background.
+    self.pendingParseCacheEntry = [self.parseCache entryForTasks:savedTasks fileData:data];
+    
+    return data;
+}
+
+- (void)saveToURL:(NSURL *)url
+           ofType:(NSString *)typeName
+ forSaveOperation:(NSSaveOperationType)saveOperation
+completionHandler:(void (^)(NSError *errorOrNil))completionHandler {
+    [super saveToURL:url ofType:typeName forSaveOperation:saveOperation completionHandler:^(NSError *errorOrNil) {
+        // Once the file is written, cache its tasks so that the next open does not parse it.
+        TTMParseCacheEntry *parseCacheEntry = self.pendingParseCacheEntry;
+        self.pendingParseCacheEntry = nil;
+        if (errorOrNil == nil && [url isEqual:self.fileURL]) {
+            [self.parseCache storeEntry:parseCacheEntry forFileURL:url];
         }
+        completionHandler(errorOrNil);
+    }];
+}
+
+- (TTMParseCache*)parseCache {
+    return [[NSUserDefaults standardUserDefaults] boolForKey:@"useParsedStateCache"] ?
+        [TTMParseCache defaultCache] :
+        nil;
+}
+
+- (BOOL)readFromURL:(NSURL *)url ofType:(NSString *)typeName error:(NSError **)outError {
+    // Map the file instead of reading it into memory. The mapping only lives while the
+    // tasks are parsed; each task keeps its own copy of its line.
+    NSData *data = [NSData dataWithContentsOfURL:url
+                                         options:NSDataReadingMappedIfSafe
+                                           error:outError];
+    if (!data) {
+        return NO;
     }
-    return [fileData dataUsingEncoding:NSUTF8StringEncoding];
+    return [self readFromData:data fileURL:url error:outError];
 }
 
 - (BOOL)readFromData:(NSData *)data ofType:(NSString *)typeName error:(NSError **)outError {
-    // Read file contents.
-    NSString *fileContents = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-    if (!fileContents) {
+    return [self readFromData:data fileURL:nil error:outError];
+}
+
+- (BOOL)readFromData:(NSData *)data fileURL:(NSURL *)fileURL error:(NSError **)outError {
+    // Index the lines of the file in one pass over its bytes, without making any
+    // whole-file strings.
+    // Note: A file with Windows line endings ("\r\n") may also have Unix line endings ("\n").
+    // This can happen if a text file is created on Windows, then is edited on the Mac
+    // (in TextEdit, for example). The line index accepts either ending on every line.
+    // The same pass checks that the file is UTF-8.
+    TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:data];
+    
+    // Restore the tasks from the parse cache if the file has not changed since it was cached.
+    // Otherwise, parse the tasks straight from the file's bytes, and cache them.
+    NSArray *tasks = nil;
+    if (lineIndex.isValidUTF8) {
+        TTMParseCache *parseCache = (fileURL != nil) ? self.parseCache : nil;
+        tasks = [parseCache tasksFromData:data
+                                lineIndex:lineIndex
+                                  fileURL:fileURL
+                              firstTaskId:0
+                              symbolTable:self.symbolTable];
+        if (!tasks) {
+            tasks = [TTMTaskLoader tasksFromData:data
+                                       lineIndex:lineIndex
+                                     firstTaskId:0
+                                     symbolTable:self.symbolTable];
+            [parseCache storeEntry:[parseCache entryForTasks:tasks fileData:data]
+                        forFileURL:fileURL];
+        }
+    }
+    if (!tasks) {
         if (outError != nil) {
             *outError = [NSError errorWithDomain:NSCocoaErrorDomain
                                             code:NSFileReadUnknownError
@@ -207,23 +353,12 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
         return NO;
     }
 
-    // Check the line endings in the file, and remember if Windows line endings ("\r\n") are used.
-    self.usesWindowsLineEndings = ([fileContents rangeOfString:@"\r\n"].location != NSNotFound);
+    // Remember if Windows line endings ("\r\n") are used.
+    self.usesWindowsLineEndings = lineIndex.hasWindowsLineEndings;
     self.preferredLineEnding = (self.usesWindowsLineEndings) ? @"\r\n" : @"\n";
-    
-    // Split contents of file into an array of strings.
-    // Note: A file with Windows line endings ("\r\n") may also have Unix line endings ("\n").
-    // This can happen if a text file is created on Windows, then is edited on the Mac
-    // (in TextEdit, for example).
-    // Because inconsistent line endings can exist, for files with Windows line endings,
-    // we remove the carriage return character prior to splitting the file contents into
-    // an array of strings.
-    NSArray *rawTextStrings = (self.usesWindowsLineEndings) ?
-        [[fileContents stringByReplacingOccurrencesOfString:@"\r" withString:@""] componentsSeparatedByString:@"\n"] :
-        [fileContents componentsSeparatedByString:@"\n"];
 
     // Refresh the arrayController and tableView
-    [self addTasksFromArray:rawTextStrings removeAllTasksFirst:YES undoActionName:@""];
+    [self replaceAllTasksWithLoadedTasks:tasks];
 
     [self updateLastInternalModificationDate];
 
@@ -242,7 +377,12 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 - (IBAction)reloadFile:(id)sender {
-    [[self.undoManager prepareWithInvocationTarget:self] replaceAllTasks:[self.taskList copy]];
+    // Apply only the lines that changed, unless too many lines changed.
+    if ([self reloadFileIncrementally]) {
+        return;
+    }
+    
+    [self registerUndoReplacingAllTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Reload File", @"Undo Reload File")];
     
     // retain selected items, because selection is lost when the file/arrayController is reloaded
@@ -258,6 +398,130 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [self updateTaskListMetadata];
 }
 
+- (BOOL)reloadFileIncrementally {
+    if (self.fileURL == nil) {
+        return NO;
+    }
+    NSData *data NS_VALID_UNTIL_END_OF_SCOPE =
+        [NSData dataWithContentsOfURL:self.fileURL options:NSDataReadingMappedIfSafe error:nil];
+    if (!data) {
+        return NO;
+    }
+    TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:data];
+    if (!lineIndex.isValidUTF8) {
+        return NO;
+    }
+    const char *bytes = data.bytes;
+    
+    // Hash the non-blank lines of the file, which become tasks, and the tasks in file order.
+    NSUInteger lineCount = lineIndex.lineCount;
+    NSRange *lineRanges = malloc(MAX(lineCount, (NSUInteger)1) * sizeof(NSRange));
+    TTMDiffLine *newLines = malloc(MAX(lineCount, (NSUInteger)1) * sizeof(TTMDiffLine));
+    NSUInteger newCount = 0;
+    for (NSUInteger i = 0; i < lineCount; i++) {
+        NSRange range = [lineIndex rangeOfLineAtIndex:i];
+        if (range.length > 0) {
+            lineRanges[newCount] = range;
+            newLines[newCount].bytes = bytes + range.location;
+            newLines[newCount].length = range.length;
+            newLines[newCount].hash = [TTMLineDiff hashOfBytes:bytes + range.location
+                                                        length:range.length];
+            newCount++;
+        }
+    }
+    NSArray *oldTasks = [self.taskList copy];
+    NSUInteger oldCount = [oldTasks count];
+    TTMDiffLine *oldLines = malloc(MAX(oldCount, (NSUInteger)1) * sizeof(TTMDiffLine));
+    for (NSUInteger i = 0; i < oldCount; i++) {
+        // The UTF-8 buffers are autoreleased, so they outlive the diff.
+        const char *utf8 = [[[oldTasks objectAtIndex:i] rawText] UTF8String] ?: "";
+        oldLines[i].bytes = utf8;
+        oldLines[i].length = strlen(utf8);
+        oldLines[i].hash = [TTMLineDiff hashOfBytes:utf8 length:oldLines[i].length];
+    }
+    TTMLineDiff *diff = [[TTMLineDiff alloc] initWithOldLines:oldLines count:oldCount
+                                                     newLines:newLines count:newCount
+                                              maxEditDistance:MaxIncrementalReloadEdits];
+    free(oldLines);
+    free(newLines);
+    if (!diff) {
+        free(lineRanges);
+        return NO;
+    }
+    
+    // Walk the runs of deleted and inserted lines between matching lines. Within a run,
+    // deleted tasks are paired with inserted lines and changed in place; the rest of the
+    // run is removed or inserted. Only changed and inserted lines are parsed.
+    NSStringEncoding encoding = lineIndex.isASCII ? NSASCIIStringEncoding : NSUTF8StringEncoding;
+    NSMutableIndexSet *removedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *insertedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableArray *insertedTasks = [NSMutableArray array];
+    NSMutableArray *changedTasks = [NSMutableArray array];
+    NSMutableArray *changedRawTexts = [NSMutableArray array];
+    NSUInteger i = 0;
+    NSUInteger j = 0;
+    while (i < oldCount || j < newCount) {
+        NSUInteger deletedCount = 0;
+        while (i + deletedCount < oldCount &&
+               [diff.deletedIndexes containsIndex:i + deletedCount]) {
+            deletedCount++;
+        }
+        NSUInteger insertedCount = 0;
+        while (j + insertedCount < newCount &&
+               [diff.insertedIndexes containsIndex:j + insertedCount]) {
+            insertedCount++;
+        }
+        if (deletedCount == 0 && insertedCount == 0) {
+            i++;
+            j++;
+            continue;
+        }
+        
+        NSUInteger changedCount = MIN(deletedCount, insertedCount);
+        for (NSUInteger k = 0; k < insertedCount; k++) {
+            NSRange range = lineRanges[j + k];
+            NSString *rawText = [[NSString alloc] initWithBytes:bytes + range.location
+                                                         length:range.length
+                                                       encoding:encoding];
+            if (k < changedCount) {
+                [changedTasks addObject:[oldTasks objectAtIndex:i + k]];
+                [changedRawTexts addObject:rawText];
+            } else {
+                TTMTask *task = [[TTMTask alloc] initWithRawText:rawText withTaskId:j + k];
+                task.symbolTable = self.symbolTable;
+                [insertedTasks addObject:task];
+                [insertedIndexes addIndex:j + k];
+            }
+        }
+        [removedIndexes addIndexesInRange:NSMakeRange(i + changedCount,
+                                                      deletedCount - changedCount)];
+        i += deletedCount;
+        j += insertedCount;
+    }
+    free(lineRanges);
+    
+    if ([removedIndexes count] > 0 || [insertedTasks count] > 0 || [changedTasks count] > 0) {
+        [self replaceTasksAtIndexes:removedIndexes
+                          withTasks:insertedTasks
+                          atIndexes:insertedIndexes
+                      changingTasks:changedTasks
+                         toRawTexts:changedRawTexts];
+        [self.undoManager setActionName:NSLocalizedString(@"Reload File", @"Undo Reload File")];
+    }
+    
+    // Remember if Windows line endings ("\r\n") are used.
+    self.usesWindowsLineEndings = lineIndex.hasWindowsLineEndings;
+    self.preferredLineEnding = (self.usesWindowsLineEndings) ? @"\r\n" : @"\n";
+    
+    // The document now matches the file, as it would after a full revert.
+    NSDate *fileDate;
+    [self.fileURL getResourceValue:&fileDate forKey:NSURLContentModificationDateKey error:nil];
+    self.fileModificationDate = fileDate;
+    [self updateLastInternalModificationDate];
+    
+    return YES;
+}
+
 - (NSArray*)getTaskListSelections {
     return [[self.arrayController selectedObjects] copy];
 }
@@ -267,27 +531,45 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
         return;
     }
 
-    NSMutableArray *selectedItems = [NSMutableArray arrayWithArray:taskListSelectedItems];
-    NSMutableArray *itemsToSelect = [NSMutableArray array];
+    // Find each selected task by its unique ID, which survives edits, sorts and filters.
+    NSMutableArray *itemsToSelect = [NSMutableArray arrayWithCapacity:[taskListSelectedItems count]];
+    NSMutableIndexSet *selectedUniqueIds = [NSMutableIndexSet indexSet];
+    NSCountedSet *unmatchedRawTexts = nil;
+    for (TTMTask *selection in taskListSelectedItems) {
+        TTMTask *task = [self taskWithUniqueId:selection.uniqueId];
+        if (task != nil) {
+            [itemsToSelect addObject:task];
+            [selectedUniqueIds addIndex:task.uniqueId];
+        } else {
+            if (unmatchedRawTexts == nil) {
+                unmatchedRawTexts = [[NSCountedSet alloc] init];
+            }
+            [unmatchedRawTexts addObject:selection.rawText];
+        }
+    }
     
-    for (TTMTask *task in [self.arrayController arrangedObjects]) {
-        int i = 0;
-        BOOL selected = NO;
-        while (i < [selectedItems count] && !selected) {
-            TTMTask *selection = [selectedItems objectAtIndex:i];
-            if ([task.rawText isEqualToString:selection.rawText]) {
+    // Tasks replaced by a full reload have new IDs, so fall back to matching raw text. Each
+    // selection with a given raw text selects the next task with that text.
+    if ([unmatchedRawTexts count] > 0) {
+        for (TTMTask *task in [self.arrayController arrangedObjects]) {
+            if ([unmatchedRawTexts countForObject:task.rawText] > 0 &&
+                ![selectedUniqueIds containsIndex:task.uniqueId]) {
                 [itemsToSelect addObject:task];
-                [selectedItems removeObjectAtIndex:i];
-                selected = YES;
-            }
-            else {
-                i++;
+                [selectedUniqueIds addIndex:task.uniqueId];
+                [unmatchedRawTexts removeObject:task.rawText];
+                if ([unmatchedRawTexts count] == 0) {
+                    break;
+                }
             }
         }
     }
     [self.arrayController setSelectedObjects:itemsToSelect];
 }
 
+- (TTMTask*)taskWithUniqueId:(NSUInteger)uniqueId {
+    return [self.tasksByUniqueId objectForKey:@(uniqueId)];
+}
+
 - (void)presentedItemDidChange {
     dispatch_async(dispatch_get_main_queue(), ^{
         [self performSynchronousFileAccessUsingBlock:^{
@@ -312,7 +594,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 #pragma mark - Undo/Redo Methods
 
 - (void)replaceAllTasks:(NSArray*)newTasks {
-    [[self.undoManager prepareWithInvocationTarget:self] replaceAllTasks:[[self.arrayController arrangedObjects] copy]];
+    [self registerUndoReplacingAllTasks];
     NSRange range = NSMakeRange(0, [[self.arrayController arrangedObjects] count]);
     
     // retain selected items, because selection is lost when the file/arrayController is reloaded
@@ -341,21 +623,118 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 
+- (void)updateUndoLimits {
+    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+    [self.undoManager setLevelsOfUndo:[defaults integerForKey:@"levelsOfUndo"]];
+    self.undoBudget.levelsOfUndo = [self.undoManager levelsOfUndo];
+    // The limit is set in megabytes; zero means no limit.
+    self.undoBudget.byteLimit = MAX([defaults integerForKey:@"undoMemoryLimit"], 0) * 1024 * 1024;
+}
+
+- (void)setRawTexts:(NSArray*)rawTexts ofTasksWithUniqueIds:(NSArray*)uniqueIds {
+    // Tasks that have since left the task list are skipped.
+    NSMutableArray *tasks = [NSMutableArray arrayWithCapacity:[uniqueIds count]];
+    NSMutableArray *newRawTexts = [NSMutableArray arrayWithCapacity:[rawTexts count]];
+    for (NSUInteger i = 0; i < [uniqueIds count]; i++) {
+        TTMTask *task = [self taskWithUniqueId:[[uniqueIds objectAtIndex:i] unsignedIntegerValue]];
+        if (task != nil) {
+            [tasks addObject:task];
+            [newRawTexts addObject:[rawTexts objectAtIndex:i]];
+        }
+    }
+    [self registerUndoSettingRawTexts:[tasks valueForKey:@"rawText"] ofTasks:tasks];
+    for (NSUInteger i = 0; i < [tasks count]; i++) {
+        [[tasks objectAtIndex:i] setRawText:[newRawTexts objectAtIndex:i]];
+    }
+    [self refreshTaskListForChangedTasks:tasks withSave:YES];
+}
+
+- (void)registerUndoSettingRawTexts:(NSArray*)rawTexts ofTasks:(NSArray*)tasks {
+    [[self.undoManager prepareWithInvocationTarget:self] setRawTexts:rawTexts
+                                                ofTasksWithUniqueIds:[tasks valueForKey:@"uniqueId"]];
+    [self.undoBudget addBytes:UndoInvocationByteCount + [tasks count] * sizeof(NSUInteger) +
+                              [TTMUndoBudget byteCountOfStrings:rawTexts]];
+}
+
+- (void)registerUndoAddingTasks:(NSArray*)tasks {
+    [[self.undoManager prepareWithInvocationTarget:self] addTasks:tasks];
+    [self.undoBudget addBytes:[self undoByteCountOfTasks:tasks]];
+}
+
+- (void)registerUndoRemovingTasks:(NSArray*)tasks {
+    [[self.undoManager prepareWithInvocationTarget:self] removeTasks:tasks];
+    // The tasks are still in the task list, so undo only holds references to them.
+    [self.undoBudget addBytes:UndoInvocationByteCount + [tasks count] * sizeof(id)];
+}
+
+- (void)registerUndoReplacingAllTasks {
+    // Keep the replaced tasks themselves, so undo brings back their unique IDs and the
+    // task edits recorded before the reload still find them.
+    NSArray *tasks = [self.taskList copy];
+    [[self.undoManager prepareWithInvocationTarget:self] replaceAllTasks:tasks];
+    [self.undoBudget addBytes:[self undoByteCountOfTasks:tasks]];
+}
+
+- (NSUInteger)undoByteCountOfTasks:(NSArray*)tasks {
+    // A task holds its parsed fields as well as its raw text.
+    return UndoInvocationByteCount + [tasks count] * UndoTaskByteCount +
+        [TTMUndoBudget byteCountOfStrings:[tasks valueForKey:@"rawText"]];
+}
+
 - (void)replaceTasks:(NSArray*)oldTasks withTasks:(NSArray*)newTasks {
     [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self.undoBudget addBytes:[self undoByteCountOfTasks:[oldTasks arrayByAddingObjectsFromArray:newTasks]]];
     [self.arrayController removeObjects:oldTasks];
     [self.arrayController addObjects:newTasks];
     [self refreshTaskListWithSave:YES];
 }
 
+- (void)replaceTasksAtIndexes:(NSIndexSet*)removedIndexes
+                    withTasks:(NSArray*)insertedTasks
+                    atIndexes:(NSIndexSet*)insertedIndexes
+                changingTasks:(NSArray*)changedTasks
+                   toRawTexts:(NSArray*)rawTexts {
+    NSArray *removedTasks = [self.taskList objectsAtIndexes:removedIndexes];
+    NSArray *previousRawTexts = [changedTasks valueForKey:@"rawText"];
+    [[self.undoManager prepareWithInvocationTarget:self] replaceTasksAtIndexes:insertedIndexes
+                                                                     withTasks:removedTasks
+                                                                     atIndexes:removedIndexes
+                                                                 changingTasks:changedTasks
+                                                                    toRawTexts:previousRawTexts];
+    [self.undoBudget addBytes:[self undoByteCountOfTasks:removedTasks] +
+                              [TTMUndoBudget byteCountOfStrings:previousRawTexts]];
+    
+    for (NSUInteger i = 0; i < [changedTasks count]; i++) {
+        [[changedTasks objectAtIndex:i] setRawText:[rawTexts objectAtIndex:i]];
+    }
+    
+    // Change the task list through its indexed accessors, so the array controller only
+    // updates the tasks that were removed or inserted.
+    NSMutableArray *taskList = [self mutableArrayValueForKey:@"taskList"];
+    [taskList removeObjectsAtIndexes:removedIndexes];
+    [taskList insertObjects:insertedTasks atIndexes:insertedIndexes];
+    
+    // Task IDs are line numbers, so renumber the tasks that moved.
+    NSUInteger taskId = 0;
+    for (TTMTask *task in self.taskList) {
+        if (task.taskId != taskId) {
+            task.taskId = taskId;
+        }
+        taskId++;
+    }
+    
+    // Reloading the file leaves it as it is; undoing or redoing the reload saves it.
+    [self refreshTaskListWithSave:(self.undoManager.isUndoing || self.undoManager.isRedoing)];
+}
+
 - (void)addTasks:(NSArray*)newTasks {
-    [[self.undoManager prepareWithInvocationTarget:self] removeTasks:newTasks];
+    [self registerUndoRemovingTasks:newTasks];
     [self.arrayController addObjects:newTasks];
     [self refreshTaskListWithSave:YES];
 }
 
 - (void)removeTasks:(NSArray*)oldTasks {
-    [[self.undoManager prepareWithInvocationTarget:self] addTasks:oldTasks];
+    [self registerUndoAddingTasks:oldTasks];
     [self.arrayController removeObjects:oldTasks];
     [self refreshTaskListWithSave:YES];
 }
@@ -384,6 +763,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
                                                withTaskId:newTaskId
                                         withPrependedDate:[TTMDateUtility today]] :
         [[self.arrayController newObject] initWithRawText:rawText withTaskId:newTaskId];
+    workingTask.symbolTable = self.symbolTable;
     return workingTask;
 }
 
@@ -391,10 +771,37 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [self.textField becomeFirstResponder];
 }
 
-- (void)removeAllTasks {
-    for (TTMTask *task in self.taskList) {
-        [self.arrayController removeObject:task];
+- (void)insertTaskList:(NSArray*)tasks atIndexes:(NSIndexSet*)indexes {
+    [_taskList insertObjects:tasks atIndexes:indexes];
+    for (TTMTask *task in tasks) {
+        [self.tasksByUniqueId setObject:task forKey:@(task.uniqueId)];
+    }
+    [self.taskIndex addTasks:tasks];
+    [self.tasklistMetadata addTasks:tasks];
+}
+
+- (void)removeTaskListAtIndexes:(NSIndexSet*)indexes {
+    NSArray *removedTasks = [_taskList objectsAtIndexes:indexes];
+    for (TTMTask *task in removedTasks) {
+        // A copy restored by undo may already have taken the task's place.
+        NSNumber *uniqueId = @(task.uniqueId);
+        if ([self.tasksByUniqueId objectForKey:uniqueId] == task) {
+            [self.tasksByUniqueId removeObjectForKey:uniqueId];
+        }
     }
+    [self.taskIndex removeTasks:removedTasks];
+    [self.tasklistMetadata removeTasks:removedTasks];
+    [_taskList removeObjectsAtIndexes:indexes];
+}
+
+- (void)removeAllTasks {
+    [self.arrayController removeObjects:[self.taskList copy]];
+}
+
+- (void)replaceAllTasksWithLoadedTasks:(NSArray*)loadedTasks {
+    [self removeAllTasks];
+    [self.arrayController addObjects:loadedTasks];
+    [self visualRefreshOnly:self];
 }
 
 - (void)addTasksFromArray:(NSArray*)rawTextStrings
@@ -408,26 +815,29 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     NSUInteger newTaskId = (self.arrayController == nil) ?
                             [self.taskList count] :
                             [[self.arrayController arrangedObjects] count];
-    for (NSString *rawTextString in rawTextStrings) {
-        if (rawTextString.length > 0) {
-            TTMTask *newTask;
-            if (removeAllTasksFirst) {
-                newTask = [[TTMTask alloc]
-                           initWithRawText:(NSString*)rawTextString
-                           withTaskId:newTaskId++];
-                [self.arrayController addObject:newTask];
-            } else {
-                newTask = [self createWorkingTaskWithRawText:(NSString*)rawTextString
-                                                  withTaskId:newTaskId++];
+    if (removeAllTasksFirst) {
+        // Loading a file: parse the lines on all cores, then add the tasks in one batch.
+        NSArray *loadedTasks = [TTMTaskLoader tasksFromRawTextStrings:rawTextStrings
+                                                          firstTaskId:newTaskId
+                                                          symbolTable:self.symbolTable];
+        [self.arrayController addObjects:loadedTasks];
+        if ([undoActionName length] > 0) {
+            [newTasks addObjectsFromArray:loadedTasks];
+        }
+    } else {
+        for (NSString *rawTextString in rawTextStrings) {
+            if (rawTextString.length > 0) {
+                TTMTask *newTask = [self createWorkingTaskWithRawText:(NSString*)rawTextString
+                                                           withTaskId:newTaskId++];
                 [self.arrayController addObject:newTask];
+                [newTasks addObject:newTask];
             }
-            [newTasks addObject:[newTask copy]];
         }
     }
     
     if ([undoActionName length] > 0) {
         [self.undoManager setActionName:undoActionName];
-        [[self.undoManager prepareWithInvocationTarget:self] removeTasks:newTasks];
+        [self registerUndoRemovingTasks:newTasks];
     }
     
     if (removeAllTasksFirst) {
@@ -449,9 +859,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     TTMTask *newTask = [self createWorkingTaskWithRawText:newTaskText
                                                withTaskId:newTaskId];
     
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
-    [newTasks addObject:[newTask copy]];
-    [[self.undoManager prepareWithInvocationTarget:self] removeTasks:newTasks];
+    [self registerUndoRemovingTasks:@[newTask]];
     [self.undoManager setActionName:NSLocalizedString(@"Add New Task", @"Undo Add New Task")];
     
     [self.arrayController addObject:newTask];
@@ -546,6 +954,29 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [self updateTaskListMetadata];
 }
 
+- (void)refreshTaskListForChangedTasks:(NSArray*)changedTasks withSave:(BOOL)saveToFile {
+    NSArray *taskListSelectedItemsList = [self getTaskListSelections];
+
+    if (saveToFile) {
+        [self saveToFile];
+    }
+
+    // Move only the changed tasks, and reload only the rows between their old and new places.
+    NSIndexSet *changedRows = [self.arrayController rearrangeChangedTasks:changedTasks];
+    if (changedRows == nil) {
+        [self.tableView reloadData];
+        [self setTableWidthToWidthOfContents];
+    } else {
+        [self.tableView reloadDataForRowIndexes:changedRows
+                                  columnIndexes:[NSIndexSet indexSetWithIndex:0]];
+        [self widenTableToFitTasks:changedTasks];
+    }
+
+    [self setTaskListSelections:taskListSelectedItemsList];
+    
+    [self updateTaskListMetadata];
+}
+
 - (void)saveToFile {
     [self autosaveWithImplicitCancellability:YES completionHandler:^(NSError * _Nullable errorOrNil) {
         [self updateLastInternalModificationDate];
@@ -561,7 +992,8 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [self reapplyActiveFilterPredicate];
     [self.tableView reloadData];
     [self setTableWidthToWidthOfContents];
-    [self updateTaskListMetadata];
+    // Preferences that the status bar shows are applied by a visual refresh.
+    [self updateTaskListMetadataWithChangedInputs:TTMStatusBarPreferencesInput];
 }
 
 - (void)setTaskListFont {
@@ -584,13 +1016,12 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 - (void)initializeUpdateSelectedTask {
-    self.originalTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                              copyItems:YES];
+    self.originalTasks = [self.arrayController selectedObjects];
+    self.originalRawTexts = [self.originalTasks valueForKey:@"rawText"];
 }
 
 - (void)finalizeUpdateSelectedTask:(NSString*)rawText {
-    NSArray *newTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
+    NSArray *newTasks = [self.arrayController selectedObjects];
     
     NSMutableArray *newTaskStrings = [[NSMutableArray alloc] init];
     BOOL taskWasCompleted = NO;
@@ -616,15 +1047,15 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
         }
     }
     
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks
-                                                            withTasks:self.originalTasks];
+    [self registerUndoSettingRawTexts:self.originalRawTexts ofTasks:self.originalTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Edit Task", @"Undo Edit Task")];
     self.originalTasks = nil;
+    self.originalRawTexts = nil;
     
     if (taskWasCompleted && [[NSUserDefaults standardUserDefaults] integerForKey:@"archiveTasksUponCompletion"]) {
         [self archiveCompletedTasks:self];
     } else {
-        [self refreshTaskListWithSave:YES];
+        [self refreshTaskListForChangedTasks:newTasks withSave:YES];
     }
     
     if (recurringTasksWereCreated) {
@@ -633,15 +1064,14 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 - (IBAction)toggleTaskCompletion:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     NSMutableArray *newTaskStrings = [[NSMutableArray alloc] init];
     
     BOOL recurringTasksWereCreated = NO;
     BOOL prependDate = [[NSUserDefaults standardUserDefaults] boolForKey:@"prependDateOnNewTasks"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         // if task is being marked complete...
         if (!task.isCompleted) {
             if (task.isRecurring) {
@@ -657,16 +1087,15 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
         }
         
         [task toggleCompletionStatus];
-        [newTasks addObject:[task copy]];
     }
     
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Toggle Completion", @"Undo Toggle Completion")];
 
     if ([[NSUserDefaults standardUserDefaults] integerForKey:@"archiveTasksUponCompletion"]) {
         [self archiveCompletedTasks:self];
     } else {
-        [self refreshTaskListWithSave:YES];
+        [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
     }
 
     if (recurringTasksWereCreated) {
@@ -683,10 +1112,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [deletePrompt addButtonWithTitle:@"Cancel"];
     [deletePrompt beginSheetModalForWindow:self.windowForSheet completionHandler:^(NSModalResponse returnCode) {
         if (returnCode == NSAlertFirstButtonReturn) {
-            NSArray *oldTasks = [[NSArray alloc]
-                                 initWithArray:[self.arrayController selectedObjects]
-                                 copyItems:YES];
-            [[self.undoManager prepareWithInvocationTarget:self] addTasks:oldTasks];
+            [self registerUndoAddingTasks:[self.arrayController selectedObjects]];
             [self.undoManager setActionName:NSLocalizedString(@"Delete Tasks", @"Undo Delete Tasks")];
             
             [self.arrayController removeObjectsAtArrangedObjectIndexes:[self.tableView selectedRowIndexes]];
@@ -711,16 +1137,14 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
             return;
         }
 
-        NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                                 copyItems:YES];
-        NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+        NSArray *selectedTasks = [self.arrayController selectedObjects];
+        NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
         
-        for (TTMTask *task in [self.arrayController selectedObjects]) {
+        for (TTMTask *task in selectedTasks) {
             [task appendText:[input stringValue]];
-            [newTasks addObject:[task copy]];
         }
         
-        [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+        [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
         [self.undoManager setActionName:NSLocalizedString(@"Append Text", @"Undo Append Text")];
     };
     
@@ -744,16 +1168,14 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
             return;
         }
         
-        NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                                 copyItems:YES];
-        NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+        NSArray *selectedTasks = [self.arrayController selectedObjects];
+        NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
         
-        for (TTMTask *task in [self.arrayController selectedObjects]) {
+        for (TTMTask *task in selectedTasks) {
             [task prependText:[input stringValue]];
-            [newTasks addObject:[task copy]];
         }
         
-        [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+        [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
         [self.undoManager setActionName:NSLocalizedString(@"Prepend Text", @"Undo Prepend Text")];
     };
     
@@ -777,16 +1199,14 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
             return;
         }
         
-        NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                                 copyItems:YES];
-        NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+        NSArray *selectedTasks = [self.arrayController selectedObjects];
+        NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
         
-        for (TTMTask *task in [self.arrayController selectedObjects]) {
+        for (TTMTask *task in selectedTasks) {
             [task replaceText:[self.findText stringValue] withText:[self.replaceText stringValue]];
-            [newTasks addObject:[task copy]];
         }
         
-        [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+        [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
         [self.undoManager setActionName:NSLocalizedString(@"Replace Text", @"Undo Replace Text")];
     };
     
@@ -819,19 +1239,17 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
             return;
         }
         
-        NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                                 copyItems:YES];
-        NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+        NSArray *selectedTasks = [self.arrayController selectedObjects];
+        NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
         
-        for (TTMTask *task in [self.arrayController selectedObjects]) {
+        for (TTMTask *task in selectedTasks) {
             [task setPriority:priority];
-            [newTasks addObject:[task copy]];
         }
         
-        [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+        [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
         [self.undoManager setActionName:NSLocalizedString(@"Set Priority", @"Undo Set Priority")];
 
-        [self refreshTaskListWithSave:YES];
+        [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
     };
     
     [alert beginSheetModalForWindow:self.windowForSheet completionHandler: completionHandler];
@@ -839,50 +1257,44 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 - (IBAction)increasePriority:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task increasePriority];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Increase Priority", @"Undo Increase Priority")];
 }
 
 - (IBAction)decreasePriority:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task decreasePriority];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Decrease Priority", @"Undo Decrease Priority")];
 }
 
 - (IBAction)removePriority:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task removePriority];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Remove Priority", @"Undo Remove Priority")];
 }
 
@@ -902,18 +1314,16 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     // Define the completion handler for the modal sheet.
     void (^completionHandler)(NSModalResponse returnCode) = ^(NSModalResponse returnCode) {
         if (returnCode == NSAlertFirstButtonReturn) {
-            NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                                     copyItems:YES];
-            NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+            NSArray *selectedTasks = [self.arrayController selectedObjects];
+            NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
             
-            for (TTMTask *task in [self.arrayController selectedObjects]) {
+            for (TTMTask *task in selectedTasks) {
                 [task setDueDate:[input dateValue]];
-                [newTasks addObject:[task copy]];
             }
 
-            [self refreshTaskListWithSave:YES];
+            [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-            [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+            [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
             [self.undoManager setActionName:NSLocalizedString(@"Set Due Date", @"Undo Set Due Date")];
         }
     };
@@ -923,50 +1333,44 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 - (IBAction)increaseDueDateByOneDay:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task incrementDueDate:1];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Increase Due Date", @"Undo Increase Due Date")];
 }
 
 - (IBAction)decreaseDueDateByOneDay:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task decrementDueDate:1];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Decrease Due Date", @"Undo Decrease Due Date")];
 }
 
 - (IBAction)removeDueDate:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task removeDueDate];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Remove Due Date", @"Undo Remove Due Date")];
 }
 
@@ -985,18 +1389,16 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
         if (returnCode == NSAlertFirstButtonReturn &&
             [[input stringValue] length] != 0 &&
             [input integerValue] != 0) {
-            NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                                     copyItems:YES];
-            NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+            NSArray *selectedTasks = [self.arrayController selectedObjects];
+            NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
             
-            for (TTMTask *task in [self.arrayController selectedObjects]) {
+            for (TTMTask *task in selectedTasks) {
                 [task postponeTask:[input integerValue]];
-                [newTasks addObject:[task copy]];
             }
 
-            [self refreshTaskListWithSave:YES];
+            [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-            [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+            [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
             [self.undoManager setActionName:NSLocalizedString(@"Postpone", @"Undo Postpone")];
         }
     };
@@ -1021,18 +1423,16 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     // Define the completion handler for the modal sheet.
     void (^completionHandler)(NSModalResponse returnCode) = ^(NSModalResponse returnCode) {
         if (returnCode == NSAlertFirstButtonReturn) {
-            NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                                     copyItems:YES];
-            NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+            NSArray *selectedTasks = [self.arrayController selectedObjects];
+            NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
             
-            for (TTMTask *task in [self.arrayController selectedObjects]) {
+            for (TTMTask *task in selectedTasks) {
                 [task setThresholdDate:[input dateValue]];
-                [newTasks addObject:[task copy]];
             }
 
-            [self refreshTaskListWithSave:YES];
+            [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-            [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+            [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
             [self.undoManager setActionName:NSLocalizedString(@"Set Threshold Date", @"Undo Set Threshold Date")];
         }
     };
@@ -1043,50 +1443,44 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 
 
 - (IBAction)increaseThresholdDateByOneDay:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task incrementThresholdDate:1];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Increase Threshold Date", @"Undo Increase Threshold Date")];
 }
 
 - (IBAction)decreaseThresholdDateByOneDay:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task decrementThresholdDate:1];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Decrease Threshold Date", @"Undo Decrease Threshold Date")];
 }
 
 - (IBAction)removeThresholdDate:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    NSMutableArray *newTasks = [[NSMutableArray alloc] init];
+    NSArray *selectedTasks = [self.arrayController selectedObjects];
+    NSArray *oldRawTexts = [selectedTasks valueForKey:@"rawText"];
     
-    for (TTMTask *task in [self.arrayController selectedObjects]) {
+    for (TTMTask *task in selectedTasks) {
         [task removeThresholdDate];
-        [newTasks addObject:[task copy]];
     }
 
-    [self refreshTaskListWithSave:YES];
+    [self refreshTaskListForChangedTasks:selectedTasks withSave:YES];
 
-    [[self.undoManager prepareWithInvocationTarget:self] replaceTasks:newTasks withTasks:oldTasks];
+    [self registerUndoSettingRawTexts:oldRawTexts ofTasks:selectedTasks];
     [self.undoManager setActionName:NSLocalizedString(@"Remove Threshold Date", @"Undo Remove Threshold Date")];
 }
 
@@ -1094,103 +1488,9 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 
 - (void)sortTaskList:(TTMTaskListSortType)sortType {
     
-    // set up sort descriptors for the arrayController
-    NSSortDescriptor *isPrioritizedDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"isPrioritized"
-                                    ascending:NO
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *priorityDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"priority"
-                                    ascending:YES
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *hasProjectsDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"hasProjects"
-                                    ascending:NO
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *projectDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"projects"
-                                    ascending:YES
-                                     selector:@selector(localizedCaseInsensitiveCompare:)];
-    NSSortDescriptor *hasContextsDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"hasContexts"
-                                    ascending:NO
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *contextDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"contexts"
-                                    ascending:YES
-                                     selector:@selector(localizedCaseInsensitiveCompare:)];
-    NSSortDescriptor *dueStateDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"dueState"
-                                    ascending:YES
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *dueDateDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"dueDate"
-                                    ascending:YES
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *creationDateDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"creationDate"
-                                    ascending:YES
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *completionDateDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"completionDate"
-                                    ascending:YES
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *taskIdDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"taskId"
-                                    ascending:YES
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *completedDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"isCompleted"
-                                    ascending:YES
-                                     selector:@selector(compare:)];
-    NSSortDescriptor *thresholdDateDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"thresholdDate"
-                                ascending:YES
-                                 selector:@selector(compare:)];
-    NSSortDescriptor *alphabeticalDescriptor =
-        [[NSSortDescriptor alloc] initWithKey:@"rawText"
-                                    ascending:YES
-                                     selector:@selector(localizedCaseInsensitiveCompare:)];
-    
-    // apply sort descriptors, depending on sort type, to the arrayController
-    NSArray *sortDescriptors;
-    switch (sortType) {
-        case TTMSortOrderInFile:
-            sortDescriptors = @[taskIdDescriptor];
-            break;
-        case TTMSortPriority:
-            sortDescriptors = @[isPrioritizedDescriptor, priorityDescriptor, completedDescriptor,
-                                dueStateDescriptor, dueDateDescriptor, thresholdDateDescriptor, taskIdDescriptor];
-            break;
-        case TTMSortProject:
-            sortDescriptors = @[hasProjectsDescriptor, projectDescriptor, priorityDescriptor,
-                                completedDescriptor, dueDateDescriptor, thresholdDateDescriptor, taskIdDescriptor];
-            break;
-        case TTMSortContext:
-            sortDescriptors = @[hasContextsDescriptor, contextDescriptor, isPrioritizedDescriptor,
-                                priorityDescriptor, completedDescriptor, dueDateDescriptor, thresholdDateDescriptor, taskIdDescriptor];
-            break;
-        case TTMSortDueDate:
-            sortDescriptors = @[dueDateDescriptor, isPrioritizedDescriptor, priorityDescriptor,
-                                thresholdDateDescriptor, taskIdDescriptor];
-            break;
-        case TTMSortCreationDate:
-            sortDescriptors = @[creationDateDescriptor, taskIdDescriptor];
-            break;
-        case TTMSortCompletionDate:
-            sortDescriptors = @[completionDateDescriptor, taskIdDescriptor];
-            break;
-        case TTMSortThresholdDate:
-            sortDescriptors = @[thresholdDateDescriptor, isPrioritizedDescriptor, priorityDescriptor, completedDescriptor, dueStateDescriptor, dueDateDescriptor, taskIdDescriptor];
-            break;
-        case TTMSortAlphabetical:
-            sortDescriptors = @[alphabeticalDescriptor];
-            break;
-        default:
-            sortDescriptors = @[taskIdDescriptor];
-            break;
-    }
-    [self.arrayController setSortDescriptors:sortDescriptors];
+    // The array controller sorts by packed keys for the sort type, rather than by a chain
+    // of sort descriptors.
+    self.arrayController.sortType = sortType;
     
     // Update the active sort type.
     self.activeSortType = sortType;
@@ -1199,7 +1499,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [[NSUserDefaults standardUserDefaults] setInteger:sortType forKey:@"taskListSortType"];
     [[NSUserDefaults standardUserDefaults] synchronize];
     
-    [self updateTaskListMetadata];
+    [self updateTaskListMetadataWithChangedInputs:TTMStatusBarSortInput];
 }
 
 - (IBAction)sortTaskListUsingTagforPreset:(id)sender {
@@ -1248,9 +1548,27 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [TTMFilterPredicates setActiveFilterPredicate:self.activeFilterPredicate];
     [TTMFilterPredicates setActiveFilterPredicatePresetNumber:presetNumber];
     self.activeFilterPredicateNumber = presetNumber;
+    // A filter applied in the background updates the metadata once it is shown.
+    if (!self.arrayController.isArrangingInBackground) {
+        [self searchFieldFilterWasShown];
+        [self updateTaskListMetadataWithChangedInputs:TTMStatusBarFilterInput];
+    } else {
+        [self updateStatusBarTextForChangedInputs:TTMStatusBarFilterInput];
+    }
+}
+
+- (void)arrayControllerDidArrangeInBackground:(NSNotification *)notification {
+    [self searchFieldFilterWasShown];
     [self updateTaskListMetadata];
 }
 
+- (void)searchFieldFilterWasShown {
+    if (self.searchFieldChangeDate) {
+        [self.searchLatencies recordLatency:-[self.searchFieldChangeDate timeIntervalSinceNow]];
+        self.searchFieldChangeDate = nil;
+    }
+}
+
 #pragma mark - Archiving Methods
 
 - (IBAction)archiveCompletedTasks:(id)sender {
@@ -1277,7 +1595,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
             [completedTasksIndexSet addIndex:i];
             [completedTasksString appendString:self.preferredLineEnding]; // assumption may be wrong
             [completedTasksString appendString:task.rawText];
-            [archivedTasks addObject:[task copy]];
+            [archivedTasks addObject:task];
         }
     }
     
@@ -1290,6 +1608,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
         [self.undoManager setActionName:NSLocalizedString(@"Archive Tasks", @"Undo Archive Tasks")];
         [[self.undoManager prepareWithInvocationTarget:self] undoArchiveTasks:archivedTasks
                                                               fromArchiveFile:archiveFilePath];
+        [self.undoBudget addBytes:[self undoByteCountOfTasks:archivedTasks]];
     }
     
     @try {
@@ -1325,19 +1644,23 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 
 - (void)removeTasks:(NSArray*)tasksToRemove fromArchiveFile:(NSString*)archiveFilePath {
     NSURL *archiveFileURL = [[NSURL alloc] initFileURLWithPath:archiveFilePath];
-    NSError *err = [[NSError alloc] init];
-    NSString *fileContents = [[NSString alloc] initWithContentsOfURL:archiveFileURL
-                                                            encoding:NSUTF8StringEncoding
-                                                               error:&err];
-    
-    BOOL usesWindowsLineEndings = ([fileContents rangeOfString:@"\r\n"].location != NSNotFound);
-    NSString *preferredLineEnding = (usesWindowsLineEndings) ? @"\r\n" : @"\n";
-    NSMutableArray *rawTextStrings = [[NSMutableArray alloc] initWithArray:[fileContents componentsSeparatedByString:preferredLineEnding]];
-
+    NSData *fileData = [NSData dataWithContentsOfURL:archiveFileURL
+                                             options:NSDataReadingMappedIfSafe
+                                               error:nil];
+    TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:fileData];
+    
+    // Find the last line matching each task. Lines are compared as UTF-8 bytes, so no
+    // strings are made from the archive.
+    const char *bytes = fileData.bytes;
+    NSMutableIndexSet *linesToRemove = [[NSMutableIndexSet alloc] init];
     for (TTMTask *task in tasksToRemove) {
-        for (long j = [rawTextStrings count] - 1; j > 0; j--) {
-            if ([[rawTextStrings objectAtIndex:j] isEqualToString:task.rawText]) {
-                [rawTextStrings removeObjectAtIndex:j];
+        NSData *taskData = [task.rawText dataUsingEncoding:NSUTF8StringEncoding];
+        for (long j = lineIndex.lineCount - 1; j > 0; j--) {
+            NSRange lineRange = [lineIndex rangeOfLineAtIndex:j];
+            if (lineRange.length == taskData.length &&
+                ![linesToRemove containsIndex:j] &&
+                memcmp(bytes + lineRange.location, taskData.bytes, lineRange.length) == 0) {
+                [linesToRemove addIndex:j];
                 break;
             }
         }
@@ -1346,17 +1669,37 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     [self.undoManager setActionName:NSLocalizedString(@"Remove Tasks From Archive",
                                                       @"Undo Remove Tasks From Archive")];
     [[self.undoManager prepareWithInvocationTarget:self] archiveCompletedTasks:self];
+    [self.undoBudget addBytes:UndoInvocationByteCount];
+    
+    // Leave the archive alone if it could not be read as UTF-8.
+    if (!fileData || !lineIndex.isValidUTF8) {
+        return;
+    }
     
-    NSString *content = [rawTextStrings componentsJoinedByString:preferredLineEnding];
-    [content writeToFile:archiveFilePath
-              atomically:YES
-                encoding:NSUTF8StringEncoding
-                   error:nil];
+    // Copy every other line, with its own line ending, so the rest of the file is unchanged.
+    NSMutableData *content = [[NSMutableData alloc] initWithCapacity:fileData.length];
+    NSUInteger firstLineStart = (lineIndex.lineCount > 0) ?
+        [lineIndex rangeOfLineAtIndex:0].location :
+        fileData.length;
+    [content appendBytes:bytes length:firstLineStart];
+    for (NSUInteger j = 0; j < lineIndex.lineCount; j++) {
+        if (![linesToRemove containsIndex:j]) {
+            NSRange lineRange = [lineIndex rangeOfLineWithEndingAtIndex:j];
+            [content appendBytes:bytes + lineRange.location length:lineRange.length];
+        }
+    }
+    [content writeToFile:archiveFilePath atomically:YES];
 }
 
 
 #pragma mark - NSDocument Method Overrides
 
+- (void)close {
+    // A filter waiting for typing to pause would otherwise run after the window is gone.
+    [NSObject cancelPreviousPerformRequestsWithTarget:self];
+    [super close];
+}
+
 // Override normal copy handler to copy selected tasks from the task list.
 // This does not get called when the field editor is active.
 - (IBAction)copy:(id)sender {
@@ -1379,9 +1722,7 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 // Override normal cut handler to cut selected tasks from the task list.
 // This does not get called when the field editor is active.
 - (IBAction)cut:(id)sender {
-    NSArray *oldTasks = [[NSArray alloc] initWithArray:[self.arrayController selectedObjects]
-                                             copyItems:YES];
-    [[self.undoManager prepareWithInvocationTarget:self] addTasks:oldTasks];
+    [self registerUndoAddingTasks:[self.arrayController selectedObjects]];
     [self.undoManager setActionName:NSLocalizedString(@"Cut", @"Undo Cut")];
 
     [self copy:sender];
@@ -1456,21 +1797,28 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 #pragma mark - Tasklist Metadata Methods
 
 - (void)updateTaskListMetadata {
-    // Update tasklist metadata.
-    if (!self.tasklistMetadata) {
-        self.tasklistMetadata = [[TTMTasklistMetadata alloc] init];
-    }
-    [self.tasklistMetadata updateMetadataFromTaskArray:self.taskList];
-    
-    // Update filtered tasklist metadata.
-    if (!self.filteredTasklistMetadata) {
-        self.filteredTasklistMetadata = [[TTMTasklistMetadata alloc] init];
+    [self updateTaskListMetadataWithChangedInputs:0];
+}
+
+- (void)updateTaskListMetadataWithChangedInputs:(TTMStatusBarInputs)changedInputs {
+    NSArray *filteredTasks = [self.arrayController arrangedObjects];
+    if (self.tasklistMetadata.needsFullCount) {
+        // Count the task list and the filtered tasks together, in one pass.
+        [TTMTasklistMetadata countTasks:self.taskList
+                             inMetadata:self.tasklistMetadata
+                          filteredTasks:[TTMTaskIndex bitsetOfTasks:filteredTasks]
+                       filteredMetadata:self.filteredTasklistMetadata];
+    } else {
+        // Update tasklist metadata. Added and removed tasks were counted as they changed.
+        [self.tasklistMetadata updateChangedTasks];
+        
+        // Update filtered tasklist metadata, counting only the tasks filtered in or out.
+        [self.filteredTasklistMetadata updateMetadataFromTaskArray:filteredTasks];
     }
-    [self.filteredTasklistMetadata
-     updateMetadataFromTaskArray:[self.arrayController arrangedObjects]];
     
     // Update status bar text
-    [self updateStatusBarText];
+    [self updateStatusBarTextForChangedInputs:changedInputs | TTMStatusBarAllTasksInput |
+                                              TTMStatusBarShownTasksInput];
 }
 
 - (IBAction)showTasklistMetadata:(id)sender {
@@ -1493,17 +1841,26 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 
 - (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context {
     if ([keyPath isEqualToString:@"selection"]) {
-        [self updateStatusBarText];
+        [self updateStatusBarTextForChangedInputs:TTMStatusBarSelectionInput];
         return;
     }
     
     if ([keyPath isEqualToString:@"searchFieldPredicate"]) {
-        [self reapplyActiveFilterPredicate];
+        // Filter once typing pauses, rather than after every keystroke.
+        if (!self.searchFieldChangeDate) {
+            self.searchFieldChangeDate = [NSDate date];
+        }
+        [NSObject cancelPreviousPerformRequestsWithTarget:self
+                                                 selector:@selector(reapplyActiveFilterPredicate)
+                                                   object:nil];
+        [self performSelector:@selector(reapplyActiveFilterPredicate)
+                   withObject:nil
+                   afterDelay:SearchFieldDebounceInterval];
         return;
     }
     
-    if ([keyPath isEqualToString:@"levelsOfUndo"]) {
-        [self.undoManager setLevelsOfUndo:[[NSUserDefaults standardUserDefaults] integerForKey:@"levelsOfUndo"]];
+    if ([keyPath isEqualToString:@"levelsOfUndo"] || [keyPath isEqualToString:@"undoMemoryLimit"]) {
+        [self updateUndoLimits];
         return;
     }
 
@@ -1552,11 +1909,29 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
 }
 
 - (void)updateStatusBarText {
+    [self updateStatusBarTextForChangedInputs:TTMStatusBarAllInputs];
+}
+
+- (void)updateStatusBarTextForChangedInputs:(TTMStatusBarInputs)changedInputs {
+    // Every undoable edit changes the undo memory, so it is checked here instead of by
+    // each edit.
+    NSUInteger undoByteCount = self.undoBudget.byteCount;
+    if (undoByteCount != self.statusBarUndoByteCount) {
+        self.statusBarUndoByteCount = undoByteCount;
+        changedInputs |= TTMStatusBarUndoMemoryInput;
+    }
     NSString *format = [[NSUserDefaults standardUserDefaults] stringForKey:@"statusBarFormat"];
-    TTMDocumentStatusBarText *txt = [[TTMDocumentStatusBarText alloc]
-                                     initWithTTMDocument:self
-                                     format:format];
-    self.statusBarText = [txt statusBarText];
+    if (!self.statusBarTextMaker) {
+        self.statusBarTextMaker = [[TTMDocumentStatusBarText alloc] initWithTTMDocument:self
+                                                                                 format:format];
+    } else if (format != self.statusBarTextMaker.format &&
+               ![self.statusBarTextMaker.format isEqualToString:format]) {
+        self.statusBarTextMaker.format = format;
+    }
+    NSString *text = [self.statusBarTextMaker statusBarTextWithChangedInputs:changedInputs];
+    if (text != self.statusBarText) {
+        self.statusBarText = text;
+    }
 }
 
 - (BOOL)statusBarVisable {
@@ -1586,6 +1961,24 @@ static NSString * const RelativeDueDatePattern = @"(?<=due:)\\S*";
     }
 }
 
+- (void)widenTableToFitTasks:(NSArray*)tasks {
+    // Only the changed rows are measured, so the table grows to fit them but does not shrink
+    // until the next full refresh.
+    NSTableView *tableView = self.tableView;
+    NSTableColumn *column = tableView.tableColumns.lastObject;
+    NSArray *arrangedTasks = self.arrayController.arrangedObjects;
+    NSRect rect = NSMakeRect(0, 0, INFINITY, tableView.rowHeight);
+    CGFloat maxSize = column.minWidth;
+    for (TTMTask *task in tasks) {
+        NSUInteger row = [arrangedTasks indexOfObjectIdenticalTo:task];
+        if (row != NSNotFound && row < (NSUInteger)tableView.numberOfRows) {
+            NSCell *cell = [tableView preparedCellAtColumn:0 row:(NSInteger)row];
+            maxSize = MAX(maxSize, [cell cellSizeForBounds:rect].width);
+        }
+    }
+    [column setMinWidth:maxSize];
+}
+
 - (CGFloat)tableViewContentWidth {
     NSTableView * tableView = self.tableView;
     NSRect rect = NSMakeRect(0,0, INFINITY, tableView.rowHeight);
@@ -48,6 +48,25 @@
 
 @class TTMDocument;
 
+/*! The document values that status bar tags show, as flags. */
+typedef enum : NSUInteger {
+    TTMStatusBarAllTasksInput = 1 << 0,
+    TTMStatusBarShownTasksInput = 1 << 1,
+    TTMStatusBarFilterInput = 1 << 2,
+    TTMStatusBarSortInput = 1 << 3,
+    TTMStatusBarSelectionInput = 1 << 4,
+    TTMStatusBarPreferencesInput = 1 << 5,
+    TTMStatusBarUndoMemoryInput = 1 << 6,
+    TTMStatusBarAllInputs = (1 << 7) - 1
+} TTMStatusBarInputs;
+
+/*!
+ * @class TTMDocumentStatusBarText
+ * @abstract TTMDocumentStatusBarText makes the status bar text of a document from a format.
+ * @discussion The format is split into plain text and tags when it is set. Each tag keeps
+ * the text it last showed, and only tags that show a changed input are looked at again, so
+ * a change of selection only updates the {Selected} tag.
+ */
 @interface TTMDocumentStatusBarText : NSObject
 
 extern NSString* const TTMAllStatusBarAllTaskCountTag;
@@ -78,9 +97,13 @@ extern NSString* const TTMActiveSortName;
 extern NSString* const TTMSelectedTaskCount;
 extern NSString* const TTMHideFutureTasks;
 extern NSString* const TTMHideHiddenTasks;
+extern NSString* const TTMUndoMemory;
+
+@property (nonatomic, weak) TTMDocument *document;
+@property (nonatomic, copy) NSString *format;
 
-@property (nonatomic, retain) TTMDocument *document;
-@property (nonatomic) NSString *format;
+/*! The inputs that the tags in the format show. */
+@property (nonatomic, readonly) TTMStatusBarInputs inputs;
 
 #pragma mark - Init Method
 
@@ -107,10 +130,20 @@ extern NSString* const TTMHideHiddenTasks;
 /*!
  * @method statusBarText:
  * @abstract This method produces text for the task list status bar. It builds the output string
- * by replacing tags within the format property string with document metadata.
+ * by replacing tags within the format property string with document metadata, all of which
+ * is looked at again.
  */
 - (NSString*)statusBarText;
 
+/*!
+ * @method statusBarTextWithChangedInputs:
+ * @abstract Updates the tags that show any of the given inputs, and produces text for the
+ * task list status bar.
+ * @param changedInputs The inputs that may have changed since the text was last made.
+ * @return The same string as last time if no tag's text changed.
+ */
+- (NSString*)statusBarTextWithChangedInputs:(TTMStatusBarInputs)changedInputs;
+
 /*!
  * @method availableTags:
  * @abstract This method returns a list of tags available for the user to insert into the status
@@ -48,8 +48,7 @@
 #import "TTMDocument.h"
 #import "TTMTasklistMetadata.h"
 #import "TTMFilterPredicates.h"
-
-@implementation TTMDocumentStatusBarText
+#import "TTMUndoBudget.h"
 
 NSString* const TTMAllStatusBarAllTaskCountTag = @"{All Tasks}";
 NSString* const TTMAllCompletedTaskCount = @"{All Completed}";
@@ -77,6 +76,85 @@ NSString* const TTMActiveSortName = @"{Sort Name}";
 NSString* const TTMSelectedTaskCount = @"{Selected}";
 NSString* const TTMHideFutureTasks = @"{Hide Future Tasks}";
 NSString* const TTMHideHiddenTasks = @"{Hide Hidden Tasks}";
+NSString* const TTMUndoMemory = @"{Undo Memory}";
+
+// The tags, in the order of availableTags.
+typedef enum : NSUInteger {
+    TTMAllTaskCountTag,
+    TTMAllCompletedTag,
+    TTMAllIncompleteTag,
+    TTMAllDueTodayTag,
+    TTMAllOverdueTag,
+    TTMAllNotDueTag,
+    TTMAllNoDueDateTag,
+    TTMAllPrioritiesTag,
+    TTMAllProjectsTag,
+    TTMAllContextsTag,
+    TTMShownTaskCountTag,
+    TTMShownCompletedTag,
+    TTMShownIncompleteTag,
+    TTMShownDueTodayTag,
+    TTMShownOverdueTag,
+    TTMShownNotDueTag,
+    TTMShownNoDueDateTag,
+    TTMShownPrioritiesTag,
+    TTMShownProjectsTag,
+    TTMShownContextsTag,
+    TTMFilterPresetTag,
+    TTMSortPresetTag,
+    TTMSortNameTag,
+    TTMSelectedTag,
+    TTMHideFutureTasksTag,
+    TTMHideHiddenTasksTag,
+    TTMUndoMemoryTag,
+    TTMTagCount
+} TTMStatusBarTag;
+
+static TTMStatusBarInputs InputsOfTag(TTMStatusBarTag tag) {
+    if (tag <= TTMAllContextsTag) {
+        return TTMStatusBarAllTasksInput;
+    }
+    if (tag <= TTMShownContextsTag) {
+        return TTMStatusBarShownTasksInput;
+    }
+    switch (tag) {
+        case TTMFilterPresetTag: return TTMStatusBarFilterInput;
+        case TTMSortPresetTag:
+        case TTMSortNameTag: return TTMStatusBarSortInput;
+        case TTMSelectedTag: return TTMStatusBarSelectionInput;
+        case TTMHideFutureTasksTag:
+        case TTMHideHiddenTasksTag: return TTMStatusBarPreferencesInput;
+        default: return TTMStatusBarUndoMemoryInput;
+    }
+}
+
+#pragma mark - TTMStatusBarToken
+
+// A run of plain text in the format, or a tag and the text last shown for it.
+@interface TTMStatusBarToken : NSObject
+
+@property (nonatomic) BOOL isTag;
+@property (nonatomic) TTMStatusBarTag tag;
+@property (nonatomic) NSString *text;
+
+@end
+
+@implementation TTMStatusBarToken
+@end
+
+#pragma mark - TTMDocumentStatusBarText
+
+@interface TTMDocumentStatusBarText ()
+
+/*! The format, split into plain text and tags. */
+@property (nonatomic) NSArray *tokens;
+
+/*! The text last made from the tokens. */
+@property (nonatomic) NSString *text;
+
+@end
+
+@implementation TTMDocumentStatusBarText
 
 #pragma mark - Init Method
 
@@ -84,52 +162,135 @@ NSString* const TTMHideHiddenTasks = @"{Hide Hidden Tasks}";
     self = [super init];
     if (self) {
         _document = sourceDocument;
-        _format = format;
+        self.format = format;
     }
     return self;
 }
 
+#pragma mark - Format Methods
+
+- (void)setFormat:(NSString*)format {
+    _format = [format copy];
+    [self compileFormat];
+}
+
+- (void)compileFormat {
+    // Split the format into plain text and tags once, instead of searching it for every tag
+    // each time the text is made. Tags are matched case-insensitively, as they always were.
+    NSArray *availableTags = [TTMDocumentStatusBarText availableTags];
+    NSMutableArray *tokens = [NSMutableArray array];
+    NSString *format = (self.format != nil) ? self.format : @"";
+    NSUInteger length = format.length;
+    NSUInteger textStart = 0;
+    NSUInteger position = 0;
+    TTMStatusBarInputs inputs = 0;
+    while (position < length) {
+        NSRange brace = [format rangeOfString:@"{" options:NSLiteralSearch
+                                        range:NSMakeRange(position, length - position)];
+        if (brace.location == NSNotFound) {
+            break;
+        }
+        NSUInteger tag = NSNotFound;
+        for (NSUInteger i = 0; i < TTMTagCount; i++) {
+            NSString *tagText = availableTags[i];
+            if (brace.location + tagText.length <= length &&
+                [format compare:tagText options:NSCaseInsensitiveSearch
+                          range:NSMakeRange(brace.location, tagText.length)] == NSOrderedSame) {
+                tag = i;
+                break;
+            }
+        }
+        if (tag == NSNotFound) {
+            position = brace.location + 1;
+            continue;
+        }
+        if (brace.location > textStart) {
+            TTMStatusBarToken *textToken = [[TTMStatusBarToken alloc] init];
+            textToken.text = [format substringWithRange:NSMakeRange(textStart,
+                                                                   brace.location - textStart)];
+            [tokens addObject:textToken];
+        }
+        TTMStatusBarToken *tagToken = [[TTMStatusBarToken alloc] init];
+        tagToken.isTag = YES;
+        tagToken.tag = (TTMStatusBarTag)tag;
+        [tokens addObject:tagToken];
+        inputs |= InputsOfTag((TTMStatusBarTag)tag);
+        position = textStart = brace.location + [availableTags[tag] length];
+    }
+    if (textStart < length) {
+        TTMStatusBarToken *textToken = [[TTMStatusBarToken alloc] init];
+        textToken.text = [format substringFromIndex:textStart];
+        [tokens addObject:textToken];
+    }
+    self.tokens = tokens;
+    _inputs = inputs;
+    self.text = nil;
+}
+
 #pragma mark - Metadata Method
 
 - (NSDictionary*)documentMetadata {
-    NSDictionary *sortNames = @{@(TTMSortOrderInFile) : @"File",
-                                @(TTMSortPriority) : @"Priority",
-                                @(TTMSortProject) : @"Project",
-                                @(TTMSortContext) : @"Context",
-                                @(TTMSortDueDate) : @"Due Date",
-                                @(TTMSortCreationDate) : @"Creation Date",
-                                @(TTMSortCompletionDate) : @"Completion Date",
-                                @(TTMSortThresholdDate) : @"Threshold Date",
-                                @(TTMSortAlphabetical) : @"Alphabetical"
-                                };
-    
-    return @{TTMAllStatusBarAllTaskCountTag : @(self.document.tasklistMetadata.allTaskCount),
-             TTMAllCompletedTaskCount : @(self.document.tasklistMetadata.completedTaskCount),
-             TTMAllIncompleteTaskCount : @(self.document.tasklistMetadata.incompleteTaskCount),
-             TTMAllDueTodayTaskCount : @(self.document.tasklistMetadata.dueTodayTaskCount),
-             TTMAllOverdueTaskCount : @(self.document.tasklistMetadata.overdueTaskCount),
-             TTMAllNotDueTaskCount : @(self.document.tasklistMetadata.notDueTaskCount),
-             TTMAllNoDueDateTaskCount : @(self.document.tasklistMetadata.noDueDateTaskCount),
-             TTMAllPrioritiesCount : @(self.document.tasklistMetadata.projectsCount),
-             TTMAllProjectsCount : @(self.document.tasklistMetadata.projectsCount),
-             TTMAllContextsCount : @(self.document.tasklistMetadata.contextsCount),
-             TTMShownStatusBarAllTaskCountTag : @(self.document.filteredTasklistMetadata.allTaskCount),
-             TTMShownCompletedTaskCount : @(self.document.filteredTasklistMetadata.completedTaskCount),
-             TTMShownIncompleteTaskCount : @(self.document.filteredTasklistMetadata.incompleteTaskCount),
-             TTMShownDueTodayTaskCount : @(self.document.filteredTasklistMetadata.dueTodayTaskCount),
-             TTMShownOverdueTaskCount : @(self.document.filteredTasklistMetadata.overdueTaskCount),
-             TTMShownNotDueTaskCount : @(self.document.filteredTasklistMetadata.notDueTaskCount),
-             TTMShownNoDueDateTaskCount : @(self.document.filteredTasklistMetadata.noDueDateTaskCount),
-             TTMShownPrioritiesCount : @(self.document.filteredTasklistMetadata.projectsCount),
-             TTMShownProjectsCount : @(self.document.filteredTasklistMetadata.projectsCount),
-             TTMShownContextsCount : @(self.document.filteredTasklistMetadata.contextsCount),
-             TTMActiveFilterNumber : @(self.document.activeFilterPredicateNumber),
-             TTMActiveSortNumber : @(self.document.activeSortType),
-             TTMActiveSortName : [sortNames objectForKey:@(self.document.activeSortType)],
-             TTMSelectedTaskCount : @(self.document.arrayController.selectionIndexes.count),
-             TTMHideFutureTasks : [self hideFutureTasks],
-             TTMHideHiddenTasks : [self hideHiddenTasks]
-             };
+    NSArray *availableTags = [TTMDocumentStatusBarText availableTags];
+    NSMutableDictionary *metadata = [NSMutableDictionary dictionaryWithCapacity:TTMTagCount];
+    for (NSUInteger tag = 0; tag < TTMTagCount; tag++) {
+        metadata[availableTags[tag]] = [self textForTag:(TTMStatusBarTag)tag];
+    }
+    return metadata;
+}
+
+- (NSString*)textForTag:(TTMStatusBarTag)tag {
+    TTMTasklistMetadata *all = self.document.tasklistMetadata;
+    TTMTasklistMetadata *shown = self.document.filteredTasklistMetadata;
+    switch (tag) {
+        case TTMAllTaskCountTag: return [self textForCount:all.allTaskCount];
+        case TTMAllCompletedTag: return [self textForCount:all.completedTaskCount];
+        case TTMAllIncompleteTag: return [self textForCount:all.incompleteTaskCount];
+        case TTMAllDueTodayTag: return [self textForCount:all.dueTodayTaskCount];
+        case TTMAllOverdueTag: return [self textForCount:all.overdueTaskCount];
+        case TTMAllNotDueTag: return [self textForCount:all.notDueTaskCount];
+        case TTMAllNoDueDateTag: return [self textForCount:all.noDueDateTaskCount];
+        case TTMAllPrioritiesTag: return [self textForCount:all.prioritiesCount];
+        case TTMAllProjectsTag: return [self textForCount:all.projectsCount];
+        case TTMAllContextsTag: return [self textForCount:all.contextsCount];
+        case TTMShownTaskCountTag: return [self textForCount:shown.allTaskCount];
+        case TTMShownCompletedTag: return [self textForCount:shown.completedTaskCount];
+        case TTMShownIncompleteTag: return [self textForCount:shown.incompleteTaskCount];
+        case TTMShownDueTodayTag: return [self textForCount:shown.dueTodayTaskCount];
+        case TTMShownOverdueTag: return [self textForCount:shown.overdueTaskCount];
+        case TTMShownNotDueTag: return [self textForCount:shown.notDueTaskCount];
+        case TTMShownNoDueDateTag: return [self textForCount:shown.noDueDateTaskCount];
+        case TTMShownPrioritiesTag: return [self textForCount:shown.prioritiesCount];
+        case TTMShownProjectsTag: return [self textForCount:shown.projectsCount];
+        case TTMShownContextsTag: return [self textForCount:shown.contextsCount];
+        case TTMFilterPresetTag: return [self textForCount:self.document.activeFilterPredicateNumber];
+        case TTMSortPresetTag: return [self textForCount:self.document.activeSortType];
+        case TTMSortNameTag: return [self sortName];
+        case TTMSelectedTag:
+            return [self textForCount:self.document.arrayController.selectionIndexes.count];
+        case TTMHideFutureTasksTag: return [self hideFutureTasks];
+        case TTMHideHiddenTasksTag: return [self hideHiddenTasks];
+        case TTMUndoMemoryTag: return [self undoMemory];
+        default: return @"";
+    }
+}
+
+- (NSString*)textForCount:(NSInteger)count {
+    return [NSString stringWithFormat:@"%ld", (long)count];
+}
+
+- (NSString*)sortName {
+    switch (self.document.activeSortType) {
+        case TTMSortOrderInFile: return @"File";
+        case TTMSortPriority: return @"Priority";
+        case TTMSortProject: return @"Project";
+        case TTMSortContext: return @"Context";
+        case TTMSortDueDate: return @"Due Date";
+        case TTMSortCreationDate: return @"Creation Date";
+        case TTMSortCompletionDate: return @"Completion Date";
+        case TTMSortThresholdDate: return @"Threshold Date";
+        case TTMSortAlphabetical: return @"Alphabetical";
+        default: return @"";
+    }
 }
 
 - (NSString*)hideFutureTasks {
@@ -148,19 +309,44 @@ NSString* const TTMHideHiddenTasks = @"{Hide Hidden Tasks}";
     }
 }
 
+- (NSString*)undoMemory {
+    return [NSByteCountFormatter stringFromByteCount:(long long)self.document.undoBudget.byteCount
+                                          countStyle:NSByteCountFormatterCountStyleMemory];
+}
+
 #pragma mark - Output/Property Methods
 
 - (NSString*)statusBarText {
-    NSMutableString *text = [self.format mutableCopy];
-    NSDictionary *dict = [self documentMetadata];
-    for (NSString *key in dict) {
-        [text replaceOccurrencesOfString:key
-                              withString:[NSString stringWithFormat:@"%@",
-                                          [dict objectForKey:key]]
-                                 options:NSCaseInsensitiveSearch
-                                   range:NSMakeRange(0, text.length)];
+    return [self statusBarTextWithChangedInputs:TTMStatusBarAllInputs];
+}
+
+- (NSString*)statusBarTextWithChangedInputs:(TTMStatusBarInputs)changedInputs {
+    // Only the tags that show a changed input are looked at again, except after the format
+    // is compiled, when no tag has any text yet.
+    BOOL hasChangedText = (self.text == nil);
+    if (hasChangedText || (changedInputs & self.inputs)) {
+        for (TTMStatusBarToken *token in self.tokens) {
+            if (!token.isTag ||
+                (token.text != nil && !(InputsOfTag(token.tag) & changedInputs))) {
+                continue;
+            }
+            NSString *text = [self textForTag:token.tag];
+            if (![text isEqualToString:token.text]) {
+                token.text = text;
+                hasChangedText = YES;
+            }
+        }
+    }
+    if (hasChangedText) {
+        NSMutableString *text = [NSMutableString string];
+        for (TTMStatusBarToken *token in self.tokens) {
+            if (token.text != nil) {
+                [text appendString:token.text];
+            }
+        }
+        self.text = [text copy];
     }
-    return text;
+    return self.text;
 }
 
 + (NSArray*)availableTags {
@@ -189,7 +375,8 @@ NSString* const TTMHideHiddenTasks = @"{Hide Hidden Tasks}";
              TTMActiveSortName,
              TTMSelectedTaskCount,
              TTMHideFutureTasks,
-             TTMHideHiddenTasks
+             TTMHideHiddenTasks,
+             TTMUndoMemory
              ];
 }
 
@@ -0,0 +1,96 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @class TTMFilterResultCache
+ * @abstract TTMFilterResultCache holds the tasks the last few filter predicates let through.
+ * @discussion Typing in the search field makes a predicate that refines the one before
+ * it, so its tasks are found by filtering the earlier result instead of the whole task
+ * list. Deleting a character goes back to a predicate whose result is still held. The
+ * results are only valid for the tasks they were filtered from; the owner removes them
+ * when those tasks change.
+ */
+@interface TTMFilterResultCache : NSObject
+
+/*! The most results held. The least recently used result is dropped first. */
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/*!
+ * @method initWithCapacity:
+ * @abstract Makes an empty cache.
+ * @param capacity The most results to hold.
+ * @result Returns the newly initialized cache.
+ */
+- (id)initWithCapacity:(NSUInteger)capacity;
+
+/*!
+ * @method tasksToFilterWithPredicate:isFiltered:
+ * @abstract Finds the fewest tasks that must be filtered with a predicate.
+ * @param predicate The predicate to filter with.
+ * @param isFiltered Set to YES if the tasks are the result of the same predicate and need
+ * no more filtering, or NO if they are the smallest result of a predicate that the
+ * predicate refines.
+ * @return The tasks, in task list order, or nil if every task must be filtered.
+ */
+- (NSArray*)tasksToFilterWithPredicate:(NSPredicate*)predicate isFiltered:(BOOL*)isFiltered;
+
+/*!
+ * @method addFilteredTasks:forPredicate:
+ * @abstract Holds the result of filtering the task list with a predicate.
+ * @param tasks The tasks the predicate let through, in task list order.
+ * @param predicate The predicate.
+ */
+- (void)addFilteredTasks:(NSArray*)tasks forPredicate:(NSPredicate*)predicate;
+
+/*!
+ * @method removeAllResults
+ * @abstract Drops every result, because the tasks they were filtered from changed.
+ */
+- (void)removeAllResults;
+
+@end
@@ -0,0 +1,126 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMFilterResultCache.h"
+#import "TTMCompiledPredicate.h"
+
+/*! The tasks one predicate let through. */
+@interface TTMFilterResult : NSObject
+
+@property (nonatomic) NSPredicate *predicate;
+@property (nonatomic) NSArray *tasks;
+
+@end
+
+@implementation TTMFilterResult
+
+@end
+
+@interface TTMFilterResultCache ()
+
+// The results, least recently used first.
+@property (nonatomic) NSMutableArray *results;
+
+@end
+
+@implementation TTMFilterResultCache
+
+#pragma mark - Init Methods
+
+- (id)initWithCapacity:(NSUInteger)capacity {
+    self = [super init];
+    if (self) {
+        _capacity = capacity;
+        _results = [[NSMutableArray alloc] initWithCapacity:capacity + 1];
+    }
+    return self;
+}
+
+#pragma mark - Cache Methods
+
+- (NSArray*)tasksToFilterWithPredicate:(NSPredicate*)predicate isFiltered:(BOOL*)isFiltered {
+    *isFiltered = NO;
+    TTMFilterResult *smallestResult = nil;
+    for (TTMFilterResult *result in self.results) {
+        if ([result.predicate isEqual:predicate]) {
+            [self markResultUsed:result];
+            *isFiltered = YES;
+            return result.tasks;
+        }
+        if ((smallestResult == nil || result.tasks.count < smallestResult.tasks.count) &&
+            [TTMCompiledPredicate predicate:predicate refinesPredicate:result.predicate]) {
+            smallestResult = result;
+        }
+    }
+    if (smallestResult != nil) {
+        [self markResultUsed:smallestResult];
+    }
+    return smallestResult.tasks;
+}
+
+- (void)addFilteredTasks:(NSArray*)tasks forPredicate:(NSPredicate*)predicate {
+    if (self.capacity == 0) {
+        return;
+    }
+    TTMFilterResult *result = [[TTMFilterResult alloc] init];
+    result.predicate = predicate;
+    result.tasks = [tasks copy];
+    [self.results addObject:result];
+    if (self.results.count > self.capacity) {
+        [self.results removeObjectAtIndex:0];
+    }
+}
+
+- (void)markResultUsed:(TTMFilterResult*)result {
+    [self.results removeObjectIdenticalTo:result];
+    [self.results addObject:result];
+}
+
+- (void)removeAllResults {
+    [self.results removeAllObjects];
+}
+
+@end
@@ -0,0 +1,93 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @class TTMLatencyHistogram
+ * @abstract TTMLatencyHistogram counts latencies in buckets that double in width.
+ * @discussion Bucket 0 holds latencies under a millisecond, and bucket n holds latencies
+ * from 2^(n-1) up to 2^n milliseconds. The last bucket also holds anything longer.
+ * Percentiles are reported as the upper bound of the bucket they fall in.
+ */
+@interface TTMLatencyHistogram : NSObject
+
+/*! The number of latencies recorded. */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*! The longest latency recorded, in seconds. */
+@property (nonatomic, readonly) NSTimeInterval maximumLatency;
+
+/*!
+ * @method recordLatency:
+ * @abstract Counts one latency.
+ * @param latency The latency, in seconds.
+ */
+- (void)recordLatency:(NSTimeInterval)latency;
+
+/*!
+ * @method countInBucket:
+ * @param bucket The bucket number, from zero.
+ * @return The number of latencies recorded in the bucket.
+ */
+- (NSUInteger)countInBucket:(NSUInteger)bucket;
+
+/*!
+ * @method latencyAtPercentile:
+ * @abstract Finds the latency that a percentage of the recorded latencies are within.
+ * @param percentile The percentage, from 0 to 100.
+ * @return The upper bound, in seconds, of the bucket the percentile falls in, or zero if
+ * nothing has been recorded.
+ */
+- (NSTimeInterval)latencyAtPercentile:(double)percentile;
+
+/*!
+ * @method removeAllLatencies
+ * @abstract Empties the histogram.
+ */
+- (void)removeAllLatencies;
+
+@end
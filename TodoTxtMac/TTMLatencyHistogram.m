@@ -0,0 +1,98 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMLatencyHistogram.h"
+
+#define BucketCount 16
+
+@implementation TTMLatencyHistogram {
+    NSUInteger _counts[BucketCount];
+}
+
+- (void)recordLatency:(NSTimeInterval)latency {
+    double milliseconds = latency * 1000;
+    NSUInteger bucket = 0;
+    while (bucket < BucketCount - 1 && milliseconds >= (double)((NSUInteger)1 << bucket)) {
+        bucket++;
+    }
+    _counts[bucket]++;
+    _count++;
+    _maximumLatency = MAX(_maximumLatency, latency);
+}
+
+- (NSUInteger)countInBucket:(NSUInteger)bucket {
+    return (bucket < BucketCount) ? _counts[bucket] : 0;
+}
+
+- (NSTimeInterval)latencyAtPercentile:(double)percentile {
+    if (_count == 0) {
+        return 0;
+    }
+    double wantedCount = MAX(1.0, ceil(_count * percentile / 100));
+    NSUInteger count = 0;
+    for (NSUInteger bucket = 0; bucket < BucketCount - 1; bucket++) {
+        count += _counts[bucket];
+        if (count >= wantedCount) {
+            return (double)((NSUInteger)1 << bucket) / 1000;
+        }
+    }
+    return _maximumLatency;
+}
+
+- (void)removeAllLatencies {
+    memset(_counts, 0, sizeof(_counts));
+    _count = 0;
+    _maximumLatency = 0;
+}
+
+- (NSString*)description {
+    return [NSString stringWithFormat:@"%lu latencies: 50%% within %.0f ms, 90%% within %.0f ms, "
+            @"99%% within %.0f ms, longest %.1f ms", (unsigned long)_count,
+            [self latencyAtPercentile:50] * 1000, [self latencyAtPercentile:90] * 1000,
+            [self latencyAtPercentile:99] * 1000, _maximumLatency * 1000];
+}
+
+@end
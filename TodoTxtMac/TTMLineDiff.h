@@ -0,0 +1,110 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @typedef TTMDiffLine
+ * @abstract A line to diff: its UTF-8 bytes and their hash.
+ */
+typedef struct {
+    /*! The line's UTF-8 bytes, which must stay valid while the diff is made. */
+    const char *bytes;
+    /*! The number of bytes. */
+    NSUInteger length;
+    /*! The line's hash from hashOfBytes:length:. */
+    uint64_t hash;
+} TTMDiffLine;
+
+/*!
+ * @class TTMLineDiff
+ * @abstract TTMLineDiff finds the lines that differ between two versions of a file.
+ * @discussion Lines are compared by 64-bit hashes of their bytes, and lines whose hashes
+ * match are confirmed byte for byte, so a collision cannot hide an edit. The common prefix and
+ * suffix are trimmed first, and the Myers O(ND) algorithm finds a shortest edit script
+ * for the lines in between. Its cost grows with the number of edits rather than the
+ * length of the file, so the number of edits is capped.
+ */
+@interface TTMLineDiff : NSObject
+
+/*! The indexes of old lines that are not in the new version. */
+@property (nonatomic, readonly) NSIndexSet *deletedIndexes;
+
+/*! The indexes of new lines that are not in the old version. */
+@property (nonatomic, readonly) NSIndexSet *insertedIndexes;
+
+/*!
+ * @method initWithOldLines:count:newLines:count:maxEditDistance:
+ * @abstract Diffs two sequences of lines.
+ * @param oldLines The old lines.
+ * @param oldCount The number of old lines.
+ * @param newLines The new lines.
+ * @param newCount The number of new lines.
+ * @param maxEditDistance The most deleted plus inserted lines to look for.
+ * @result Returns the diff, or nil if the versions differ by more than maxEditDistance lines.
+ */
+- (id)initWithOldLines:(const TTMDiffLine*)oldLines count:(NSUInteger)oldCount
+              newLines:(const TTMDiffLine*)newLines count:(NSUInteger)newCount
+       maxEditDistance:(NSUInteger)maxEditDistance;
+
+/*!
+ * @method hashOfBytes:length:
+ * @abstract Hashes a line's bytes with 64-bit FNV-1a.
+ * @param bytes The line's UTF-8 bytes.
+ * @param length The number of bytes.
+ * @return The hash of the line.
+ */
++ (uint64_t)hashOfBytes:(const char*)bytes length:(NSUInteger)length;
+
+/*!
+ * @method hashOfString:
+ * @abstract Hashes a string's UTF-8 bytes, without copying the string if it is avoidable.
+ * @param string The line.
+ * @return The same hash as hashOfBytes:length: returns for the string's UTF-8 bytes.
+ */
++ (uint64_t)hashOfString:(NSString*)string;
+
+@end
@@ -0,0 +1,243 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMLineDiff.h"
+
+static const uint64_t FNVOffsetBasis = 0xcbf29ce484222325ULL;
+static const uint64_t FNVPrime = 0x100000001b3ULL;
+
+static inline uint64_t HashBytes(uint64_t hash, const uint8_t *bytes, NSUInteger length) {
+    for (NSUInteger i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= FNVPrime;
+    }
+    return hash;
+}
+
+// Lines with different hashes differ. Lines with the same hash are compared byte for byte.
+static inline BOOL LinesAreEqual(const TTMDiffLine *a, const TTMDiffLine *b) {
+    return (a->hash == b->hash && a->length == b->length &&
+            memcmp(a->bytes, b->bytes, a->length) == 0);
+}
+
+#pragma mark - Myers Diff
+
+// Picks the move that reaches furthest along diagonal k after d edits, given the furthest
+// x on each diagonal after d - 1 edits (-1 where a diagonal was not reached). A move down
+// comes from diagonal k + 1 and inserts a new line; a move right comes from diagonal k - 1
+// and deletes an old line. Returns the x after the move, or -1 if neither move stays
+// inside the edit graph.
+static NSInteger ChooseMove(const NSInteger *v, NSInteger k, NSInteger d,
+                            NSInteger n, NSInteger m, BOOL *down) {
+    NSInteger downX = (k < d) ? v[k + 1] : -1;
+    BOOL downIsValid = (downX >= 0 && downX - k <= m);
+    NSInteger rightX = (k > -d && v[k - 1] >= 0) ? v[k - 1] + 1 : -1;
+    BOOL rightIsValid = (rightX >= 0 && rightX <= n);
+    if (downIsValid && (!rightIsValid || rightX <= downX)) {
+        *down = YES;
+        return downX;
+    }
+    *down = NO;
+    return (rightIsValid) ? rightX : -1;
+}
+
+// Finds a shortest edit script between a and b, which must both be non-empty, and adds
+// the deleted and inserted lines, shifted by offset, to the index sets. The furthest x on
+// each diagonal is saved before every round so that the path can be traced back.
+// Returns NO if the script needs more than maxD edits.
+static BOOL DiffLines(const TTMDiffLine *a, NSInteger n, const TTMDiffLine *b, NSInteger m,
+                      NSInteger maxD, NSUInteger offset,
+                      NSMutableIndexSet *deletedIndexes, NSMutableIndexSet *insertedIndexes) {
+    maxD = MIN(maxD, n + m);
+    if (labs(n - m) > maxD) {
+        return NO;
+    }
+    
+    NSInteger *vStorage = malloc((2 * maxD + 3) * sizeof(NSInteger));
+    for (NSInteger i = 0; i < 2 * maxD + 3; i++) {
+        vStorage[i] = -1;
+    }
+    NSInteger *v = vStorage + maxD + 1;
+    
+    // Round d saves diagonals -d - 1 through d + 1, starting at d * (d + 2).
+    NSUInteger traceCapacity = 1024;
+    NSInteger *trace = malloc(traceCapacity * sizeof(NSInteger));
+    NSInteger finalD = -1;
+    
+    for (NSInteger d = 0; d <= maxD && finalD < 0; d++) {
+        NSUInteger traceEnd = (NSUInteger)((d + 1) * (d + 3));
+        if (traceEnd > traceCapacity) {
+            traceCapacity = MAX(traceCapacity * 2, traceEnd);
+            trace = realloc(trace, traceCapacity * sizeof(NSInteger));
+        }
+        memcpy(trace + d * (d + 2), v - d - 1, (2 * d + 3) * sizeof(NSInteger));
+        
+        NSInteger kMin = MAX(-d, -m);
+        if ((kMin + d) % 2 != 0) {
+            kMin++;
+        }
+        NSInteger kMax = MIN(d, n);
+        for (NSInteger k = kMin; k <= kMax; k += 2) {
+            BOOL down;
+            NSInteger x = (d == 0) ? 0 : ChooseMove(v, k, d, n, m, &down);
+            if (x >= 0) {
+                NSInteger y = x - k;
+                while (x < n && y < m && LinesAreEqual(&a[x], &b[y])) {
+                    x++;
+                    y++;
+                }
+                if (x == n && y == m) {
+                    finalD = d;
+                }
+            }
+            v[k] = x;
+        }
+    }
+    
+    if (finalD >= 0) {
+        NSInteger x = n;
+        NSInteger y = m;
+        for (NSInteger d = finalD; d > 0; d--) {
+            const NSInteger *previousV = trace + d * (d + 2) + d + 1;
+            NSInteger k = x - y;
+            BOOL down;
+            ChooseMove(previousV, k, d, n, m, &down);
+            NSInteger previousK = (down) ? k + 1 : k - 1;
+            NSInteger previousX = previousV[previousK];
+            NSInteger previousY = previousX - previousK;
+            if (down) {
+                [insertedIndexes addIndex:offset + previousY];
+            } else {
+                [deletedIndexes addIndex:offset + previousX];
+            }
+            x = previousX;
+            y = previousY;
+        }
+    }
+    
+    free(trace);
+    free(vStorage);
+    return (finalD >= 0);
+}
+
+#pragma mark - TTMLineDiff
+
+@implementation TTMLineDiff
+
+- (id)initWithOldLines:(const TTMDiffLine*)oldLines count:(NSUInteger)oldCount
+              newLines:(const TTMDiffLine*)newLines count:(NSUInteger)newCount
+       maxEditDistance:(NSUInteger)maxEditDistance {
+    self = [super init];
+    if (!self) {
+        return self;
+    }
+    
+    // Most external edits touch a few lines, so skip the lines at both ends that match.
+    NSUInteger prefix = 0;
+    while (prefix < oldCount && prefix < newCount &&
+           LinesAreEqual(&oldLines[prefix], &newLines[prefix])) {
+        prefix++;
+    }
+    NSUInteger suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix &&
+           LinesAreEqual(&oldLines[oldCount - suffix - 1], &newLines[newCount - suffix - 1])) {
+        suffix++;
+    }
+    NSUInteger middleOldCount = oldCount - prefix - suffix;
+    NSUInteger middleNewCount = newCount - prefix - suffix;
+    
+    NSMutableIndexSet *deletedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *insertedIndexes = [NSMutableIndexSet indexSet];
+    if (middleOldCount == 0 || middleNewCount == 0) {
+        if (middleOldCount + middleNewCount > maxEditDistance) {
+            return nil;
+        }
+        [deletedIndexes addIndexesInRange:NSMakeRange(prefix, middleOldCount)];
+        [insertedIndexes addIndexesInRange:NSMakeRange(prefix, middleNewCount)];
+    } else if (!DiffLines(oldLines + prefix, (NSInteger)middleOldCount,
+                          newLines + prefix, (NSInteger)middleNewCount,
+                          (NSInteger)MIN(maxEditDistance, (NSUInteger)NSIntegerMax / 4), prefix,
+                          deletedIndexes, insertedIndexes)) {
+        return nil;
+    }
+    
+    _deletedIndexes = [deletedIndexes copy];
+    _insertedIndexes = [insertedIndexes copy];
+    return self;
+}
+
++ (uint64_t)hashOfBytes:(const char*)bytes length:(NSUInteger)length {
+    return HashBytes(FNVOffsetBasis, (const uint8_t*)bytes, length);
+}
+
++ (uint64_t)hashOfString:(NSString*)string {
+    const char *utf8 = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if (utf8 != NULL) {
+        return HashBytes(FNVOffsetBasis, (const uint8_t*)utf8, strlen(utf8));
+    }
+    
+    // Convert the string a buffer at a time, so long lines are not copied whole.
+    uint64_t hash = FNVOffsetBasis;
+    uint8_t buffer[256];
+    NSRange remainingRange = NSMakeRange(0, [string length]);
+    while (remainingRange.length > 0) {
+        NSUInteger usedLength = 0;
+        if (![string getBytes:buffer
+                    maxLength:sizeof(buffer)
+                   usedLength:&usedLength
+                     encoding:NSUTF8StringEncoding
+                      options:0
+                        range:remainingRange
+               remainingRange:&remainingRange] ||
+            usedLength == 0) {
+            break;
+        }
+        hash = HashBytes(hash, buffer, usedLength);
+    }
+    return hash;
+}
+
+@end
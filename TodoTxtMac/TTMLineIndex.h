@@ -0,0 +1,107 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @class TTMLineIndex
+ * @abstract TTMLineIndex records where each line starts and ends in a buffer of UTF-8 text.
+ * @discussion The buffer is scanned once, 16 bytes at a time with SSE2 or NEON where
+ * available, to find line endings and validate UTF-8. Blocks of plain ASCII skip UTF-8
+ * validation. Lines may end in "\n" or "\r\n", and one file may use both. Line ranges
+ * exclude the line ending and any other carriage returns directly before it. A UTF-8 byte
+ * order mark at the start of the buffer is not part of the first line. No strings are
+ * created, so a memory-mapped file can be indexed without copying it.
+ */
+@interface TTMLineIndex : NSObject
+
+/*! The number of lines. Text after the last line ending counts as a line. */
+@property (nonatomic, readonly) NSUInteger lineCount;
+
+/*! Whether any line ends in "\r\n". */
+@property (nonatomic, readonly) BOOL hasWindowsLineEndings;
+
+/*! Whether the buffer is valid UTF-8. */
+@property (nonatomic, readonly) BOOL isValidUTF8;
+
+/*! Whether every byte after the byte order mark, if any, is ASCII. */
+@property (nonatomic, readonly) BOOL isASCII;
+
+/*!
+ * @method initWithBytes:length:
+ * @abstract Indexes the lines of a buffer. The buffer is not retained.
+ * @param bytes UTF-8 text.
+ * @param length The length of the buffer in bytes.
+ * @result Returns the newly initialized index.
+ */
+- (id)initWithBytes:(const char*)bytes length:(NSUInteger)length;
+
+/*!
+ * @method initWithData:
+ * @abstract Indexes the lines of a data object's bytes. The data object is not retained.
+ * @param data UTF-8 text, which may be memory-mapped.
+ * @result Returns the newly initialized index.
+ */
+- (id)initWithData:(NSData*)data;
+
+/*!
+ * @method rangeOfLineAtIndex:
+ * @abstract Returns the byte range of a line, without its line ending.
+ * @param index The zero-based line number.
+ * @return The line's range in the indexed buffer.
+ */
+- (NSRange)rangeOfLineAtIndex:(NSUInteger)index;
+
+/*!
+ * @method rangeOfLineWithEndingAtIndex:
+ * @abstract Returns the byte range of a line, including its line ending.
+ * @param index The zero-based line number.
+ * @return The line's range in the indexed buffer. The ranges of all lines, plus the byte
+ * order mark, cover the whole buffer.
+ */
+- (NSRange)rangeOfLineWithEndingAtIndex:(NSUInteger)index;
+
+@end
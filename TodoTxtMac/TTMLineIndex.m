@@ -0,0 +1,237 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMLineIndex.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TTM_LINE_INDEX_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TTM_LINE_INDEX_NEON 1
+#endif
+
+#if TTM_LINE_INDEX_SSE2 || TTM_LINE_INDEX_NEON
+static const NSUInteger BlockSize = 16;
+#endif
+
+#pragma mark - UTF-8 Validation
+
+// Tracks a multi-byte UTF-8 sequence across calls, so that a sequence may straddle blocks.
+// The first continuation byte has a narrower range after E0, ED, F0, and F4, which rules
+// out overlong encodings, surrogates, and code points above U+10FFFF.
+typedef struct {
+    uint8_t remaining;
+    uint8_t low;
+    uint8_t high;
+} TTMUTF8State;
+
+static BOOL ValidateUTF8(TTMUTF8State *state, const uint8_t *bytes, NSUInteger length) {
+    for (NSUInteger i = 0; i < length; i++) {
+        uint8_t byte = bytes[i];
+        if (state->remaining > 0) {
+            if (byte < state->low || byte > state->high) {
+                return NO;
+            }
+            state->remaining--;
+            state->low = 0x80;
+            state->high = 0xBF;
+            continue;
+        }
+        if (byte < 0x80) {
+            continue;
+        }
+        state->low = 0x80;
+        state->high = 0xBF;
+        if (byte >= 0xC2 && byte <= 0xDF) {
+            state->remaining = 1;
+        } else if (byte >= 0xE0 && byte <= 0xEF) {
+            state->remaining = 2;
+            if (byte == 0xE0) {
+                state->low = 0xA0;
+            } else if (byte == 0xED) {
+                state->high = 0x9F;
+            }
+        } else if (byte >= 0xF0 && byte <= 0xF4) {
+            state->remaining = 3;
+            if (byte == 0xF0) {
+                state->low = 0x90;
+            } else if (byte == 0xF4) {
+                state->high = 0x8F;
+            }
+        } else {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+#pragma mark - Block Scanning
+
+#if TTM_LINE_INDEX_SSE2 || TTM_LINE_INDEX_NEON
+// Returns a bit mask of the "\n" bytes in a 16-byte block, and whether any byte is non-ASCII.
+static inline uint32_t ScanBlock(const uint8_t *block, BOOL *hasHighBytes) {
+#if TTM_LINE_INDEX_SSE2
+    __m128i bytes = _mm_loadu_si128((const __m128i*)block);
+    *hasHighBytes = (_mm_movemask_epi8(bytes) != 0);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+#else
+    static const uint8_t bitWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                           1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bytes = vld1q_u8(block);
+    *hasHighBytes = (vmaxvq_u8(bytes) >= 0x80);
+    uint8x16_t newlines = vandq_u8(vceqq_u8(bytes, vdupq_n_u8('\n')), vld1q_u8(bitWeights));
+    return (uint32_t)vaddv_u8(vget_low_u8(newlines)) |
+           ((uint32_t)vaddv_u8(vget_high_u8(newlines)) << 8);
+#endif
+}
+#endif
+
+#pragma mark - TTMLineIndex
+
+@interface TTMLineIndex () {
+    NSRange *_lineRanges;
+    NSUInteger _capacity;
+    NSUInteger _length;
+}
+
+@end
+
+@implementation TTMLineIndex
+
+- (id)initWithBytes:(const char*)bytes length:(NSUInteger)length {
+    self = [super init];
+    if (self) {
+        const uint8_t *buffer = (const uint8_t*)bytes;
+        _length = length;
+        _isValidUTF8 = YES;
+        _isASCII = YES;
+        
+        NSUInteger lineStart = 0;
+        if (length >= 3 && memcmp(buffer, "\xEF\xBB\xBF", 3) == 0) {
+            lineStart = 3;
+        }
+        
+        TTMUTF8State state = {0, 0x80, 0xBF};
+        NSUInteger i = lineStart;
+#if TTM_LINE_INDEX_SSE2 || TTM_LINE_INDEX_NEON
+        for (; i + BlockSize <= length; i += BlockSize) {
+            BOOL hasHighBytes;
+            uint32_t newlines = ScanBlock(buffer + i, &hasHighBytes);
+            // ASCII blocks cannot be invalid unless they interrupt a multi-byte sequence.
+            if (hasHighBytes || state.remaining > 0) {
+                _isASCII = _isASCII && !hasHighBytes;
+                _isValidUTF8 = _isValidUTF8 && ValidateUTF8(&state, buffer + i, BlockSize);
+            }
+            while (newlines != 0) {
+                NSUInteger newline = i + __builtin_ctz(newlines);
+                [self addLineFrom:lineStart toNewline:newline inBuffer:buffer];
+                lineStart = newline + 1;
+                newlines &= newlines - 1;
+            }
+        }
+#endif
+        // Scan whatever is left (all of the buffer when there is no vector unit).
+        for (; i < length; i++) {
+            uint8_t byte = buffer[i];
+            if (byte >= 0x80 || state.remaining > 0) {
+                _isASCII = _isASCII && (byte < 0x80);
+                _isValidUTF8 = _isValidUTF8 && ValidateUTF8(&state, buffer + i, 1);
+            }
+            if (byte == '\n') {
+                [self addLineFrom:lineStart toNewline:i inBuffer:buffer];
+                lineStart = i + 1;
+            }
+        }
+        if (state.remaining > 0) {
+            _isValidUTF8 = NO;
+        }
+        if (lineStart < length) {
+            [self addLineRange:NSMakeRange(lineStart, length - lineStart)];
+        }
+    }
+    return self;
+}
+
+- (id)initWithData:(NSData*)data {
+    return [self initWithBytes:data.bytes length:data.length];
+}
+
+- (void)dealloc {
+    free(_lineRanges);
+}
+
+- (void)addLineFrom:(NSUInteger)lineStart toNewline:(NSUInteger)newline
+           inBuffer:(const uint8_t*)buffer {
+    NSUInteger lineEnd = newline;
+    if (lineEnd > lineStart && buffer[lineEnd - 1] == '\r') {
+        _hasWindowsLineEndings = YES;
+        while (lineEnd > lineStart && buffer[lineEnd - 1] == '\r') {
+            lineEnd--;
+        }
+    }
+    [self addLineRange:NSMakeRange(lineStart, lineEnd - lineStart)];
+}
+
+- (void)addLineRange:(NSRange)lineRange {
+    if (_lineCount == _capacity) {
+        _capacity = MAX(_capacity * 2, (NSUInteger)1024);
+        _lineRanges = realloc(_lineRanges, _capacity * sizeof(NSRange));
+    }
+    _lineRanges[_lineCount++] = lineRange;
+}
+
+- (NSRange)rangeOfLineAtIndex:(NSUInteger)index {
+    return _lineRanges[index];
+}
+
+- (NSRange)rangeOfLineWithEndingAtIndex:(NSUInteger)index {
+    NSUInteger start = _lineRanges[index].location;
+    NSUInteger end = (index + 1 < _lineCount) ? _lineRanges[index + 1].location : _length;
+    return NSMakeRange(start, end - start);
+}
+
+@end
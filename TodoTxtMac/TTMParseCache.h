@@ -0,0 +1,134 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class TTMLineIndex;
+@class TTMSymbolTable;
+@class TTMParseCacheEntry;
+
+/*!
+ * @class TTMParseCache
+ * @abstract TTMParseCache keeps the parsed state of todo.txt files on disk, so that an
+ * unchanged file can be reopened without parsing it again.
+ * @discussion Each file gets one cache entry in the cache directory. An entry is a flat
+ * binary file that is read memory-mapped: a header with the file's size, modification time,
+ * and SHA-256 content hash; a fixed-size record per task with its scanned ranges and
+ * project and context IDs; and the table of project and context names those IDs refer to.
+ * An entry is used only if the size, modification time, and hash all match the file, and
+ * every record is consistent with the file's lines. Otherwise the file is parsed as usual.
+ * Entries that have not been used recently are deleted when the cache grows past its byte
+ * limit.
+ */
+@interface TTMParseCache : NSObject
+
+/*! The directory that holds the cache entries. */
+@property (nonatomic, readonly) NSURL *directoryURL;
+
+/*! The most bytes the entries may take up together. After each write, the least recently
+ *  used entries are deleted until the rest fit. The default is 64 MB. */
+@property (atomic) unsigned long long byteLimit;
+
+/*!
+ * @method defaultCache
+ * @abstract Returns the cache kept in the application's Application Support directory.
+ * @return The shared parse cache.
+ */
++ (TTMParseCache*)defaultCache;
+
+/*!
+ * @method initWithDirectoryURL:
+ * @abstract Initializes a cache that keeps its entries in a directory.
+ * @param directoryURL The directory, which is created when the first entry is written.
+ * @result Returns the newly initialized cache.
+ */
+- (id)initWithDirectoryURL:(NSURL*)directoryURL;
+
+/*!
+ * @method tasksFromData:lineIndex:fileURL:firstTaskId:symbolTable:
+ * @abstract Restores a file's tasks from its cache entry.
+ * @param data The current contents of the file.
+ * @param lineIndex The index of the lines in data.
+ * @param fileURL The location of the file.
+ * @param firstTaskId The task ID to give the first task.
+ * @param symbolTable The symbol table to intern the tasks' projects and contexts in.
+ * @return The tasks, in line order, or nil if there is no usable entry for the file.
+ */
+- (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+                  fileURL:(NSURL*)fileURL
+              firstTaskId:(NSUInteger)firstTaskId
+              symbolTable:(TTMSymbolTable*)symbolTable;
+
+/*!
+ * @method entryForTasks:fileData:
+ * @abstract Captures the parsed state of the tasks in a file.
+ * @discussion This must be called on the thread that owns the tasks, before they can
+ * change. It copies only each task's scanned ranges and symbol IDs, which loaded tasks have
+ * already decoded. Looking up the symbols, hashing the file, and encoding the entry happen
+ * in the background when the entry is stored.
+ * @param tasks The file's non-blank tasks, in line order, which must share one symbol table.
+ * @param fileData The contents of the file.
+ * @return The captured entry, or nil if the tasks cannot be cached.
+ */
+- (TTMParseCacheEntry*)entryForTasks:(NSArray*)tasks fileData:(NSData*)fileData;
+
+/*!
+ * @method storeEntry:forFileURL:
+ * @abstract Encodes an entry, stamps it with the file's modification time, and writes it to
+ * the cache directory in the background, then deletes old entries over the byte limit.
+ * @param entry An entry returned by entryForTasks:fileData:, or nil to do nothing.
+ * @param fileURL The location of the file the entry describes, which must already be written.
+ */
+- (void)storeEntry:(TTMParseCacheEntry*)entry forFileURL:(NSURL*)fileURL;
+
+/*!
+ * @method waitForPendingWrites
+ * @abstract Blocks until every entry passed to storeEntry:forFileURL: has been written.
+ */
+- (void)waitForPendingWrites;
+
+@end
@@ -0,0 +1,525 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMParseCache.h"
+#import "TTMTask.h"
+#import "TTMTaskLoader.h"
+#import "TTMLineIndex.h"
+#import "TTMSymbolTable.h"
+#import <CommonCrypto/CommonDigest.h>
+
+#pragma mark - Cache Entry Format
+
+// An entry is laid out as:
+//   TTMParseCacheHeader
+//   TTMCachedTask[taskCount]
+//   uint32_t symbolIDs[symbolIDCount]          (each task's project IDs, then context IDs)
+//   uint32_t symbolOffsets[symbolCount + 1]    (into the symbol bytes)
+//   char symbolBytes[symbolBytesLength]        (UTF-8 project and context names)
+// Symbol IDs are local to the entry and are mapped to the document's symbol table on load.
+
+static const uint32_t CacheMagic = 0x434D5454; // "TTMC" in little-endian byte order
+static const uint32_t CacheVersion = 1;
+static const uint32_t NotFoundLocation = UINT32_MAX;
+static const uint32_t UnusedSymbolID = UINT32_MAX;
+static const unsigned long long DefaultByteLimit = 64 * 1024 * 1024;
+static NSString * const EntryPathExtension = @"ttmcache";
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fileSize;
+    double modificationTime;
+    uint8_t contentHash[CC_SHA256_DIGEST_LENGTH];
+    uint32_t taskCount;
+    uint32_t symbolIDCount;
+    uint32_t symbolCount;
+    uint32_t symbolBytesLength;
+} TTMParseCacheHeader;
+
+typedef struct {
+    uint32_t location;
+    uint32_t length;
+} TTMCachedRange;
+
+typedef struct {
+    TTMCachedRange completionDateRange;
+    TTMCachedRange priorityRange;
+    TTMCachedRange creationDateRange;
+    TTMCachedRange completedCreationDateRange;
+    TTMCachedRange dueDateRange;
+    TTMCachedRange thresholdDateRange;
+    TTMCachedRange recurrenceRange;
+    uint32_t firstSymbolID;
+    uint16_t projectIDCount;
+    uint16_t contextIDCount;
+    uint8_t hasCompletedPrefix;
+    uint8_t isHidden;
+    uint8_t reserved[2];
+} TTMCachedTask;
+
+static BOOL CacheRangeFromRange(NSRange range, TTMCachedRange *cachedRange) {
+    if (range.location == NSNotFound) {
+        *cachedRange = (TTMCachedRange){NotFoundLocation, 0};
+        return YES;
+    }
+    if (range.location >= NotFoundLocation || range.length >= NotFoundLocation) {
+        return NO;
+    }
+    *cachedRange = (TTMCachedRange){(uint32_t)range.location, (uint32_t)range.length};
+    return YES;
+}
+
+static BOOL RangeFromCacheRange(TTMCachedRange cachedRange, NSUInteger stringLength,
+                                NSRange *range) {
+    if (cachedRange.location == NotFoundLocation) {
+        *range = NSMakeRange(NSNotFound, 0);
+        return YES;
+    }
+    if ((uint64_t)cachedRange.location + cachedRange.length > stringLength) {
+        return NO;
+    }
+    *range = NSMakeRange(cachedRange.location, cachedRange.length);
+    return YES;
+}
+
+static void HashData(NSData *data, uint8_t hash[CC_SHA256_DIGEST_LENGTH]) {
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+    const uint8_t *bytes = data.bytes;
+    NSUInteger remaining = data.length;
+    while (remaining > 0) {
+        CC_LONG chunkLength = (CC_LONG)MIN(remaining, (NSUInteger)(1 << 30));
+        CC_SHA256_Update(&context, bytes, chunkLength);
+        bytes += chunkLength;
+        remaining -= chunkLength;
+    }
+    CC_SHA256_Final(hash, &context);
+}
+
+/*!
+ * @class TTMParseCacheEntry
+ * @abstract The parsed state of a file's tasks, captured on the thread that owns them and
+ * encoded on the write queue.
+ * @discussion The records hold the document's symbol IDs until the entry is encoded, when
+ * they are renumbered to the symbols the entry actually uses.
+ */
+@interface TTMParseCacheEntry : NSObject
+
+@property (nonatomic) NSData *fileData;
+@property (nonatomic) TTMSymbolTable *symbolTable;
+@property (nonatomic) NSData *cachedTasks;
+@property (nonatomic) NSData *symbolIDs;
+
+@end
+
+@implementation TTMParseCacheEntry
+
+@end
+
+@interface TTMParseCache ()
+
+@property (nonatomic) dispatch_queue_t writeQueue;
+
+@end
+
+@implementation TTMParseCache
+
++ (TTMParseCache*)defaultCache {
+    static TTMParseCache *defaultCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *applicationSupportURL = [[[NSFileManager defaultManager]
+                                         URLsForDirectory:NSApplicationSupportDirectory
+                                         inDomains:NSUserDomainMask] firstObject];
+        NSString *bundleIdentifier = [[NSBundle mainBundle] bundleIdentifier] ?: @"TodoTxtMac";
+        NSURL *directoryURL = [[applicationSupportURL
+                                URLByAppendingPathComponent:bundleIdentifier isDirectory:YES]
+                               URLByAppendingPathComponent:@"ParseCache" isDirectory:YES];
+        defaultCache = [[TTMParseCache alloc] initWithDirectoryURL:directoryURL];
+    });
+    return defaultCache;
+}
+
+- (id)initWithDirectoryURL:(NSURL*)directoryURL {
+    self = [super init];
+    if (self) {
+        _directoryURL = directoryURL;
+        _writeQueue = dispatch_queue_create("TTMParseCache.write", DISPATCH_QUEUE_SERIAL);
+        _byteLimit = DefaultByteLimit;
+    }
+    return self;
+}
+
+#pragma mark - Locating Entries
+
+- (NSURL*)entryURLForFileURL:(NSURL*)fileURL {
+    // Name the entry after a hash of the file's path, which is unique and has no slashes.
+    NSData *path = [[[fileURL URLByStandardizingPath] path] dataUsingEncoding:NSUTF8StringEncoding];
+    uint8_t hash[CC_SHA256_DIGEST_LENGTH];
+    HashData(path, hash);
+    NSMutableString *name = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2 + 9];
+    for (NSUInteger i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [name appendFormat:@"%02x", hash[i]];
+    }
+    [name appendFormat:@".%@", EntryPathExtension];
+    return [self.directoryURL URLByAppendingPathComponent:name isDirectory:NO];
+}
+
+- (double)modificationTimeOfFileURL:(NSURL*)fileURL {
+    // Use a fresh URL, because NSURL caches resource values.
+    NSURL *uncachedURL = [NSURL fileURLWithPath:[fileURL path]];
+    NSDate *modificationDate = nil;
+    [uncachedURL getResourceValue:&modificationDate forKey:NSURLContentModificationDateKey error:nil];
+    return (modificationDate != nil) ? [modificationDate timeIntervalSinceReferenceDate] : NAN;
+}
+
+#pragma mark - Reading Entries
+
+- (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+                  fileURL:(NSURL*)fileURL
+              firstTaskId:(NSUInteger)firstTaskId
+              symbolTable:(TTMSymbolTable*)symbolTable {
+    NSURL *entryURL = [self entryURLForFileURL:fileURL];
+    NSData *entry NS_VALID_UNTIL_END_OF_SCOPE = [NSData dataWithContentsOfURL:entryURL
+                                                                      options:NSDataReadingMappedIfSafe
+                                                                        error:nil];
+    if (entry.length < sizeof(TTMParseCacheHeader)) {
+        return nil;
+    }
+    
+    // Check the cheap parts of the key before hashing the file.
+    TTMParseCacheHeader header;
+    memcpy(&header, entry.bytes, sizeof(header));
+    if (header.magic != CacheMagic ||
+        header.version != CacheVersion ||
+        header.fileSize != data.length ||
+        header.modificationTime != [self modificationTimeOfFileURL:fileURL]) {
+        return nil;
+    }
+    uint64_t expectedLength = sizeof(TTMParseCacheHeader) +
+                              (uint64_t)header.taskCount * sizeof(TTMCachedTask) +
+                              (uint64_t)header.symbolIDCount * sizeof(uint32_t) +
+                              ((uint64_t)header.symbolCount + 1) * sizeof(uint32_t) +
+                              header.symbolBytesLength;
+    if (expectedLength != entry.length) {
+        return nil;
+    }
+    uint8_t contentHash[CC_SHA256_DIGEST_LENGTH];
+    HashData(data, contentHash);
+    if (memcmp(contentHash, header.contentHash, CC_SHA256_DIGEST_LENGTH) != 0) {
+        return nil;
+    }
+    
+    const uint8_t *bytes = entry.bytes;
+    const TTMCachedTask *cachedTasks = (const TTMCachedTask*)(bytes + sizeof(TTMParseCacheHeader));
+    const uint32_t *symbolIDs = (const uint32_t*)(cachedTasks + header.taskCount);
+    const uint32_t *symbolOffsets = symbolIDs + header.symbolIDCount;
+    const char *symbolBytes = (const char*)(symbolOffsets + header.symbolCount + 1);
+    
+    // Intern the entry's symbols, and map the entry's symbol IDs to the document's.
+    TTMSymbolID *symbolMap = malloc(MAX(header.symbolCount, 1) * sizeof(TTMSymbolID));
+    for (uint32_t i = 0; i < header.symbolCount; i++) {
+        uint32_t start = symbolOffsets[i];
+        uint32_t end = symbolOffsets[i + 1];
+        NSString *symbol = (start <= end && end <= header.symbolBytesLength) ?
+            [[NSString alloc] initWithBytes:symbolBytes + start
+                                     length:end - start
+                                   encoding:NSUTF8StringEncoding] :
+            nil;
+        if (symbol == nil) {
+            free(symbolMap);
+            return nil;
+        }
+        symbolMap[i] = [symbolTable internSymbol:symbol];
+    }
+    
+    uint32_t taskCount = header.taskCount;
+    uint32_t symbolIDCount = header.symbolIDCount;
+    uint32_t symbolCount = header.symbolCount;
+    NSArray *tasks = [TTMTaskLoader tasksFromData:data
+                                        lineIndex:lineIndex
+                                      firstTaskId:firstTaskId
+                                      taskBuilder:^TTMTask*(NSString *rawText,
+                                                            NSUInteger taskIndex,
+                                                            NSUInteger taskId) {
+        if (taskIndex >= taskCount) {
+            return nil;
+        }
+        const TTMCachedTask *cachedTask = &cachedTasks[taskIndex];
+        TTMTaskScanResult scan;
+        NSUInteger length = rawText.length;
+        if (!RangeFromCacheRange(cachedTask->completionDateRange, length, &scan.completionDateRange) ||
+            !RangeFromCacheRange(cachedTask->priorityRange, length, &scan.priorityRange) ||
+            !RangeFromCacheRange(cachedTask->creationDateRange, length, &scan.creationDateRange) ||
+            !RangeFromCacheRange(cachedTask->completedCreationDateRange, length,
+                                 &scan.completedCreationDateRange) ||
+            !RangeFromCacheRange(cachedTask->dueDateRange, length, &scan.dueDateRange) ||
+            !RangeFromCacheRange(cachedTask->thresholdDateRange, length, &scan.thresholdDateRange) ||
+            !RangeFromCacheRange(cachedTask->recurrenceRange, length, &scan.recurrenceRange)) {
+            return nil;
+        }
+        scan.hasCompletedPrefix = (cachedTask->hasCompletedPrefix != 0);
+        scan.isHidden = (cachedTask->isHidden != 0);
+        
+        NSUInteger taskSymbolCount = cachedTask->projectIDCount + cachedTask->contextIDCount;
+        if ((uint64_t)cachedTask->firstSymbolID + taskSymbolCount > symbolIDCount) {
+            return nil;
+        }
+        TTMSymbolID stackSymbolIDs[32];
+        TTMSymbolID *taskSymbolIDs = (taskSymbolCount <= 32) ?
+            stackSymbolIDs :
+            malloc(taskSymbolCount * sizeof(TTMSymbolID));
+        TTMTask *task = nil;
+        BOOL validSymbolIDs = YES;
+        for (NSUInteger i = 0; i < taskSymbolCount && validSymbolIDs; i++) {
+            uint32_t symbolID = symbolIDs[cachedTask->firstSymbolID + i];
+            validSymbolIDs = (symbolID < symbolCount);
+            taskSymbolIDs[i] = validSymbolIDs ? symbolMap[symbolID] : 0;
+        }
+        if (validSymbolIDs) {
+            task = [[TTMTask alloc] initWithRawText:rawText
+                                         withTaskId:taskId
+                                         scanResult:scan
+                                        symbolTable:symbolTable
+                                         projectIDs:taskSymbolIDs
+                                              count:cachedTask->projectIDCount
+                                         contextIDs:taskSymbolIDs + cachedTask->projectIDCount
+                                              count:cachedTask->contextIDCount];
+        }
+        if (taskSymbolIDs != stackSymbolIDs) {
+            free(taskSymbolIDs);
+        }
+        return task;
+    }];
+    
+    free(symbolMap);
+    
+    // The file must have exactly one non-blank line per record.
+    if (tasks.count != taskCount) {
+        return nil;
+    }
+    [self markEntryUsedAtURL:entryURL];
+    return tasks;
+}
+
+#pragma mark - Writing Entries
+
+- (TTMParseCacheEntry*)entryForTasks:(NSArray*)tasks fileData:(NSData*)fileData {
+    if (tasks == nil || fileData == nil || tasks.count >= UINT32_MAX) {
+        return nil;
+    }
+    TTMSymbolTable *symbolTable = [[tasks firstObject] symbolTable];
+    NSMutableData *cachedTasks = [NSMutableData dataWithLength:tasks.count * sizeof(TTMCachedTask)];
+    NSMutableData *symbolIDs = [NSMutableData data];
+    
+    // Copy only state the tasks already hold. Reading the symbol IDs first lets the scan
+    // that collects projects and contexts also fill in the ranges, for a task that was edited.
+    TTMCachedTask *cachedTask = cachedTasks.mutableBytes;
+    for (TTMTask *task in tasks) {
+        NSUInteger projectIDCount = task.projectIDCount;
+        NSUInteger contextIDCount = task.contextIDCount;
+        TTMTaskScanResult scan = task.scanResult;
+        if (task.symbolTable != symbolTable ||
+            !CacheRangeFromRange(scan.completionDateRange, &cachedTask->completionDateRange) ||
+            !CacheRangeFromRange(scan.priorityRange, &cachedTask->priorityRange) ||
+            !CacheRangeFromRange(scan.creationDateRange, &cachedTask->creationDateRange) ||
+            !CacheRangeFromRange(scan.completedCreationDateRange,
+                                 &cachedTask->completedCreationDateRange) ||
+            !CacheRangeFromRange(scan.dueDateRange, &cachedTask->dueDateRange) ||
+            !CacheRangeFromRange(scan.thresholdDateRange, &cachedTask->thresholdDateRange) ||
+            !CacheRangeFromRange(scan.recurrenceRange, &cachedTask->recurrenceRange) ||
+            projectIDCount > UINT16_MAX ||
+            contextIDCount > UINT16_MAX ||
+            symbolIDs.length / sizeof(uint32_t) >= UINT32_MAX - UINT16_MAX * 2) {
+            return nil;
+        }
+        cachedTask->hasCompletedPrefix = scan.hasCompletedPrefix ? 1 : 0;
+        cachedTask->isHidden = scan.isHidden ? 1 : 0;
+        cachedTask->firstSymbolID = (uint32_t)(symbolIDs.length / sizeof(uint32_t));
+        cachedTask->projectIDCount = (uint16_t)projectIDCount;
+        cachedTask->contextIDCount = (uint16_t)contextIDCount;
+        [symbolIDs appendBytes:task.projectIDs length:projectIDCount * sizeof(TTMSymbolID)];
+        [symbolIDs appendBytes:task.contextIDs length:contextIDCount * sizeof(TTMSymbolID)];
+        cachedTask++;
+    }
+    
+    TTMParseCacheEntry *entry = [[TTMParseCacheEntry alloc] init];
+    entry.fileData = fileData;
+    entry.symbolTable = symbolTable;
+    entry.cachedTasks = cachedTasks;
+    entry.symbolIDs = symbolIDs;
+    return entry;
+}
+
+- (NSData*)encodeEntry:(TTMParseCacheEntry*)entry modificationTime:(double)modificationTime {
+    // Renumber the document's symbol IDs in order of first use, so that the entry names only
+    // the symbols its tasks use. Symbols are never removed from a symbol table, so every
+    // captured ID is still below its count.
+    TTMSymbolTable *symbolTable = entry.symbolTable;
+    NSUInteger documentSymbolCount = [symbolTable count];
+    uint32_t *entrySymbolIDs = malloc(MAX(documentSymbolCount, 1) * sizeof(uint32_t));
+    for (NSUInteger i = 0; i < documentSymbolCount; i++) {
+        entrySymbolIDs[i] = UnusedSymbolID;
+    }
+    NSMutableData *symbolOffsets = [NSMutableData data];
+    NSMutableData *symbolBytes = [NSMutableData data];
+    uint32_t symbolCount = 0;
+    NSMutableData *renumberedSymbolIDs = [entry.symbolIDs mutableCopy];
+    uint32_t *symbolIDs = renumberedSymbolIDs.mutableBytes;
+    NSUInteger symbolIDCount = renumberedSymbolIDs.length / sizeof(uint32_t);
+    for (NSUInteger i = 0; i < symbolIDCount; i++) {
+        TTMSymbolID documentSymbolID = symbolIDs[i];
+        if (documentSymbolID >= documentSymbolCount) {
+            free(entrySymbolIDs);
+            return nil;
+        }
+        if (entrySymbolIDs[documentSymbolID] == UnusedSymbolID) {
+            entrySymbolIDs[documentSymbolID] = symbolCount++;
+            uint32_t offset = (uint32_t)symbolBytes.length;
+            [symbolOffsets appendBytes:&offset length:sizeof(offset)];
+            [symbolBytes appendData:[[symbolTable symbolForID:documentSymbolID]
+                                     dataUsingEncoding:NSUTF8StringEncoding]];
+        }
+        symbolIDs[i] = entrySymbolIDs[documentSymbolID];
+    }
+    free(entrySymbolIDs);
+    uint32_t endOffset = (uint32_t)symbolBytes.length;
+    [symbolOffsets appendBytes:&endOffset length:sizeof(endOffset)];
+    
+    TTMParseCacheHeader header = {0};
+    header.magic = CacheMagic;
+    header.version = CacheVersion;
+    header.fileSize = entry.fileData.length;
+    header.modificationTime = modificationTime;
+    HashData(entry.fileData, header.contentHash);
+    header.taskCount = (uint32_t)(entry.cachedTasks.length / sizeof(TTMCachedTask));
+    header.symbolIDCount = (uint32_t)symbolIDCount;
+    header.symbolCount = symbolCount;
+    header.symbolBytesLength = (uint32_t)symbolBytes.length;
+    
+    NSMutableData *encodedEntry = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [encodedEntry appendData:entry.cachedTasks];
+    [encodedEntry appendData:renumberedSymbolIDs];
+    [encodedEntry appendData:symbolOffsets];
+    [encodedEntry appendData:symbolBytes];
+    return encodedEntry;
+}
+
+- (void)storeEntry:(TTMParseCacheEntry*)entry forFileURL:(NSURL*)fileURL {
+    if (entry == nil || fileURL == nil) {
+        return;
+    }
+    NSURL *entryURL = [self entryURLForFileURL:fileURL];
+    NSURL *directoryURL = self.directoryURL;
+    dispatch_async(self.writeQueue, ^{
+        NSData *encodedEntry = [self encodeEntry:entry
+                                modificationTime:[self modificationTimeOfFileURL:fileURL]];
+        if (encodedEntry == nil) {
+            return;
+        }
+        [[NSFileManager defaultManager] createDirectoryAtURL:directoryURL
+                                 withIntermediateDirectories:YES
+                                                  attributes:nil
+                                                       error:nil];
+        [encodedEntry writeToURL:entryURL atomically:YES];
+        [self evictEntriesOverByteLimitKeepingEntryAtURL:entryURL];
+    });
+}
+
+- (void)waitForPendingWrites {
+    dispatch_sync(self.writeQueue, ^{});
+}
+
+#pragma mark - Evicting Entries
+
+- (void)markEntryUsedAtURL:(NSURL*)entryURL {
+    // An entry's modification date is when it was last written or read.
+    dispatch_async(self.writeQueue, ^{
+        [entryURL setResourceValue:[NSDate date] forKey:NSURLContentModificationDateKey error:nil];
+    });
+}
+
+- (void)evictEntriesOverByteLimitKeepingEntryAtURL:(NSURL*)keptEntryURL {
+    NSArray *keys = @[NSURLContentModificationDateKey, NSURLFileSizeKey];
+    NSArray *entryURLs = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:self.directoryURL
+                                                       includingPropertiesForKeys:keys
+                                                                          options:0
+                                                                            error:nil];
+    NSMutableArray *evictableURLs = [NSMutableArray array];
+    NSMutableDictionary *dates = [NSMutableDictionary dictionary];
+    NSMutableDictionary *sizes = [NSMutableDictionary dictionary];
+    unsigned long long totalSize = 0;
+    for (NSURL *entryURL in entryURLs) {
+        if (![[entryURL pathExtension] isEqualToString:EntryPathExtension]) {
+            continue;
+        }
+        NSDictionary *values = [entryURL resourceValuesForKeys:keys error:nil];
+        totalSize += [values[NSURLFileSizeKey] unsignedLongLongValue];
+        if (![[entryURL lastPathComponent] isEqualToString:[keptEntryURL lastPathComponent]]) {
+            [evictableURLs addObject:entryURL];
+            dates[entryURL] = values[NSURLContentModificationDateKey] ?: [NSDate distantPast];
+            sizes[entryURL] = values[NSURLFileSizeKey] ?: @0;
+        }
+    }
+    
+    // Delete the least recently used entries first.
+    [evictableURLs sortUsingComparator:^NSComparisonResult(NSURL *a, NSURL *b) {
+        return [dates[a] compare:dates[b]];
+    }];
+    unsigned long long byteLimit = self.byteLimit;
+    for (NSURL *entryURL in evictableURLs) {
+        if (totalSize <= byteLimit) {
+            break;
+        }
+        if ([[NSFileManager defaultManager] removeItemAtURL:entryURL error:nil]) {
+            totalSize -= [sizes[entryURL] unsignedLongLongValue];
+        }
+    }
+}
+
+@end
@@ -0,0 +1,103 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*! A small integer that stands for an interned project or context string. */
+typedef uint32_t TTMSymbolID;
+
+/*!
+ * @class TTMSymbolTable
+ * @abstract TTMSymbolTable assigns a small integer ID to every distinct "+project" and
+ * "@context" string in a task list.
+ * @discussion Each document owns one symbol table, which is shared by all of its tasks.
+ * Tasks store the IDs of their projects and contexts instead of their own copies of the
+ * strings.
+ * IDs are assigned in order starting from zero and are never reused. All methods
+ * may be called from any thread.
+ */
+@interface TTMSymbolTable : NSObject
+
+/*!
+ * @method defaultSymbolTable
+ * @abstract Returns the symbol table used by tasks that do not belong to a document.
+ * @return The shared default symbol table.
+ */
++ (TTMSymbolTable*)defaultSymbolTable;
+
+/*!
+ * @method internSymbol:
+ * @abstract Returns the ID of a symbol, assigning the next ID if the symbol is new.
+ * @param symbol A project or context, such as "+Chores".
+ * @return The symbol's ID.
+ */
+- (TTMSymbolID)internSymbol:(NSString*)symbol;
+
+/*!
+ * @method symbolForID:
+ * @abstract Returns the symbol that was assigned an ID.
+ * @param symbolID An ID returned by internSymbol:.
+ * @return The symbol string. Every call returns the same instance for the same ID.
+ */
+- (NSString*)symbolForID:(TTMSymbolID)symbolID;
+
+/*!
+ * @method internString:
+ * @abstract Returns a shared instance of a string that is equal to the string passed in.
+ * @param string Any string, such as a task's comma-separated list of projects.
+ * @return A string equal to string. Equal strings return the same instance.
+ * @discussion Interned strings do not get symbol IDs.
+ */
+- (NSString*)internString:(NSString*)string;
+
+/*!
+ * @method count
+ * @abstract Returns the number of symbols in the table.
+ * @return The number of symbols, which is one more than the highest ID assigned.
+ */
+- (NSUInteger)count;
+
+@end
@@ -0,0 +1,127 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMSymbolTable.h"
+#import <pthread.h>
+
+@interface TTMSymbolTable () {
+    pthread_mutex_t _lock;
+}
+
+@property (nonatomic) NSMutableDictionary *symbolIDs;
+@property (nonatomic) NSMutableArray *symbols;
+@property (nonatomic) NSMutableDictionary *strings;
+
+@end
+
+@implementation TTMSymbolTable
+
++ (TTMSymbolTable*)defaultSymbolTable {
+    static TTMSymbolTable *defaultSymbolTable = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        defaultSymbolTable = [[TTMSymbolTable alloc] init];
+    });
+    return defaultSymbolTable;
+}
+
+- (id)init {
+    self = [super init];
+    if (self) {
+        pthread_mutex_init(&_lock, NULL);
+        _symbolIDs = [[NSMutableDictionary alloc] init];
+        _symbols = [[NSMutableArray alloc] init];
+        _strings = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (TTMSymbolID)internSymbol:(NSString*)symbol {
+    pthread_mutex_lock(&_lock);
+    NSNumber *symbolID = self.symbolIDs[symbol];
+    if (symbolID == nil) {
+        NSString *storedSymbol = [symbol copy];
+        symbolID = @((TTMSymbolID)self.symbols.count);
+        [self.symbols addObject:storedSymbol];
+        self.symbolIDs[storedSymbol] = symbolID;
+    }
+    pthread_mutex_unlock(&_lock);
+    return (TTMSymbolID)[symbolID unsignedIntValue];
+}
+
+- (NSString*)symbolForID:(TTMSymbolID)symbolID {
+    pthread_mutex_lock(&_lock);
+    NSString *symbol = self.symbols[symbolID];
+    pthread_mutex_unlock(&_lock);
+    return symbol;
+}
+
+- (NSString*)internString:(NSString*)string {
+    if (string == nil) {
+        return nil;
+    }
+    pthread_mutex_lock(&_lock);
+    NSString *storedString = self.strings[string];
+    if (storedString == nil) {
+        storedString = [string copy];
+        self.strings[storedString] = storedString;
+    }
+    pthread_mutex_unlock(&_lock);
+    return storedString;
+}
+
+- (NSUInteger)count {
+    pthread_mutex_lock(&_lock);
+    NSUInteger count = self.symbols.count;
+    pthread_mutex_unlock(&_lock);
+    return count;
+}
+
+@end
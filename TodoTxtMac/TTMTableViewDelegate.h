@@ -44,8 +44,9 @@
  * THE SOFTWARE.
  */
 
-#import <Foundation/Foundation.h>
+#import <Cocoa/Cocoa.h>
 @class TTMTask;
+@class TTMDisplayTextCache;
 
 @interface TTMTableViewDelegate : NSObject <NSTableViewDelegate>
 
@@ -53,4 +54,23 @@
 
 @property (nonatomic, retain) IBOutlet NSArrayController *arrayController;
 
+/*! The display texts of recently drawn tasks. */
+@property (nonatomic, readonly) TTMDisplayTextCache *displayTextCache;
+
+/*! Changes whenever the user changes the highlight colors. */
+@property (nonatomic, readonly) NSUInteger colorSchemeGeneration;
+
+#pragma mark - Display Text Methods
+
+/*!
+ * @method displayTextOfTask:selected:font:
+ * @abstract Makes the attributed text drawn in a task's row, or reuses the text made the
+ * last time the row was drawn if the task, font and highlight colors are unchanged.
+ * @param task The task.
+ * @param selected Whether the task's row is selected.
+ * @param font The font to draw the text in.
+ * @return The task's display text.
+ */
+- (NSAttributedString*)displayTextOfTask:(TTMTask*)task selected:(BOOL)selected font:(NSFont*)font;
+
 @end
@@ -47,10 +47,126 @@
 #import "TTMTableViewDelegate.h"
 #import "RegExCategories.h"
 #import "TTMTask.h"
+#import "TTMDisplayTextCache.h"
 #import "NSUserDefaults+myColorSupport.h"
 
+// The most bytes of display text to hold for drawing rows again.
+static const NSUInteger DisplayTextCacheByteLimit = 4 * 1024 * 1024;
+
+@interface TTMTableViewDelegate ()
+
+/*! The highlight colors and whether to use them, as last read from the user defaults. */
+@property (nonatomic) NSDictionary *colorScheme;
+
+@end
+
 @implementation TTMTableViewDelegate
 
+#pragma mark - Init Methods
+
+- (id)init {
+    self = [super init];
+    if (self) {
+        _displayTextCache = [[TTMDisplayTextCache alloc] initWithByteLimit:DisplayTextCacheByteLimit];
+        _colorScheme = [self currentColorScheme];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(userDefaultsDidChange:)
+                                                     name:NSUserDefaultsDidChangeNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Color Scheme Methods
+
+- (void)userDefaultsDidChange:(NSNotification*)notification {
+    // Any preference may have changed; only a change of highlight colors makes the held
+    // display texts out of date.
+    NSDictionary *colorScheme = [self currentColorScheme];
+    if (![colorScheme isEqualToDictionary:self.colorScheme]) {
+        self.colorScheme = colorScheme;
+        _colorSchemeGeneration++;
+        [self.displayTextCache removeAllDisplayTexts];
+    }
+}
+
+- (NSDictionary*)currentColorScheme {
+    // Get the user's preferred highlight colors or the defaults.
+    NSUserDefaults *userDefaults = [NSUserDefaults standardUserDefaults];
+    return @{@"useHighlightColorsInTaskList" :
+                 @([userDefaults boolForKey:@"useHighlightColorsInTaskList"]),
+             @"completedColor" : [NSColor lightGrayColor],
+             @"dueTodayColor" : [self colorForKey:@"dueTodayColor"
+                                  ifUserDefaultIsSet:@"useCustomColorForDueTodayTasks"
+                                         otherwise:[NSColor redColor]],
+             @"overdueColor" : [self colorForKey:@"overdueColor"
+                                 ifUserDefaultIsSet:@"useCustomColorForOverdueTasks"
+                                        otherwise:[NSColor purpleColor]],
+             @"projectColor" : [self colorForKey:@"projectColor"
+                                 ifUserDefaultIsSet:@"useCustomColorForProjects"
+                                        otherwise:[NSColor darkGrayColor]],
+             @"contextColor" : [self colorForKey:@"contextColor"
+                                 ifUserDefaultIsSet:@"useCustomColorForContexts"
+                                        otherwise:[NSColor darkGrayColor]],
+             @"tagColor" : [self colorForKey:@"tagColor"
+                             ifUserDefaultIsSet:@"useCustomColorForTags"
+                                    otherwise:[NSColor darkGrayColor]],
+             @"dueDateColor" : [self colorForKey:@"dueDateColor"
+                                 ifUserDefaultIsSet:@"useCustomColorForDueDates"
+                                        otherwise:[NSColor darkGrayColor]],
+             @"thresholdDateColor" : [self colorForKey:@"thresholdDateColor"
+                                       ifUserDefaultIsSet:@"useCustomColorForThresholdDates"
+                                              otherwise:[NSColor darkGrayColor]],
+             @"creationDateColor" : [self colorForKey:@"creationDateColor"
+                                      ifUserDefaultIsSet:@"useCustomColorForCreationDates"
+                                             otherwise:[NSColor darkGrayColor]]
+             };
+}
+
+- (NSColor*)colorForKey:(NSString*)colorKey
+     ifUserDefaultIsSet:(NSString*)flagKey
+              otherwise:(NSColor*)defaultColor {
+    NSUserDefaults *userDefaults = [NSUserDefaults standardUserDefaults];
+    NSColor *color = [userDefaults boolForKey:flagKey] ? [userDefaults colorForKey:colorKey] : nil;
+    return (color != nil) ? color : defaultColor;
+}
+
+#pragma mark - Display Text Methods
+
+- (NSAttributedString*)displayTextOfTask:(TTMTask*)task selected:(BOOL)selected font:(NSFont*)font {
+    NSAttributedString *displayText = [self.displayTextCache displayTextOfTask:task
+                                                                      selected:selected
+                                                                          font:font
+                                                         colorSchemeGeneration:self.colorSchemeGeneration];
+    if (displayText != nil) {
+        return displayText;
+    }
+    
+    NSDictionary *colorScheme = self.colorScheme;
+    displayText = [task displayText:selected
+                               font:font
+       useHighlightColorsInTaskList:[colorScheme[@"useHighlightColorsInTaskList"] boolValue]
+                     completedColor:colorScheme[@"completedColor"]
+                      dueTodayColor:colorScheme[@"dueTodayColor"]
+                       overdueColor:colorScheme[@"overdueColor"]
+                       projectColor:colorScheme[@"projectColor"]
+                       contextColor:colorScheme[@"contextColor"]
+                           tagColor:colorScheme[@"tagColor"]
+                       dueDateColor:colorScheme[@"dueDateColor"]
+                 thresholdDateColor:colorScheme[@"thresholdDateColor"]
+                  creationDateColor:colorScheme[@"creationDateColor"]];
+    [self.displayTextCache setDisplayText:displayText
+                                   ofTask:task
+                                 selected:selected
+                                     font:font
+                    colorSchemeGeneration:self.colorSchemeGeneration];
+    return displayText;
+}
+
 #pragma mark - TableView Delegate Methods
 
 - (void)tableView:(NSTableView *)tableView
@@ -64,58 +180,11 @@
             return;
         }
 
-        // Get the user's preferred highlight colors or the defaults.
+        // Rows drawn again, as when scrolling, reuse the text made the last time.
         BOOL selected = ([tableView.selectedRowIndexes containsIndex:row]);
-        BOOL useHighlightColorsInTaskList = [[NSUserDefaults standardUserDefaults]
-                                             boolForKey:@"useHighlightColorsInTaskList"];
-        NSColor *completedColor = [NSColor lightGrayColor];
-        NSColor *dueTodayColor = ([[NSUserDefaults standardUserDefaults]
-                                   boolForKey:@"useCustomColorForDueTodayTasks"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"dueTodayColor"] :
-            [NSColor redColor];
-        NSColor *overdueColor = ([[NSUserDefaults standardUserDefaults]
-                                  boolForKey:@"useCustomColorForOverdueTasks"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"overdueColor"] :
-            [NSColor purpleColor];
-        NSColor *projectColor = ([[NSUserDefaults standardUserDefaults]
-                                  boolForKey:@"useCustomColorForProjects"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"projectColor"] :
-            [NSColor darkGrayColor];
-        NSColor *contextColor = ([[NSUserDefaults standardUserDefaults]
-                                  boolForKey:@"useCustomColorForContexts"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"contextColor"] :
-            [NSColor darkGrayColor];
-        NSColor *tagColor = ([[NSUserDefaults standardUserDefaults]
-                              boolForKey:@"useCustomColorForTags"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"tagColor"] :
-            [NSColor darkGrayColor];
-        NSColor *dueDateColor = ([[NSUserDefaults standardUserDefaults]
-                                  boolForKey:@"useCustomColorForDueDates"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"dueDateColor"] :
-            [NSColor darkGrayColor];
-        NSColor *thresholdDateColor = ([[NSUserDefaults standardUserDefaults]
-                                        boolForKey:@"useCustomColorForThresholdDates"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"thresholdDateColor"] :
-            [NSColor darkGrayColor];
-        NSColor *creationDateColor = ([[NSUserDefaults standardUserDefaults]
-                                        boolForKey:@"useCustomColorForCreationDates"]) ?
-            [[NSUserDefaults standardUserDefaults] colorForKey:@"creationDateColor"] :
-            [NSColor darkGrayColor];
-
-        NSAttributedString *as = [task displayText:selected
-                                              font:[cell font]
-                      useHighlightColorsInTaskList:useHighlightColorsInTaskList
-                                    completedColor:completedColor
-                                     dueTodayColor:dueTodayColor
-                                      overdueColor:overdueColor
-                                      projectColor:projectColor
-                                      contextColor:contextColor
-                                          tagColor:tagColor
-                                      dueDateColor:dueDateColor
-                                thresholdDateColor:thresholdDateColor
-                                 creationDateColor:creationDateColor];
-        
-        [cell setAttributedStringValue:as];
+        [cell setAttributedStringValue:[self displayTextOfTask:task
+                                                      selected:selected
+                                                          font:[cell font]]];
     }
 }
 
@@ -45,11 +45,17 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "TTMDateUtility.h"
+#import "TTMSymbolTable.h"
+#import "TTMTaskParser.h"
 
 /*!
  * @class TTMTask
  * @abstract TTMTask represents a single todo.txt task.
  * @discussion A single task is a single line in the todo.txt file, which is in a specific format.
+ * Setting rawText only reads the start of the line (completion and priority). The other
+ * properties are decoded in groups the first time one of them is read, and are reported to
+ * key-value observers as changing whenever rawText changes.
  * @seealso Todo.txt format specification: 
  * https://github.com/ginatrapani/todo.txt-cli/wiki/The-Todo.txt-Format
  */
@@ -71,13 +77,30 @@ typedef enum : NSUInteger {
     ThresholdAfterToday
 } TTMThresholdState;
 
+/*! The properties the task list is sorted by, gathered so they can be read in one call. */
+typedef struct {
+    unichar priority;
+    BOOL isCompleted;
+    TTMDueState dueState;
+    TTMDayNumber dueDay;
+    TTMDayNumber creationDay;
+    TTMDayNumber completionDay;
+    TTMDayNumber thresholdDay;
+} TTMTaskSortFields;
+
 #pragma mark - Properties
 
 /*! Raw text of the task (a single line in the todo.txt file) */
 @property (nonatomic, readwrite, setter = setRawText:, getter = rawText) NSString *rawText;
 
-/*! The line number in todo.txt file, starting at zero */
-@property (nonatomic, readonly) NSUInteger taskId;
+/*! The line number in todo.txt file, starting at zero. Reset when lines are inserted or
+ *  deleted above the task by an external change to the file. */
+@property (nonatomic) NSUInteger taskId;
+
+/*! An ID that identifies the task for as long as the app runs. Unlike taskId, it does not
+ *  change when the task is edited, sorted, filtered, or moved by a reload. Copies keep the
+ *  ID of the original. */
+@property (nonatomic, readonly) NSUInteger uniqueId;
 
 @property (nonatomic, readonly) NSString *fullPriorityText;
 @property (nonatomic, readonly) NSString *priorityText;
@@ -90,6 +113,18 @@ typedef enum : NSUInteger {
 @property (nonatomic, readonly) NSDate *completionDate;
 @property (nonatomic, readonly) NSString *thresholdDateText;
 @property (nonatomic, readonly) NSDate *thresholdDate;
+
+/*!
+ * Day numbers of the due, creation, completion, and threshold dates. These are the stored
+ * form of the dates above; the NSDate properties are created from them on demand.
+ * Missing dates use the same high and low dates as the NSDate properties. Blank tasks
+ * have TTMNoDayNumber.
+ */
+@property (nonatomic, readonly) TTMDayNumber dueDay;
+@property (nonatomic, readonly) TTMDayNumber creationDay;
+@property (nonatomic, readonly) TTMDayNumber completionDay;
+@property (nonatomic, readonly) TTMDayNumber thresholdDay;
+
 @property (nonatomic, readonly, copy) NSArray *contextsArray;
 @property (nonatomic, readonly, copy) NSString *contexts;
 @property (nonatomic, readonly) BOOL hasContexts;
@@ -105,6 +140,52 @@ typedef enum : NSUInteger {
 @property (nonatomic, readonly) NSString *recurrencePattern;
 @property (nonatomic, readonly) BOOL isHidden;
 
+/*!
+ * The symbol table that the task's projects and contexts are interned in. Documents set
+ * this to their own table; tasks without one use [TTMSymbolTable defaultSymbolTable].
+ */
+@property (nonatomic, strong) TTMSymbolTable *symbolTable;
+
+/*! Symbol IDs of the task's projects, in the same order as projectsArray. */
+@property (nonatomic, readonly) const TTMSymbolID *projectIDs;
+@property (nonatomic, readonly) NSUInteger projectIDCount;
+
+/*! Symbol IDs of the task's contexts, in the same order as contextsArray. */
+@property (nonatomic, readonly) const TTMSymbolID *contextIDs;
+@property (nonatomic, readonly) NSUInteger contextIDCount;
+
+/*! The ranges and flags found by scanning rawText. Reading it scans the body if needed. */
+@property (nonatomic, readonly) TTMTaskScanResult scanResult;
+
+/*! The properties TTMTaskSorter sorts by. They are gathered when the dates are decoded. */
+@property (nonatomic, readonly) TTMTaskSortFields sortFields;
+
+/*!
+ * The TTMCollator key of rawText, which sorts tasks alphabetically. It is made the first
+ * time it is read, and again after rawText or the user's locale changes.
+ */
+@property (nonatomic, readonly) NSData *rawTextCollationKey;
+
+/*!
+ * rawText folded case- and diacritic-insensitively, which compiled filter predicates search
+ * instead of folding rawText for every comparison. It is made the first time it is read.
+ */
+@property (nonatomic, readonly) NSString *foldedRawText;
+
+/*!
+ * A number that changes every time rawText changes. Revisions are handed out in increasing
+ * order to all tasks from one counter, so a revision newer than latestRawTextRevision was
+ * at some point means the task has changed since then. Copies keep the revision.
+ */
+@property (nonatomic, readonly) NSUInteger rawTextRevision;
+
+/*!
+ * @method latestRawTextRevision
+ * @abstract Returns the revision most recently given to any task's raw text.
+ * @return The latest revision, which is zero before any task has been created.
+ */
++ (NSUInteger)latestRawTextRevision;
+
 #pragma mark - Init Methods
 
 /*!
@@ -134,6 +215,48 @@ typedef enum : NSUInteger {
  */
 - (id)initWithRawText:(NSString*)rawText withTaskId:(NSInteger)taskId;
 
+/*!
+ * @method initWithRawText:withTaskId:scanResult:symbolTable:projectIDs:count:contextIDs:count:
+ * @abstract Initializes a task from previously parsed state, without scanning its text.
+ * @discussion TTMParseCache uses this to restore tasks from a cache of an unchanged file.
+ * The caller must make sure the parsed state came from the same raw text.
+ * @param rawText The raw text of a non-blank task.
+ * @param taskId An integer that represents the task's line number (ID) in the todo.txt file.
+ * @param scanResult The scanResult of a task with the same raw text.
+ * @param symbolTable The symbol table that the project and context IDs belong to.
+ * @param projectIDs The task's project IDs, sorted by project name.
+ * @param projectIDCount The number of project IDs.
+ * @param contextIDs The task's context IDs, sorted by context name.
+ * @param contextIDCount The number of context IDs.
+ * @result Returns the newly initiatized object.
+ */
+- (id)initWithRawText:(NSString*)rawText
+           withTaskId:(NSInteger)taskId
+           scanResult:(TTMTaskScanResult)scanResult
+          symbolTable:(TTMSymbolTable*)symbolTable
+           projectIDs:(const TTMSymbolID*)projectIDs count:(NSUInteger)projectIDCount
+           contextIDs:(const TTMSymbolID*)contextIDs count:(NSUInteger)contextIDCount;
+
+/*!
+ * @method decodeSortAndFilterFields
+ * @abstract Decodes the dates, projects, and contexts now instead of on first read.
+ * @discussion Loading calls this on background threads, because the first sort, filter,
+ * and metadata pass read these fields from every task. Recurrence is still decoded on
+ * first read. A task must not be used on another thread while this runs.
+ */
+- (void)decodeSortAndFilterFields;
+
+/*!
+ * @method arrangementCopy
+ * @abstract Returns a copy of the task for sorting and filtering on a background queue.
+ * @discussion The task decodes its sort and filter fields before it makes the copy, so
+ * that the task and the copy both keep them. The same copy is returned until rawText,
+ * taskId, or the symbol table changes. Call this on the thread that owns the task. Only
+ * one background thread at a time may read the copy.
+ * @return A copy of the task that does not change.
+ */
+- (TTMTask*)arrangementCopy;
+
 #pragma mark - rawText Methods
 
 /*!
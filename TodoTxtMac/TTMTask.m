@@ -49,19 +49,90 @@
 #import "TTMDateUtility.h"
 #import "NSMutableAttributableString+ColorRegExMatches.h"
 #import "NSDate+RelativeDates.h"
+#import "TTMTaskParser.h"
+#import "TTMCollator.h"
+#import <stdatomic.h>
+
+/*! Groups of properties that are decoded from rawText together, on first use. */
+typedef NS_OPTIONS(NSUInteger, TTMTaskFieldGroup) {
+    TTMTaskFieldGroupBody = 1 << 0,
+    TTMTaskFieldGroupDates = 1 << 1,
+    TTMTaskFieldGroupProjectsAndContexts = 1 << 2,
+    TTMTaskFieldGroupRecurrence = 1 << 3,
+    TTMTaskFieldGroupAll = 0xF
+};
+
+/*! Reference-counted, immutable block holding a task's project IDs followed by its context IDs.
+ *  Copies of a task share the block with the original until either of them changes rawText. */
+typedef struct {
+    _Atomic(NSUInteger) retainCount;
+    TTMSymbolID symbolIDs[];
+} TTMSymbolIDStorage;
+
+static TTMSymbolIDStorage *SymbolIDStorageCreate(NSUInteger count) {
+    if (count == 0) {
+        return NULL;
+    }
+    TTMSymbolIDStorage *storage = malloc(sizeof(TTMSymbolIDStorage) + count * sizeof(TTMSymbolID));
+    atomic_init(&storage->retainCount, 1);
+    return storage;
+}
+
+static TTMSymbolIDStorage *SymbolIDStorageRetain(TTMSymbolIDStorage *storage) {
+    if (storage != NULL) {
+        atomic_fetch_add_explicit(&storage->retainCount, 1, memory_order_relaxed);
+    }
+    return storage;
+}
+
+static void SymbolIDStorageRelease(TTMSymbolIDStorage *storage) {
+    if (storage != NULL &&
+        atomic_fetch_sub_explicit(&storage->retainCount, 1, memory_order_acq_rel) == 1) {
+        free(storage);
+    }
+}
+
+@interface TTMTask () {
+    TTMTaskScanResult _scan;
+    TTMTaskFieldGroup _decodedFieldGroups;
+    TTMTaskSortFields _sortFields;
+    NSData *_rawTextCollationKey;
+    NSUInteger _rawTextCollationGeneration;
+    NSUInteger _symbolsCollationGeneration;
+    NSString *_foldedRawText;
+    TTMTask *_arrangementCopy;
+    TTMSymbolIDStorage *_symbolIDStorage;
+    const TTMSymbolID *_projectIDs;
+    NSUInteger _projectIDCount;
+    const TTMSymbolID *_contextIDs;
+    NSUInteger _contextIDCount;
+}
+
+@end
 
 @implementation TTMTask
 
 @synthesize rawText=_rawText;
+@synthesize dueDateText=_dueDateText;
+@synthesize dueDay=_dueDay;
+@synthesize creationDateText=_creationDateText;
+@synthesize creationDay=_creationDay;
+@synthesize thresholdDateText=_thresholdDateText;
+@synthesize thresholdDay=_thresholdDay;
+@synthesize dueState=_dueState;
+@synthesize thresholdState=_thresholdState;
+@synthesize projects=_projects;
+@synthesize contexts=_contexts;
+@synthesize isRecurring=_isRecurring;
+@synthesize recurrencePattern=_recurrencePattern;
+@synthesize isHidden=_isHidden;
 
 // define constants for regular expressions
 static NSString * const LineBreakPattern = @"(\\r|\\n)";
 static NSString * const CompletedPattern = @"^x[ ]((\\d{4})-(\\d{2})-(\\d{2}))[ ]";
-static NSString * const CompletionDatePattern = @"(?<=^x[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
 static NSString * const PriorityTextPattern = @"^(\\([A-Z]\\)[ ])";
 static NSString * const CreationDatePatternIncomplete = @"(?<=^|\\([A-Z]\\)[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
 static NSString * const CreationDatePatternIncompletePlusTrailingSpace = @"(?<=^|\\([A-Z]\\)[ ])((\\d{4})-(\\d{2})-(\\d{2}))([ ]|$)";
-static NSString * const CreationDatePatternCompleted = @"(?<=^x[ ]((\\d{4})-(\\d{2})-(\\d{2}))[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
 static NSString * const CreationDatePatternCompletedPlusTrailingSpace = @"(?<=^x[ ]((\\d{4})-(\\d{2})-(\\d{2}))[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
 static NSString * const DueDatePattern = @"(?<=(^|[ ])due:)((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
 static NSString * const FullDueDatePatternMiddleOrEnd = @"(([ ])due:)((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
@@ -72,8 +143,21 @@ static NSString * const FullThresholdDatePatternBeginning = @"^t:((\\d{4})-(\\d{
 static NSString * const ProjectPattern = @"(?<=^|[ ])(\\+[^[ ]]+)";
 static NSString * const ContextPattern = @"(?<=^|[ ])(\\@[^[ ]]+)";
 static NSString * const TagPattern = @"(?<=^|[ ])([:graph:]+:[:graph:]+)";
-static NSString * const RecurrencePattern = @"(?<=(^|[ ])rec:)((\\+?)\\d+[dDwWmMyYbB])";
-static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
+
+// Tasks are created on several threads while a file loads, so unique IDs are handed out
+// atomically. Zero is never used.
+static _Atomic(NSUInteger) LastUniqueId = 0;
+
+static NSUInteger NextUniqueId(void) {
+    return atomic_fetch_add_explicit(&LastUniqueId, 1, memory_order_relaxed) + 1;
+}
+
+// Every change to any task's raw text takes the next revision. Zero is never used.
+static _Atomic(NSUInteger) LastRawTextRevision = 0;
+
+static NSUInteger NextRawTextRevision(void) {
+    return atomic_fetch_add_explicit(&LastRawTextRevision, 1, memory_order_relaxed) + 1;
+}
 
 
 #pragma mark - Init Methods
@@ -83,6 +167,7 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
     self = [super init];
     if (self) {
         
+        _uniqueId = NextUniqueId();
         _taskId = taskId;
         [self setRawText:rawText withPrependedDate:prependedDate];
         
@@ -95,21 +180,116 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
     return [self initWithRawText:rawText withTaskId:taskId withPrependedDate:nil];
 }
 
+- (id)initWithRawText:(NSString*)rawText
+           withTaskId:(NSInteger)taskId
+           scanResult:(TTMTaskScanResult)scanResult
+          symbolTable:(TTMSymbolTable*)symbolTable
+           projectIDs:(const TTMSymbolID*)projectIDs count:(NSUInteger)projectIDCount
+           contextIDs:(const TTMSymbolID*)contextIDs count:(NSUInteger)contextIDCount {
+    self = [super init];
+    if (self) {
+        _uniqueId = NextUniqueId();
+        _taskId = taskId;
+        _rawText = [self stringWithoutLineBreaks:rawText];
+        _rawTextRevision = NextRawTextRevision();
+        _isBlank = NO;
+        _symbolTable = symbolTable;
+        _scan = scanResult;
+        _isHidden = _scan.isHidden;
+        [self decodeHeader];
+        
+        TTMSymbolIDStorage *storage = SymbolIDStorageCreate(projectIDCount + contextIDCount);
+        if (storage != NULL) {
+            memcpy(storage->symbolIDs, projectIDs, projectIDCount * sizeof(TTMSymbolID));
+            memcpy(storage->symbolIDs + projectIDCount, contextIDs,
+                   contextIDCount * sizeof(TTMSymbolID));
+        }
+        [self setSymbolIDStorage:storage projectIDCount:projectIDCount
+                  contextIDCount:contextIDCount];
+        symbolTable = self.symbolTable;
+        _projects = [symbolTable internString:[[self symbolsForIDs:projectIDs count:projectIDCount]
+                                               componentsJoinedByString:@", "]];
+        _contexts = [symbolTable internString:[[self symbolsForIDs:contextIDs count:contextIDCount]
+                                               componentsJoinedByString:@", "]];
+        // The stored order may be another locale's, so it is checked on first read.
+        _symbolsCollationGeneration = 0;
+        // Dates and recurrence are still decoded on first read, but from the stored ranges.
+        _decodedFieldGroups = TTMTaskFieldGroupBody | TTMTaskFieldGroupProjectsAndContexts;
+    }
+    return self;
+}
+
+- (id)initWithParsedStateOfTask:(TTMTask*)task {
+    self = [super init];
+    if (self) {
+        // Every field is either a value or an immutable object, so the copy shares them
+        // with the original; setRawText: replaces them rather than changing them in place.
+        _uniqueId = task->_uniqueId;
+        _taskId = task->_taskId;
+        _rawText = task->_rawText;
+        _rawTextRevision = task->_rawTextRevision;
+        _symbolTable = task->_symbolTable;
+        _scan = task->_scan;
+        _decodedFieldGroups = task->_decodedFieldGroups;
+        _sortFields = task->_sortFields;
+        _rawTextCollationKey = task->_rawTextCollationKey;
+        _rawTextCollationGeneration = task->_rawTextCollationGeneration;
+        _symbolsCollationGeneration = task->_symbolsCollationGeneration;
+        _foldedRawText = task->_foldedRawText;
+        _isBlank = task->_isBlank;
+        _isCompleted = task->_isCompleted;
+        _isPrioritized = task->_isPrioritized;
+        _fullPriorityText = task->_fullPriorityText;
+        _priorityText = task->_priorityText;
+        _priority = task->_priority;
+        _completionDateText = task->_completionDateText;
+        _completionDay = task->_completionDay;
+        _dueDateText = task->_dueDateText;
+        _dueDay = task->_dueDay;
+        _creationDateText = task->_creationDateText;
+        _creationDay = task->_creationDay;
+        _thresholdDateText = task->_thresholdDateText;
+        _thresholdDay = task->_thresholdDay;
+        _dueState = task->_dueState;
+        _thresholdState = task->_thresholdState;
+        _projects = task->_projects;
+        _contexts = task->_contexts;
+        _isRecurring = task->_isRecurring;
+        _recurrencePattern = task->_recurrencePattern;
+        _isHidden = task->_isHidden;
+        [self setSymbolIDStorage:SymbolIDStorageRetain(task->_symbolIDStorage)
+                  projectIDCount:task->_projectIDCount
+                  contextIDCount:task->_contextIDCount];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    SymbolIDStorageRelease(_symbolIDStorage);
+}
+
 #pragma mark - rawText Methods
 
 - (void)setRawText:(NSString*)rawText withPrependedDate:(NSDate*)prependedDate {
+    if (!prependedDate) {
+        [self setRawText:rawText];
+        return;
+    }
+    
     NSString *newRawText;
+    TTMTaskScanResult scan;
+    [TTMTaskParser scanString:rawText result:&scan projects:nil contexts:nil tags:nil];
     
     if (!prependedDate ||
-        [rawText isMatch:RX(CreationDatePatternIncomplete)] ||
-        [rawText isMatch:RX(CreationDatePatternCompleted)] ||
-        [rawText isMatch:RX(CompletedPattern)]
+        scan.creationDateRange.location != NSNotFound ||
+        scan.completedCreationDateRange.location != NSNotFound ||
+        scan.hasCompletedPrefix
         ) {
 
         // if no prepended date is passed, or if there is already a creation date, or the task is already completed, prepend nothing
         newRawText = rawText;
     
-    } else if ([rawText isMatch:RX(PriorityTextPattern)]) {
+    } else if (scan.priorityRange.location != NSNotFound) {
         
         // if the rawText has a priority, prepend the date after the priority
         newRawText = [NSString stringWithFormat:@"%@%@%c%@",
@@ -137,7 +317,10 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
     }
     
     // make sure the task doesn't contain line breaks
-    _rawText = [rawText replace:RX(LineBreakPattern) with:@""];
+    _rawText = [self stringWithoutLineBreaks:rawText];
+    _rawTextRevision = NextRawTextRevision();
+    _rawTextCollationKey = nil;
+    _foldedRawText = nil;
 
     // handle blank strings gracefully
     if (rawText == nil || [rawText isEqualToString:@""]) {
@@ -147,104 +330,151 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
         _priorityText = @"";
         _priority = '~';
         _contexts = @"";
-        _contextsArray = nil;
         _projects = @"";
-        _projectsArray = nil;
+        [self setSymbolIDStorage:NULL projectIDCount:0 contextIDCount:0];
         _completionDateText = @"";
-        _completionDate = nil;
+        _completionDay = TTMNoDayNumber;
         _dueDateText = @"";
-        _dueDate = nil;
+        _dueDay = TTMNoDayNumber;
         _creationDateText = @"";
-        _creationDate = nil;
+        _creationDay = TTMNoDayNumber;
         _thresholdDateText = @"";
-        _thresholdDate = nil;
+        _thresholdDay = TTMNoDayNumber;
         _dueState = NotDue;
-        _hasContexts = NO;
-        _hasProjects = NO;
         _isRecurring = NO;
         _recurrencePattern = nil;
         _isHidden = NO;
+        _decodedFieldGroups = TTMTaskFieldGroupAll;
+        [self gatherSortFields];
         return;
     }
     
     // set properties for non-blank strings
     _isBlank = NO;
     
+    // Only the start of the line is scanned here. The rest of the line is scanned, and
+    // each group of properties decoded, the first time one of those properties is read.
+    _decodedFieldGroups = 0;
+    [TTMTaskParser scanHeaderOfString:_rawText result:&_scan];
+    [self decodeHeader];
+}
+
+- (NSString*)stringWithoutLineBreaks:(NSString*)string {
+    static NSCharacterSet *lineBreaks = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        lineBreaks = [NSCharacterSet characterSetWithCharactersInString:@"\r\n"];
+    });
+    if (string == nil || [string rangeOfCharacterFromSet:lineBreaks].location == NSNotFound) {
+        return string;
+    }
+    return [string replace:RX(LineBreakPattern) with:@""];
+}
+
+- (void)decodeHeader {
     // completion date
-    _completionDateText = [_rawText firstMatch:RX(CompletionDatePattern)];
+    _completionDateText = [self rawTextSubstringWithRange:_scan.completionDateRange];
     // Set completion date to the high date (9999-12-31) to ensure that tasks with no
     // completion date are sorted after tasks with a due date.
-    NSDate *newCompletionDate = (_completionDateText == nil) ?
-        [TTMDateUtility convertStringToDate:@"9999-12-31"] :
-        [TTMDateUtility convertStringToDate:_completionDateText];
-    _completionDate = (newCompletionDate == nil) ?
-        [TTMDateUtility convertStringToDate:@"9999-12-31"] :
-        newCompletionDate;
-    _isCompleted = [_rawText isMatch:RX(CompletedPattern)] && (newCompletionDate != nil);
+    TTMDayNumber completionDay = [TTMDateUtility dayNumberFromString:_rawText
+                                                               range:_scan.completionDateRange];
+    _completionDay = (completionDay == TTMNoDayNumber) ? TTMHighDayNumber : completionDay;
+    // The completed prefix always contains the completion date, so it must be a valid date.
+    _isCompleted = _scan.hasCompletedPrefix && (completionDay != TTMNoDayNumber);
     
     // priority
-    _isPrioritized = [_rawText isMatch:RX(PriorityTextPattern)];
-    _fullPriorityText = [_rawText firstMatch:RX(PriorityTextPattern)];
+    _isPrioritized = (_scan.priorityRange.location != NSNotFound);
+    _fullPriorityText = [self rawTextSubstringWithRange:_scan.priorityRange];
     NSRange range = {.location = 1, .length = 1};
     _priorityText = [_fullPriorityText substringWithRange:range];
     // Set priority to tilde (~) to ensure that tasks with no priority are sorted after
     // tasks with any other priority (A-Z).
     _priority = (_priorityText != nil) ? [_priorityText characterAtIndex:0] : '~';
-    
-    // sorted array of projects
-    _projectsArray = [[_rawText matches:RX(ProjectPattern)]
-                      sortedArrayUsingSelector:@selector(localizedCaseInsensitiveCompare:)];
-    _projects = [_projectsArray componentsJoinedByString:@", "];
-    _hasProjects = (_projectsArray.count > 0);
+}
 
-    // sorted array of contexts
-    _contextsArray = [[_rawText matches:RX(ContextPattern)]
-                      sortedArrayUsingSelector:@selector(localizedCaseInsensitiveCompare:)];
-    _contexts = [_contextsArray componentsJoinedByString:@", "];
-    _hasContexts = (_contextsArray.count > 0);
+- (NSString*)rawTextSubstringWithRange:(NSRange)range {
+    return (range.location == NSNotFound) ? nil : [_rawText substringWithRange:range];
+}
+
+- (NSString*)rawText {
+    return _rawText;
+}
+
+#pragma mark - Lazy Decoding Methods
+
++ (NSSet*)keyPathsForValuesAffectingValueForKey:(NSString*)key {
+    // Every property other than taskId is derived from rawText.
+    static NSSet *derivedKeys = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        derivedKeys = [NSSet setWithArray:@[@"fullPriorityText", @"priorityText", @"priority",
+            @"dueDateText", @"dueDate", @"dueDay", @"creationDateText", @"creationDate",
+            @"creationDay", @"completionDateText", @"completionDate", @"completionDay",
+            @"thresholdDateText", @"thresholdDate", @"thresholdDay", @"contextsArray",
+            @"contexts", @"hasContexts", @"projectsArray", @"projects", @"hasProjects",
+            @"dueState", @"thresholdState", @"isCompleted", @"isPrioritized", @"isBlank",
+            @"isRecurring", @"recurrencePattern", @"isHidden"]];
+    });
+    NSSet *keyPaths = [super keyPathsForValuesAffectingValueForKey:key];
+    if ([derivedKeys containsObject:key]) {
+        keyPaths = [keyPaths setByAddingObject:@"rawText"];
+    }
+    return keyPaths;
+}
+
+- (void)scanBodyIfNeeded {
+    if (_decodedFieldGroups & TTMTaskFieldGroupBody) {
+        return;
+    }
+    _decodedFieldGroups |= TTMTaskFieldGroupBody;
+    [TTMTaskParser scanString:_rawText result:&_scan projects:nil contexts:nil tags:nil];
+    _isHidden = _scan.isHidden;
+}
+
+- (void)decodeDatesIfNeeded {
+    if (_decodedFieldGroups & TTMTaskFieldGroupDates) {
+        return;
+    }
+    [self scanBodyIfNeeded];
+    _decodedFieldGroups |= TTMTaskFieldGroupDates;
     
     // due date
-    _dueDateText = [_rawText firstMatch:RX(DueDatePattern)];
+    _dueDateText = [self rawTextSubstringWithRange:_scan.dueDateRange];
     // Set due date to the high date (9999-12-31) to ensure that tasks with no due date
     // are sorted after tasks with a due date.
-    NSDate *newDueDate = (_dueDateText == nil) ?
-        [TTMDateUtility convertStringToDate:@"9999-12-31"] :
-        [TTMDateUtility convertStringToDate:_dueDateText];
-    if (newDueDate == nil) {
-        _dueDate = [TTMDateUtility convertStringToDate:@"9999-12-31"];
-        _dueDateText = @"";
-    } else {
-        _dueDate = newDueDate;
+    _dueDay = [TTMDateUtility dayNumberFromString:_rawText range:_scan.dueDateRange];
+    if (_dueDay == TTMNoDayNumber) {
+        _dueDay = TTMHighDayNumber;
+        if (_dueDateText != nil) {
+            _dueDateText = @"";
+        }
     }
 
     // creation date
-    _creationDateText = _isCompleted ?
-        [_rawText firstMatch:RX(CreationDatePatternCompleted)] :
-        [_rawText firstMatch:RX(CreationDatePatternIncomplete)];
+    NSRange creationDateRange = _isCompleted ?
+        _scan.completedCreationDateRange :
+        _scan.creationDateRange;
+    _creationDateText = [self rawTextSubstringWithRange:creationDateRange];
     // Set creation date to the high date (9999-12-31) to ensure that tasks with no
     // creation date are sorted after tasks with a creation date.
-    NSDate *newCreationDate = (_creationDateText == nil) ?
-        [TTMDateUtility convertStringToDate:@"9999-12-31"] :
-        [TTMDateUtility convertStringToDate:_creationDateText];
-    if (newCreationDate == nil) {
-        _creationDate = [TTMDateUtility convertStringToDate:@"9999-12-31"];
-        _creationDateText = @"";
-    } else {
-        _creationDate = newCreationDate;
+    _creationDay = [TTMDateUtility dayNumberFromString:_rawText range:creationDateRange];
+    if (_creationDay == TTMNoDayNumber) {
+        _creationDay = TTMHighDayNumber;
+        if (_creationDateText != nil) {
+            _creationDateText = @"";
+        }
     }
 
     // threshold date
-    _thresholdDateText = [_rawText firstMatch:RX(ThresholdDatePattern)];
+    _thresholdDateText = [self rawTextSubstringWithRange:_scan.thresholdDateRange];
     // Set threshold date to the low date (1900-01-01) to ensure that tasks with no
     // threshold date are properly sorted/displated when filtered.
-    NSDate *newThresholdDate = (_thresholdDateText == nil) ?
-        [TTMDateUtility convertStringToDate:@"1900-01-01"] :
-        [TTMDateUtility convertStringToDate:_thresholdDateText];
-    if (newThresholdDate == nil) {
-        _thresholdDate = [TTMDateUtility convertStringToDate:@"1900-01-01"];
-        _thresholdDateText = @"";
-    } else {
-        _thresholdDate = newThresholdDate;
+    _thresholdDay = [TTMDateUtility dayNumberFromString:_rawText range:_scan.thresholdDateRange];
+    if (_thresholdDay == TTMNoDayNumber) {
+        _thresholdDay = TTMLowDayNumber;
+        if (_thresholdDateText != nil) {
+            _thresholdDateText = @"";
+        }
     }
     
     // due state (past due, due today, not due)
@@ -253,18 +483,310 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
     // threshold state (no threshold date, before, on, after threshold date)
     _thresholdState = [self getThresholdState];
     
-    // recurrence
-    _isRecurring = [_rawText isMatch:RX(RecurrencePattern)];
-    if (_isRecurring) {
-        _recurrencePattern = [rawText firstMatch:RX(RecurrencePattern)];
+    [self gatherSortFields];
+}
+
+- (void)gatherSortFields {
+    _sortFields.priority = _priority;
+    _sortFields.isCompleted = _isCompleted;
+    _sortFields.dueState = _dueState;
+    _sortFields.dueDay = _dueDay;
+    _sortFields.creationDay = _creationDay;
+    _sortFields.completionDay = _completionDay;
+    _sortFields.thresholdDay = _thresholdDay;
+}
+
+- (void)decodeProjectsAndContextsIfNeeded {
+    if (_decodedFieldGroups & TTMTaskFieldGroupProjectsAndContexts) {
+        [self resortProjectsAndContextsIfNeeded];
+        return;
     }
+    _decodedFieldGroups |= TTMTaskFieldGroupProjectsAndContexts;
     
-    // is hidden
-    _isHidden = [_rawText isMatch:RX(HiddenPattern)];
+    // Collecting projects and contexts needs a full scan, so let it stand in for the
+    // body scan if that has not happened yet.
+    NSMutableArray *projects = [[NSMutableArray alloc] init];
+    NSMutableArray *contexts = [[NSMutableArray alloc] init];
+    if (_decodedFieldGroups & TTMTaskFieldGroupBody) {
+        TTMTaskScanResult scan;
+        [TTMTaskParser scanString:_rawText result:&scan projects:projects contexts:contexts tags:nil];
+    } else {
+        _decodedFieldGroups |= TTMTaskFieldGroupBody;
+        [TTMTaskParser scanString:_rawText result:&_scan projects:projects contexts:contexts tags:nil];
+        _isHidden = _scan.isHidden;
+    }
+    [self storeProjects:projects contexts:contexts sortedBy:[TTMCollator currentCollator]];
 }
 
-- (NSString*)rawText {
-    return _rawText;
+- (void)resortProjectsAndContextsIfNeeded {
+    TTMCollator *collator = [TTMCollator currentCollator];
+    if (_isBlank || _symbolsCollationGeneration == collator.generation) {
+        return;
+    }
+    if (_projectIDCount < 2 && _contextIDCount < 2) {
+        // Nothing to reorder.
+        _symbolsCollationGeneration = collator.generation;
+        return;
+    }
+    // The symbols were sorted for another locale; sort them again without rescanning.
+    [self storeProjects:[self symbolsForIDs:_projectIDs count:_projectIDCount]
+               contexts:[self symbolsForIDs:_contextIDs count:_contextIDCount]
+               sortedBy:collator];
+}
+
+- (void)storeProjects:(NSArray*)projects contexts:(NSArray*)contexts
+             sortedBy:(TTMCollator*)collator {
+    // Sort projects and contexts, then keep only their symbol IDs and the joined strings.
+    // Tasks with the same projects or contexts share one joined string.
+    TTMSymbolTable *symbolTable = self.symbolTable;
+    NSArray *sortedProjects = [collator sortedStrings:projects];
+    NSArray *sortedContexts = [collator sortedStrings:contexts];
+    TTMSymbolIDStorage *storage = SymbolIDStorageCreate(sortedProjects.count + sortedContexts.count);
+    if (storage != NULL) {
+        [self internSymbols:sortedProjects inSymbolTable:symbolTable
+               intoSymbolIDs:storage->symbolIDs];
+        [self internSymbols:sortedContexts inSymbolTable:symbolTable
+               intoSymbolIDs:storage->symbolIDs + sortedProjects.count];
+    }
+    [self setSymbolIDStorage:storage projectIDCount:sortedProjects.count
+              contextIDCount:sortedContexts.count];
+    _projects = [symbolTable internString:[sortedProjects componentsJoinedByString:@", "]];
+    _contexts = [symbolTable internString:[sortedContexts componentsJoinedByString:@", "]];
+    _symbolsCollationGeneration = collator.generation;
+}
+
+- (void)internSymbols:(NSArray*)symbols inSymbolTable:(TTMSymbolTable*)symbolTable
+        intoSymbolIDs:(TTMSymbolID*)symbolIDs {
+    NSUInteger i = 0;
+    for (NSString *symbol in symbols) {
+        symbolIDs[i++] = [symbolTable internSymbol:symbol];
+    }
+}
+
+// Takes over the caller's reference to storage.
+- (void)setSymbolIDStorage:(TTMSymbolIDStorage*)storage
+            projectIDCount:(NSUInteger)projectIDCount
+            contextIDCount:(NSUInteger)contextIDCount {
+    SymbolIDStorageRelease(_symbolIDStorage);
+    _symbolIDStorage = storage;
+    _projectIDs = (projectIDCount > 0) ? storage->symbolIDs : NULL;
+    _projectIDCount = projectIDCount;
+    _contextIDs = (contextIDCount > 0) ? storage->symbolIDs + projectIDCount : NULL;
+    _contextIDCount = contextIDCount;
+}
+
+- (NSArray*)symbolsForIDs:(const TTMSymbolID*)symbolIDs count:(NSUInteger)count {
+    TTMSymbolTable *symbolTable = self.symbolTable;
+    NSMutableArray *symbols = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [symbols addObject:[symbolTable symbolForID:symbolIDs[i]]];
+    }
+    return [symbols copy];
+}
+
+#pragma mark - Symbol Table Methods
+
+- (TTMSymbolTable*)symbolTable {
+    return (_symbolTable != nil) ? _symbolTable : [TTMSymbolTable defaultSymbolTable];
+}
+
+- (void)setSymbolTable:(TTMSymbolTable*)symbolTable {
+    if (symbolTable == _symbolTable) {
+        return;
+    }
+    _symbolTable = symbolTable;
+    // Symbol IDs from the old table mean nothing in the new one.
+    if (!_isBlank) {
+        _decodedFieldGroups &= ~TTMTaskFieldGroupProjectsAndContexts;
+    }
+}
+
+- (void)decodeRecurrenceIfNeeded {
+    if (_decodedFieldGroups & TTMTaskFieldGroupRecurrence) {
+        return;
+    }
+    [self scanBodyIfNeeded];
+    _decodedFieldGroups |= TTMTaskFieldGroupRecurrence;
+    
+    _isRecurring = (_scan.recurrenceRange.location != NSNotFound);
+    _recurrencePattern = [self rawTextSubstringWithRange:_scan.recurrenceRange];
+}
+
+- (void)decodeSortAndFilterFields {
+    // Projects and contexts first, because their full scan also does the dates' body scan.
+    [self decodeProjectsAndContextsIfNeeded];
+    [self decodeDatesIfNeeded];
+}
+
+- (TTMTask*)arrangementCopy {
+    if (_arrangementCopy == nil ||
+        _arrangementCopy->_rawTextRevision != _rawTextRevision ||
+        _arrangementCopy->_taskId != _taskId ||
+        _arrangementCopy->_symbolTable != _symbolTable) {
+        [self decodeSortAndFilterFields];
+        _arrangementCopy = [self copy];
+    }
+    return _arrangementCopy;
+}
+
+- (TTMTaskScanResult)scanResult {
+    [self scanBodyIfNeeded];
+    return _scan;
+}
+
+- (TTMTaskSortFields)sortFields {
+    [self decodeDatesIfNeeded];
+    return _sortFields;
+}
+
+- (NSData*)rawTextCollationKey {
+    TTMCollator *collator = [TTMCollator currentCollator];
+    if (_rawTextCollationKey == nil || _rawTextCollationGeneration != collator.generation) {
+        _rawTextCollationKey = [collator collationKeyForString:_rawText];
+        _rawTextCollationGeneration = collator.generation;
+    }
+    return _rawTextCollationKey;
+}
+
++ (NSUInteger)latestRawTextRevision {
+    return atomic_load_explicit(&LastRawTextRevision, memory_order_relaxed);
+}
+
+- (NSString*)foldedRawText {
+    if (_foldedRawText == nil) {
+        _foldedRawText = [_rawText stringByFoldingWithOptions:NSCaseInsensitiveSearch |
+                                                              NSDiacriticInsensitiveSearch
+                                                       locale:nil];
+    }
+    return _foldedRawText;
+}
+
+#pragma mark - Lazily Decoded Properties
+
+- (NSString*)dueDateText {
+    [self decodeDatesIfNeeded];
+    return _dueDateText;
+}
+
+- (TTMDayNumber)dueDay {
+    [self decodeDatesIfNeeded];
+    return _dueDay;
+}
+
+- (NSString*)creationDateText {
+    [self decodeDatesIfNeeded];
+    return _creationDateText;
+}
+
+- (TTMDayNumber)creationDay {
+    [self decodeDatesIfNeeded];
+    return _creationDay;
+}
+
+- (NSString*)thresholdDateText {
+    [self decodeDatesIfNeeded];
+    return _thresholdDateText;
+}
+
+- (TTMDayNumber)thresholdDay {
+    [self decodeDatesIfNeeded];
+    return _thresholdDay;
+}
+
+- (TTMDueState)dueState {
+    [self decodeDatesIfNeeded];
+    return _dueState;
+}
+
+- (TTMThresholdState)thresholdState {
+    [self decodeDatesIfNeeded];
+    return _thresholdState;
+}
+
+- (NSArray*)projectsArray {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _isBlank ? nil : [self symbolsForIDs:_projectIDs count:_projectIDCount];
+}
+
+- (NSString*)projects {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _projects;
+}
+
+- (BOOL)hasProjects {
+    [self decodeProjectsAndContextsIfNeeded];
+    return (_projectIDCount > 0);
+}
+
+- (const TTMSymbolID*)projectIDs {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _projectIDs;
+}
+
+- (NSUInteger)projectIDCount {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _projectIDCount;
+}
+
+- (NSArray*)contextsArray {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _isBlank ? nil : [self symbolsForIDs:_contextIDs count:_contextIDCount];
+}
+
+- (NSString*)contexts {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _contexts;
+}
+
+- (BOOL)hasContexts {
+    [self decodeProjectsAndContextsIfNeeded];
+    return (_contextIDCount > 0);
+}
+
+- (const TTMSymbolID*)contextIDs {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _contextIDs;
+}
+
+- (NSUInteger)contextIDCount {
+    [self decodeProjectsAndContextsIfNeeded];
+    return _contextIDCount;
+}
+
+- (BOOL)isRecurring {
+    [self decodeRecurrenceIfNeeded];
+    return _isRecurring;
+}
+
+- (NSString*)recurrencePattern {
+    [self decodeRecurrenceIfNeeded];
+    return _recurrencePattern;
+}
+
+- (BOOL)isHidden {
+    [self scanBodyIfNeeded];
+    return _isHidden;
+}
+
+#pragma mark - Date Properties
+
+// Dates are stored as day numbers. NSDate objects are only created when asked for,
+// e.g. by the filter predicates.
+
+- (NSDate*)dueDate {
+    return [TTMDateUtility dateFromDayNumber:self.dueDay];
+}
+
+- (NSDate*)creationDate {
+    return [TTMDateUtility dateFromDayNumber:self.creationDay];
+}
+
+- (NSDate*)completionDate {
+    return [TTMDateUtility dateFromDayNumber:_completionDay];
+}
+
+- (NSDate*)thresholdDate {
+    return [TTMDateUtility dateFromDayNumber:self.thresholdDay];
 }
 
 - (NSAttributedString*)displayText:(BOOL)selected
@@ -427,20 +949,17 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 #pragma mark - Due/Not Due Method
 
 - (TTMDueState)getDueState {
+    [self decodeDatesIfNeeded];
+    
     // tasks with no due dates
     if (nil == _dueDateText ||
-        ([_dueDate isEqualToDate:[TTMDateUtility convertStringToDate:@"9999-12-31"]] &&
-        [_dueDateText isEqualToString:@""])) {
+        (_dueDay == TTMHighDayNumber && [_dueDateText isEqualToString:@""])) {
         return NoDueDate;        
     }
     
     // If there is a due date, compare it to today's date to determine
     // if the task is overdue, not due, or due today.
-    NSDate *todaysDate = [TTMDateUtility today];
-    NSInteger interval = [[[NSCalendar currentCalendar] components:NSCalendarUnitDay
-                                                          fromDate:todaysDate
-                                                            toDate:self.dueDate
-                                                           options:0] day];
+    NSInteger interval = (NSInteger)_dueDay - [TTMDateUtility todayDayNumber];
     if (interval < 0) {
         return Overdue;
     } else if (interval > 0) {
@@ -453,7 +972,10 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 #pragma mark - Threshold Date Methods
 
 - (void)setThresholdDate:(NSDate *)thresholdDate {
-    NSString *newThresholdDateText = [TTMDateUtility convertDateToString:thresholdDate];
+    [self updateThresholdDateText:[TTMDateUtility convertDateToString:thresholdDate]];
+}
+
+- (void)updateThresholdDateText:(NSString *)newThresholdDateText {
     // If the item has a threshold date, exchange the current threshold date with the new.
     // Else if the item does not have a threshold date, append the new threshold date to the task.
     self.rawText = (self.thresholdDateText != nil) ?
@@ -463,7 +985,7 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 
 - (void)removeThresholdDate {
     // Blank and tasks without a threshold date do not get updated.
-    if (self.isBlank || !self.thresholdDate) {
+    if (self.isBlank || self.thresholdDay == TTMNoDayNumber) {
         return;
     }
     
@@ -483,14 +1005,14 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
     
     // Get threshold date of the selected task.
     // If the selected task doesn't have a threshold date, use today as the due date.
-    NSDate *oldThresholdDate = (self.thresholdDateText != nil) ?
-        self.thresholdDate :
-        [TTMDateUtility today];
+    TTMDayNumber oldThresholdDay = (self.thresholdDateText != nil) ?
+        self.thresholdDay :
+        [TTMDateUtility todayDayNumber];
     
     // Add days to that date to create the new due date.
-    NSDate *newThresholdDate = [TTMDateUtility addDays:days toDate:oldThresholdDate];
+    TTMDayNumber newThresholdDay = oldThresholdDay + (TTMDayNumber)days;
     
-    self.thresholdDate = newThresholdDate;
+    [self updateThresholdDateText:[TTMDateUtility stringFromDayNumber:newThresholdDay]];
 }
 
 - (void)decrementThresholdDate:(NSInteger)days {
@@ -498,17 +1020,15 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 }
 
 - (TTMThresholdState)getThresholdState {
+    [self decodeDatesIfNeeded];
+    
     if (_thresholdDateText == nil) {
         return NoThresholdDate;
     }
     
     // If there is a threshold date, compare it to today's date to determine
     // if the task is overdue, not due, or due today.
-    NSDate *todaysDate = [TTMDateUtility today];
-    NSInteger interval = [[[NSCalendar currentCalendar] components:NSCalendarUnitDay
-                                                          fromDate:todaysDate
-                                                            toDate:self.thresholdDate
-                                                           options:0] day];
+    NSInteger interval = (NSInteger)_thresholdDay - [TTMDateUtility todayDayNumber];
     if (interval < 0) {
         return ThresholdBeforeToday;
     } else if (interval > 0) {
@@ -655,12 +1175,12 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 
     // Get due date of the selected task.
     // If the selected task doesn't have a due date, use today as the due date.
-    NSDate *oldDueDate = (self.dueDateText != nil) ? self.dueDate : [TTMDateUtility today];
+    TTMDayNumber oldDueDay = (self.dueDateText != nil) ? self.dueDay : [TTMDateUtility todayDayNumber];
 
     // Add days to that date to create the new due date.
-    NSDate *newDueDate = [TTMDateUtility addDays:daysToPostpone toDate:oldDueDate];
+    TTMDayNumber newDueDay = oldDueDay + (TTMDayNumber)daysToPostpone;
     
-    self.dueDate = newDueDate;
+    [self updateDueDateText:[TTMDateUtility stringFromDayNumber:newDueDay]];
 }
 
 - (void)incrementDueDate:(NSInteger)days {
@@ -678,7 +1198,10 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
         return;
     }
     
-    NSString *newDueDateText = [TTMDateUtility convertDateToString:dueDate];
+    [self updateDueDateText:[TTMDateUtility convertDateToString:dueDate]];
+}
+
+- (void)updateDueDateText:(NSString *)newDueDateText {
     // If the item has a due date, exchange the current due date with the new.
     // Else if the item does not have a due date, append the new due date to the task.
     self.rawText = (self.dueDateText != nil) ?
@@ -688,7 +1211,7 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 
 - (void)removeDueDate {
     // Blank and tasks without a due date do not get updated.
-    if (self.isBlank || !self.dueDate) {
+    if (self.isBlank || self.dueDay == TTMNoDayNumber) {
         return;
     }
     
@@ -702,7 +1225,9 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
     TTMTask *copy = [[self class] allocWithZone:zone];
     
     if (copy) {
-        return [copy initWithRawText:self.rawText withTaskId:self.taskId];
+        // Copies share the parsed state, so copying never scans rawText again.
+        // Undo restores tasks from copies, so a copy also keeps the same uniqueId.
+        copy = [copy initWithParsedStateOfTask:self];
     }
     
     return copy;
@@ -741,16 +1266,18 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
         return nil;
     }
     
-    TTMTask *newTask = [self copy];
+    // The recurring task is a new task, so it gets its own unique ID rather than a copy's.
+    TTMTask *newTask = [[TTMTask alloc] initWithRawText:self.rawText withTaskId:self.taskId];
+    newTask.symbolTable = _symbolTable;
     
     [newTask advanceDueDateBasedOnReccurencePattern:[TTMDateUtility today]];
     
-    if (_thresholdDateText != nil) {
+    if (self.thresholdDateText != nil) {
         NSInteger numberOfDaysThresholdDateIsBeforeDueDate = 0;
-        if (_dueDateText == nil) {
-            numberOfDaysThresholdDateIsBeforeDueDate = [TTMDateUtility daysBetweenDate:self.thresholdDate andEndDate:[TTMDateUtility today]];
-        } else if (_dueDateText != nil && _thresholdDateText != nil) {
-            numberOfDaysThresholdDateIsBeforeDueDate = [TTMDateUtility daysBetweenDate:self.thresholdDate andEndDate:self.dueDate];
+        if (self.dueDateText == nil) {
+            numberOfDaysThresholdDateIsBeforeDueDate = [TTMDateUtility todayDayNumber] - self.thresholdDay;
+        } else if (self.dueDateText != nil && self.thresholdDateText != nil) {
+            numberOfDaysThresholdDateIsBeforeDueDate = self.dueDay - self.thresholdDay;
         }
         if (numberOfDaysThresholdDateIsBeforeDueDate < 0) {
             numberOfDaysThresholdDateIsBeforeDueDate = 0;
@@ -763,7 +1290,7 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 
 - (void)advanceDueDateBasedOnReccurencePattern:(NSDate*)completionDate {
     NSDate *oldDueDate;
-    if (_dueDateText == nil || ![self recurrencePatternIsStrict]) {
+    if (self.dueDateText == nil || ![self recurrencePatternIsStrict]) {
         oldDueDate = completionDate;
     } else {
         oldDueDate = self.dueDate;
@@ -830,7 +1357,7 @@ static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
 
 - (void)removeCreationDate {
     // Blank and tasks without a threshold date do not get updated.
-    if (self.isBlank || !self.creationDate) {
+    if (self.isBlank || self.creationDay == TTMNoDayNumber) {
         return;
     }
     
@@ -0,0 +1,99 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import "TTMTaskSorter.h"
+@class TTMTaskIndex;
+
+/*! Posted on the main thread after an arrangement made in the background is shown. */
+extern NSString * const TTMTaskArrayControllerDidArrangeInBackgroundNotification;
+
+/*!
+ * @class TTMTaskArrayController
+ * @abstract TTMTaskArrayController arranges a document's tasks for its table view.
+ * @discussion It filters tasks with its filterPredicate like NSArrayController does, but
+ * evaluates it as a TTMCompiledPredicate, using the task index if one is set, and sorts
+ * them with TTMTaskSorter instead of evaluating sort descriptors through key-value coding.
+ * Sort descriptors, if any are set, still take precedence over the sort type.
+ *
+ * When a task index is set, the last few filter results are kept until a task is added,
+ * removed or edited. A predicate that refines one of them, such as the search field's
+ * after another character is typed, filters only that result, and going back to an
+ * earlier predicate reuses its result.
+ *
+ * When arrangesInBackground is set, a new filter predicate is applied on a background queue
+ * to copies of the tasks, which are filtered and sorted into a permutation of the task
+ * list. The current arrangement stays in place until the new one is swapped in on the main
+ * thread. Each new arrangement, background or not, cancels the one in progress, and an
+ * arrangement of tasks that changed while it was made is started again.
+ */
+@interface TTMTaskArrayController : NSArrayController
+
+/*! The index of the tasks in the content, used to filter them by project and context. */
+@property (nonatomic) TTMTaskIndex *taskIndex;
+
+/*! If YES, setting the filter predicate arranges the tasks on a background queue. */
+@property (nonatomic) BOOL arrangesInBackground;
+
+/*! YES from when a background arrangement starts until it is shown or cancelled. */
+@property (nonatomic, readonly) BOOL isArrangingInBackground;
+
+/*! The order to arrange tasks in. Setting it rearranges the tasks. */
+@property (nonatomic) TTMTaskListSortType sortType;
+
+/*!
+ * @method rearrangeChangedTasks:
+ * @abstract Moves tasks that have changed to where they now sort, without sorting the rest.
+ * @discussion Each changed task is taken out of the arranged tasks, filtered, and put back
+ * at the row a binary search finds for it. Tasks that had been filtered out are put back
+ * if they now pass the filter. When there are too many changed tasks, all the tasks are
+ * rearranged instead.
+ * @param changedTasks The tasks that changed since the last arrangement.
+ * @return The arranged rows that changed, or nil if every row may have changed.
+ */
+- (NSIndexSet*)rearrangeChangedTasks:(NSArray*)changedTasks;
+
+@end
@@ -0,0 +1,414 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMTaskArrayController.h"
+#import <stdatomic.h>
+#import "TTMCollator.h"
+#import "TTMCompiledPredicate.h"
+#import "TTMDateUtility.h"
+#import "TTMFilterResultCache.h"
+#import "TTMTask.h"
+#import "TTMTaskIndex.h"
+
+// Beyond this many changed tasks, sorting everything again is as fast as moving each one.
+static const NSUInteger MaxIncrementalRearrangeCount = 64;
+// Enough filter results to delete back through a few characters typed in the search field.
+static const NSUInteger FilterResultCacheCapacity = 8;
+// Background filtering checks whether it was cancelled after this many tasks.
+static const NSUInteger BackgroundFilterBatchSize = 4096;
+
+NSString * const TTMTaskArrayControllerDidArrangeInBackgroundNotification =
+    @"TTMTaskArrayControllerDidArrangeInBackgroundNotification";
+
+@interface TTMTaskArrayController ()
+
+// Set while rearrangeChangedTasks: hands its arrangement to rearrangeObjects.
+@property (nonatomic) NSArray *pendingArrangedObjects;
+
+// The filter predicate, compiled the first time tasks are filtered with it.
+@property (nonatomic) TTMCompiledPredicate *compiledFilterPredicate;
+
+// Recent filter results, and what the tasks were like when they were filtered.
+@property (nonatomic) TTMFilterResultCache *filterResults;
+@property (nonatomic) NSUInteger filterResultsMutationCount;
+@property (nonatomic) NSUInteger filterResultsRawTextRevision;
+@property (nonatomic) TTMDayNumber filterResultsDay;
+
+@property (nonatomic, readwrite) BOOL isArrangingInBackground;
+
+@end
+
+@implementation TTMTaskArrayController {
+    dispatch_queue_t _arrangementQueue;
+    // Incremented by every arrangement, which cancels any background arrangement before it.
+    _Atomic(NSUInteger) _arrangementGeneration;
+}
+
+- (id)initWithContent:(id)content {
+    self = [super initWithContent:content];
+    if (self) {
+        [self commonInit];
+    }
+    return self;
+}
+
+- (id)initWithCoder:(NSCoder*)coder {
+    self = [super initWithCoder:coder];
+    if (self) {
+        [self commonInit];
+    }
+    return self;
+}
+
+- (void)commonInit {
+    _arrangementQueue = dispatch_queue_create("TTMTaskArrayController.arrangement",
+                                              DISPATCH_QUEUE_SERIAL);
+    [self observeCollatorChanges];
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)observeCollatorChanges {
+    // Strings sort differently in the new locale.
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(collatorDidChange:)
+                                                 name:TTMCollatorDidChangeNotification
+                                               object:nil];
+}
+
+- (void)collatorDidChange:(NSNotification*)notification {
+    [self rearrangeObjects];
+}
+
+- (void)setSortType:(TTMTaskListSortType)sortType {
+    _sortType = sortType;
+    [self rearrangeObjects];
+}
+
+- (TTMCompiledPredicate*)compiledFilter {
+    NSPredicate *filterPredicate = self.filterPredicate;
+    if (filterPredicate == nil) {
+        return nil;
+    }
+    if (self.compiledFilterPredicate.predicate != filterPredicate ||
+        self.compiledFilterPredicate.taskIndex != self.taskIndex) {
+        self.compiledFilterPredicate = [[TTMCompiledPredicate alloc]
+                                        initWithPredicate:filterPredicate
+                                        taskIndex:self.taskIndex];
+    }
+    return self.compiledFilterPredicate;
+}
+
+- (NSArray*)automaticRearrangementKeyPaths {
+    // The document rearranges the tasks after every edit, incrementally where it can.
+    return nil;
+}
+
+- (NSArray*)arrangeObjects:(NSArray*)objects {
+    if (self.pendingArrangedObjects != nil) {
+        return self.pendingArrangedObjects;
+    }
+    if (self.sortDescriptors.count > 0) {
+        return [super arrangeObjects:objects];
+    }
+    TTMCompiledPredicate *filter = [self compiledFilter];
+    NSArray *filteredObjects = (filter == nil) ? objects : [self filteredObjects:objects
+                                                                      withFilter:filter];
+    return [TTMTaskSorter sortedTasks:filteredObjects sortType:self.sortType];
+}
+
+- (NSArray*)filteredObjects:(NSArray*)objects withFilter:(TTMCompiledPredicate*)filter {
+    TTMFilterResultCache *filterResults = [self validFilterResults];
+    BOOL isFiltered = NO;
+    NSArray *tasks = [filterResults tasksToFilterWithPredicate:filter.predicate
+                                                    isFiltered:&isFiltered];
+    if (isFiltered) {
+        return tasks;
+    }
+    NSArray *filteredTasks = [filter filteredTasks:(tasks != nil) ? tasks : objects];
+    [filterResults addFilteredTasks:filteredTasks forPredicate:filter.predicate];
+    return filteredTasks;
+}
+
+- (TTMFilterResultCache*)validFilterResults {
+    // Without a task index, there is no telling whether the tasks changed.
+    if (self.taskIndex == nil) {
+        return nil;
+    }
+    
+    // Results are dropped when tasks are added, removed or edited, or a new day changes
+    // which tasks are due.
+    NSUInteger mutationCount = self.taskIndex.mutationCount;
+    NSUInteger rawTextRevision = [TTMTask latestRawTextRevision];
+    TTMDayNumber today = [TTMDateUtility todayDayNumber];
+    if (self.filterResults == nil) {
+        self.filterResults = [[TTMFilterResultCache alloc] initWithCapacity:FilterResultCacheCapacity];
+    } else if (mutationCount != self.filterResultsMutationCount ||
+               rawTextRevision != self.filterResultsRawTextRevision ||
+               today != self.filterResultsDay) {
+        [self.filterResults removeAllResults];
+    }
+    self.filterResultsMutationCount = mutationCount;
+    self.filterResultsRawTextRevision = rawTextRevision;
+    self.filterResultsDay = today;
+    return self.filterResults;
+}
+
+#pragma mark - Background Arrangement Methods
+
+- (void)setFilterPredicate:(NSPredicate*)filterPredicate {
+    if (!self.arrangesInBackground || self.sortDescriptors.count > 0) {
+        [super setFilterPredicate:filterPredicate];
+        return;
+    }
+    // Keep showing the current arrangement until the new one is ready.
+    self.pendingArrangedObjects = [self.arrangedObjects copy];
+    [super setFilterPredicate:filterPredicate];
+    self.pendingArrangedObjects = nil;
+    [self arrangeInBackground];
+}
+
+- (void)rearrangeObjects {
+    // An arrangement made now supersedes any being made in the background.
+    atomic_fetch_add_explicit(&_arrangementGeneration, 1, memory_order_relaxed);
+    self.isArrangingInBackground = NO;
+    [super rearrangeObjects];
+}
+
+- (BOOL)isArrangementCancelled:(NSUInteger)generation {
+    return atomic_load_explicit(&_arrangementGeneration, memory_order_relaxed) != generation;
+}
+
+- (void)arrangeInBackground {
+    NSUInteger generation =
+        atomic_fetch_add_explicit(&_arrangementGeneration, 1, memory_order_relaxed) + 1;
+    self.isArrangingInBackground = YES;
+    
+    // Filter only as many tasks as the recent filter results allow.
+    NSArray *tasks = [self.content copy];
+    NSPredicate *predicate = self.filterPredicate;
+    TTMCompiledPredicate *filter = nil;
+    TTMFilterResultCache *filterResults = [self validFilterResults];
+    if (predicate != nil) {
+        BOOL isFiltered = NO;
+        NSArray *cachedTasks = [filterResults tasksToFilterWithPredicate:predicate
+                                                              isFiltered:&isFiltered];
+        if (cachedTasks != nil) {
+            tasks = cachedTasks;
+        }
+        if (!isFiltered) {
+            // A predicate of its own, so the background queue is the only thread using it.
+            filter = [[TTMCompiledPredicate alloc] initWithPredicate:predicate
+                                                           taskIndex:self.taskIndex];
+            [filter lookUpIndexedTasks];
+        }
+    }
+    NSArray *snapshot = [self snapshotOfTasks:tasks];
+    TTMTaskListSortType sortType = self.sortType;
+    NSUInteger mutationCount = self.taskIndex.mutationCount;
+    NSUInteger rawTextRevision = [TTMTask latestRawTextRevision];
+    
+    dispatch_async(_arrangementQueue, ^{
+        if ([self isArrangementCancelled:generation]) {
+            return;
+        }
+        
+        // Filter the snapshot, noting where each task that passes is in it.
+        NSUInteger count = snapshot.count;
+        NSMutableArray *filteredTasks = [NSMutableArray arrayWithCapacity:count];
+        NSMapTable *positions = [NSMapTable
+                                 mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory |
+                                                        NSPointerFunctionsOpaquePersonality
+                                 valueOptions:NSPointerFunctionsOpaqueMemory |
+                                              NSPointerFunctionsIntegerPersonality];
+        for (NSUInteger position = 0; position < count; position++) {
+            if (position % BackgroundFilterBatchSize == 0 && [self isArrangementCancelled:generation]) {
+                return;
+            }
+            TTMTask *task = snapshot[position];
+            if (filter == nil || [filter evaluateWithTask:task]) {
+                [filteredTasks addObject:task];
+                NSMapInsert(positions, (__bridge void*)task, (void*)(position + 1));
+            }
+        }
+        if ([self isArrangementCancelled:generation]) {
+            return;
+        }
+        
+        // Sort, and turn the sorted tasks into positions in the snapshot.
+        NSArray *sortedTasks = [TTMTaskSorter sortedTasks:filteredTasks sortType:sortType];
+        NSMutableData *permutation = [NSMutableData dataWithLength:sortedTasks.count *
+                                                                    sizeof(NSUInteger)];
+        NSUInteger *sortedPositions = permutation.mutableBytes;
+        for (NSUInteger i = 0; i < sortedTasks.count; i++) {
+            sortedPositions[i] = (NSUInteger)NSMapGet(positions, (__bridge void*)sortedTasks[i]) - 1;
+        }
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if ([self isArrangementCancelled:generation]) {
+                return;
+            }
+            if (self.taskIndex.mutationCount != mutationCount ||
+                [TTMTask latestRawTextRevision] != rawTextRevision) {
+                // The tasks changed while they were being arranged.
+                [self arrangeInBackground];
+                return;
+            }
+            [self publishPermutation:permutation ofTasks:tasks filteredWith:filter];
+        });
+    });
+}
+
+- (NSArray*)snapshotOfTasks:(NSArray*)tasks {
+    // Tasks decode their fields lazily, so the background queue reads copies of them that
+    // no other thread touches. Each task keeps its copy until it changes.
+    NSMutableArray *snapshot = [NSMutableArray arrayWithCapacity:tasks.count];
+    for (TTMTask *task in tasks) {
+        [snapshot addObject:[task arrangementCopy]];
+    }
+    return snapshot;
+}
+
+- (void)publishPermutation:(NSData*)permutation
+                   ofTasks:(NSArray*)tasks
+              filteredWith:(TTMCompiledPredicate*)filter {
+    const NSUInteger *positions = permutation.bytes;
+    NSUInteger count = permutation.length / sizeof(NSUInteger);
+    NSMutableArray *arrangedTasks = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [arrangedTasks addObject:tasks[positions[i]]];
+    }
+    
+    if (filter != nil) {
+        // Filter results are kept in task list order.
+        NSMutableIndexSet *filteredPositions = [NSMutableIndexSet indexSet];
+        for (NSUInteger i = 0; i < count; i++) {
+            [filteredPositions addIndex:positions[i]];
+        }
+        [[self validFilterResults] addFilteredTasks:[tasks objectsAtIndexes:filteredPositions]
+                                       forPredicate:filter.predicate];
+    }
+    
+    // Swap the whole arrangement in at once.
+    self.pendingArrangedObjects = arrangedTasks;
+    [self rearrangeObjects];
+    self.pendingArrangedObjects = nil;
+    [[NSNotificationCenter defaultCenter]
+     postNotificationName:TTMTaskArrayControllerDidArrangeInBackgroundNotification object:self];
+}
+
+- (NSIndexSet*)rearrangeChangedTasks:(NSArray*)changedTasks {
+    // The arranged tasks may still be those of the filter before the one being applied.
+    if (self.sortDescriptors.count > 0 || changedTasks.count > MaxIncrementalRearrangeCount ||
+        self.isArrangingInBackground) {
+        [self rearrangeObjects];
+        return nil;
+    }
+    
+    NSMutableArray *arrangedTasks = [self.arrangedObjects mutableCopy];
+    NSUInteger oldCount = arrangedTasks.count;
+    NSUInteger firstChangedRow = NSNotFound;
+    NSUInteger lastChangedRow = 0;
+    
+    // Take the changed tasks out of their old rows.
+    NSMutableIndexSet *oldRows = [NSMutableIndexSet indexSet];
+    for (TTMTask *task in changedTasks) {
+        NSUInteger row = [arrangedTasks indexOfObjectIdenticalTo:task];
+        if (row != NSNotFound) {
+            [oldRows addIndex:row];
+        }
+    }
+    [arrangedTasks removeObjectsAtIndexes:oldRows];
+    if (oldRows.count > 0) {
+        firstChangedRow = oldRows.firstIndex;
+        lastChangedRow = oldRows.lastIndex;
+    }
+    
+    // Put back the ones that still pass the filter, where they now sort.
+    TTMTaskListSortType sortType = self.sortType;
+    NSComparator comparator = ^NSComparisonResult(TTMTask *task1, TTMTask *task2) {
+        return [TTMTaskSorter compareTask:task1 toTask:task2 sortType:sortType];
+    };
+    TTMCompiledPredicate *filter = [self compiledFilter];
+    NSMutableArray *insertedTasks = [NSMutableArray arrayWithCapacity:changedTasks.count];
+    for (TTMTask *task in changedTasks) {
+        if (filter != nil && ![filter evaluateWithTask:task]) {
+            continue;
+        }
+        NSUInteger row = [arrangedTasks indexOfObject:task
+                                        inSortedRange:NSMakeRange(0, arrangedTasks.count)
+                                              options:NSBinarySearchingInsertionIndex
+                                      usingComparator:comparator];
+        [arrangedTasks insertObject:task atIndex:row];
+        [insertedTasks addObject:task];
+    }
+    for (TTMTask *task in insertedTasks) {
+        NSUInteger row = [arrangedTasks indexOfObject:task
+                                        inSortedRange:NSMakeRange(0, arrangedTasks.count)
+                                              options:NSBinarySearchingFirstEqual
+                                      usingComparator:comparator];
+        firstChangedRow = MIN(firstChangedRow, row);
+        lastChangedRow = MAX(lastChangedRow, row);
+    }
+    
+    self.pendingArrangedObjects = arrangedTasks;
+    [self rearrangeObjects];
+    self.pendingArrangedObjects = nil;
+    
+    if (firstChangedRow == NSNotFound) {
+        return [NSIndexSet indexSet];
+    }
+    // Rows after the changes shift when tasks leave or join the arrangement.
+    if (arrangedTasks.count != oldCount) {
+        lastChangedRow = MAX(arrangedTasks.count, oldCount) - 1;
+    }
+    return [NSIndexSet indexSetWithIndexesInRange:
+            NSMakeRange(firstChangedRow, lastChangedRow - firstChangedRow + 1)];
+}
+
+@end
@@ -0,0 +1,119 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @class TTMTaskBitset
+ * @abstract TTMTaskBitset is a compressed set of 32-bit task numbers.
+ * @discussion Numbers are grouped by their high 16 bits into containers, as in a roaring
+ * bitmap. A container holding up to 4096 numbers stores their low 16 bits as a sorted
+ * array; a fuller container stores a 65536-bit bitmap. Sets of tasks that share a project
+ * or context are therefore small, and set operations work a container at a time.
+ */
+@interface TTMTaskBitset : NSObject <NSCopying>
+
+/*! The number of numbers in the set. */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*!
+ * @method addIndex:
+ * @abstract Adds a number to the set.
+ * @param index The number to add.
+ */
+- (void)addIndex:(uint32_t)index;
+
+/*!
+ * @method removeIndex:
+ * @abstract Removes a number from the set.
+ * @param index The number to remove.
+ */
+- (void)removeIndex:(uint32_t)index;
+
+/*!
+ * @method containsIndex:
+ * @param index The number to look for.
+ * @return YES if the number is in the set.
+ */
+- (BOOL)containsIndex:(uint32_t)index;
+
+/*!
+ * @method unionWithBitset:
+ * @abstract Adds every number in another set to this one.
+ * @param bitset The other set.
+ */
+- (void)unionWithBitset:(TTMTaskBitset*)bitset;
+
+/*!
+ * @method intersectWithBitset:
+ * @abstract Removes every number that is not also in another set.
+ * @param bitset The other set.
+ */
+- (void)intersectWithBitset:(TTMTaskBitset*)bitset;
+
+/*!
+ * @method subtractBitset:
+ * @abstract Removes every number that is in another set.
+ * @param bitset The other set.
+ */
+- (void)subtractBitset:(TTMTaskBitset*)bitset;
+
+/*!
+ * @method countOfIntersectionWithBitset:
+ * @abstract Counts the numbers in both sets, without making their intersection.
+ * @param bitset The other set.
+ * @return The number of numbers in both sets.
+ */
+- (NSUInteger)countOfIntersectionWithBitset:(TTMTaskBitset*)bitset;
+
+/*!
+ * @method enumerateIndexesUsingBlock:
+ * @abstract Calls a block with each number in the set, in increasing order.
+ * @param block The block to call. Setting *stop to YES ends the enumeration.
+ */
+- (void)enumerateIndexesUsingBlock:(void (^)(uint32_t index, BOOL *stop))block;
+
+@end
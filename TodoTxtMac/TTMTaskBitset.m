@@ -0,0 +1,500 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMTaskBitset.h"
+
+// Containers with more numbers than this are bitmaps.
+static const uint32_t MaxArrayCardinality = 4096;
+// A bitmap container has one bit for each of the 65536 low halves.
+#define BitmapWordCount 1024
+
+typedef enum : NSUInteger {
+    TTMSetUnion,
+    TTMSetIntersection,
+    TTMSetDifference
+} TTMSetOperation;
+
+/*! The numbers of a set that share their high 16 bits. */
+typedef struct {
+    uint16_t key;
+    bool isBitmap;
+    uint32_t cardinality;
+    uint32_t capacity;
+    uint16_t *values;
+    uint64_t *words;
+} TTMBitsetContainer;
+
+#pragma mark - Container Functions
+
+static void ContainerFree(TTMBitsetContainer *container) {
+    free(container->values);
+    free(container->words);
+}
+
+static TTMBitsetContainer ContainerCopy(const TTMBitsetContainer *container) {
+    TTMBitsetContainer copy = *container;
+    if (container->isBitmap) {
+        copy.words = malloc(BitmapWordCount * sizeof(uint64_t));
+        memcpy(copy.words, container->words, BitmapWordCount * sizeof(uint64_t));
+    } else {
+        copy.capacity = MAX(container->cardinality, 1);
+        copy.values = malloc(copy.capacity * sizeof(uint16_t));
+        memcpy(copy.values, container->values, container->cardinality * sizeof(uint16_t));
+    }
+    return copy;
+}
+
+// Returns the position of value, or -1 minus the position it would be inserted at.
+static int32_t ArraySearch(const uint16_t *values, uint32_t count, uint16_t value) {
+    int32_t low = 0;
+    int32_t high = (int32_t)count - 1;
+    while (low <= high) {
+        int32_t middle = (low + high) >> 1;
+        if (values[middle] < value) {
+            low = middle + 1;
+        } else if (values[middle] > value) {
+            high = middle - 1;
+        } else {
+            return middle;
+        }
+    }
+    return -(low + 1);
+}
+
+static bool ContainerContains(const TTMBitsetContainer *container, uint16_t low) {
+    if (container->isBitmap) {
+        return (container->words[low >> 6] >> (low & 63)) & 1;
+    }
+    return ArraySearch(container->values, container->cardinality, low) >= 0;
+}
+
+static void ContainerConvertToBitmap(TTMBitsetContainer *container) {
+    uint64_t *words = calloc(BitmapWordCount, sizeof(uint64_t));
+    for (uint32_t i = 0; i < container->cardinality; i++) {
+        uint16_t value = container->values[i];
+        words[value >> 6] |= (uint64_t)1 << (value & 63);
+    }
+    free(container->values);
+    container->values = NULL;
+    container->capacity = 0;
+    container->words = words;
+    container->isBitmap = true;
+}
+
+static void ContainerConvertToArray(TTMBitsetContainer *container) {
+    uint32_t capacity = MAX(container->cardinality, 1);
+    uint16_t *values = malloc(capacity * sizeof(uint16_t));
+    uint32_t count = 0;
+    for (uint32_t w = 0; w < BitmapWordCount; w++) {
+        uint64_t word = container->words[w];
+        while (word != 0) {
+            values[count++] = (uint16_t)(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    free(container->words);
+    container->words = NULL;
+    container->values = values;
+    container->capacity = capacity;
+    container->isBitmap = false;
+}
+
+// Makes a container an array if it holds few enough numbers, and a bitmap otherwise.
+static void ContainerNormalize(TTMBitsetContainer *container) {
+    if (container->isBitmap && container->cardinality <= MaxArrayCardinality) {
+        ContainerConvertToArray(container);
+    } else if (!container->isBitmap && container->cardinality > MaxArrayCardinality) {
+        ContainerConvertToBitmap(container);
+    }
+}
+
+static bool ContainerAdd(TTMBitsetContainer *container, uint16_t low) {
+    if (container->isBitmap) {
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (container->words[low >> 6] & bit) {
+            return false;
+        }
+        container->words[low >> 6] |= bit;
+        container->cardinality++;
+        return true;
+    }
+    int32_t position = ArraySearch(container->values, container->cardinality, low);
+    if (position >= 0) {
+        return false;
+    }
+    if (container->cardinality == MaxArrayCardinality) {
+        ContainerConvertToBitmap(container);
+        return ContainerAdd(container, low);
+    }
+    position = -position - 1;
+    if (container->cardinality == container->capacity) {
+        container->capacity = MIN(MAX(container->capacity * 2, 4), MaxArrayCardinality);
+        container->values = realloc(container->values, container->capacity * sizeof(uint16_t));
+    }
+    memmove(container->values + position + 1, container->values + position,
+            (container->cardinality - position) * sizeof(uint16_t));
+    container->values[position] = low;
+    container->cardinality++;
+    return true;
+}
+
+static bool ContainerRemove(TTMBitsetContainer *container, uint16_t low) {
+    if (container->isBitmap) {
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (!(container->words[low >> 6] & bit)) {
+            return false;
+        }
+        container->words[low >> 6] &= ~bit;
+        container->cardinality--;
+        ContainerNormalize(container);
+        return true;
+    }
+    int32_t position = ArraySearch(container->values, container->cardinality, low);
+    if (position < 0) {
+        return false;
+    }
+    memmove(container->values + position, container->values + position + 1,
+            (container->cardinality - position - 1) * sizeof(uint16_t));
+    container->cardinality--;
+    return true;
+}
+
+// Returns the bitmap of a container, filling in scratch if the container is an array.
+static const uint64_t *ContainerWords(const TTMBitsetContainer *container, uint64_t *scratch) {
+    if (container->isBitmap) {
+        return container->words;
+    }
+    memset(scratch, 0, BitmapWordCount * sizeof(uint64_t));
+    for (uint32_t i = 0; i < container->cardinality; i++) {
+        uint16_t value = container->values[i];
+        scratch[value >> 6] |= (uint64_t)1 << (value & 63);
+    }
+    return scratch;
+}
+
+// Keeps the values of an array container that are (or are not) in another container.
+static TTMBitsetContainer ContainerFilter(const TTMBitsetContainer *array,
+                                          const TTMBitsetContainer *other, bool keepIfContained) {
+    TTMBitsetContainer result = {.key = array->key};
+    result.capacity = MAX(array->cardinality, 1);
+    result.values = malloc(result.capacity * sizeof(uint16_t));
+    for (uint32_t i = 0; i < array->cardinality; i++) {
+        if (ContainerContains(other, array->values[i]) == keepIfContained) {
+            result.values[result.cardinality++] = array->values[i];
+        }
+    }
+    return result;
+}
+
+static TTMBitsetContainer ContainerCombine(const TTMBitsetContainer *a, const TTMBitsetContainer *b,
+                                           TTMSetOperation operation) {
+    if (!a->isBitmap && operation != TTMSetUnion) {
+        return ContainerFilter(a, b, operation == TTMSetIntersection);
+    }
+    if (!b->isBitmap && operation == TTMSetIntersection) {
+        return ContainerFilter(b, a, true);
+    }
+    
+    TTMBitsetContainer result = {.key = a->key};
+    if (!a->isBitmap && !b->isBitmap) {
+        // Merge two sorted arrays.
+        result.capacity = MAX(a->cardinality + b->cardinality, 1);
+        result.values = malloc(result.capacity * sizeof(uint16_t));
+        uint32_t i = 0, j = 0, count = 0;
+        while (i < a->cardinality && j < b->cardinality) {
+            uint16_t x = a->values[i];
+            uint16_t y = b->values[j];
+            result.values[count++] = (x <= y) ? x : y;
+            i += (x <= y);
+            j += (y <= x);
+        }
+        while (i < a->cardinality) {
+            result.values[count++] = a->values[i++];
+        }
+        while (j < b->cardinality) {
+            result.values[count++] = b->values[j++];
+        }
+        result.cardinality = count;
+    } else {
+        uint64_t scratchA[BitmapWordCount];
+        uint64_t scratchB[BitmapWordCount];
+        const uint64_t *wordsA = ContainerWords(a, scratchA);
+        const uint64_t *wordsB = ContainerWords(b, scratchB);
+        result.isBitmap = true;
+        result.words = malloc(BitmapWordCount * sizeof(uint64_t));
+        uint32_t count = 0;
+        for (uint32_t w = 0; w < BitmapWordCount; w++) {
+            uint64_t word;
+            switch (operation) {
+                case TTMSetUnion:
+                    word = wordsA[w] | wordsB[w];
+                    break;
+                case TTMSetIntersection:
+                    word = wordsA[w] & wordsB[w];
+                    break;
+                default:
+                    word = wordsA[w] & ~wordsB[w];
+                    break;
+            }
+            result.words[w] = word;
+            count += __builtin_popcountll(word);
+        }
+        result.cardinality = count;
+    }
+    ContainerNormalize(&result);
+    return result;
+}
+
+static uint32_t ContainerIntersectionCount(const TTMBitsetContainer *a, const TTMBitsetContainer *b) {
+    uint32_t count = 0;
+    if (a->isBitmap && b->isBitmap) {
+        for (uint32_t w = 0; w < BitmapWordCount; w++) {
+            count += __builtin_popcountll(a->words[w] & b->words[w]);
+        }
+    } else if (!a->isBitmap && !b->isBitmap) {
+        uint32_t i = 0, j = 0;
+        while (i < a->cardinality && j < b->cardinality) {
+            uint16_t x = a->values[i];
+            uint16_t y = b->values[j];
+            count += (x == y);
+            i += (x <= y);
+            j += (y <= x);
+        }
+    } else {
+        const TTMBitsetContainer *array = a->isBitmap ? b : a;
+        const TTMBitsetContainer *bitmap = a->isBitmap ? a : b;
+        for (uint32_t i = 0; i < array->cardinality; i++) {
+            count += ContainerContains(bitmap, array->values[i]);
+        }
+    }
+    return count;
+}
+
+// Returns the position of the container for key, or -1 minus where it would be inserted.
+static NSInteger ContainerSearch(const TTMBitsetContainer *containers, NSUInteger count, uint16_t key) {
+    NSInteger low = 0;
+    NSInteger high = (NSInteger)count - 1;
+    while (low <= high) {
+        NSInteger middle = (low + high) >> 1;
+        if (containers[middle].key < key) {
+            low = middle + 1;
+        } else if (containers[middle].key > key) {
+            high = middle - 1;
+        } else {
+            return middle;
+        }
+    }
+    return -(low + 1);
+}
+
+@implementation TTMTaskBitset {
+    TTMBitsetContainer *_containers;
+    NSUInteger _containerCount;
+    NSUInteger _containerCapacity;
+    NSUInteger _count;
+}
+
+#pragma mark - Init Methods
+
+- (void)dealloc {
+    for (NSUInteger i = 0; i < _containerCount; i++) {
+        ContainerFree(&_containers[i]);
+    }
+    free(_containers);
+}
+
+- (id)copyWithZone:(NSZone*)zone {
+    TTMTaskBitset *copy = [[TTMTaskBitset allocWithZone:zone] init];
+    copy->_containerCapacity = MAX(_containerCount, 1);
+    copy->_containers = malloc(copy->_containerCapacity * sizeof(TTMBitsetContainer));
+    for (NSUInteger i = 0; i < _containerCount; i++) {
+        copy->_containers[i] = ContainerCopy(&_containers[i]);
+    }
+    copy->_containerCount = _containerCount;
+    copy->_count = _count;
+    return copy;
+}
+
+#pragma mark - Membership Methods
+
+- (void)addIndex:(uint32_t)index {
+    uint16_t key = (uint16_t)(index >> 16);
+    NSInteger position = ContainerSearch(_containers, _containerCount, key);
+    if (position < 0) {
+        position = -position - 1;
+        if (_containerCount == _containerCapacity) {
+            _containerCapacity = MAX(_containerCapacity * 2, 4);
+            _containers = realloc(_containers, _containerCapacity * sizeof(TTMBitsetContainer));
+        }
+        memmove(_containers + position + 1, _containers + position,
+                (_containerCount - position) * sizeof(TTMBitsetContainer));
+        _containers[position] = (TTMBitsetContainer){.key = key};
+        _containerCount++;
+    }
+    if (ContainerAdd(&_containers[position], (uint16_t)index)) {
+        _count++;
+    }
+}
+
+- (void)removeIndex:(uint32_t)index {
+    NSInteger position = ContainerSearch(_containers, _containerCount, (uint16_t)(index >> 16));
+    if (position < 0 || !ContainerRemove(&_containers[position], (uint16_t)index)) {
+        return;
+    }
+    _count--;
+    if (_containers[position].cardinality == 0) {
+        ContainerFree(&_containers[position]);
+        memmove(_containers + position, _containers + position + 1,
+                (_containerCount - position - 1) * sizeof(TTMBitsetContainer));
+        _containerCount--;
+    }
+}
+
+- (BOOL)containsIndex:(uint32_t)index {
+    NSInteger position = ContainerSearch(_containers, _containerCount, (uint16_t)(index >> 16));
+    return position >= 0 && ContainerContains(&_containers[position], (uint16_t)index);
+}
+
+#pragma mark - Set Operation Methods
+
+- (void)unionWithBitset:(TTMTaskBitset*)bitset {
+    [self combineWithBitset:bitset operation:TTMSetUnion];
+}
+
+- (void)intersectWithBitset:(TTMTaskBitset*)bitset {
+    [self combineWithBitset:bitset operation:TTMSetIntersection];
+}
+
+- (void)subtractBitset:(TTMTaskBitset*)bitset {
+    [self combineWithBitset:bitset operation:TTMSetDifference];
+}
+
+- (void)combineWithBitset:(TTMTaskBitset*)bitset operation:(TTMSetOperation)operation {
+    if (bitset == self) {
+        bitset = [bitset copy];
+    }
+    const TTMBitsetContainer *others = bitset->_containers;
+    NSUInteger otherCount = bitset->_containerCount;
+    NSUInteger capacity = MAX((operation == TTMSetUnion) ? _containerCount + otherCount :
+                                                           _containerCount, 1);
+    TTMBitsetContainer *results = malloc(capacity * sizeof(TTMBitsetContainer));
+    NSUInteger resultCount = 0;
+    NSUInteger count = 0;
+    
+    // Walk both sorted lists of containers, combining the ones with the same key.
+    NSUInteger i = 0, j = 0;
+    while (i < _containerCount || j < otherCount) {
+        TTMBitsetContainer result;
+        if (j == otherCount || (i < _containerCount && _containers[i].key < others[j].key)) {
+            if (operation == TTMSetIntersection) {
+                ContainerFree(&_containers[i++]);
+                continue;
+            }
+            result = _containers[i++];
+        } else if (i == _containerCount || others[j].key < _containers[i].key) {
+            if (operation != TTMSetUnion) {
+                j++;
+                continue;
+            }
+            result = ContainerCopy(&others[j++]);
+        } else {
+            result = ContainerCombine(&_containers[i], &others[j], operation);
+            ContainerFree(&_containers[i]);
+            i++;
+            j++;
+            if (result.cardinality == 0) {
+                ContainerFree(&result);
+                continue;
+            }
+        }
+        results[resultCount++] = result;
+        count += result.cardinality;
+    }
+    
+    free(_containers);
+    _containers = results;
+    _containerCount = resultCount;
+    _containerCapacity = capacity;
+    _count = count;
+}
+
+- (NSUInteger)countOfIntersectionWithBitset:(TTMTaskBitset*)bitset {
+    NSUInteger count = 0;
+    NSUInteger i = 0, j = 0;
+    while (i < _containerCount && j < bitset->_containerCount) {
+        uint16_t key = _containers[i].key;
+        uint16_t otherKey = bitset->_containers[j].key;
+        if (key == otherKey) {
+            count += ContainerIntersectionCount(&_containers[i], &bitset->_containers[j]);
+        }
+        i += (key <= otherKey);
+        j += (otherKey <= key);
+    }
+    return count;
+}
+
+- (void)enumerateIndexesUsingBlock:(void (^)(uint32_t index, BOOL *stop))block {
+    BOOL stop = NO;
+    for (NSUInteger i = 0; i < _containerCount && !stop; i++) {
+        const TTMBitsetContainer *container = &_containers[i];
+        uint32_t high = (uint32_t)container->key << 16;
+        if (container->isBitmap) {
+            for (uint32_t w = 0; w < BitmapWordCount && !stop; w++) {
+                uint64_t word = container->words[w];
+                while (word != 0 && !stop) {
+                    block(high | (w * 64 + __builtin_ctzll(word)), &stop);
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (uint32_t v = 0; v < container->cardinality && !stop; v++) {
+                block(high | container->values[v], &stop);
+            }
+        }
+    }
+}
+
+@end
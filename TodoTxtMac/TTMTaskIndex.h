@@ -0,0 +1,177 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "TTMTaskBitset.h"
+@class TTMTask;
+
+/*! The kinds of token a TTMTaskIndex indexes tasks by. */
+typedef enum : NSUInteger {
+    /*! A "+project". */
+    TTMTaskIndexProject,
+    /*! An "@context". */
+    TTMTaskIndexContext,
+    /*! A "key:value" tag, such as "due:2016-01-01". */
+    TTMTaskIndexTag,
+    /*! The key of a tag, up to its first colon, such as "due". */
+    TTMTaskIndexTagKey
+} TTMTaskIndexTokenKind;
+
+/*!
+ * @class TTMTaskIndex
+ * @abstract TTMTaskIndex maps the projects, contexts and tags of a task list to the tasks
+ * that have them.
+ * @discussion Each token has a TTMTaskBitset of the unique IDs (truncated to 32 bits) of
+ * the tasks that have it, so questions about tokens are answered with set operations
+ * instead of by reading every task. A document adds and removes tasks as they enter and
+ * leave its task list. Tasks that change in place are found by their rawTextRevision the
+ * next time the index is asked anything, and only they are indexed again. Tasks are
+ * indexed the first time the index is asked anything after they were added.
+ *
+ * The index also maps each trigram (three UTF-16 characters) of the tasks' raw text,
+ * folded case- and diacritic-insensitively, to the tasks that have it, so a text search
+ * only has to check the tasks that have every trigram of the string searched for. The
+ * trigrams are only indexed once a text search is made, and are kept up to date after that.
+ * Use an index from one thread at a time.
+ */
+@interface TTMTaskIndex : NSObject
+
+/*! The number of tasks in the index. */
+@property (nonatomic, readonly) NSUInteger count;
+
+/*! Counts the calls that added or removed tasks, to tell when the set of tasks changed. */
+@property (nonatomic, readonly) NSUInteger mutationCount;
+
+/*!
+ * @method addTasks:
+ * @abstract Adds tasks to the index.
+ * @discussion A task replaces any task with the same unique ID already in the index.
+ * @param tasks The tasks to add.
+ */
+- (void)addTasks:(NSArray*)tasks;
+
+/*!
+ * @method removeTasks:
+ * @abstract Removes tasks from the index.
+ * @discussion A task is only removed if it is the task the index holds for its unique ID,
+ * so removing a task that a copy has since replaced leaves the copy in the index.
+ * @param tasks The tasks to remove.
+ */
+- (void)removeTasks:(NSArray*)tasks;
+
+/*!
+ * @method removeAllTasks
+ * @abstract Empties the index.
+ */
+- (void)removeAllTasks;
+
+/*!
+ * @method allTasks
+ * @return A new set of every task in the index.
+ */
+- (TTMTaskBitset*)allTasks;
+
+/*!
+ * @method tasksWithToken:ofKind:
+ * @abstract Finds the tasks that have a token.
+ * @param token The token, such as "+Family", compared exactly.
+ * @param kind The kind of token.
+ * @return A new set of the tasks that have the token.
+ */
+- (TTMTaskBitset*)tasksWithToken:(NSString*)token ofKind:(TTMTaskIndexTokenKind)kind;
+
+/*!
+ * @method tasksWithTokenOfKind:containing:options:
+ * @abstract Finds the tasks that have a token containing a string.
+ * @discussion The string and the tokens are folded with the options before they are
+ * compared, as TTMCompiledPredicate compares strings.
+ * @param kind The kind of token.
+ * @param string The string to look for in the tokens.
+ * @param options NSCaseInsensitiveSearch, NSDiacriticInsensitiveSearch, both, or neither.
+ * @return A new set of the tasks that have a token containing the string.
+ */
+- (TTMTaskBitset*)tasksWithTokenOfKind:(TTMTaskIndexTokenKind)kind
+                            containing:(NSString*)string
+                               options:(NSStringCompareOptions)options;
+
+/*!
+ * @method canNarrowTextSearchForString:
+ * @abstract Tells whether candidateTasksWithTextContaining: can narrow a search.
+ * @param string The string to search for.
+ * @return YES if the string is at least a trigram long once it is folded.
+ */
++ (BOOL)canNarrowTextSearchForString:(NSString*)string;
+
+/*!
+ * @method candidateTasksWithTextContaining:
+ * @abstract Finds the tasks whose raw text might contain a string.
+ * @discussion Raw text that contains the string when both are folded case- and
+ * diacritic-insensitively has every trigram of the folded string, so every such task is
+ * in the set, along with any tasks that have the trigrams in other places. The caller
+ * checks the candidates' text.
+ * @param string The string to search for, which canNarrowTextSearchForString: accepts.
+ * @return A new set of the tasks that have every trigram of the folded string.
+ */
+- (TTMTaskBitset*)candidateTasksWithTextContaining:(NSString*)string;
+
+/*!
+ * @method taskCountsOfTokensOfKind:inTasks:
+ * @abstract Counts the tasks that have each token.
+ * @param kind The kind of token.
+ * @param tasks The tasks to count, or nil to count every task in the index.
+ * @return A dictionary from each token that some counted task has to its number of tasks.
+ */
+- (NSDictionary*)taskCountsOfTokensOfKind:(TTMTaskIndexTokenKind)kind inTasks:(TTMTaskBitset*)tasks;
+
+/*!
+ * @method bitsetOfTasks:
+ * @abstract Makes the set of some tasks, to compare with the sets the index returns.
+ * @param tasks An array of TTMTask objects.
+ * @return A new set of the tasks' unique IDs.
+ */
++ (TTMTaskBitset*)bitsetOfTasks:(NSArray*)tasks;
+
+@end
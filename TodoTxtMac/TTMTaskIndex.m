@@ -0,0 +1,433 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMTaskIndex.h"
+#import "TTMTask.h"
+#import "TTMTaskParser.h"
+
+#define TokenKindCount 4
+#define TrigramLength 3
+
+static const NSStringCompareOptions CaseAndDiacriticInsensitive =
+    NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch;
+
+#pragma mark - Trigrams
+
+// A trigram packed into the integer key of a map table. The high bit keeps it from being
+// zero, which a map table cannot hold.
+typedef uintptr_t TTMTrigram;
+
+static inline TTMTrigram MakeTrigram(const unichar *characters) {
+    return ((TTMTrigram)1 << 48) | ((TTMTrigram)characters[0] << 32) |
+           ((TTMTrigram)characters[1] << 16) | (TTMTrigram)characters[2];
+}
+
+// Calls block with each trigram of string, including repeats.
+static void EnumerateTrigrams(NSString *string, void (^block)(TTMTrigram trigram)) {
+    NSUInteger length = string.length;
+    if (length < TrigramLength) {
+        return;
+    }
+    unichar stackCharacters[256];
+    unichar *characters = (length <= 256) ? stackCharacters : malloc(length * sizeof(unichar));
+    [string getCharacters:characters range:NSMakeRange(0, length)];
+    for (NSUInteger i = 0; i + TrigramLength <= length; i++) {
+        block(MakeTrigram(characters + i));
+    }
+    if (characters != stackCharacters) {
+        free(characters);
+    }
+}
+
+/*! The tasks that have one token. */
+@interface TTMTaskIndexPosting : NSObject
+
+@property (nonatomic, readonly) TTMTaskBitset *tasks;
+// The token folded case- and diacritic-insensitively, made the first time it is searched.
+@property (nonatomic) NSString *foldedToken;
+
+@end
+
+@implementation TTMTaskIndexPosting
+
+- (id)init {
+    self = [super init];
+    if (self) {
+        _tasks = [[TTMTaskBitset alloc] init];
+    }
+    return self;
+}
+
+@end
+
+/*! What the index knows about one task. */
+@interface TTMTaskIndexEntry : NSObject
+
+@property (nonatomic) TTMTask *task;
+// Where the entry is in the index's array of entries.
+@property (nonatomic) NSUInteger position;
+// The rawTextRevision the task was indexed at, or zero if it has not been indexed.
+@property (nonatomic) NSUInteger indexedRevision;
+// The task's tokens when it was indexed, as an array of arrays of each kind.
+@property (nonatomic) NSArray *tokensByKind;
+// The folded raw text whose trigrams were indexed, or nil if they were not.
+@property (nonatomic) NSString *indexedText;
+
+@end
+
+@implementation TTMTaskIndexEntry
+
+@end
+
+@implementation TTMTaskIndex {
+    NSMutableArray *_entries;
+    NSMutableDictionary *_entriesByUniqueId;
+    NSMutableDictionary *_postingsByToken[TokenKindCount];
+    TTMTaskBitset *_allTasks;
+    // Trigrams to the TTMTaskBitset of tasks that have them, once a text search is made.
+    NSMapTable *_tasksByTrigram;
+    // The latest rawTextRevision when the entries were last checked for changed tasks.
+    NSUInteger _checkedRevision;
+    BOOL _hasUnindexedTasks;
+}
+
+#pragma mark - Init Methods
+
+- (id)init {
+    self = [super init];
+    if (self) {
+        [self removeAllTasks];
+    }
+    return self;
+}
+
+#pragma mark - Task Methods
+
+- (NSUInteger)count {
+    return _entries.count;
+}
+
+- (void)addTasks:(NSArray*)tasks {
+    _mutationCount++;
+    for (TTMTask *task in tasks) {
+        NSNumber *uniqueId = @(task.uniqueId);
+        TTMTaskIndexEntry *entry = _entriesByUniqueId[uniqueId];
+        if (entry != nil) {
+            if (entry.task == task) {
+                continue;
+            }
+            // A copy restored by undo takes its original's place.
+            [self unindexEntry:entry];
+            entry.task = task;
+        } else {
+            entry = [[TTMTaskIndexEntry alloc] init];
+            entry.task = task;
+            entry.position = _entries.count;
+            [_entries addObject:entry];
+            _entriesByUniqueId[uniqueId] = entry;
+            [_allTasks addIndex:(uint32_t)task.uniqueId];
+        }
+        _hasUnindexedTasks = YES;
+    }
+}
+
+- (void)removeTasks:(NSArray*)tasks {
+    _mutationCount++;
+    for (TTMTask *task in tasks) {
+        NSNumber *uniqueId = @(task.uniqueId);
+        TTMTaskIndexEntry *entry = _entriesByUniqueId[uniqueId];
+        if (entry.task != task) {
+            continue;
+        }
+        [self unindexEntry:entry];
+        
+        // Move the last entry into the removed entry's place.
+        TTMTaskIndexEntry *lastEntry = [_entries lastObject];
+        lastEntry.position = entry.position;
+        _entries[entry.position] = lastEntry;
+        [_entries removeLastObject];
+        
+        [_entriesByUniqueId removeObjectForKey:uniqueId];
+        [_allTasks removeIndex:(uint32_t)task.uniqueId];
+    }
+}
+
+- (void)removeAllTasks {
+    _mutationCount++;
+    _entries = [[NSMutableArray alloc] init];
+    _entriesByUniqueId = [[NSMutableDictionary alloc] init];
+    for (NSUInteger kind = 0; kind < TokenKindCount; kind++) {
+        _postingsByToken[kind] = [[NSMutableDictionary alloc] init];
+    }
+    _allTasks = [[TTMTaskBitset alloc] init];
+    _hasUnindexedTasks = NO;
+    if (_tasksByTrigram != nil) {
+        [_tasksByTrigram removeAllObjects];
+    }
+}
+
+#pragma mark - Indexing Methods
+
+- (void)indexChangedTasks {
+    NSUInteger latestRevision = [TTMTask latestRawTextRevision];
+    if (!_hasUnindexedTasks && latestRevision == _checkedRevision) {
+        return;
+    }
+    for (TTMTaskIndexEntry *entry in _entries) {
+        if (entry.indexedRevision != entry.task.rawTextRevision) {
+            [self unindexEntry:entry];
+            [self indexEntry:entry];
+        }
+    }
+    _checkedRevision = latestRevision;
+    _hasUnindexedTasks = NO;
+}
+
+- (void)indexEntry:(TTMTaskIndexEntry*)entry {
+    TTMTask *task = entry.task;
+    NSArray *tokensByKind = [self tokensOfTask:task];
+    uint32_t index = (uint32_t)task.uniqueId;
+    for (NSUInteger kind = 0; kind < TokenKindCount; kind++) {
+        NSMutableDictionary *postingsByToken = _postingsByToken[kind];
+        for (NSString *token in tokensByKind[kind]) {
+            TTMTaskIndexPosting *posting = postingsByToken[token];
+            if (posting == nil) {
+                posting = [[TTMTaskIndexPosting alloc] init];
+                postingsByToken[token] = posting;
+            }
+            [posting.tasks addIndex:index];
+        }
+    }
+    entry.tokensByKind = tokensByKind;
+    entry.indexedRevision = task.rawTextRevision;
+    if (_tasksByTrigram != nil) {
+        [self indexTrigramsOfEntry:entry];
+    }
+}
+
+- (void)unindexEntry:(TTMTaskIndexEntry*)entry {
+    uint32_t index = (uint32_t)entry.task.uniqueId;
+    for (NSUInteger kind = 0; kind < entry.tokensByKind.count; kind++) {
+        NSMutableDictionary *postingsByToken = _postingsByToken[kind];
+        for (NSString *token in entry.tokensByKind[kind]) {
+            TTMTaskIndexPosting *posting = postingsByToken[token];
+            [posting.tasks removeIndex:index];
+            if (posting != nil && posting.tasks.count == 0) {
+                [postingsByToken removeObjectForKey:token];
+            }
+        }
+    }
+    entry.tokensByKind = nil;
+    entry.indexedRevision = 0;
+    if (entry.indexedText != nil) {
+        [self unindexTrigramsOfEntry:entry];
+    }
+}
+
+- (void)indexTrigramsOfEntry:(TTMTaskIndexEntry*)entry {
+    NSString *text = entry.task.foldedRawText;
+    uint32_t index = (uint32_t)entry.task.uniqueId;
+    NSMapTable *tasksByTrigram = _tasksByTrigram;
+    EnumerateTrigrams(text, ^(TTMTrigram trigram) {
+        TTMTaskBitset *tasks = (__bridge TTMTaskBitset*)NSMapGet(tasksByTrigram, (void*)trigram);
+        if (tasks == nil) {
+            tasks = [[TTMTaskBitset alloc] init];
+            NSMapInsert(tasksByTrigram, (void*)trigram, (__bridge void*)tasks);
+        }
+        [tasks addIndex:index];
+    });
+    entry.indexedText = (text != nil) ? text : @"";
+}
+
+- (void)unindexTrigramsOfEntry:(TTMTaskIndexEntry*)entry {
+    uint32_t index = (uint32_t)entry.task.uniqueId;
+    NSMapTable *tasksByTrigram = _tasksByTrigram;
+    EnumerateTrigrams(entry.indexedText, ^(TTMTrigram trigram) {
+        TTMTaskBitset *tasks = (__bridge TTMTaskBitset*)NSMapGet(tasksByTrigram, (void*)trigram);
+        [tasks removeIndex:index];
+        if (tasks != nil && tasks.count == 0) {
+            NSMapRemove(tasksByTrigram, (void*)trigram);
+        }
+    });
+    entry.indexedText = nil;
+}
+
+- (NSArray*)tokensOfTask:(TTMTask*)task {
+    NSArray *projects = task.projectsArray ?: @[];
+    NSArray *contexts = task.contextsArray ?: @[];
+    
+    // Only the tags need another scan, and a line without a colon has none.
+    NSString *rawText = task.rawText;
+    NSMutableArray *tags = [[NSMutableArray alloc] init];
+    if (rawText.length > 0 && [rawText rangeOfString:@":"].location != NSNotFound) {
+        TTMTaskScanResult scan;
+        [TTMTaskParser scanString:rawText result:&scan projects:nil contexts:nil tags:tags];
+    }
+    NSMutableArray *tagKeys = [[NSMutableArray alloc] initWithCapacity:tags.count];
+    for (NSString *tag in tags) {
+        [tagKeys addObject:[tag substringToIndex:[tag rangeOfString:@":"].location]];
+    }
+    
+    return @[projects, contexts, (tags.count > 0) ? tags : @[], tagKeys];
+}
+
+#pragma mark - Query Methods
+
+- (TTMTaskBitset*)allTasks {
+    return [_allTasks copy];
+}
+
+- (TTMTaskBitset*)tasksWithToken:(NSString*)token ofKind:(TTMTaskIndexTokenKind)kind {
+    [self indexChangedTasks];
+    TTMTaskIndexPosting *posting = _postingsByToken[kind][token];
+    return (posting != nil) ? [posting.tasks copy] : [[TTMTaskBitset alloc] init];
+}
+
+- (TTMTaskBitset*)tasksWithTokenOfKind:(TTMTaskIndexTokenKind)kind
+                            containing:(NSString*)string
+                               options:(NSStringCompareOptions)options {
+    [self indexChangedTasks];
+    options &= NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch;
+    NSString *foldedString = (options == 0) ?
+        string : [string stringByFoldingWithOptions:options locale:nil];
+    // With the diacritics folded away, the folded strings can be compared literally.
+    NSStringCompareOptions searchOptions =
+        (options & NSDiacriticInsensitiveSearch) ? NSLiteralSearch : 0;
+    
+    TTMTaskBitset *tasks = [[TTMTaskBitset alloc] init];
+    [_postingsByToken[kind] enumerateKeysAndObjectsUsingBlock:
+     ^(NSString *token, TTMTaskIndexPosting *posting, BOOL *stop) {
+         NSString *foldedToken = [self foldedToken:token ofPosting:posting options:options];
+         if ([foldedToken rangeOfString:foldedString options:searchOptions].location != NSNotFound) {
+             [tasks unionWithBitset:posting.tasks];
+         }
+     }];
+    return tasks;
+}
+
+- (NSString*)foldedToken:(NSString*)token
+               ofPosting:(TTMTaskIndexPosting*)posting
+                 options:(NSStringCompareOptions)options {
+    if (options == 0) {
+        return token;
+    }
+    if (options != (NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch)) {
+        return [token stringByFoldingWithOptions:options locale:nil];
+    }
+    if (posting.foldedToken == nil) {
+        posting.foldedToken = [token stringByFoldingWithOptions:options locale:nil];
+    }
+    return posting.foldedToken;
+}
+
++ (BOOL)canNarrowTextSearchForString:(NSString*)string {
+    return [string stringByFoldingWithOptions:CaseAndDiacriticInsensitive locale:nil].length >=
+        TrigramLength;
+}
+
+- (TTMTaskBitset*)candidateTasksWithTextContaining:(NSString*)string {
+    [self indexChangedTasks];
+    if (_tasksByTrigram == nil) {
+        // Index the trigrams of the tasks indexed so far; later tasks are indexed with them.
+        _tasksByTrigram = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory |
+                                                             NSPointerFunctionsIntegerPersonality
+                                                valueOptions:NSPointerFunctionsStrongMemory];
+        for (TTMTaskIndexEntry *entry in _entries) {
+            [self indexTrigramsOfEntry:entry];
+        }
+    }
+    
+    // Intersect the trigrams' sets, smallest first, so the candidates shrink quickly.
+    NSMutableArray *trigramTasks = [[NSMutableArray alloc] init];
+    __block BOOL hasMissingTrigram = NO;
+    NSMapTable *tasksByTrigram = _tasksByTrigram;
+    EnumerateTrigrams([string stringByFoldingWithOptions:CaseAndDiacriticInsensitive locale:nil],
+                      ^(TTMTrigram trigram) {
+        TTMTaskBitset *tasks = (__bridge TTMTaskBitset*)NSMapGet(tasksByTrigram, (void*)trigram);
+        if (tasks == nil) {
+            hasMissingTrigram = YES;
+        } else if ([trigramTasks indexOfObjectIdenticalTo:tasks] == NSNotFound) {
+            [trigramTasks addObject:tasks];
+        }
+    });
+    if (hasMissingTrigram || trigramTasks.count == 0) {
+        return [[TTMTaskBitset alloc] init];
+    }
+    [trigramTasks sortUsingComparator:^NSComparisonResult(TTMTaskBitset *tasks1, TTMTaskBitset *tasks2) {
+        return (tasks1.count < tasks2.count) ? NSOrderedAscending :
+               (tasks1.count > tasks2.count) ? NSOrderedDescending : NSOrderedSame;
+    }];
+    TTMTaskBitset *candidates = [trigramTasks[0] copy];
+    for (NSUInteger i = 1; i < trigramTasks.count && candidates.count > 0; i++) {
+        [candidates intersectWithBitset:trigramTasks[i]];
+    }
+    return candidates;
+}
+
+- (NSDictionary*)taskCountsOfTokensOfKind:(TTMTaskIndexTokenKind)kind inTasks:(TTMTaskBitset*)tasks {
+    [self indexChangedTasks];
+    NSMutableDictionary *counts = [NSMutableDictionary
+                                   dictionaryWithCapacity:_postingsByToken[kind].count];
+    [_postingsByToken[kind] enumerateKeysAndObjectsUsingBlock:
+     ^(NSString *token, TTMTaskIndexPosting *posting, BOOL *stop) {
+         NSUInteger count = (tasks == nil) ?
+            posting.tasks.count : [posting.tasks countOfIntersectionWithBitset:tasks];
+         if (count > 0) {
+             counts[token] = @(count);
+         }
+     }];
+    return counts;
+}
+
++ (TTMTaskBitset*)bitsetOfTasks:(NSArray*)tasks {
+    TTMTaskBitset *bitset = [[TTMTaskBitset alloc] init];
+    for (TTMTask *task in tasks) {
+        [bitset addIndex:(uint32_t)task.uniqueId];
+    }
+    return bitset;
+}
+
+@end
@@ -0,0 +1,171 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class TTMSymbolTable;
+@class TTMLineIndex;
+@class TTMTask;
+
+/*!
+ * Builds the task for one non-blank line. taskIndex counts non-blank lines from zero.
+ * Returns nil to fail the whole load. It is called concurrently from several threads.
+ */
+typedef TTMTask* (^TTMTaskBuilder)(NSString *rawText, NSUInteger taskIndex, NSUInteger taskId);
+
+/*!
+ * @class TTMTaskLoader
+ * @abstract TTMTaskLoader turns the lines of a todo.txt file into tasks.
+ * @discussion Lines are parsed in contiguous chunks on all cores with dispatch_apply. Blank
+ * lines are skipped, and the remaining tasks are numbered in line order exactly as if they
+ * had been created one at a time. Files are loaded straight from their (memory-mapped)
+ * bytes through a TTMLineIndex, so each task's text is the only string made from a line.
+ */
+@interface TTMTaskLoader : NSObject
+
+/*!
+ * @method tasksFromRawTextStrings:firstTaskId:symbolTable:
+ * @abstract Creates a task for every non-blank line, using every available core.
+ * @param rawTextStrings The lines of the file, without line endings.
+ * @param firstTaskId The task ID to give the first task.
+ * @param symbolTable The symbol table to intern the tasks' projects and contexts in.
+ * @return An array of tasks, in line order. Their dates, projects, and contexts are
+ * already decoded.
+ */
++ (NSArray*)tasksFromRawTextStrings:(NSArray*)rawTextStrings
+                        firstTaskId:(NSUInteger)firstTaskId
+                        symbolTable:(TTMSymbolTable*)symbolTable;
+
+/*!
+ * @method tasksFromRawTextStrings:firstTaskId:symbolTable:workerCount:
+ * @abstract Creates a task for every non-blank line, splitting the lines into one chunk
+ * per worker.
+ * @param rawTextStrings The lines of the file, without line endings.
+ * @param firstTaskId The task ID to give the first task.
+ * @param symbolTable The symbol table to intern the tasks' projects and contexts in.
+ * @param workerCount The number of chunks to parse concurrently. Pass 1 to parse on the
+ * calling thread.
+ * @return An array of tasks, in line order. Their dates, projects, and contexts are
+ * already decoded.
+ */
++ (NSArray*)tasksFromRawTextStrings:(NSArray*)rawTextStrings
+                        firstTaskId:(NSUInteger)firstTaskId
+                        symbolTable:(TTMSymbolTable*)symbolTable
+                        workerCount:(NSUInteger)workerCount;
+
+/*!
+ * @method tasksFromData:lineIndex:firstTaskId:symbolTable:
+ * @abstract Creates a task for every non-blank line of a UTF-8 file, using every available
+ * core.
+ * @param data The contents of the file, which may be memory-mapped.
+ * @param lineIndex The index of the lines in data.
+ * @param firstTaskId The task ID to give the first task.
+ * @param symbolTable The symbol table to intern the tasks' projects and contexts in.
+ * @return An array of tasks, in line order, or nil if any line is not valid UTF-8. Their
+ * dates, projects, and contexts are already decoded.
+ */
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              symbolTable:(TTMSymbolTable*)symbolTable;
+
+/*!
+ * @method tasksFromData:lineIndex:firstTaskId:symbolTable:workerCount:
+ * @abstract Creates a task for every non-blank line of a UTF-8 file, splitting the lines
+ * into one chunk per worker.
+ * @param data The contents of the file, which may be memory-mapped.
+ * @param lineIndex The index of the lines in data.
+ * @param firstTaskId The task ID to give the first task.
+ * @param symbolTable The symbol table to intern the tasks' projects and contexts in.
+ * @param workerCount The number of chunks to parse concurrently. Pass 1 to parse on the
+ * calling thread.
+ * @return An array of tasks, in line order, or nil if any line is not valid UTF-8. Their
+ * dates, projects, and contexts are already decoded.
+ */
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              symbolTable:(TTMSymbolTable*)symbolTable
+              workerCount:(NSUInteger)workerCount;
+
+/*!
+ * @method tasksFromData:lineIndex:firstTaskId:taskBuilder:
+ * @abstract Creates a task for every non-blank line of a UTF-8 file with a custom builder,
+ * using every available core.
+ * @discussion TTMParseCache uses this to restore tasks from their cached state instead of
+ * parsing them.
+ * @param data The contents of the file, which may be memory-mapped.
+ * @param lineIndex The index of the lines in data.
+ * @param firstTaskId The task ID to give the first task.
+ * @param taskBuilder The block that creates each task.
+ * @return An array of tasks, in line order, or nil if any line is not valid UTF-8 or the
+ * builder returned nil.
+ */
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              taskBuilder:(TTMTaskBuilder)taskBuilder;
+
+/*!
+ * @method tasksFromData:lineIndex:firstTaskId:taskBuilder:workerCount:
+ * @abstract Creates a task for every non-blank line of a UTF-8 file with a custom builder,
+ * splitting the lines into one chunk per worker.
+ * @param data The contents of the file, which may be memory-mapped.
+ * @param lineIndex The index of the lines in data.
+ * @param firstTaskId The task ID to give the first task.
+ * @param taskBuilder The block that creates each task.
+ * @param workerCount The number of chunks to build concurrently. Pass 1 to build on the
+ * calling thread.
+ * @return An array of tasks, in line order, or nil if any line is not valid UTF-8 or the
+ * builder returned nil.
+ */
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              taskBuilder:(TTMTaskBuilder)taskBuilder
+              workerCount:(NSUInteger)workerCount;
+
+@end
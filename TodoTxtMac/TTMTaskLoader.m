@@ -0,0 +1,202 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMTaskLoader.h"
+#import "TTMTask.h"
+#import "TTMLineIndex.h"
+
+// Below this many lines, handing chunks to other threads costs more than it saves.
+static const NSUInteger MinimumLinesPerWorker = 256;
+
+@implementation TTMTaskLoader
+
++ (NSArray*)tasksFromRawTextStrings:(NSArray*)rawTextStrings
+                        firstTaskId:(NSUInteger)firstTaskId
+                        symbolTable:(TTMSymbolTable*)symbolTable {
+    return [self tasksFromRawTextStrings:rawTextStrings
+                             firstTaskId:firstTaskId
+                             symbolTable:symbolTable
+                             workerCount:[[NSProcessInfo processInfo] activeProcessorCount]];
+}
+
++ (NSArray*)tasksFromRawTextStrings:(NSArray*)rawTextStrings
+                        firstTaskId:(NSUInteger)firstTaskId
+                        symbolTable:(TTMSymbolTable*)symbolTable
+                        workerCount:(NSUInteger)workerCount {
+    return [self tasksFromLineCount:[rawTextStrings count]
+                        isLineBlank:^BOOL(NSUInteger line) {
+                            return ([rawTextStrings[line] length] == 0);
+                        }
+                         lineString:^NSString*(NSUInteger line) {
+                             return rawTextStrings[line];
+                         }
+                        firstTaskId:firstTaskId
+                        taskBuilder:[self parsingTaskBuilderWithSymbolTable:symbolTable]
+                        workerCount:workerCount];
+}
+
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              symbolTable:(TTMSymbolTable*)symbolTable {
+    return [self tasksFromData:data
+                     lineIndex:lineIndex
+                   firstTaskId:firstTaskId
+                   symbolTable:symbolTable
+                   workerCount:[[NSProcessInfo processInfo] activeProcessorCount]];
+}
+
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              symbolTable:(TTMSymbolTable*)symbolTable
+              workerCount:(NSUInteger)workerCount {
+    return [self tasksFromData:data
+                     lineIndex:lineIndex
+                   firstTaskId:firstTaskId
+                   taskBuilder:[self parsingTaskBuilderWithSymbolTable:symbolTable]
+                   workerCount:workerCount];
+}
+
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              taskBuilder:(TTMTaskBuilder)taskBuilder {
+    return [self tasksFromData:data
+                     lineIndex:lineIndex
+                   firstTaskId:firstTaskId
+                   taskBuilder:taskBuilder
+                   workerCount:[[NSProcessInfo processInfo] activeProcessorCount]];
+}
+
++ (NSArray*)tasksFromData:(NSData*)data
+                lineIndex:(TTMLineIndex*)lineIndex
+              firstTaskId:(NSUInteger)firstTaskId
+              taskBuilder:(TTMTaskBuilder)taskBuilder
+              workerCount:(NSUInteger)workerCount {
+    const char *bytes = data.bytes;
+    // Plain ASCII lines can skip UTF-8 decoding.
+    NSStringEncoding encoding = lineIndex.isASCII ? NSASCIIStringEncoding : NSUTF8StringEncoding;
+    return [self tasksFromLineCount:lineIndex.lineCount
+                        isLineBlank:^BOOL(NSUInteger line) {
+                            return ([lineIndex rangeOfLineAtIndex:line].length == 0);
+                        }
+                         lineString:^NSString*(NSUInteger line) {
+                             NSRange range = [lineIndex rangeOfLineAtIndex:line];
+                             return [[NSString alloc] initWithBytes:bytes + range.location
+                                                             length:range.length
+                                                           encoding:encoding];
+                         }
+                        firstTaskId:firstTaskId
+                        taskBuilder:taskBuilder
+                        workerCount:workerCount];
+}
+
++ (TTMTaskBuilder)parsingTaskBuilderWithSymbolTable:(TTMSymbolTable*)symbolTable {
+    return ^TTMTask*(NSString *rawText, NSUInteger taskIndex, NSUInteger taskId) {
+        TTMTask *task = [[TTMTask alloc] initWithRawText:rawText withTaskId:taskId];
+        task.symbolTable = symbolTable;
+        [task decodeSortAndFilterFields];
+        return task;
+    };
+}
+
++ (NSArray*)tasksFromLineCount:(NSUInteger)lineCount
+                   isLineBlank:(BOOL (^)(NSUInteger line))isLineBlank
+                    lineString:(NSString* (^)(NSUInteger line))lineString
+                   firstTaskId:(NSUInteger)firstTaskId
+                   taskBuilder:(TTMTaskBuilder)taskBuilder
+                   workerCount:(NSUInteger)workerCount {
+    // Find the non-blank lines first, so that each task's ID (and its slot in the result)
+    // is known before any chunk is parsed.
+    NSUInteger *lineIndexes = malloc(MAX(lineCount, (NSUInteger)1) * sizeof(NSUInteger));
+    NSUInteger taskCount = 0;
+    for (NSUInteger i = 0; i < lineCount; i++) {
+        if (!isLineBlank(i)) {
+            lineIndexes[taskCount++] = i;
+        }
+    }
+    
+    workerCount = MAX(MIN(workerCount, taskCount / MinimumLinesPerWorker), (NSUInteger)1);
+    NSUInteger linesPerWorker = (taskCount + workerCount - 1) / workerCount;
+    
+    // Every chunk writes only its own slots, so the workers need no locking here.
+    __strong TTMTask **tasks = (__strong TTMTask **)calloc(MAX(taskCount, (NSUInteger)1),
+                                                           sizeof(TTMTask*));
+    __block volatile BOOL failed = NO;
+    void (^parseChunk)(size_t) = ^(size_t worker) {
+        NSUInteger start = worker * linesPerWorker;
+        NSUInteger end = MIN(start + linesPerWorker, taskCount);
+        for (NSUInteger i = start; i < end && !failed; i++) {
+            @autoreleasepool {
+                NSString *rawText = lineString(lineIndexes[i]);
+                TTMTask *task = (rawText != nil) ? taskBuilder(rawText, i, firstTaskId + i) : nil;
+                if (task == nil) {
+                    failed = YES;
+                    break;
+                }
+                tasks[i] = task;
+            }
+        }
+    };
+    if (workerCount == 1) {
+        parseChunk(0);
+    } else {
+        dispatch_apply(workerCount,
+                       dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0),
+                       parseChunk);
+    }
+    
+    NSArray *result = failed ? nil : [[NSArray alloc] initWithObjects:tasks count:taskCount];
+    for (NSUInteger i = 0; i < taskCount; i++) {
+        tasks[i] = nil;
+    }
+    free(tasks);
+    free(lineIndexes);
+    return result;
+}
+
+@end
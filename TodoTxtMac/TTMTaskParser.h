@@ -0,0 +1,112 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @typedef TTMTaskScanResult
+ * @abstract The ranges and flags found by a single scan over a task's raw text.
+ * @discussion Ranges that were not found have a location of NSNotFound.
+ */
+typedef struct {
+    /*! The line starts with "x YYYY-MM-DD " (note the trailing space). */
+    BOOL hasCompletedPrefix;
+    /*! The "YYYY-MM-DD" following a leading "x ". */
+    NSRange completionDateRange;
+    /*! The "(A) " priority at the start of the line, including the trailing space. */
+    NSRange priorityRange;
+    /*! The first creation date of an incomplete task. */
+    NSRange creationDateRange;
+    /*! The creation date of a completed task, which follows the completion date. */
+    NSRange completedCreationDateRange;
+    /*! The date of the first "due:YYYY-MM-DD" tag. */
+    NSRange dueDateRange;
+    /*! The date of the first "t:YYYY-MM-DD" tag. */
+    NSRange thresholdDateRange;
+    /*! The pattern of the first "rec:" tag, e.g. "+1w". */
+    NSRange recurrenceRange;
+    /*! The line contains an "h:1" tag. */
+    BOOL isHidden;
+} TTMTaskScanResult;
+
+/*!
+ * @class TTMTaskParser
+ * @abstract TTMTaskParser splits a todo.txt line into its parts in one forward pass.
+ * @discussion The scanner matches the regular expressions used elsewhere in TTMTask exactly,
+ * including their quirks (such as "\d" matching any Unicode decimal digit and "$" matching
+ * before a trailing line terminator). TTMTask uses it in setRawText: instead of running a
+ * separate regular expression for each property.
+ * @seealso Todo.txt format specification:
+ * https://github.com/ginatrapani/todo.txt-cli/wiki/The-Todo.txt-Format
+ */
+@interface TTMTaskParser : NSObject
+
+/*!
+ * @method scanString:result:projects:contexts:tags:
+ * @abstract Scans a single line of todo.txt text.
+ * @param string The raw text of the task. It must not contain "\r" or "\n".
+ * @param result The struct to fill in with ranges and flags.
+ * @param projects If not nil, "+project" strings are appended to it in the order found.
+ * @param contexts If not nil, "@context" strings are appended to it in the order found.
+ * @param tags If not nil, "key:value" strings are appended to it in the order found.
+ */
++ (void)scanString:(NSString*)string
+            result:(TTMTaskScanResult*)result
+          projects:(NSMutableArray*)projects
+          contexts:(NSMutableArray*)contexts
+              tags:(NSMutableArray*)tags;
+
+/*!
+ * @method scanHeaderOfString:result:
+ * @abstract Scans only the start of a line of todo.txt text.
+ * @param string The raw text of the task. It must not contain "\r" or "\n".
+ * @param result The struct to fill in. Only hasCompletedPrefix, completionDateRange,
+ * completedCreationDateRange, and priorityRange are set; the other ranges are not found.
+ * @discussion Reads at most the first 24 characters of the line, however long it is.
+ */
++ (void)scanHeaderOfString:(NSString*)string result:(TTMTaskScanResult*)result;
+
+@end
@@ -0,0 +1,332 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMTaskParser.h"
+
+@implementation TTMTaskParser
+
+// Lines up to this length are copied to the stack rather than the heap.
+static const NSUInteger StackBufferLength = 256;
+
+// The header ("x YYYY-MM-DD YYYY-MM-DD") is 23 characters long.
+static const NSUInteger HeaderLength = 23;
+
+// Non-ASCII Unicode decimal digits (ICU's "\d") and characters outside ICU's "[:graph:]".
+static NSCharacterSet *DecimalDigitCharacterSet = nil;
+static NSCharacterSet *NonGraphCharacterSet = nil;
+
++ (void)initialize {
+    if (self != [TTMTaskParser class]) {
+        return;
+    }
+    DecimalDigitCharacterSet = [NSCharacterSet decimalDigitCharacterSet];
+    NSMutableCharacterSet *nonGraph = [NSMutableCharacterSet whitespaceAndNewlineCharacterSet];
+    [nonGraph addCharactersInRange:NSMakeRange(0x00, 0x20)];
+    [nonGraph addCharactersInRange:NSMakeRange(0x7F, 0x21)];
+    [nonGraph formUnionWithCharacterSet:[NSCharacterSet illegalCharacterSet]];
+    NonGraphCharacterSet = [nonGraph copy];
+}
+
+#pragma mark - Character Classes
+
+static inline BOOL IsDigit(unichar c) {
+    if (c < 0x80) {
+        return (c >= '0' && c <= '9');
+    }
+    return [DecimalDigitCharacterSet characterIsMember:c];
+}
+
+static inline BOOL IsGraph(unichar c) {
+    if (c < 0x80) {
+        return (c > ' ' && c != 0x7F);
+    }
+    return ![NonGraphCharacterSet characterIsMember:c];
+}
+
+static inline BOOL IsUppercaseASCIILetter(unichar c) {
+    return (c >= 'A' && c <= 'Z');
+}
+
+static inline BOOL IsRecurrenceUnit(unichar c) {
+    switch (c) {
+        case 'd': case 'D':
+        case 'w': case 'W':
+        case 'm': case 'M':
+        case 'y': case 'Y':
+        case 'b': case 'B':
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+// "$" matches at the end of the line, or before a line terminator that ends the line.
+// "\r" and "\n" are stripped from raw text before it is scanned.
+static inline BOOL IsLineTerminator(unichar c) {
+    return (c == 0x0B || c == 0x0C || c == 0x85 || c == 0x2028 || c == 0x2029);
+}
+
+#pragma mark - Token Tests
+
+static inline BOOL IsEnd(const unichar *s, NSUInteger n, NSUInteger i) {
+    return (i == n) || (i + 1 == n && IsLineTerminator(s[i]));
+}
+
+static inline BOOL HasPrefix(const unichar *s, NSUInteger n, NSUInteger i, const char *prefix) {
+    for (; *prefix != '\0'; prefix++, i++) {
+        if (i >= n || s[i] != (unichar)*prefix) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+// Matches "(\d{4})-(\d{2})-(\d{2})" at index i.
+static inline BOOL IsDate(const unichar *s, NSUInteger n, NSUInteger i) {
+    if (i + 10 > n) {
+        return NO;
+    }
+    return IsDigit(s[i]) && IsDigit(s[i + 1]) && IsDigit(s[i + 2]) && IsDigit(s[i + 3]) &&
+           s[i + 4] == '-' && IsDigit(s[i + 5]) && IsDigit(s[i + 6]) &&
+           s[i + 7] == '-' && IsDigit(s[i + 8]) && IsDigit(s[i + 9]);
+}
+
+// Matches "(\d{4})-(\d{2})-(\d{2})(?=[ ]|$)" at index i.
+static inline BOOL IsDelimitedDate(const unichar *s, NSUInteger n, NSUInteger i) {
+    if (!IsDate(s, n, i)) {
+        return NO;
+    }
+    NSUInteger end = i + 10;
+    return (end < n && s[end] == ' ') || IsEnd(s, n, end);
+}
+
+#pragma mark - Scan Methods
+
+static void ResetResult(TTMTaskScanResult *result) {
+    NSRange notFound = NSMakeRange(NSNotFound, 0);
+    result->hasCompletedPrefix = NO;
+    result->completionDateRange = notFound;
+    result->priorityRange = notFound;
+    result->creationDateRange = notFound;
+    result->completedCreationDateRange = notFound;
+    result->dueDateRange = notFound;
+    result->thresholdDateRange = notFound;
+    result->recurrenceRange = notFound;
+    result->isHidden = NO;
+}
+
+// Finds the parts of the task that can only appear at the start of the line.
+// n may be the length of a prefix of the line, as long as it covers HeaderLength characters.
+static void ScanHeader(const unichar *s, NSUInteger n, TTMTaskScanResult *result) {
+    // Completion: "^x[ ]" followed by the completion date and, for completed tasks,
+    // a space and an optional creation date.
+    if (HasPrefix(s, n, 0, "x ")) {
+        if (IsDelimitedDate(s, n, 2)) {
+            result->completionDateRange = NSMakeRange(2, 10);
+        }
+        if (IsDate(s, n, 2) && n > 12 && s[12] == ' ') {
+            result->hasCompletedPrefix = YES;
+            if (IsDelimitedDate(s, n, 13)) {
+                result->completedCreationDateRange = NSMakeRange(13, 10);
+            }
+        }
+    }
+
+    // Priority: "^(\([A-Z]\)[ ])"
+    if (n >= 4 && s[0] == '(' && IsUppercaseASCIILetter(s[1]) && s[2] == ')' && s[3] == ' ') {
+        result->priorityRange = NSMakeRange(0, 4);
+    }
+}
+
++ (void)scanHeaderOfString:(NSString*)string result:(TTMTaskScanResult*)result {
+    ResetResult(result);
+
+    // "x YYYY-MM-DD YYYY-MM-DD" plus the character after it, which decides whether the
+    // creation date is delimited.
+    unichar s[HeaderLength];
+    NSUInteger n = MIN([string length], HeaderLength);
+    [string getCharacters:s range:NSMakeRange(0, n)];
+    BOOL isTruncated = ([string length] > n);
+
+    // IsEnd() treats the end of the buffer as the end of the line, so only
+    // trust a date that ends at the buffer boundary if the line really ends there.
+    ScanHeader(s, n, result);
+    if (isTruncated && result->completedCreationDateRange.location != NSNotFound &&
+        NSMaxRange(result->completedCreationDateRange) == n) {
+        unichar next = [string characterAtIndex:n];
+        if (next != ' ' && !(IsLineTerminator(next) && [string length] == n + 1)) {
+            result->completedCreationDateRange = NSMakeRange(NSNotFound, 0);
+        }
+    }
+}
+
+
++ (void)scanString:(NSString*)string
+            result:(TTMTaskScanResult*)result
+          projects:(NSMutableArray*)projects
+          contexts:(NSMutableArray*)contexts
+              tags:(NSMutableArray*)tags {
+    ResetResult(result);
+
+    NSUInteger n = [string length];
+    if (n == 0) {
+        return;
+    }
+
+    // Get direct access to the UTF-16 characters, copying them only if necessary.
+    unichar stackBuffer[StackBufferLength];
+    unichar *heapBuffer = NULL;
+    const unichar *s = CFStringGetCharactersPtr((__bridge CFStringRef)string);
+    if (s == NULL) {
+        unichar *buffer = stackBuffer;
+        if (n > StackBufferLength) {
+            heapBuffer = malloc(n * sizeof(unichar));
+            buffer = heapBuffer;
+        }
+        [string getCharacters:buffer range:NSMakeRange(0, n)];
+        s = buffer;
+    }
+
+    ScanHeader(s, n, result);
+
+    // Every other pattern starts at the beginning of the line or after a space,
+    // so walk the line one space-delimited word at a time.
+    NSUInteger wordStart = 0;
+    while (wordStart <= n) {
+        NSUInteger wordEnd = wordStart;
+        while (wordEnd < n && s[wordEnd] != ' ') {
+            wordEnd++;
+        }
+        NSUInteger i = wordStart;
+
+        // Creation date of an incomplete task: the first date at the start of the line or
+        // after any "(A) ".
+        if (result->creationDateRange.location == NSNotFound &&
+            (i == 0 || (i >= 4 && s[i - 4] == '(' && IsUppercaseASCIILetter(s[i - 3]) &&
+                        s[i - 2] == ')')) &&
+            IsDelimitedDate(s, n, i)) {
+            result->creationDateRange = NSMakeRange(i, 10);
+        }
+
+        if (wordEnd > i) {
+            switch (s[i]) {
+                case '+':
+                    if (projects && wordEnd > i + 1) {
+                        [projects addObject:[string substringWithRange:
+                                             NSMakeRange(i, wordEnd - i)]];
+                    }
+                    break;
+                case '@':
+                    if (contexts && wordEnd > i + 1) {
+                        [contexts addObject:[string substringWithRange:
+                                             NSMakeRange(i, wordEnd - i)]];
+                    }
+                    break;
+                case 'd':
+                    if (result->dueDateRange.location == NSNotFound &&
+                        HasPrefix(s, n, i, "due:") && IsDelimitedDate(s, n, i + 4)) {
+                        result->dueDateRange = NSMakeRange(i + 4, 10);
+                    }
+                    break;
+                case 't':
+                    if (result->thresholdDateRange.location == NSNotFound &&
+                        HasPrefix(s, n, i, "t:") && IsDelimitedDate(s, n, i + 2)) {
+                        result->thresholdDateRange = NSMakeRange(i + 2, 10);
+                    }
+                    break;
+                case 'r':
+                    if (result->recurrenceRange.location == NSNotFound &&
+                        HasPrefix(s, n, i, "rec:")) {
+                        // "((\+?)\d+[dDwWmMyYbB])" with no trailing delimiter
+                        NSUInteger j = i + 4;
+                        if (j < n && s[j] == '+') {
+                            j++;
+                        }
+                        NSUInteger digitsStart = j;
+                        while (j < n && IsDigit(s[j])) {
+                            j++;
+                        }
+                        if (j > digitsStart && j < n && IsRecurrenceUnit(s[j])) {
+                            result->recurrenceRange = NSMakeRange(i + 4, j + 1 - (i + 4));
+                        }
+                    }
+                    break;
+                case 'h':
+                    if (HasPrefix(s, n, i, "h:1") &&
+                        (IsEnd(s, n, i + 3) || (i + 3 < n && s[i + 3] == ' '))) {
+                        result->isHidden = YES;
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            // Tags: "([:graph:]+:[:graph:]+)", which takes the whole run of graphic
+            // characters if it contains a colon that is neither first nor last.
+            if (tags) {
+                NSUInteger graphEnd = i;
+                while (graphEnd < wordEnd && IsGraph(s[graphEnd])) {
+                    graphEnd++;
+                }
+                for (NSUInteger j = i + 1; j + 1 < graphEnd; j++) {
+                    if (s[j] == ':') {
+                        [tags addObject:[string substringWithRange:
+                                         NSMakeRange(i, graphEnd - i)]];
+                        break;
+                    }
+                }
+            }
+        }
+
+        wordStart = wordEnd + 1;
+    }
+
+    if (heapBuffer) {
+        free(heapBuffer);
+    }
+}
+
+@end
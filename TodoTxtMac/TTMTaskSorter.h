@@ -0,0 +1,108 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+@class TTMTask;
+
+typedef enum : NSUInteger {
+    TTMSortOrderInFile,
+    TTMSortPriority,
+    TTMSortProject,
+    TTMSortContext,
+    TTMSortDueDate,
+    TTMSortCreationDate,
+    TTMSortCompletionDate,
+    TTMSortThresholdDate,
+    TTMSortAlphabetical
+} TTMTaskListSortType;
+
+/*!
+ * @class TTMTaskSorter
+ * @abstract TTMTaskSorter sorts tasks in the orders of the Sort menu.
+ * @discussion Every property a sort type compares is packed, most significant first, into
+ * one fixed-width integer key per task, and the keys are radix sorted. Projects, contexts
+ * and raw text are packed as their rank among the distinct strings being sorted, which is
+ * found by comparing their TTMCollator keys. The task ID
+ * is always the last property compared, so the order is the same on every sort.
+ */
+@interface TTMTaskSorter : NSObject
+
+/*!
+ * @method sortTasks:sortType:permutation:
+ * @abstract Finds the sorted order of tasks without reordering them.
+ * @param tasks The tasks to sort.
+ * @param sortType The order to sort them in.
+ * @param permutation An array of tasks.count indexes, which is filled with the index in
+ * tasks of the first task in sorted order, then of the second, and so on.
+ */
++ (void)sortTasks:(NSArray*)tasks
+         sortType:(TTMTaskListSortType)sortType
+      permutation:(NSUInteger*)permutation;
+
+/*!
+ * @method sortedTasks:sortType:
+ * @abstract Sorts tasks.
+ * @param tasks The tasks to sort.
+ * @param sortType The order to sort them in.
+ * @return A new array with the tasks in sorted order.
+ */
++ (NSArray*)sortedTasks:(NSArray*)tasks sortType:(TTMTaskListSortType)sortType;
+
+/*!
+ * @method compareTask:toTask:sortType:
+ * @abstract Compares two tasks in the same order that sortTasks:sortType:permutation: uses.
+ * @discussion Use this to find where one task goes in an already sorted list, for example
+ * with a binary search.
+ * @param task1 The first task.
+ * @param task2 The second task.
+ * @param sortType The order to compare them in.
+ * @return NSOrderedAscending if task1 sorts before task2.
+ */
++ (NSComparisonResult)compareTask:(TTMTask*)task1
+                           toTask:(TTMTask*)task2
+                         sortType:(TTMTaskListSortType)sortType;
+
+@end
@@ -0,0 +1,365 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMTaskSorter.h"
+#import "TTMTask.h"
+#import "TTMCollator.h"
+
+/*! A packed sort key. Properties are appended below the ones compared before them. */
+typedef unsigned __int128 TTMSortKey;
+
+typedef struct {
+    TTMSortKey key;
+    NSUInteger index;
+} TTMSortEntry;
+
+// Field widths. Days are counted from 0000-01-01, which fits every date that
+// TTMDateUtility accepts (years 0000-9999) in 22 bits, with zero left for tasks without one.
+static const unsigned DayBits = 22;
+static const unsigned PriorityBits = 5;
+static const unsigned DueStateBits = 2;
+static const unsigned FlagBits = 1;
+static const unsigned RankBits = 32;
+static const unsigned TaskIdBits = 32;
+static const TTMDayNumber FirstDayNumber = -719528;
+
+static inline TTMSortKey Append(TTMSortKey key, uint64_t value, unsigned bits) {
+    uint64_t maxValue = (1ULL << bits) - 1;
+    return (key << bits) | MIN(value, maxValue);
+}
+
+static inline uint64_t PackedDay(TTMDayNumber day) {
+    if (day == TTMNoDayNumber) {
+        return 0;
+    }
+    return (uint64_t)MAX((int64_t)day - FirstDayNumber + 1, 1);
+}
+
+static inline uint64_t PackedPriority(unichar priority) {
+    // A-Z become 0-25. Tasks without a priority have a tilde (~), which sorts after them.
+    return (priority >= 'A') ? (uint64_t)(priority - 'A') : 0;
+}
+
+static void RadixSortEntries(TTMSortEntry *entries, NSUInteger count) {
+    enum { DigitCount = sizeof(TTMSortKey), BucketCount = 256 };
+    NSUInteger (*histograms)[BucketCount] = calloc(DigitCount, sizeof(*histograms));
+    for (NSUInteger i = 0; i < count; i++) {
+        TTMSortKey key = entries[i].key;
+        for (unsigned digit = 0; digit < DigitCount; digit++) {
+            histograms[digit][(uint8_t)(key >> (digit * 8))]++;
+        }
+    }
+    
+    TTMSortEntry *buffer = malloc(count * sizeof(TTMSortEntry));
+    TTMSortEntry *from = entries;
+    TTMSortEntry *to = buffer;
+    for (unsigned digit = 0; digit < DigitCount; digit++) {
+        NSUInteger *histogram = histograms[digit];
+        // Skip digits that every key shares, such as the unused high bytes.
+        if (histogram[(uint8_t)(from[0].key >> (digit * 8))] == count) {
+            continue;
+        }
+        NSUInteger offsets[BucketCount];
+        NSUInteger offset = 0;
+        for (unsigned bucket = 0; bucket < BucketCount; bucket++) {
+            offsets[bucket] = offset;
+            offset += histogram[bucket];
+        }
+        for (NSUInteger i = 0; i < count; i++) {
+            to[offsets[(uint8_t)(from[i].key >> (digit * 8))]++] = from[i];
+        }
+        TTMSortEntry *swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != entries) {
+        memcpy(entries, from, count * sizeof(TTMSortEntry));
+    }
+    free(buffer);
+    free(histograms);
+}
+
+typedef struct {
+    const uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger index;
+} TTMRankEntry;
+
+static int CompareRankEntries(const void *entry1, const void *entry2) {
+    const TTMRankEntry *rankEntry1 = entry1;
+    const TTMRankEntry *rankEntry2 = entry2;
+    NSUInteger commonLength = MIN(rankEntry1->length, rankEntry2->length);
+    int result = (commonLength > 0) ? memcmp(rankEntry1->bytes, rankEntry2->bytes, commonLength) : 0;
+    if (result != 0 || rankEntry1->length == rankEntry2->length) {
+        return result;
+    }
+    return (rankEntry1->length < rankEntry2->length) ? -1 : 1;
+}
+
+// Ranks collation keys by comparing their bytes. Equal keys get the same rank.
+static uint32_t *RanksOfCollationKeys(__unsafe_unretained NSData **keys, NSUInteger count) {
+    uint32_t *ranks = malloc(MAX(count, (NSUInteger)1) * sizeof(uint32_t));
+    TTMRankEntry *entries = malloc(MAX(count, (NSUInteger)1) * sizeof(TTMRankEntry));
+    for (NSUInteger i = 0; i < count; i++) {
+        entries[i].bytes = keys[i].bytes;
+        entries[i].length = keys[i].length;
+        entries[i].index = i;
+    }
+    qsort(entries, count, sizeof(TTMRankEntry), CompareRankEntries);
+    uint32_t rank = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (i > 0 && CompareRankEntries(&entries[i - 1], &entries[i]) != 0) {
+            rank++;
+        }
+        ranks[entries[i].index] = rank;
+    }
+    free(entries);
+    return ranks;
+}
+
+@implementation TTMTaskSorter
+
+#pragma mark - Sorting Methods
+
++ (void)sortTasks:(NSArray*)tasks
+         sortType:(TTMTaskListSortType)sortType
+      permutation:(NSUInteger*)permutation {
+    NSUInteger count = tasks.count;
+    if (count == 0) {
+        return;
+    }
+    __unsafe_unretained TTMTask **objects =
+        (__unsafe_unretained TTMTask **)malloc(count * sizeof(TTMTask*));
+    [tasks getObjects:objects range:NSMakeRange(0, count)];
+    
+    uint32_t *ranks = NULL;
+    if (sortType == TTMSortProject || sortType == TTMSortContext) {
+        __unsafe_unretained NSString **strings =
+            (__unsafe_unretained NSString **)malloc(count * sizeof(NSString*));
+        for (NSUInteger i = 0; i < count; i++) {
+            NSString *string = (sortType == TTMSortProject) ? objects[i].projects :
+                                                               objects[i].contexts;
+            strings[i] = (string != nil) ? string : @"";
+        }
+        ranks = [self ranksOfStrings:strings count:count];
+        free(strings);
+    } else if (sortType == TTMSortAlphabetical) {
+        __unsafe_unretained NSData **keys =
+            (__unsafe_unretained NSData **)malloc(count * sizeof(NSData*));
+        for (NSUInteger i = 0; i < count; i++) {
+            keys[i] = objects[i].rawTextCollationKey;
+        }
+        ranks = RanksOfCollationKeys(keys, count);
+        free(keys);
+    }
+    
+    TTMSortEntry *entries = malloc(count * sizeof(TTMSortEntry));
+    for (NSUInteger i = 0; i < count; i++) {
+        entries[i].key = [self keyOfTask:objects[i] sortType:sortType rank:(ranks ? ranks[i] : 0)];
+        entries[i].index = i;
+    }
+    free(ranks);
+    free(objects);
+    
+    RadixSortEntries(entries, count);
+    for (NSUInteger i = 0; i < count; i++) {
+        permutation[i] = entries[i].index;
+    }
+    free(entries);
+}
+
++ (NSArray*)sortedTasks:(NSArray*)tasks sortType:(TTMTaskListSortType)sortType {
+    NSUInteger count = tasks.count;
+    if (count == 0) {
+        return @[];
+    }
+    NSUInteger *permutation = malloc(count * sizeof(NSUInteger));
+    [self sortTasks:tasks sortType:sortType permutation:permutation];
+    
+    __unsafe_unretained id *objects = (__unsafe_unretained id *)malloc(count * sizeof(id));
+    __unsafe_unretained id *sortedObjects = (__unsafe_unretained id *)malloc(count * sizeof(id));
+    [tasks getObjects:objects range:NSMakeRange(0, count)];
+    for (NSUInteger i = 0; i < count; i++) {
+        sortedObjects[i] = objects[permutation[i]];
+    }
+    NSArray *sortedTasks = [NSArray arrayWithObjects:sortedObjects count:count];
+    free(sortedObjects);
+    free(objects);
+    free(permutation);
+    return sortedTasks;
+}
+
++ (NSComparisonResult)compareTask:(TTMTask*)task1
+                           toTask:(TTMTask*)task2
+                         sortType:(TTMTaskListSortType)sortType {
+    // Strings are compared by their collation keys where the packed keys hold their ranks,
+    // and the packed keys, with equal ranks, decide the rest.
+    NSComparisonResult result = NSOrderedSame;
+    if (sortType == TTMSortProject || sortType == TTMSortContext) {
+        NSString *string1 = (sortType == TTMSortProject) ? task1.projects : task1.contexts;
+        NSString *string2 = (sortType == TTMSortProject) ? task2.projects : task2.contexts;
+        BOOL isEmpty1 = (string1.length == 0);
+        BOOL isEmpty2 = (string2.length == 0);
+        if (isEmpty1 != isEmpty2) {
+            return isEmpty2 ? NSOrderedAscending : NSOrderedDescending;
+        }
+        TTMCollator *collator = [TTMCollator currentCollator];
+        result = [TTMCollator compareCollationKey:[collator cachedCollationKeyForString:string1]
+                                   toCollationKey:[collator cachedCollationKeyForString:string2]];
+    } else if (sortType == TTMSortAlphabetical) {
+        result = [TTMCollator compareCollationKey:task1.rawTextCollationKey
+                                   toCollationKey:task2.rawTextCollationKey];
+    }
+    if (result != NSOrderedSame) {
+        return result;
+    }
+    
+    TTMSortKey key1 = [self keyOfTask:task1 sortType:sortType rank:0];
+    TTMSortKey key2 = [self keyOfTask:task2 sortType:sortType rank:0];
+    if (key1 == key2) {
+        return NSOrderedSame;
+    }
+    return (key1 < key2) ? NSOrderedAscending : NSOrderedDescending;
+}
+
+#pragma mark - Key Methods
+
+// Packs everything a sort type compares, in the order it is compared, ending with the task ID.
+// Properties that were sorted in descending order (has projects, has contexts,
+// is prioritized) are packed inverted.
++ (TTMSortKey)keyOfTask:(TTMTask*)task sortType:(TTMTaskListSortType)sortType rank:(uint32_t)rank {
+    TTMTaskSortFields fields = task.sortFields;
+    BOOL isPrioritized = (fields.priority != '~');
+    TTMSortKey key = 0;
+    switch (sortType) {
+        case TTMSortPriority:
+            key = Append(key, !isPrioritized, FlagBits);
+            key = Append(key, PackedPriority(fields.priority), PriorityBits);
+            key = Append(key, fields.isCompleted, FlagBits);
+            key = Append(key, fields.dueState, DueStateBits);
+            key = Append(key, PackedDay(fields.dueDay), DayBits);
+            key = Append(key, PackedDay(fields.thresholdDay), DayBits);
+            break;
+        case TTMSortProject:
+            key = Append(key, (task.projects.length == 0), FlagBits);
+            key = Append(key, rank, RankBits);
+            key = Append(key, PackedPriority(fields.priority), PriorityBits);
+            key = Append(key, fields.isCompleted, FlagBits);
+            key = Append(key, PackedDay(fields.dueDay), DayBits);
+            key = Append(key, PackedDay(fields.thresholdDay), DayBits);
+            break;
+        case TTMSortContext:
+            key = Append(key, (task.contexts.length == 0), FlagBits);
+            key = Append(key, rank, RankBits);
+            key = Append(key, !isPrioritized, FlagBits);
+            key = Append(key, PackedPriority(fields.priority), PriorityBits);
+            key = Append(key, fields.isCompleted, FlagBits);
+            key = Append(key, PackedDay(fields.dueDay), DayBits);
+            key = Append(key, PackedDay(fields.thresholdDay), DayBits);
+            break;
+        case TTMSortDueDate:
+            key = Append(key, PackedDay(fields.dueDay), DayBits);
+            key = Append(key, !isPrioritized, FlagBits);
+            key = Append(key, PackedPriority(fields.priority), PriorityBits);
+            key = Append(key, PackedDay(fields.thresholdDay), DayBits);
+            break;
+        case TTMSortCreationDate:
+            key = Append(key, PackedDay(fields.creationDay), DayBits);
+            break;
+        case TTMSortCompletionDate:
+            key = Append(key, PackedDay(fields.completionDay), DayBits);
+            break;
+        case TTMSortAlphabetical:
+            key = Append(key, rank, RankBits);
+            break;
+        case TTMSortThresholdDate:
+            key = Append(key, PackedDay(fields.thresholdDay), DayBits);
+            key = Append(key, !isPrioritized, FlagBits);
+            key = Append(key, PackedPriority(fields.priority), PriorityBits);
+            key = Append(key, fields.isCompleted, FlagBits);
+            key = Append(key, fields.dueState, DueStateBits);
+            key = Append(key, PackedDay(fields.dueDay), DayBits);
+            break;
+        default:
+            break;
+    }
+    return Append(key, task.taskId, TaskIdBits);
+}
+
+// Ranks each string among the distinct strings, in collation order. Tasks intern their
+// projects and contexts, so equal strings are usually the same object, which skips the
+// dictionary lookup.
++ (uint32_t*)ranksOfStrings:(__unsafe_unretained NSString **)strings count:(NSUInteger)count {
+    NSArray *distinctStrings = [[NSSet setWithObjects:strings count:count] allObjects];
+    NSUInteger distinctCount = distinctStrings.count;
+    TTMCollator *collator = [TTMCollator currentCollator];
+    __unsafe_unretained NSData **keys =
+        (__unsafe_unretained NSData **)malloc(distinctCount * sizeof(NSData*));
+    for (NSUInteger i = 0; i < distinctCount; i++) {
+        keys[i] = [collator cachedCollationKeyForString:distinctStrings[i]];
+    }
+    uint32_t *distinctRanks = RanksOfCollationKeys(keys, distinctCount);
+    free(keys);
+    NSMutableDictionary *rankOfString = [NSMutableDictionary dictionaryWithCapacity:distinctCount];
+    for (NSUInteger i = 0; i < distinctCount; i++) {
+        rankOfString[distinctStrings[i]] = @(distinctRanks[i]);
+    }
+    free(distinctRanks);
+    
+    uint32_t *ranks = malloc(count * sizeof(uint32_t));
+    __unsafe_unretained NSString *lastString = nil;
+    uint32_t lastRank = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (strings[i] != lastString) {
+            lastString = strings[i];
+            lastRank = [rankOfString[lastString] unsignedIntValue];
+        }
+        ranks[i] = lastRank;
+    }
+    return ranks;
+}
+
+@end
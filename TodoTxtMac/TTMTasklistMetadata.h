@@ -46,7 +46,18 @@
 
 #import <Foundation/Foundation.h>
 @class TTMTask;
+@class TTMTaskBitset;
 
+/*!
+ * @class TTMTasklistMetadata
+ * @abstract TTMTasklistMetadata counts a list of tasks by state, project, context and
+ * priority.
+ * @discussion The counts are kept up to date as tasks are added and removed, and as counted
+ * tasks are edited, by taking away what each task counted for before and adding what it
+ * counts for now. The sorted arrays of projects, contexts and priorities are rebuilt only
+ * when one is added or removed. A whole task list and its filtered tasks can also be counted
+ * from scratch in one pass.
+ */
 @interface TTMTasklistMetadata : NSObject
 
 #pragma mark - Properties
@@ -77,22 +88,68 @@
 
 /*!
  * @method updateMetadataFromTaskArray:
- * @abstract Generates metadata from a list of tasks.
+ * @abstract Counts exactly the tasks in a list, adding and removing tasks as needed, then
+ * updates the counts of any that changed.
  * @param taskArray An array of TTMTask objects.
  */
 - (void)updateMetadataFromTaskArray:(NSArray*)taskArray;
 
 /*!
- * @method initialize:
- * @abstract Initializes the class. Called in method updateMetadataFromTaskArray:.
+ * @method addTasks:
+ * @abstract Counts tasks that are not already counted.
+ * @discussion Call updateChangedTasks before reading the sorted arrays and distinct counts.
+ * @param tasks An array of TTMTask objects.
  */
-- (void)initialize;
+- (void)addTasks:(NSArray*)tasks;
+
+/*!
+ * @method removeTasks:
+ * @abstract Takes counted tasks out of the counts.
+ * @discussion Call updateChangedTasks before reading the sorted arrays and distinct counts.
+ * @param tasks An array of TTMTask objects.
+ */
+- (void)removeTasks:(NSArray*)tasks;
+
+/*!
+ * @method removeAllTasks
+ * @abstract Empties the metadata.
+ */
+- (void)removeAllTasks;
+
+/*!
+ * @method updateChangedTasks
+ * @abstract Recounts the tasks edited since they were counted, or every task on a new day,
+ * and sorts the projects, contexts and priorities again if they changed.
+ */
+- (void)updateChangedTasks;
+
+/*!
+ * @method needsFullCount
+ * @return Returns YES if the metadata was emptied, or counted on an earlier day, so that
+ * countTasks:inMetadata:filteredTasks:filteredMetadata: would be faster than updating it.
+ */
+- (BOOL)needsFullCount;
+
+/*!
+ * @method countTasks:inMetadata:filteredTasks:filteredMetadata:
+ * @abstract Counts a task list, and the filtered tasks in it, from scratch in one pass.
+ * @discussion The tasks are counted without boxing, and long lists are split into runs
+ * counted in parallel and then added together. The tasks must not be used on other threads
+ * during the count.
+ * @param tasks An array of TTMTask objects.
+ * @param metadata The metadata to count every task in.
+ * @param filteredTasks The unique IDs of the filtered tasks.
+ * @param filteredMetadata The metadata to count the filtered tasks in.
+ */
++ (void)countTasks:(NSArray*)tasks
+        inMetadata:(TTMTasklistMetadata*)metadata
+     filteredTasks:(TTMTaskBitset*)filteredTasks
+  filteredMetadata:(TTMTasklistMetadata*)filteredMetadata;
 
 /*!
  * @method initialize:
- * @abstract Helper function to populate task counts in the properties projectTaskCounts,
- * contextTaskCounts, and priorityTaskCounts. Called in method updateMetadataFromTaskArray:.
+ * @abstract Resets the metadata to count no tasks. Called in methods init and removeAllTasks.
  */
-- (void)incrementCountsInDictionary:(NSMutableDictionary*)dictionary FromArray:(NSArray*)array;
+- (void)initialize;
 
 @end
@@ -46,57 +46,447 @@
 
 #import "TTMTasklistMetadata.h"
 #import "TTMTask.h"
+#import "TTMTaskBitset.h"
+#import "TTMDateUtility.h"
+
+// Lists of at least twice this many tasks are counted in runs of this many, in parallel.
+static const NSUInteger ParallelCountRunLength = 16384;
+
+// Per-symbol task counts, indexed by symbol ID and grown as new IDs appear.
+typedef struct {
+    NSUInteger *counts;
+    NSUInteger capacity;
+} TTMSymbolCounts;
+
+// Unboxed counts of a run of tasks, added together once every run is counted.
+typedef struct {
+    NSInteger allTaskCount;
+    NSInteger completedTaskCount;
+    NSInteger dueTodayTaskCount;
+    NSInteger overdueTaskCount;
+    NSInteger notDueTaskCount;
+    NSInteger noDueDateTaskCount;
+    NSInteger hiddenCount;
+    NSUInteger priorityCounts[26];
+    TTMSymbolCounts projectCounts;
+    TTMSymbolCounts contextCounts;
+} TTMTaskCounts;
+
+static void AddSymbolCount(TTMSymbolCounts *symbolCounts, TTMSymbolID symbolID, NSUInteger count) {
+    if (symbolID >= symbolCounts->capacity) {
+        NSUInteger newCapacity = MAX((NSUInteger)symbolID + 1, symbolCounts->capacity * 2);
+        symbolCounts->counts = realloc(symbolCounts->counts, newCapacity * sizeof(NSUInteger));
+        memset(symbolCounts->counts + symbolCounts->capacity, 0,
+               (newCapacity - symbolCounts->capacity) * sizeof(NSUInteger));
+        symbolCounts->capacity = newCapacity;
+    }
+    symbolCounts->counts[symbolID] += count;
+}
+
+static void AddTaskCounts(TTMTaskCounts *total, const TTMTaskCounts *counts) {
+    total->allTaskCount += counts->allTaskCount;
+    total->completedTaskCount += counts->completedTaskCount;
+    total->dueTodayTaskCount += counts->dueTodayTaskCount;
+    total->overdueTaskCount += counts->overdueTaskCount;
+    total->notDueTaskCount += counts->notDueTaskCount;
+    total->noDueDateTaskCount += counts->noDueDateTaskCount;
+    total->hiddenCount += counts->hiddenCount;
+    for (NSUInteger priority = 0; priority < 26; priority++) {
+        total->priorityCounts[priority] += counts->priorityCounts[priority];
+    }
+    for (NSUInteger symbolID = 0; symbolID < counts->projectCounts.capacity; symbolID++) {
+        if (counts->projectCounts.counts[symbolID] > 0) {
+            AddSymbolCount(&total->projectCounts, (TTMSymbolID)symbolID,
+                           counts->projectCounts.counts[symbolID]);
+        }
+    }
+    for (NSUInteger symbolID = 0; symbolID < counts->contextCounts.capacity; symbolID++) {
+        if (counts->contextCounts.counts[symbolID] > 0) {
+            AddSymbolCount(&total->contextCounts, (TTMSymbolID)symbolID,
+                           counts->contextCounts.counts[symbolID]);
+        }
+    }
+}
+
+// The single-letter strings of the priorities, so counting a priority allocates nothing.
+static NSString *PriorityKey(unichar priority) {
+    static NSArray *priorityKeys;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableArray *keys = [NSMutableArray arrayWithCapacity:26];
+        for (unichar letter = 'A'; letter <= 'Z'; letter++) {
+            [keys addObject:[NSString stringWithCharacters:&letter length:1]];
+        }
+        priorityKeys = keys;
+    });
+    return priorityKeys[priority - 'A'];
+}
+
+#pragma mark - TTMTasklistMetadataEntry
+
+// What one task adds to the metadata, kept so that it can be taken away again. Entries are
+// not changed once made, so the full and filtered metadata can share them.
+@interface TTMTasklistMetadataEntry : NSObject
+
+@property (nonatomic, readonly) NSUInteger countedRevision;
+@property (nonatomic, readonly) BOOL isCompleted;
+@property (nonatomic, readonly) BOOL isHidden;
+@property (nonatomic, readonly) TTMDueState dueState;
+@property (nonatomic, readonly) unichar priority;
+@property (nonatomic, readonly) NSArray *projects;
+@property (nonatomic, readonly) NSArray *contexts;
+
+- (id)initWithTask:(TTMTask*)task;
+
+@end
+
+@implementation TTMTasklistMetadataEntry
+
+- (id)initWithTask:(TTMTask*)task {
+    self = [super init];
+    if (self) {
+        _countedRevision = task.rawTextRevision;
+        _isCompleted = task.isCompleted;
+        _isHidden = task.isHidden;
+        _dueState = task.dueState;
+        _priority = task.isPrioritized ? task.priority : 0;
+        _projects = task.projectsArray;
+        _contexts = task.contextsArray;
+    }
+    return self;
+}
+
+- (void)addToCounts:(TTMTaskCounts*)counts
+           fromTask:(TTMTask*)task
+        symbolTable:(TTMSymbolTable*)symbolTable {
+    counts->allTaskCount++;
+    counts->completedTaskCount += (_isCompleted ? 1 : 0);
+    counts->dueTodayTaskCount += (_dueState == DueToday ? 1 : 0);
+    counts->overdueTaskCount += (_dueState == Overdue ? 1 : 0);
+    counts->notDueTaskCount += (_dueState == NotDue ? 1 : 0);
+    counts->noDueDateTaskCount += (_dueState == NoDueDate ? 1 : 0);
+    counts->hiddenCount += (_isHidden ? 1 : 0);
+    if (_priority != 0) {
+        counts->priorityCounts[_priority - 'A']++;
+    }
+    
+    // Count projects and contexts by ID in the given symbol table. A task with another
+    // table has its symbols looked up by string.
+    BOOL sharesSymbolTable = (task.symbolTable == symbolTable);
+    if (sharesSymbolTable && _projects.count == task.projectIDCount) {
+        const TTMSymbolID *projectIDs = task.projectIDs;
+        for (NSUInteger i = 0; i < task.projectIDCount; i++) {
+            AddSymbolCount(&counts->projectCounts, projectIDs[i], 1);
+        }
+    } else {
+        for (NSString *project in _projects) {
+            AddSymbolCount(&counts->projectCounts, [symbolTable internSymbol:project], 1);
+        }
+    }
+    if (sharesSymbolTable && _contexts.count == task.contextIDCount) {
+        const TTMSymbolID *contextIDs = task.contextIDs;
+        for (NSUInteger i = 0; i < task.contextIDCount; i++) {
+            AddSymbolCount(&counts->contextCounts, contextIDs[i], 1);
+        }
+    } else {
+        for (NSString *context in _contexts) {
+            AddSymbolCount(&counts->contextCounts, [symbolTable internSymbol:context], 1);
+        }
+    }
+}
+
+@end
+
+#pragma mark - TTMTasklistMetadata
+
+@interface TTMTasklistMetadata ()
+
+/*! The entries of the counted tasks, keyed by task identity. */
+@property (nonatomic) NSMapTable *entries;
+
+/*! The latest raw text revision when the counted tasks were last checked for edits. */
+@property (nonatomic) NSUInteger checkedRevision;
+
+/*! The day the due states were counted on. */
+@property (nonatomic) TTMDayNumber countedDay;
+
+/*! Set when a distinct project, context or priority is added or removed, until the
+ *  sorted arrays are rebuilt. */
+@property (nonatomic) BOOL hasChangedDistinctValues;
+
+/*! Set when the metadata is emptied, until a full count of the tasks. */
+@property (nonatomic) BOOL isEmptied;
+
+@end
 
 @implementation TTMTasklistMetadata
 
+- (id)init {
+    self = [super init];
+    if (self) {
+        [self initialize];
+    }
+    return self;
+}
+
+#pragma mark - Task Methods
+
 - (void)updateMetadataFromTaskArray:(NSArray*)taskArray {
+    // Take away the tasks that are no longer in the array, and add the new ones.
+    NSMapTable *newTasks = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsOpaqueMemory |
+                                                              NSPointerFunctionsOpaquePersonality
+                                                 valueOptions:NSPointerFunctionsOpaqueMemory];
+    for (TTMTask *task in taskArray) {
+        NSMapInsert(newTasks, (__bridge void*)task, (__bridge void*)task);
+    }
+    NSMutableArray *removedTasks = [NSMutableArray array];
+    for (TTMTask *task in self.entries) {
+        if (NSMapGet(newTasks, (__bridge void*)task) == NULL) {
+            [removedTasks addObject:task];
+        }
+    }
+    [self removeTasks:removedTasks];
+    [self addTasks:taskArray];
+    [self updateChangedTasks];
+}
+
+- (void)addTasks:(NSArray*)tasks {
+    for (TTMTask *task in tasks) {
+        if ([self.entries objectForKey:task] == nil) {
+            [self countTask:task];
+        }
+    }
+}
+
+- (void)removeTasks:(NSArray*)tasks {
+    for (TTMTask *task in tasks) {
+        TTMTasklistMetadataEntry *entry = [self.entries objectForKey:task];
+        if (entry == nil) {
+            continue;
+        }
+        [self addEntry:entry withSign:-1];
+        [self.entries removeObjectForKey:task];
+    }
+}
+
+- (void)removeAllTasks {
     [self initialize];
+}
+
+- (BOOL)needsFullCount {
+    return self.isEmptied || self.countedDay != [TTMDateUtility todayDayNumber];
+}
+
+- (void)updateChangedTasks {
+    // Due states change with the day, so a new day recounts every task.
+    TTMDayNumber today = [TTMDateUtility todayDayNumber];
+    BOOL isNewDay = (today != self.countedDay);
+    NSUInteger latestRevision = [TTMTask latestRawTextRevision];
+    if (isNewDay || latestRevision != self.checkedRevision) {
+        NSMutableArray *changedTasks = [NSMutableArray array];
+        for (TTMTask *task in self.entries) {
+            TTMTasklistMetadataEntry *entry = [self.entries objectForKey:task];
+            if (isNewDay || entry.countedRevision != task.rawTextRevision) {
+                [changedTasks addObject:task];
+            }
+        }
+        [self removeTasks:changedTasks];
+        [self addTasks:changedTasks];
+        self.countedDay = today;
+        self.checkedRevision = latestRevision;
+    }
     
-    for (TTMTask *task in taskArray) {
-     
-        // update task counts
-        self.allTaskCount++;
-        self.completedTaskCount += (task.isCompleted ? 1 : 0);
-        self.incompleteTaskCount += (task.isCompleted ? 0 : 1);
-        self.dueTodayTaskCount += (task.dueState == DueToday ? 1 : 0);
-        self.overdueTaskCount += (task.dueState == Overdue ? 1 : 0);
-        self.notDueTaskCount += (task.dueState == NotDue ? 1 : 0);
-        self.noDueDateTaskCount += (task.dueState == NoDueDate ? 1 : 0);
-        self.hiddenCount += (task.isHidden ? 1 : 0);
-
-        // update task counts by project and context
-        [self incrementCountsInDictionary:self.projectTaskCounts FromArray:task.projectsArray];
-        [self incrementCountsInDictionary:self.contextTaskCounts FromArray:task.contextsArray];
-        
-        // add all projects and contexts to sets
-        [self.projectsSet addObjectsFromArray:task.projectsArray];
-        [self.contextsSet addObjectsFromArray:task.contextsArray];
-        
-        // update task count by priority, and add priority to set
-        if (task.priorityText != nil) {
-            [self incrementCountsInDictionary:self.priorityTaskCounts
-                                    FromArray:@[task.priorityText]];
-            [self.prioritiesSet addObject:task.priorityText];
-        }
-    }
-
-    // Convert the sets to case-insensitive-sorted arrays.
-    NSSortDescriptor *sortDescriptor = [[NSSortDescriptor alloc]
-                                        initWithKey:@""
-                                        ascending:YES
-                                        selector:@selector(caseInsensitiveCompare:)];
-    NSArray *sortDescriptorArray = @[sortDescriptor];
-    self.projectsArray = [self.projectsSet sortedArrayUsingDescriptors:sortDescriptorArray];
-    self.contextsArray = [self.contextsSet sortedArrayUsingDescriptors:sortDescriptorArray];
-    self.prioritiesArray = [self.prioritiesSet sortedArrayUsingDescriptors:sortDescriptorArray];
-
-    // update counts of projects, contexts, and priorities
-    self.projectsCount = [self.projectsSet count];
-    self.contextsCount = [self.contextsSet count];
-    self.prioritiesCount = [self.prioritiesSet count];
+    // Only a change to the distinct values changes their order.
+    if (self.hasChangedDistinctValues) {
+        NSSortDescriptor *sortDescriptor = [[NSSortDescriptor alloc]
+                                            initWithKey:@""
+                                            ascending:YES
+                                            selector:@selector(caseInsensitiveCompare:)];
+        NSArray *sortDescriptorArray = @[sortDescriptor];
+        self.projectsArray = [self.projectsSet sortedArrayUsingDescriptors:sortDescriptorArray];
+        self.contextsArray = [self.contextsSet sortedArrayUsingDescriptors:sortDescriptorArray];
+        self.prioritiesArray = [self.prioritiesSet sortedArrayUsingDescriptors:sortDescriptorArray];
+        self.projectsCount = [self.projectsSet count];
+        self.contextsCount = [self.contextsSet count];
+        self.prioritiesCount = [self.prioritiesSet count];
+        self.hasChangedDistinctValues = NO;
+    }
+}
+
+#pragma mark - Counting Methods
+
+- (void)countTask:(TTMTask*)task {
+    TTMTasklistMetadataEntry *entry = [[TTMTasklistMetadataEntry alloc] initWithTask:task];
+    [self.entries setObject:entry forKey:task];
+    [self addEntry:entry withSign:1];
+}
+
+- (void)addEntry:(TTMTasklistMetadataEntry*)entry withSign:(NSInteger)sign {
+    self.allTaskCount += sign;
+    self.completedTaskCount += (entry.isCompleted ? sign : 0);
+    self.incompleteTaskCount += (entry.isCompleted ? 0 : sign);
+    self.dueTodayTaskCount += (entry.dueState == DueToday ? sign : 0);
+    self.overdueTaskCount += (entry.dueState == Overdue ? sign : 0);
+    self.notDueTaskCount += (entry.dueState == NotDue ? sign : 0);
+    self.noDueDateTaskCount += (entry.dueState == NoDueDate ? sign : 0);
+    self.hiddenCount += (entry.isHidden ? sign : 0);
+    
+    for (NSString *project in entry.projects) {
+        [self addCount:sign forKey:project toDictionary:self.projectTaskCounts set:self.projectsSet];
+    }
+    for (NSString *context in entry.contexts) {
+        [self addCount:sign forKey:context toDictionary:self.contextTaskCounts set:self.contextsSet];
+    }
+    if (entry.priority != 0) {
+        [self addCount:sign forKey:PriorityKey(entry.priority)
+          toDictionary:self.priorityTaskCounts set:self.prioritiesSet];
+    }
+}
+
+- (void)addCount:(NSInteger)count
+          forKey:(NSString*)key
+    toDictionary:(NSMutableDictionary*)dictionary
+             set:(NSMutableSet*)set {
+    NSInteger newCount = [dictionary[key] integerValue] + count;
+    if (newCount > 0) {
+        if (dictionary[key] == nil) {
+            [set addObject:key];
+            self.hasChangedDistinctValues = YES;
+        }
+        dictionary[key] = @(newCount);
+    } else {
+        [dictionary removeObjectForKey:key];
+        [set removeObject:key];
+        self.hasChangedDistinctValues = YES;
+    }
+}
+
+#pragma mark - Full Count Methods
+
++ (void)countTasks:(NSArray*)tasks
+        inMetadata:(TTMTasklistMetadata*)metadata
+     filteredTasks:(TTMTaskBitset*)filteredTasks
+  filteredMetadata:(TTMTasklistMetadata*)filteredMetadata {
+    [metadata initialize];
+    [filteredMetadata initialize];
+    NSUInteger latestRevision = [TTMTask latestRawTextRevision];
+    
+    // Count projects and contexts by symbol ID in the first task's symbol table. Tasks
+    // from one document share a table.
+    TTMSymbolTable *symbolTable = ((TTMTask*)[tasks firstObject]).symbolTable;
+    NSUInteger taskCount = tasks.count;
+    NSUInteger runLength = (taskCount >= 2 * ParallelCountRunLength) ?
+        ParallelCountRunLength : MAX(taskCount, (NSUInteger)1);
+    NSUInteger runCount = (taskCount + runLength - 1) / runLength;
+    
+    // Each run has its own counts, for all tasks and for the filtered tasks, and its own
+    // list of entries, so that runs share nothing while they are counted.
+    TTMTaskCounts *runCounts = calloc(MAX(runCount, (NSUInteger)1) * 2, sizeof(TTMTaskCounts));
+    NSMutableArray *runEntries = [NSMutableArray arrayWithCapacity:runCount];
+    for (NSUInteger run = 0; run < runCount; run++) {
+        [runEntries addObject:[NSMutableArray arrayWithCapacity:runLength]];
+    }
+    void (^countRun)(size_t) = ^(size_t run) {
+        TTMTaskCounts *allCounts = &runCounts[run * 2];
+        TTMTaskCounts *filteredCounts = &runCounts[run * 2 + 1];
+        NSMutableArray *entries = runEntries[run];
+        NSUInteger end = MIN((run + 1) * runLength, taskCount);
+        for (NSUInteger i = run * runLength; i < end; i++) {
+            TTMTask *task = tasks[i];
+            TTMTasklistMetadataEntry *entry = [[TTMTasklistMetadataEntry alloc] initWithTask:task];
+            [entries addObject:entry];
+            [entry addToCounts:allCounts fromTask:task symbolTable:symbolTable];
+            if ([filteredTasks containsIndex:(uint32_t)task.uniqueId]) {
+                [entry addToCounts:filteredCounts fromTask:task symbolTable:symbolTable];
+            }
+        }
+    };
+    if (runCount > 1) {
+        dispatch_apply(runCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0),
+                       countRun);
+    } else if (runCount == 1) {
+        countRun(0);
+    }
+    
+    // Add the runs' counts together, and keep the entries for counting changes later.
+    for (NSUInteger run = 1; run < runCount; run++) {
+        AddTaskCounts(&runCounts[0], &runCounts[run * 2]);
+        AddTaskCounts(&runCounts[1], &runCounts[run * 2 + 1]);
+    }
+    NSUInteger i = 0;
+    for (NSArray *entries in runEntries) {
+        for (TTMTasklistMetadataEntry *entry in entries) {
+            TTMTask *task = tasks[i++];
+            [metadata.entries setObject:entry forKey:task];
+            if ([filteredTasks containsIndex:(uint32_t)task.uniqueId]) {
+                [filteredMetadata.entries setObject:entry forKey:task];
+            }
+        }
+    }
+    [metadata setCounts:&runCounts[0] symbolTable:symbolTable revision:latestRevision];
+    [filteredMetadata setCounts:&runCounts[1] symbolTable:symbolTable revision:latestRevision];
+    for (NSUInteger count = 0; count < MAX(runCount, (NSUInteger)1) * 2; count++) {
+        free(runCounts[count].projectCounts.counts);
+        free(runCounts[count].contextCounts.counts);
+    }
+    free(runCounts);
+}
+
+- (void)setCounts:(const TTMTaskCounts*)counts
+      symbolTable:(TTMSymbolTable*)symbolTable
+         revision:(NSUInteger)revision {
+    self.allTaskCount = counts->allTaskCount;
+    self.completedTaskCount = counts->completedTaskCount;
+    self.incompleteTaskCount = counts->allTaskCount - counts->completedTaskCount;
+    self.dueTodayTaskCount = counts->dueTodayTaskCount;
+    self.overdueTaskCount = counts->overdueTaskCount;
+    self.notDueTaskCount = counts->notDueTaskCount;
+    self.noDueDateTaskCount = counts->noDueDateTaskCount;
+    self.hiddenCount = counts->hiddenCount;
+    
+    // Only the distinct values are boxed.
+    [self addSymbolCounts:&counts->projectCounts fromSymbolTable:symbolTable
+             toDictionary:self.projectTaskCounts set:self.projectsSet];
+    [self addSymbolCounts:&counts->contextCounts fromSymbolTable:symbolTable
+             toDictionary:self.contextTaskCounts set:self.contextsSet];
+    for (unichar priority = 'A'; priority <= 'Z'; priority++) {
+        NSUInteger count = counts->priorityCounts[priority - 'A'];
+        if (count > 0) {
+            self.priorityTaskCounts[PriorityKey(priority)] = @(count);
+            [self.prioritiesSet addObject:PriorityKey(priority)];
+        }
+    }
+    
+    // Tasks edited after the revision are counted again by updateChangedTasks.
+    self.checkedRevision = revision;
+    self.isEmptied = NO;
+    self.hasChangedDistinctValues = YES;
+    [self updateChangedTasks];
+}
+
+- (void)addSymbolCounts:(const TTMSymbolCounts*)symbolCounts
+        fromSymbolTable:(TTMSymbolTable*)symbolTable
+           toDictionary:(NSMutableDictionary*)dictionary
+                    set:(NSMutableSet*)set {
+    for (NSUInteger symbolID = 0; symbolID < symbolCounts->capacity; symbolID++) {
+        NSUInteger count = symbolCounts->counts[symbolID];
+        if (count > 0) {
+            NSString *symbol = [symbolTable symbolForID:(TTMSymbolID)symbolID];
+            dictionary[symbol] = @(count);
+            [set addObject:symbol];
+        }
+    }
 }
 
 - (void)initialize {
+    self.entries = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory |
+                                                      NSPointerFunctionsObjectPointerPersonality
+                                         valueOptions:NSPointerFunctionsStrongMemory];
+    self.checkedRevision = [TTMTask latestRawTextRevision];
+    self.countedDay = [TTMDateUtility todayDayNumber];
+    self.hasChangedDistinctValues = NO;
+    self.isEmptied = YES;
+    
     self.allTaskCount = 0;
     self.completedTaskCount = 0;
     self.incompleteTaskCount = 0;
@@ -123,16 +513,6 @@
     self.prioritiesCount = 0;
 }
 
-- (void)incrementCountsInDictionary:(NSMutableDictionary*)dictionary FromArray:(NSArray*)array {
-    for (NSString *key in array) {
-        if (dictionary[key] == nil) {
-            dictionary[key] = @1;
-        } else {
-            dictionary[key] = @([dictionary[key] integerValue] + 1);
-        }
-    }
-}
-
 - (NSString*)projects {
     return [self.projectsArray componentsJoinedByString:@"\n"];
 }
@@ -0,0 +1,95 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @class TTMUndoBudget
+ * @abstract TTMUndoBudget tracks how much memory an undo manager's undo and redo stacks hold,
+ * and discards the oldest undo groups when they hold more than a set number of bytes.
+ * @discussion Whoever registers an undo action reports the bytes it holds with addBytes:.
+ * The bytes reported while an undo group is open are charged to that group. Groups are
+ * discarded by briefly lowering the undo manager's levelsOfUndo, which drops the oldest
+ * groups first; the most recent group is always kept.
+ */
+@interface TTMUndoBudget : NSObject
+
+/*! The undo manager whose groups are tracked. */
+@property (nonatomic, readonly, weak) NSUndoManager *undoManager;
+
+/*! The most bytes the undo stack may hold. Zero means no limit. */
+@property (nonatomic) NSUInteger byteLimit;
+
+/*! The levels of undo to restore after groups are discarded. Zero means no limit. */
+@property (nonatomic) NSUInteger levelsOfUndo;
+
+/*! The bytes held by the undo and redo stacks. */
+@property (nonatomic, readonly) NSUInteger byteCount;
+
+/*!
+ * @method initWithUndoManager:
+ * @abstract Starts tracking an undo manager's groups. The undo manager is not retained.
+ * @param undoManager The undo manager to track.
+ * @result Returns the newly initialized budget.
+ */
+- (id)initWithUndoManager:(NSUndoManager*)undoManager;
+
+/*!
+ * @method addBytes:
+ * @abstract Charges the undo group being recorded for the memory held by an undo action.
+ * @param byteCount The approximate number of bytes the undo action holds.
+ */
+- (void)addBytes:(NSUInteger)byteCount;
+
+/*!
+ * @method byteCountOfStrings:
+ * @abstract Estimates the bytes held by an array of strings, such as task raw text.
+ * @param strings The strings.
+ * @return The UTF-8 length of the strings, plus a fixed overhead per string.
+ */
++ (NSUInteger)byteCountOfStrings:(NSArray*)strings;
+
+@end
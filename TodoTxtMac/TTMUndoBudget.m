@@ -0,0 +1,218 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2015 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMUndoBudget.h"
+
+// Approximate bytes taken by an object and its bookkeeping, beyond its contents.
+static const NSUInteger ObjectOverhead = 48;
+
+@interface TTMUndoBudget ()
+
+/*! The bytes held by each group on the undo stack, oldest first. */
+@property (nonatomic) NSMutableArray *undoGroupByteCounts;
+
+/*! The bytes held by each group on the redo stack, oldest first. */
+@property (nonatomic) NSMutableArray *redoGroupByteCounts;
+
+/*! The bytes reported since the last group was closed, undone, or redone. */
+@property (nonatomic) NSUInteger pendingByteCount;
+
+@property (nonatomic, readwrite) NSUInteger byteCount;
+
+@end
+
+@implementation TTMUndoBudget
+
+#pragma mark - Init Methods
+
+- (id)initWithUndoManager:(NSUndoManager*)undoManager {
+    self = [super init];
+    if (self) {
+        _undoManager = undoManager;
+        _undoGroupByteCounts = [[NSMutableArray alloc] init];
+        _redoGroupByteCounts = [[NSMutableArray alloc] init];
+        _levelsOfUndo = undoManager.levelsOfUndo;
+        
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        [center addObserver:self
+                   selector:@selector(undoManagerDidOpenUndoGroup:)
+                       name:NSUndoManagerDidOpenUndoGroupNotification
+                     object:undoManager];
+        [center addObserver:self
+                   selector:@selector(undoManagerDidCloseUndoGroup:)
+                       name:NSUndoManagerDidCloseUndoGroupNotification
+                     object:undoManager];
+        [center addObserver:self
+                   selector:@selector(undoManagerDidUndoChange:)
+                       name:NSUndoManagerDidUndoChangeNotification
+                     object:undoManager];
+        [center addObserver:self
+                   selector:@selector(undoManagerDidRedoChange:)
+                       name:NSUndoManagerDidRedoChangeNotification
+                     object:undoManager];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Accounting Methods
+
+- (void)addBytes:(NSUInteger)byteCount {
+    // Nothing is recorded while undo registration is disabled.
+    if ([self.undoManager isUndoRegistrationEnabled]) {
+        self.pendingByteCount += byteCount;
+    }
+}
+
++ (NSUInteger)byteCountOfStrings:(NSArray*)strings {
+    NSUInteger byteCount = 0;
+    for (NSString *string in strings) {
+        byteCount += [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding] + ObjectOverhead;
+    }
+    return byteCount;
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit {
+    _byteLimit = byteLimit;
+    [self discardGroupsOverBudget];
+}
+
+- (void)setLevelsOfUndo:(NSUInteger)levelsOfUndo {
+    _levelsOfUndo = levelsOfUndo;
+    [self discardGroupsOverBudget];
+}
+
+#pragma mark - Notification Methods
+
+- (void)undoManagerDidOpenUndoGroup:(NSNotification*)notification {
+    // The new group is still empty, so the stacks can be checked for having been cleared.
+    if (!self.undoManager.isUndoing && !self.undoManager.isRedoing) {
+        [self forgetClearedStacks];
+    }
+}
+
+- (void)undoManagerDidCloseUndoGroup:(NSNotification*)notification {
+    // Groups closed while undoing or redoing are accounted for when the undo or redo ends.
+    // Empty groups are not kept by the undo manager, and nothing is reported for them.
+    if (self.undoManager.isUndoing || self.undoManager.isRedoing || self.pendingByteCount == 0) {
+        return;
+    }
+    [self.undoGroupByteCounts addObject:@(self.pendingByteCount)];
+    self.pendingByteCount = 0;
+    // A new action clears the redo stack.
+    [self.redoGroupByteCounts removeAllObjects];
+    [self discardGroupsOverBudget];
+}
+
+- (void)undoManagerDidUndoChange:(NSNotification*)notification {
+    [self moveLastGroupFrom:self.undoGroupByteCounts to:self.redoGroupByteCounts];
+}
+
+- (void)undoManagerDidRedoChange:(NSNotification*)notification {
+    [self moveLastGroupFrom:self.redoGroupByteCounts to:self.undoGroupByteCounts];
+    [self discardGroupsOverBudget];
+}
+
+- (void)moveLastGroupFrom:(NSMutableArray*)fromStack to:(NSMutableArray*)toStack {
+    // The undone or redone group is replaced by the group that reverses it, which holds the
+    // bytes reported while it ran.
+    [fromStack removeLastObject];
+    [toStack addObject:@(self.pendingByteCount)];
+    self.pendingByteCount = 0;
+    [self forgetClearedStacks];
+    [self updateByteCount];
+}
+
+- (void)forgetClearedStacks {
+    // removeAllActions posts no notification, so check whether the stacks were cleared.
+    if (!self.undoManager.canUndo) {
+        [self.undoGroupByteCounts removeAllObjects];
+    }
+    if (!self.undoManager.canRedo) {
+        [self.redoGroupByteCounts removeAllObjects];
+    }
+}
+
+- (void)discardGroupsOverBudget {
+    NSMutableArray *counts = self.undoGroupByteCounts;
+    
+    // The undo manager drops groups beyond its levels of undo on its own.
+    if (self.levelsOfUndo > 0 && [counts count] > self.levelsOfUndo) {
+        [counts removeObjectsInRange:NSMakeRange(0, [counts count] - self.levelsOfUndo)];
+    }
+    
+    // Lowering the levels of undo drops the oldest groups from both stacks, so only do it
+    // when there is nothing to redo.
+    if (self.byteLimit > 0 && [self.redoGroupByteCounts count] == 0) {
+        NSUInteger total = [[counts valueForKeyPath:@"@sum.self"] unsignedIntegerValue];
+        NSUInteger discardCount = 0;
+        while (total > self.byteLimit && [counts count] - discardCount > 1) {
+            total -= [[counts objectAtIndex:discardCount] unsignedIntegerValue];
+            discardCount++;
+        }
+        if (discardCount > 0) {
+            [counts removeObjectsInRange:NSMakeRange(0, discardCount)];
+            self.undoManager.levelsOfUndo = [counts count];
+            self.undoManager.levelsOfUndo = self.levelsOfUndo;
+        }
+    }
+    [self updateByteCount];
+}
+
+- (void)updateByteCount {
+    NSUInteger undoByteCount =
+        [[self.undoGroupByteCounts valueForKeyPath:@"@sum.self"] unsignedIntegerValue];
+    NSUInteger redoByteCount =
+        [[self.redoGroupByteCounts valueForKeyPath:@"@sum.self"] unsignedIntegerValue];
+    if (self.byteCount != undoByteCount + redoByteCount) {
+        self.byteCount = undoByteCount + redoByteCount;
+    }
+}
+
+@end
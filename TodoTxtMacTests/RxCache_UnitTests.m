@@ -0,0 +1,153 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "RegExCategories.h"
+
+@interface RxCache_UnitTests : XCTestCase
+
+@end
+
+@implementation RxCache_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    [RxCache removeAllObjects];
+}
+
+- (void)tearDown {
+    [RxCache removeAllObjects];
+    [super tearDown];
+}
+
+- (void)testSamePatternReturnsSameInstance {
+    NSRegularExpression *first = RX(@"(?<=^|[ ])(\\+[^[ ]]+)");
+    NSRegularExpression *second = RX(@"(?<=^|[ ])(\\+[^[ ]]+)");
+    XCTAssertNotNil(first);
+    XCTAssertEqual(first, second);
+}
+
+- (void)testMutablePatternIsCopiedIntoCache {
+    NSMutableString *pattern = [NSMutableString stringWithString:@"abc"];
+    NSRegularExpression *first = RX(pattern);
+    [pattern setString:@"xyz"];
+    XCTAssertEqual(RX(@"abc"), first);
+    XCTAssertNotEqual(RX(@"xyz"), first);
+}
+
+- (void)testOptionsArePartOfTheKey {
+    NSRegularExpression *caseSensitive = [NSRegularExpression rx:@"due:" ignoreCase:NO];
+    NSRegularExpression *caseInsensitive = [NSRegularExpression rx:@"due:" ignoreCase:YES];
+    XCTAssertNotEqual(caseSensitive, caseInsensitive);
+    XCTAssertEqual(caseSensitive.options, 0);
+    XCTAssertEqual(caseInsensitive.options, NSRegularExpressionCaseInsensitive);
+    XCTAssertEqual(caseInsensitive, [@"due:" toRxIgnoreCase:YES]);
+    XCTAssertEqual(caseSensitive, [@"due:" toRx]);
+    XCTAssertEqual(caseInsensitive,
+                   [@"due:" toRxWithOptions:NSRegularExpressionCaseInsensitive]);
+}
+
+- (void)testHitAndMissCounters {
+    XCTAssertEqual([RxCache hitCount], 0);
+    XCTAssertEqual([RxCache missCount], 0);
+    RX(@"\\d+");
+    XCTAssertEqual([RxCache missCount], 1);
+    XCTAssertEqual([RxCache hitCount], 0);
+    RX(@"\\d+");
+    RX(@"\\d+");
+    XCTAssertEqual([RxCache missCount], 1);
+    XCTAssertEqual([RxCache hitCount], 2);
+    XCTAssertEqual([RxCache count], 1);
+}
+
+- (void)testInvalidPatternIsNotCached {
+    XCTAssertNil(RX(@"(unclosed"));
+    XCTAssertNil(RX(@"(unclosed"));
+    XCTAssertEqual([RxCache count], 0);
+    XCTAssertEqual([RxCache missCount], 2);
+}
+
+- (void)testNilPatternReturnsNil {
+    XCTAssertNil([RxCache regexWithPattern:nil options:0]);
+}
+
+- (void)testInitWithPatternIsNotCached {
+    NSRegularExpression *cached = RX(@"abc");
+    NSRegularExpression *uncached = [[NSRegularExpression alloc] initWithPattern:@"abc"];
+    XCTAssertNotEqual(cached, uncached);
+    XCTAssertEqual([RxCache count], 1);
+}
+
+- (void)testConcurrentLookupsShareOneInstance {
+    NSString *pattern = @"(?<=^|[ ])([:graph:]+:[:graph:]+)";
+    NSMutableArray *results = [NSMutableArray array];
+    NSObject *lock = [[NSObject alloc] init];
+    dispatch_apply(64, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        NSRegularExpression *rx = RX(pattern);
+        @synchronized(lock) {
+            [results addObject:rx];
+        }
+    });
+    XCTAssertEqual(results.count, 64);
+    XCTAssertEqual([RxCache count], 1);
+    XCTAssertEqual([RxCache hitCount] + [RxCache missCount], 64);
+    NSRegularExpression *shared = RX(pattern);
+    for (NSRegularExpression *rx in results) {
+        XCTAssertEqualObjects(rx.pattern, shared.pattern);
+    }
+}
+
+- (void)testCachedExpressionMatchesLikeUncached {
+    NSString *line = @"(A) call mom +Family @Phone due:2016-01-01";
+    NSRegularExpression *cached = RX(@"(?<=^|[ ])(\\@[^[ ]]+)");
+    NSRegularExpression *uncached = [[NSRegularExpression alloc]
+                                     initWithPattern:@"(?<=^|[ ])(\\@[^[ ]]+)"];
+    XCTAssertEqualObjects([line matches:cached], [line matches:uncached]);
+    XCTAssertEqualObjects([line matches:RX(@"(?<=^|[ ])(\\@[^[ ]]+)")], @[@"@Phone"]);
+}
+
+@end
@@ -0,0 +1,149 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMCollator.h"
+#import "TTMTask.h"
+
+@interface TTMCollator_UnitTests : XCTestCase
+
+@property TTMCollator *collator;
+
+@end
+
+@implementation TTMCollator_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.collator = [[TTMCollator alloc] initWithLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSComparisonResult)compareKeysOfString:(NSString*)string1 toString:(NSString*)string2 {
+    return [TTMCollator compareCollationKey:[self.collator collationKeyForString:string1]
+                             toCollationKey:[self.collator collationKeyForString:string2]];
+}
+
+- (void)testKeysCompareLikeStrings {
+    NSArray *strings = @[@"apple", @"Banana", @"banana split", @"+Chores", @"@Home",
+                         @"(A) call mom", @"x 2016-01-01 done", @"zebra", @"Zoo", @"éclair"];
+    NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+    for (NSString *string1 in strings) {
+        for (NSString *string2 in strings) {
+            NSComparisonResult expected = [string1 compare:string2
+                                                   options:NSCaseInsensitiveSearch
+                                                     range:NSMakeRange(0, string1.length)
+                                                    locale:locale];
+            XCTAssertEqual([self compareKeysOfString:string1 toString:string2], expected,
+                           @"%@ vs %@", string1, string2);
+        }
+    }
+}
+
+- (void)testKeysIgnoreCase {
+    XCTAssertEqual([self compareKeysOfString:@"+Reading" toString:@"+reading"], NSOrderedSame);
+}
+
+- (void)testKeysDoNotIgnoreAccents {
+    XCTAssertNotEqual([self compareKeysOfString:@"resume" toString:@"résumé"], NSOrderedSame);
+}
+
+- (void)testKeysOfLongStrings {
+    NSString *base = [@"" stringByPaddingToLength:2000 withString:@"abc " startingAtIndex:0];
+    XCTAssertEqual([self compareKeysOfString:[base stringByAppendingString:@"a"]
+                                    toString:[base stringByAppendingString:@"B"]],
+                   NSOrderedAscending);
+}
+
+- (void)testEmptyAndNilStringsSortFirst {
+    XCTAssertEqual([self.collator collationKeyForString:nil].length, 0);
+    XCTAssertEqual([self compareKeysOfString:@"" toString:@"a"], NSOrderedAscending);
+}
+
+- (void)testCachedKeyIsMadeOnce {
+    NSData *key = [self.collator cachedCollationKeyForString:@"+Chores"];
+    XCTAssertEqual([self.collator cachedCollationKeyForString:[@"+Chores" mutableCopy]], key);
+}
+
+- (void)testSortedStrings {
+    NSArray *sorted = [self.collator sortedStrings:@[@"+zoo", @"+Apple", @"+banana"]];
+    XCTAssertEqualObjects(sorted, (@[@"+Apple", @"+banana", @"+zoo"]));
+}
+
+- (void)testEveryCollatorHasNewGeneration {
+    TTMCollator *collator = [[TTMCollator alloc] initWithLocale:self.collator.locale];
+    XCTAssertNotEqual(collator.generation, self.collator.generation);
+}
+
+- (void)testTaskKeyFollowsRawText {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom" withTaskId:0];
+    NSData *key = task.rawTextCollationKey;
+    XCTAssertEqual(task.rawTextCollationKey, key);
+    task.rawText = @"call dad";
+    TTMCollator *collator = [TTMCollator currentCollator];
+    XCTAssertEqualObjects(task.rawTextCollationKey, [collator collationKeyForString:@"call dad"]);
+}
+
+- (void)testTaskSymbolsAreSortedAgainWhenLocaleChanges {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +zoo +Apple @phone"
+                                          withTaskId:0];
+    const TTMSymbolID *projectIDs = task.projectIDs;
+    XCTAssertEqual(task.projectIDs, projectIDs);
+    NSUInteger generation = [TTMCollator currentCollator].generation;
+    [[NSNotificationCenter defaultCenter] postNotificationName:NSCurrentLocaleDidChangeNotification
+                                                        object:nil];
+    XCTAssertNotEqual([TTMCollator currentCollator].generation, generation);
+    XCTAssertNotEqual(task.projectIDs, projectIDs);
+    XCTAssertEqualObjects(task.projectsArray, (@[@"+Apple", @"+zoo"]));
+    XCTAssertEqualObjects(task.projects, @"+Apple, +zoo");
+    XCTAssertEqualObjects(task.contextsArray, @[@"@phone"]);
+}
+
+@end
@@ -0,0 +1,105 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMCompiledPredicate.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger TaskCount = 100000;
+
+@interface TTMCompiledPredicate_PerformanceTests : XCTestCase
+
+@property NSArray *tasks;
+@property NSPredicate *predicate;
+
+@end
+
+@implementation TTMCompiledPredicate_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    self.tasks = [TTMTestTasks tasksWithCount:TaskCount];
+    
+    // A preset as the filter editor saves it, with the hide options appended.
+    NSPredicate *preset = [NSPredicate predicateWithFormat:
+                           @"(rawText CONTAINS[cd] 'MOM' OR NOT rawText CONTAINS[cd] 'book') "
+                           @"AND completed == %@ AND dueState != %d AND dueDate < %@",
+                           @NO, (int)NoDueDate, [NSDate date]];
+    NSPredicate *hideOptions = [NSPredicate predicateWithFormat:
+                                @"thresholdState != %d AND isHidden == 0",
+                                (int)ThresholdAfterToday];
+    self.predicate = [NSCompoundPredicate andPredicateWithSubpredicates:@[preset, hideOptions]];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)test_Performance_FilterWithCompiledPredicate {
+    [self measureBlock:^{
+        NSDate *start = [NSDate date];
+        TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc]
+                                                   initWithPredicate:self.predicate];
+        NSArray *filteredTasks = [compiledPredicate filteredTasks:self.tasks];
+        NSLog(@"Filtered %lu tasks to %lu with a compiled predicate in %.1f ms",
+              (unsigned long)TaskCount, (unsigned long)filteredTasks.count,
+              -[start timeIntervalSinceNow] * 1000);
+    }];
+}
+
+- (void)test_Performance_FilterWithPredicate {
+    [self measureBlock:^{
+        NSDate *start = [NSDate date];
+        NSArray *filteredTasks = [self.tasks filteredArrayUsingPredicate:self.predicate];
+        NSLog(@"Filtered %lu tasks to %lu with NSPredicate in %.1f ms",
+              (unsigned long)TaskCount, (unsigned long)filteredTasks.count,
+              -[start timeIntervalSinceNow] * 1000);
+    }];
+}
+
+@end
@@ -0,0 +1,289 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMCompiledPredicate.h"
+#import "TTMDateUtility.h"
+#import "TTMFilterPredicates.h"
+
+@interface TTMCompiledPredicate_UnitTests : XCTestCase
+
+@property NSArray *tasks;
+
+@end
+
+@implementation TTMCompiledPredicate_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    NSString *today = [TTMDateUtility todayAsString];
+    NSArray *rawTexts = @[@"(B) call mom +Family @Phone due:2016-02-01",
+                          @"(A) file taxes +Finance @Computer t:2016-03-01",
+                          @"x 2016-01-05 2016-01-01 renew passport +Travel @Errands",
+                          @"water the plants @Home rec:+1w due:2016-01-20",
+                          @"2015-12-01 read a book +reading h:1",
+                          @"2015-12-01 Réad a böok +Reading",
+                          @"(A) 2016-01-02 pay rent +Finance due:2016-02-01 t:2016-01-25",
+                          @"",
+                          @"x 2016-01-03 buy milk @Errands",
+                          @"(C) plan trip +Travel +Family @Computer @Phone due:2015-12-31",
+                          [NSString stringWithFormat:@"due:%@ due today", today],
+                          [NSString stringWithFormat:@"t:%@ starts today", today],
+                          @"t:2999-01-01 far in the future",
+                          @"CAFÉ meeting at the Cafe @Town",
+                          @"(Z) lowest priority +ζήτα"];
+    NSMutableArray *tasks = [NSMutableArray array];
+    [rawTexts enumerateObjectsUsingBlock:^(NSString *rawText, NSUInteger i, BOOL *stop) {
+        [tasks addObject:[[TTMTask alloc] initWithRawText:rawText withTaskId:i]];
+    }];
+    self.tasks = tasks;
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)assertCompiledPredicateAgreesWithPredicate:(NSPredicate*)predicate {
+    TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc]
+                                               initWithPredicate:predicate];
+    for (TTMTask *task in self.tasks) {
+        XCTAssertEqual([compiledPredicate evaluateWithTask:task],
+                       [predicate evaluateWithObject:task],
+                       @"%@ on \"%@\"", predicate.predicateFormat, task.rawText);
+    }
+    XCTAssertEqualObjects([compiledPredicate filteredTasks:self.tasks],
+                          [self.tasks filteredArrayUsingPredicate:predicate],
+                          @"%@", predicate.predicateFormat);
+}
+
+#pragma mark - Equivalence Tests
+
+- (void)testTextComparisons {
+    NSArray *formats = @[@"rawText contains ''",
+                         @"rawText CONTAINS[cd] 'call'",
+                         @"rawText CONTAINS[cd] 'CAFE'",
+                         @"rawText CONTAINS[cd] 'read a book'",
+                         @"rawText CONTAINS[c] 'café'",
+                         @"rawText CONTAINS[d] 'Read'",
+                         @"rawText CONTAINS 'Read'",
+                         @"NOT rawText CONTAINS[cd] '+family'",
+                         @"rawText BEGINSWITH[cd] 'x '",
+                         @"rawText BEGINSWITH[cd] ''",
+                         @"rawText ENDSWITH[cd] '@PHONE'",
+                         @"rawText ==[cd] 'X 2016-01-03 BUY MILK @ERRANDS'",
+                         @"rawText !=[cd] ''",
+                         @"rawText MATCHES[cd] '.*\\\\+travel.*'",
+                         @"rawText LIKE[cd] '*rent*'",
+                         @"projects CONTAINS[cd] 'reading'",
+                         @"projects ==[cd] ''",
+                         @"contexts ENDSWITH[cd] 'errands'",
+                         @"contexts CONTAINS[cd] 'ZΉΤΑ'",
+                         @"priorityText ==[cd] 'a'",
+                         @"priorityText <[cd] 'C'",
+                         @"priorityText >=[cd] 'b'"];
+    for (NSString *format in formats) {
+        [self assertCompiledPredicateAgreesWithPredicate:[NSPredicate predicateWithFormat:format]];
+    }
+}
+
+- (void)testStateComparisons {
+    NSArray *predicates = @[[NSPredicate predicateWithFormat:@"completed == %@", @YES],
+                            [NSPredicate predicateWithFormat:@"completed == %@", @NO],
+                            [NSPredicate predicateWithFormat:@"isHidden == 0"],
+                            [NSPredicate predicateWithFormat:@"isHidden == %@", @YES],
+                            [NSPredicate predicateWithFormat:@"dueState == %d", (int)DueToday],
+                            [NSPredicate predicateWithFormat:@"dueState != %d", (int)NoDueDate],
+                            [NSPredicate predicateWithFormat:@"dueState == %d", (int)Overdue],
+                            [NSPredicate predicateWithFormat:@"thresholdState != %d",
+                             (int)ThresholdAfterToday],
+                            [NSPredicate predicateWithFormat:@"thresholdState == %d",
+                             (int)ThresholdIsToday],
+                            [NSPredicate predicateWithFormat:@"priority >= %d", (int)'B'],
+                            [NSPredicate predicateWithFormat:@"isPrioritized == YES"]];
+    for (NSPredicate *predicate in predicates) {
+        [self assertCompiledPredicateAgreesWithPredicate:predicate];
+    }
+}
+
+- (void)testDateComparisons {
+    NSDate *midnight = [TTMDateUtility convertStringToDate:@"2016-02-01"];
+    NSDate *afternoon = [midnight dateByAddingTimeInterval:15 * 60 * 60];
+    NSArray *keyPaths = @[@"dueDate", @"creationDate", @"completionDate", @"thresholdDate"];
+    NSArray *operators = @[@"<", @"<=", @">", @">=", @"==", @"!="];
+    for (NSString *keyPath in keyPaths) {
+        for (NSString *operator in operators) {
+            NSString *format = [NSString stringWithFormat:@"%@ %@ %%@", keyPath, operator];
+            [self assertCompiledPredicateAgreesWithPredicate:
+             [NSPredicate predicateWithFormat:format, midnight]];
+            [self assertCompiledPredicateAgreesWithPredicate:
+             [NSPredicate predicateWithFormat:format, afternoon]];
+        }
+    }
+}
+
+- (void)testCompoundPredicates {
+    NSArray *formats = @[@"rawText CONTAINS[cd] 'call' AND isHidden == 0",
+                         @"rawText CONTAINS[cd] 'call' OR rawText CONTAINS[cd] 'rent'",
+                         @"NOT (completed == YES OR priorityText ==[cd] 'a')",
+                         @"(contexts CONTAINS[cd] 'phone' AND NOT projects CONTAINS[cd] 'travel') OR isHidden == 1",
+                         @"TRUEPREDICATE",
+                         @"FALSEPREDICATE",
+                         @"SELF.rawText CONTAINS[cd] 'milk'"];
+    for (NSString *format in formats) {
+        [self assertCompiledPredicateAgreesWithPredicate:[NSPredicate predicateWithFormat:format]];
+    }
+    [self assertCompiledPredicateAgreesWithPredicate:
+     [NSCompoundPredicate andPredicateWithSubpredicates:@[]]];
+    [self assertCompiledPredicateAgreesWithPredicate:
+     [NSCompoundPredicate orPredicateWithSubpredicates:@[]]];
+}
+
+- (void)testFilterPresets {
+    [self assertCompiledPredicateAgreesWithPredicate:[TTMFilterPredicates defaultFilterPredicate]];
+    [self assertCompiledPredicateAgreesWithPredicate:
+     [TTMFilterPredicates hideFutureTasksFilterSubPredicate]];
+    [self assertCompiledPredicateAgreesWithPredicate:
+     [TTMFilterPredicates hideHiddenTasksFilterSubPredicate]];
+}
+
+- (void)testArchivedPredicateAgrees {
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:
+                              @"rawText CONTAINS[cd] 'a' AND dueState == %d", (int)NotDue];
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:predicate];
+    [self assertCompiledPredicateAgreesWithPredicate:[NSKeyedUnarchiver unarchiveObjectWithData:data]];
+}
+
+#pragma mark - Compilation Tests
+
+- (void)testRowTemplatePredicatesAreFullyCompiled {
+    NSArray *predicates = @[[TTMFilterPredicates defaultFilterPredicate],
+                            [NSPredicate predicateWithFormat:
+                             @"NOT rawText CONTAINS[cd] 'x' AND completed == %@", @NO],
+                            [NSPredicate predicateWithFormat:@"dueDate < %@", [NSDate date]],
+                            [NSPredicate predicateWithFormat:
+                             @"thresholdState != %d OR isHidden == 0", (int)ThresholdAfterToday]];
+    for (NSPredicate *predicate in predicates) {
+        XCTAssertTrue([[TTMCompiledPredicate alloc] initWithPredicate:predicate].isFullyCompiled,
+                      @"%@", predicate.predicateFormat);
+    }
+}
+
+- (void)testUnsupportedPredicatesFallBack {
+    NSArray *formats = @[@"rawText MATCHES[cd] '.*call.*'",
+                         @"rawText CONTAINS[cd] 'a' AND projectsArray.@count > 1",
+                         @"'call' IN rawText"];
+    for (NSString *format in formats) {
+        NSPredicate *predicate = [NSPredicate predicateWithFormat:format];
+        XCTAssertFalse([[TTMCompiledPredicate alloc] initWithPredicate:predicate].isFullyCompiled,
+                       @"%@", format);
+        [self assertCompiledPredicateAgreesWithPredicate:predicate];
+    }
+}
+
+- (void)testCompiledPredicateFollowsEditedTask {
+    TTMTask *task = self.tasks[0];
+    TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc] initWithPredicate:
+                                               [NSPredicate predicateWithFormat:
+                                                @"rawText CONTAINS[cd] 'DAD'"]];
+    XCTAssertFalse([compiledPredicate evaluateWithTask:task]);
+    [task replaceText:@"mom" withText:@"Dad"];
+    XCTAssertTrue([compiledPredicate evaluateWithTask:task]);
+}
+
+#pragma mark - Refinement Tests
+
+- (void)assertPredicateFormat:(NSString*)format
+         refinesPredicateFormat:(NSString*)otherFormat
+                       expected:(BOOL)expected {
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:format];
+    NSPredicate *otherPredicate = [NSPredicate predicateWithFormat:otherFormat];
+    XCTAssertEqual([TTMCompiledPredicate predicate:predicate refinesPredicate:otherPredicate],
+                   expected, @"%@ refines %@", format, otherFormat);
+    if (expected) {
+        // Every task the narrower predicate lets through, the broader one does too.
+        NSArray *narrowTasks = [self.tasks filteredArrayUsingPredicate:predicate];
+        NSArray *broadTasks = [self.tasks filteredArrayUsingPredicate:otherPredicate];
+        XCTAssertTrue([[NSSet setWithArray:narrowTasks] isSubsetOfSet:[NSSet setWithArray:broadTasks]]);
+    }
+}
+
+- (void)testRefinement {
+    NSString *preset = @"completed == NO AND dueState != 3";
+    NSArray *refinements = @[
+        @[@"rawText CONTAINS[cd] 'pa'", @"rawText CONTAINS[cd] 'p'"],
+        @[@"rawText CONTAINS[cd] 'CAFÉ'", @"rawText CONTAINS[cd] 'caf'"],
+        @[@"rawText CONTAINS[cd] 'ca'", @"rawText CONTAINS[cd] 'ca'"],
+        @[@"rawText BEGINSWITH[cd] '(a) '", @"rawText BEGINSWITH[cd] '(a'"],
+        @[@"rawText BEGINSWITH[cd] '(a) '", @"rawText CONTAINS[cd] 'a)'"],
+        @[@"rawText ENDSWITH[cd] 'phone'", @"rawText ENDSWITH[cd] 'one'"],
+        @[[preset stringByAppendingString:@" AND rawText CONTAINS[cd] 'call'"],
+          [preset stringByAppendingString:@" AND rawText CONTAINS[cd] 'cal'"]],
+        @[[preset stringByAppendingString:@" AND rawText CONTAINS[cd] 'call'"], preset],
+        @[@"rawText CONTAINS[cd] 'mom'", @"rawText CONTAINS[cd] 'mo' OR isHidden == 1"],
+        @[@"rawText CONTAINS[cd] 'mom' OR rawText CONTAINS[cd] 'plants'",
+          @"rawText CONTAINS[cd] 'm' OR rawText CONTAINS[cd] 'p'"]];
+    for (NSArray *pair in refinements) {
+        [self assertPredicateFormat:pair[0] refinesPredicateFormat:pair[1] expected:YES];
+    }
+    
+    NSArray *broadenings = @[
+        @[@"rawText CONTAINS[cd] 'p'", @"rawText CONTAINS[cd] 'pa'"],
+        @[@"rawText CONTAINS[cd] 'pa'", @"rawText CONTAINS[cd] ''"],
+        @[@"rawText CONTAINS 'pa'", @"rawText CONTAINS 'p'"],
+        @[@"rawText CONTAINS[c] 'pa'", @"rawText CONTAINS[cd] 'p'"],
+        @[@"projects CONTAINS[cd] 'pa'", @"rawText CONTAINS[cd] 'p'"],
+        @[@"rawText CONTAINS[cd] '(a) '", @"rawText BEGINSWITH[cd] '(a'"],
+        @[@"NOT rawText CONTAINS[cd] 'pa'", @"NOT rawText CONTAINS[cd] 'p'"],
+        @[preset, [preset stringByAppendingString:@" AND rawText CONTAINS[cd] 'call'"]],
+        @[@"rawText CONTAINS[cd] 'mom' OR isHidden == 1", @"rawText CONTAINS[cd] 'mo'"]];
+    for (NSArray *pair in broadenings) {
+        [self assertPredicateFormat:pair[0] refinesPredicateFormat:pair[1] expected:NO];
+    }
+}
+
+@end
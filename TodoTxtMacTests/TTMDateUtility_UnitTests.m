@@ -118,4 +118,73 @@
     XCTAssertEqualObjects(firstDateModified, secondDate);
 }
 
+- (void)testDayNumberFromString_WithEpochAndSentinels {
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"1970-01-01"], 0);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"1969-12-31"], -1);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"9999-12-31"], TTMHighDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"1900-01-01"], TTMLowDayNumber);
+}
+
+- (void)testDayNumberFromString_WithLeapDays {
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2016-02-29"],
+                   [TTMDateUtility dayNumberFromString:@"2016-02-28"] + 1);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2000-02-29"],
+                   [TTMDateUtility dayNumberFromString:@"2000-03-01"] - 1);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2015-02-29"], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"1900-02-29"], TTMNoDayNumber);
+}
+
+- (void)testDayNumberFromString_WithInvalidDates {
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2020-13-01"], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2020-00-01"], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2020-04-31"], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2020-01-00"], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2020-1-01"], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@"2020/01/01"], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:@""], TTMNoDayNumber);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:nil], TTMNoDayNumber);
+}
+
+- (void)testDayNumberFromString_WithRange {
+    NSString *task = @"pick up groceries due:2016-03-15 +Chores";
+    NSRange range = NSMakeRange(22, 10);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:task range:range],
+                   [TTMDateUtility dayNumberFromString:@"2016-03-15"]);
+    XCTAssertEqual([TTMDateUtility dayNumberFromString:task range:NSMakeRange(NSNotFound, 0)],
+                   TTMNoDayNumber);
+}
+
+- (void)testStringFromDayNumber_RoundTrips {
+    for (NSString *dateString in @[@"1900-01-01", @"1970-01-01", @"2000-02-29", @"2015-03-08",
+                                   @"2015-11-01", @"2016-12-31", @"9999-12-31"]) {
+        TTMDayNumber dayNumber = [TTMDateUtility dayNumberFromString:dateString];
+        XCTAssertEqualObjects([TTMDateUtility stringFromDayNumber:dayNumber], dateString);
+    }
+    XCTAssertNil([TTMDateUtility stringFromDayNumber:TTMNoDayNumber]);
+}
+
+- (void)testDateFromDayNumber_MatchesDateFormatter {
+    NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
+    [dateFormatter setCalendar:[[NSCalendar alloc]
+                                initWithCalendarIdentifier:NSCalendarIdentifierGregorian]];
+    [dateFormatter setLocale:[NSLocale systemLocale]];
+    [dateFormatter setDateFormat:@"yyyy-MM-dd HH:mm:ss"];
+    for (NSString *dateString in @[@"1900-01-01", @"1970-01-01", @"2015-03-08", @"2015-03-09",
+                                   @"2015-11-01", @"2016-02-29", @"9999-12-31"]) {
+        NSDate *expected = [dateFormatter dateFromString:
+                            [dateString stringByAppendingString:@" 00:00:00"]];
+        TTMDayNumber dayNumber = [TTMDateUtility dayNumberFromString:dateString];
+        XCTAssertEqualObjects([TTMDateUtility dateFromDayNumber:dayNumber], expected);
+        XCTAssertEqual([TTMDateUtility dayNumberFromDate:expected], dayNumber);
+    }
+    XCTAssertNil([TTMDateUtility dateFromDayNumber:TTMNoDayNumber]);
+}
+
+- (void)testTodayDayNumber_MatchesToday {
+    XCTAssertEqual([TTMDateUtility todayDayNumber],
+                   [TTMDateUtility dayNumberFromDate:[TTMDateUtility today]]);
+    XCTAssertEqualObjects([TTMDateUtility stringFromDayNumber:[TTMDateUtility todayDayNumber]],
+                          [TTMDateUtility todayAsString]);
+}
+
 @end
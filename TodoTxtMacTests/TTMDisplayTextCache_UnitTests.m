@@ -0,0 +1,149 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMDisplayTextCache.h"
+
+@interface TTMDisplayTextCache_UnitTests : XCTestCase
+
+@property TTMDisplayTextCache *cache;
+@property TTMTask *task;
+@property NSFont *font;
+
+@end
+
+@implementation TTMDisplayTextCache_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.cache = [[TTMDisplayTextCache alloc] initWithByteLimit:1024 * 1024];
+    self.task = [[TTMTask alloc] initWithRawText:@"(A) call mom +Family" withTaskId:0];
+    self.font = [NSFont systemFontOfSize:13];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSAttributedString*)textOfTask:(TTMTask*)task {
+    return [[NSAttributedString alloc] initWithString:task.rawText];
+}
+
+- (void)addTask:(TTMTask*)task {
+    [self.cache setDisplayText:[self textOfTask:task] ofTask:task selected:NO font:self.font
+         colorSchemeGeneration:0];
+}
+
+- (NSAttributedString*)cachedTextOfTask:(TTMTask*)task {
+    return [self.cache displayTextOfTask:task selected:NO font:self.font colorSchemeGeneration:0];
+}
+
+- (void)testHeldTextIsReused {
+    NSAttributedString *text = [self textOfTask:self.task];
+    [self.cache setDisplayText:text ofTask:self.task selected:NO font:self.font
+         colorSchemeGeneration:0];
+    XCTAssertEqual([self cachedTextOfTask:self.task], text);
+    XCTAssertEqual(self.cache.count, 1);
+}
+
+- (void)testSelectedAndUnselectedRowsAreHeldApart {
+    [self addTask:self.task];
+    XCTAssertNil([self.cache displayTextOfTask:self.task selected:YES font:self.font
+                         colorSchemeGeneration:0]);
+}
+
+- (void)testEditedTaskIsNotReused {
+    [self addTask:self.task];
+    self.task.rawText = @"(B) call mom +Family";
+    XCTAssertNil([self cachedTextOfTask:self.task]);
+}
+
+- (void)testOtherFontOrColorSchemeIsNotReused {
+    [self addTask:self.task];
+    XCTAssertNil([self.cache displayTextOfTask:self.task selected:NO
+                                          font:[NSFont systemFontOfSize:18]
+                         colorSchemeGeneration:0]);
+    XCTAssertNil([self.cache displayTextOfTask:self.task selected:NO font:self.font
+                         colorSchemeGeneration:1]);
+    // An equal font is the same font.
+    XCTAssertNotNil([self.cache displayTextOfTask:self.task selected:NO
+                                             font:[NSFont systemFontOfSize:13]
+                            colorSchemeGeneration:0]);
+}
+
+- (void)testLeastRecentlyUsedTextIsDroppedOverTheLimit {
+    NSMutableArray *tasks = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; i++) {
+        [tasks addObject:[[TTMTask alloc] initWithRawText:@"(A) call mom +Family" withTaskId:i]];
+        [self addTask:tasks[i]];
+    }
+    NSUInteger byteCountOfOne = self.cache.byteCount / 3;
+    [self cachedTextOfTask:tasks[0]];
+    self.cache.byteLimit = byteCountOfOne * 2;
+    XCTAssertEqual(self.cache.count, 2);
+    XCTAssertNotNil([self cachedTextOfTask:tasks[0]]);
+    XCTAssertNil([self cachedTextOfTask:tasks[1]]);
+    XCTAssertNotNil([self cachedTextOfTask:tasks[2]]);
+    
+    // Adding another drops the least recently used.
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"(A) call mom +Family" withTaskId:3];
+    [self addTask:task];
+    XCTAssertEqual(self.cache.count, 2);
+    XCTAssertNil([self cachedTextOfTask:tasks[0]]);
+    XCTAssertNotNil([self cachedTextOfTask:task]);
+}
+
+- (void)testRemoveAllDisplayTexts {
+    [self addTask:self.task];
+    [self.cache removeAllDisplayTexts];
+    XCTAssertEqual(self.cache.count, 0);
+    XCTAssertEqual(self.cache.byteCount, 0);
+    XCTAssertNil([self cachedTextOfTask:self.task]);
+}
+
+@end
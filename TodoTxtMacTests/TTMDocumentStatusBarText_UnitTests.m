@@ -0,0 +1,114 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMDocument.h"
+#import "TTMDocumentStatusBarText.h"
+#import "TTMTasklistMetadata.h"
+
+@interface TTMDocumentStatusBarText_UnitTests : XCTestCase
+
+@property TTMDocument *document;
+
+@end
+
+@implementation TTMDocumentStatusBarText_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.document = [[TTMDocument alloc] init];
+    self.document.tasklistMetadata.allTaskCount = 12;
+    self.document.filteredTasklistMetadata.allTaskCount = 5;
+    self.document.tasklistMetadata.prioritiesCount = 3;
+    self.document.activeSortType = TTMSortDueDate;
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)testTagsAreReplaced {
+    TTMDocumentStatusBarText *statusBarText = [[TTMDocumentStatusBarText alloc]
+                                               initWithTTMDocument:self.document
+                                               format:@"{Shown Tasks} of {all tasks}, "
+                                                      @"{All Priorities} priorities, {Sort Name}"];
+    XCTAssertEqualObjects([statusBarText statusBarText], @"5 of 12, 3 priorities, Due Date");
+}
+
+- (void)testTextThatIsNotATagIsKept {
+    TTMDocumentStatusBarText *statusBarText = [[TTMDocumentStatusBarText alloc]
+                                               initWithTTMDocument:self.document
+                                               format:@"{{All Tasks}} {Unknown} {"];
+    XCTAssertEqualObjects([statusBarText statusBarText], @"{12} {Unknown} {");
+}
+
+- (void)testOnlyTagsOfChangedInputsAreUpdated {
+    TTMDocumentStatusBarText *statusBarText = [[TTMDocumentStatusBarText alloc]
+                                               initWithTTMDocument:self.document
+                                               format:@"Tasks: {All Tasks} Selected: {Selected}"];
+    XCTAssertEqual(statusBarText.inputs, TTMStatusBarAllTasksInput | TTMStatusBarSelectionInput);
+    NSString *text = [statusBarText statusBarText];
+    XCTAssertEqualObjects(text, @"Tasks: 12 Selected: 0");
+    
+    // A change of selection does not look at the task counts.
+    self.document.tasklistMetadata.allTaskCount = 13;
+    XCTAssertEqual([statusBarText statusBarTextWithChangedInputs:TTMStatusBarSelectionInput], text);
+    XCTAssertEqualObjects([statusBarText statusBarTextWithChangedInputs:TTMStatusBarAllTasksInput],
+                          @"Tasks: 13 Selected: 0");
+}
+
+- (void)testChangingTheFormatCompilesItAgain {
+    TTMDocumentStatusBarText *statusBarText = [[TTMDocumentStatusBarText alloc]
+                                               initWithTTMDocument:self.document
+                                               format:@"{All Tasks}"];
+    [statusBarText statusBarText];
+    statusBarText.format = @"{Shown Tasks}";
+    XCTAssertEqual(statusBarText.inputs, TTMStatusBarShownTasksInput);
+    XCTAssertEqualObjects([statusBarText statusBarTextWithChangedInputs:0], @"5");
+}
+
+@end
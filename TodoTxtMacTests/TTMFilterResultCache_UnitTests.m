@@ -0,0 +1,115 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMFilterResultCache.h"
+
+@interface TTMFilterResultCache_UnitTests : XCTestCase
+
+@property TTMFilterResultCache *cache;
+
+@end
+
+@implementation TTMFilterResultCache_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.cache = [[TTMFilterResultCache alloc] initWithCapacity:2];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSPredicate*)searchFor:(NSString*)string {
+    return [NSPredicate predicateWithFormat:@"rawText CONTAINS[cd] %@", string];
+}
+
+- (void)testSamePredicateIsAlreadyFiltered {
+    [self.cache addFilteredTasks:@[@"pay rent"] forPredicate:[self searchFor:@"pa"]];
+    BOOL isFiltered = NO;
+    NSArray *tasks = [self.cache tasksToFilterWithPredicate:[self searchFor:@"pa"]
+                                                 isFiltered:&isFiltered];
+    XCTAssertTrue(isFiltered);
+    XCTAssertEqualObjects(tasks, @[@"pay rent"]);
+}
+
+- (void)testRefinementFiltersSmallestResult {
+    [self.cache addFilteredTasks:@[@"pay rent", @"plants"] forPredicate:[self searchFor:@"p"]];
+    [self.cache addFilteredTasks:@[@"pay rent"] forPredicate:[self searchFor:@"pa"]];
+    BOOL isFiltered = YES;
+    NSArray *tasks = [self.cache tasksToFilterWithPredicate:[self searchFor:@"pay"]
+                                                 isFiltered:&isFiltered];
+    XCTAssertFalse(isFiltered);
+    XCTAssertEqualObjects(tasks, @[@"pay rent"]);
+}
+
+- (void)testBroaderPredicateFiltersEverything {
+    [self.cache addFilteredTasks:@[@"pay rent"] forPredicate:[self searchFor:@"pa"]];
+    BOOL isFiltered = YES;
+    XCTAssertNil([self.cache tasksToFilterWithPredicate:[self searchFor:@"p"]
+                                             isFiltered:&isFiltered]);
+    XCTAssertFalse(isFiltered);
+}
+
+- (void)testLeastRecentlyUsedResultIsDropped {
+    BOOL isFiltered = NO;
+    [self.cache addFilteredTasks:@[@"a"] forPredicate:[self searchFor:@"a"]];
+    [self.cache addFilteredTasks:@[@"b"] forPredicate:[self searchFor:@"b"]];
+    [self.cache tasksToFilterWithPredicate:[self searchFor:@"a"] isFiltered:&isFiltered];
+    [self.cache addFilteredTasks:@[@"c"] forPredicate:[self searchFor:@"c"]];
+    XCTAssertNotNil([self.cache tasksToFilterWithPredicate:[self searchFor:@"a"]
+                                                isFiltered:&isFiltered]);
+    XCTAssertNil([self.cache tasksToFilterWithPredicate:[self searchFor:@"b"]
+                                             isFiltered:&isFiltered]);
+    
+    [self.cache removeAllResults];
+    XCTAssertNil([self.cache tasksToFilterWithPredicate:[self searchFor:@"a"]
+                                             isFiltered:&isFiltered]);
+}
+
+@end
@@ -0,0 +1,102 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMLatencyHistogram.h"
+
+@interface TTMLatencyHistogram_UnitTests : XCTestCase
+
+@property TTMLatencyHistogram *histogram;
+
+@end
+
+@implementation TTMLatencyHistogram_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.histogram = [[TTMLatencyHistogram alloc] init];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)testLatenciesAreCountedInDoublingBuckets {
+    [self.histogram recordLatency:0.0005];
+    [self.histogram recordLatency:0.001];
+    [self.histogram recordLatency:0.003];
+    [self.histogram recordLatency:0.0035];
+    [self.histogram recordLatency:100];
+    XCTAssertEqual(self.histogram.count, 5);
+    XCTAssertEqual([self.histogram countInBucket:0], 1);
+    XCTAssertEqual([self.histogram countInBucket:1], 1);
+    XCTAssertEqual([self.histogram countInBucket:2], 2);
+    // Anything too long for the other buckets goes in the last one.
+    XCTAssertEqual([self.histogram countInBucket:15], 1);
+    XCTAssertEqual(self.histogram.maximumLatency, 100);
+}
+
+- (void)testPercentilesAreBucketUpperBounds {
+    XCTAssertEqual([self.histogram latencyAtPercentile:50], 0);
+    for (NSUInteger i = 0; i < 9; i++) {
+        [self.histogram recordLatency:0.005];
+    }
+    [self.histogram recordLatency:0.040];
+    XCTAssertEqualWithAccuracy([self.histogram latencyAtPercentile:50], 0.008, 1e-9);
+    XCTAssertEqualWithAccuracy([self.histogram latencyAtPercentile:90], 0.008, 1e-9);
+    XCTAssertEqualWithAccuracy([self.histogram latencyAtPercentile:99], 0.064, 1e-9);
+}
+
+- (void)testRemoveAllLatencies {
+    [self.histogram recordLatency:0.002];
+    [self.histogram removeAllLatencies];
+    XCTAssertEqual(self.histogram.count, 0);
+    XCTAssertEqual([self.histogram countInBucket:2], 0);
+    XCTAssertEqual(self.histogram.maximumLatency, 0);
+}
+
+@end
@@ -0,0 +1,186 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMLineDiff.h"
+
+@interface TTMLineDiff_UnitTests : XCTestCase
+
+@end
+
+@implementation TTMLineDiff_UnitTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (TTMDiffLine*)diffLinesFromStrings:(NSArray*)strings {
+    TTMDiffLine *lines = malloc(MAX([strings count], (NSUInteger)1) * sizeof(TTMDiffLine));
+    for (NSUInteger i = 0; i < [strings count]; i++) {
+        const char *utf8 = [[strings objectAtIndex:i] UTF8String];
+        lines[i].bytes = utf8;
+        lines[i].length = strlen(utf8);
+        lines[i].hash = [TTMLineDiff hashOfBytes:utf8 length:lines[i].length];
+    }
+    return lines;
+}
+
+- (TTMLineDiff*)diffFromLines:(NSArray*)oldLines toLines:(NSArray*)newLines
+              maxEditDistance:(NSUInteger)maxEditDistance {
+    TTMDiffLine *oldDiffLines = [self diffLinesFromStrings:oldLines];
+    TTMDiffLine *newDiffLines = [self diffLinesFromStrings:newLines];
+    TTMLineDiff *diff = [[TTMLineDiff alloc] initWithOldLines:oldDiffLines count:[oldLines count]
+                                                     newLines:newDiffLines count:[newLines count]
+                                              maxEditDistance:maxEditDistance];
+    free(oldDiffLines);
+    free(newDiffLines);
+    return diff;
+}
+
+- (TTMLineDiff*)diffFromLines:(NSArray*)oldLines toLines:(NSArray*)newLines {
+    return [self diffFromLines:oldLines toLines:newLines maxEditDistance:100];
+}
+
+- (NSIndexSet*)indexes:(NSArray*)indexes {
+    NSMutableIndexSet *indexSet = [NSMutableIndexSet indexSet];
+    for (NSNumber *index in indexes) {
+        [indexSet addIndex:[index unsignedIntegerValue]];
+    }
+    return indexSet;
+}
+
+- (void)testIdenticalLines {
+    TTMLineDiff *diff = [self diffFromLines:@[@"a", @"b", @"c"] toLines:@[@"a", @"b", @"c"]];
+    XCTAssertEqual([diff.deletedIndexes count], 0);
+    XCTAssertEqual([diff.insertedIndexes count], 0);
+}
+
+- (void)testChangedLine {
+    TTMLineDiff *diff = [self diffFromLines:@[@"a", @"b", @"c"] toLines:@[@"a", @"x", @"c"]];
+    XCTAssertEqualObjects(diff.deletedIndexes, [self indexes:@[@1]]);
+    XCTAssertEqualObjects(diff.insertedIndexes, [self indexes:@[@1]]);
+}
+
+- (void)testInsertedAndDeletedLines {
+    TTMLineDiff *diff = [self diffFromLines:@[@"a", @"b", @"c", @"d"]
+                                    toLines:@[@"new", @"a", @"c", @"d", @"end"]];
+    XCTAssertEqualObjects(diff.deletedIndexes, [self indexes:@[@1]]);
+    XCTAssertEqualObjects(diff.insertedIndexes, [self indexes:@[@0, @4]]);
+}
+
+- (void)testEmptySides {
+    TTMLineDiff *diff = [self diffFromLines:@[] toLines:@[@"a", @"b"]];
+    XCTAssertEqualObjects(diff.insertedIndexes, [self indexes:@[@0, @1]]);
+    diff = [self diffFromLines:@[@"a", @"b"] toLines:@[]];
+    XCTAssertEqualObjects(diff.deletedIndexes, [self indexes:@[@0, @1]]);
+}
+
+- (void)testShortestEditScript {
+    // "abcabba" to "cbabac" is the example in Myers' paper; it takes five edits.
+    NSArray *oldLines = @[@"a", @"b", @"c", @"a", @"b", @"b", @"a"];
+    NSArray *newLines = @[@"c", @"b", @"a", @"b", @"a", @"c"];
+    TTMLineDiff *diff = [self diffFromLines:oldLines toLines:newLines];
+    XCTAssertEqual([diff.deletedIndexes count] + [diff.insertedIndexes count], 5);
+    
+    // The lines left over on each side match in order.
+    NSMutableArray *keptOldLines = [oldLines mutableCopy];
+    [keptOldLines removeObjectsAtIndexes:diff.deletedIndexes];
+    NSMutableArray *keptNewLines = [newLines mutableCopy];
+    [keptNewLines removeObjectsAtIndexes:diff.insertedIndexes];
+    XCTAssertEqualObjects(keptOldLines, keptNewLines);
+}
+
+- (void)testTooManyEdits {
+    NSArray *oldLines = @[@"a", @"b", @"c", @"d"];
+    NSArray *newLines = @[@"w", @"x", @"y", @"z"];
+    XCTAssertNil([self diffFromLines:oldLines toLines:newLines maxEditDistance:7]);
+    XCTAssertNotNil([self diffFromLines:oldLines toLines:newLines maxEditDistance:8]);
+    XCTAssertNil([self diffFromLines:@[] toLines:oldLines maxEditDistance:3]);
+}
+
+- (void)testOneChangedLineInLargeFile {
+    NSMutableArray *oldLines = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 50000; i++) {
+        [oldLines addObject:[NSString stringWithFormat:@"task %lu +project @context", i]];
+    }
+    NSMutableArray *newLines = [oldLines mutableCopy];
+    [newLines replaceObjectAtIndex:25000 withObject:@"x task 25000 +project @context"];
+    TTMLineDiff *diff = [self diffFromLines:oldLines toLines:newLines];
+    XCTAssertEqualObjects(diff.deletedIndexes, [self indexes:@[@25000]]);
+    XCTAssertEqualObjects(diff.insertedIndexes, [self indexes:@[@25000]]);
+}
+
+- (void)testLinesWithCollidingHashesDiffer {
+    // Give two different lines the same hash, as a collision would.
+    TTMDiffLine oldLines[] = {{"a", 1, 7}, {"b", 1, 42}, {"c", 1, 9}};
+    TTMDiffLine newLines[] = {{"a", 1, 7}, {"x", 1, 42}, {"c", 1, 9}};
+    TTMLineDiff *diff = [[TTMLineDiff alloc] initWithOldLines:oldLines count:3
+                                                     newLines:newLines count:3
+                                              maxEditDistance:100];
+    XCTAssertEqualObjects(diff.deletedIndexes, [self indexes:@[@1]]);
+    XCTAssertEqualObjects(diff.insertedIndexes, [self indexes:@[@1]]);
+}
+
+- (void)testStringHashMatchesByteHash {
+    NSString *line = @"(A) Call Mom été \U0001F600 +family @phone";
+    NSData *data = [line dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqual([TTMLineDiff hashOfString:line],
+                   [TTMLineDiff hashOfBytes:data.bytes length:data.length]);
+    
+    // Long lines are hashed a buffer at a time.
+    NSString *longLine = [@"" stringByPaddingToLength:1000 withString:@"éx" startingAtIndex:0];
+    data = [longLine dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqual([TTMLineDiff hashOfString:longLine],
+                   [TTMLineDiff hashOfBytes:data.bytes length:data.length]);
+    XCTAssertNotEqual([TTMLineDiff hashOfString:@"a"], [TTMLineDiff hashOfString:@"b"]);
+}
+
+@end
@@ -0,0 +1,125 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMLineIndex.h"
+#import "TTMTestTasks.h"
+
+// About 8 MB of archived tasks.
+static const NSUInteger ArchiveLineCount = 120000;
+
+@interface TTMLineIndex_PerformanceTests : XCTestCase
+
+@property NSData *asciiArchive;
+@property NSData *mixedArchive;
+
+@end
+
+@implementation TTMLineIndex_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    self.asciiArchive = [self archiveWithTemplates:
+                         @[@"x 2016-01-%02lu 2015-12-%02lu file taxes and send the forms +Finance @Computer",
+                           @"x 2016-02-%02lu 2016-01-%02lu call mom about the family dinner +Family @Phone"]];
+    self.mixedArchive = [self archiveWithTemplates:
+                         @[@"x 2016-01-%02lu 2015-12-%02lu file taxes and send the forms +Finance @Computer",
+                           @"x 2016-02-%02lu 2016-01-%02lu réserver le café pour la réunion +Réunion @Bureau"]];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSData*)archiveWithTemplates:(NSArray*)templates {
+    NSArray *lines = [TTMTestTasks rawTextsWithCount:ArchiveLineCount templates:templates];
+    NSMutableString *archive = [NSMutableString string];
+    for (NSUInteger i = 0; i < ArchiveLineCount; i++) {
+        [archive appendString:lines[i]];
+        // Mix line endings the way a file edited on both Windows and the Mac would.
+        [archive appendString:(i % 3 == 0) ? @"\r\n" : @"\n"];
+    }
+    return [archive dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)measureFoundationSplitOfData:(NSData*)data {
+    [self measureBlock:^{
+        NSString *fileContents = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+        BOOL usesWindowsLineEndings = ([fileContents rangeOfString:@"\r\n"].location != NSNotFound);
+        NSArray *lines = (usesWindowsLineEndings) ?
+            [[fileContents stringByReplacingOccurrencesOfString:@"\r" withString:@""]
+             componentsSeparatedByString:@"\n"] :
+            [fileContents componentsSeparatedByString:@"\n"];
+        XCTAssertEqual(lines.count, ArchiveLineCount + 1);
+    }];
+}
+
+- (void)measureLineIndexOfData:(NSData*)data {
+    [self measureBlock:^{
+        TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:data];
+        XCTAssertEqual(lineIndex.lineCount, ArchiveLineCount);
+        XCTAssertTrue(lineIndex.isValidUTF8);
+    }];
+}
+
+- (void)test_Performance_FoundationSplit_ASCII {
+    [self measureFoundationSplitOfData:self.asciiArchive];
+}
+
+- (void)test_Performance_LineIndex_ASCII {
+    [self measureLineIndexOfData:self.asciiArchive];
+}
+
+- (void)test_Performance_FoundationSplit_NonASCII {
+    [self measureFoundationSplitOfData:self.mixedArchive];
+}
+
+- (void)test_Performance_LineIndex_NonASCII {
+    [self measureLineIndexOfData:self.mixedArchive];
+}
+
+@end
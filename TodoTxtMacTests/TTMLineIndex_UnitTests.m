@@ -0,0 +1,176 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMLineIndex.h"
+
+@interface TTMLineIndex_UnitTests : XCTestCase
+
+@end
+
+@implementation TTMLineIndex_UnitTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSArray*)linesOfString:(NSString*)string lineIndex:(TTMLineIndex**)outLineIndex {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:data];
+    NSMutableArray *lines = [NSMutableArray array];
+    for (NSUInteger i = 0; i < lineIndex.lineCount; i++) {
+        NSData *lineData = [data subdataWithRange:[lineIndex rangeOfLineAtIndex:i]];
+        [lines addObject:[[NSString alloc] initWithData:lineData encoding:NSUTF8StringEncoding]];
+    }
+    if (outLineIndex != NULL) {
+        *outLineIndex = lineIndex;
+    }
+    return lines;
+}
+
+- (void)testUnixLineEndings {
+    TTMLineIndex *lineIndex;
+    NSArray *lines = [self linesOfString:@"first\nsecond\n\nfourth\n" lineIndex:&lineIndex];
+    XCTAssertEqualObjects(lines, (@[@"first", @"second", @"", @"fourth"]));
+    XCTAssertFalse(lineIndex.hasWindowsLineEndings);
+}
+
+- (void)testWindowsLineEndings {
+    TTMLineIndex *lineIndex;
+    NSArray *lines = [self linesOfString:@"first\r\nsecond\r\n" lineIndex:&lineIndex];
+    XCTAssertEqualObjects(lines, (@[@"first", @"second"]));
+    XCTAssertTrue(lineIndex.hasWindowsLineEndings);
+}
+
+- (void)testMixedLineEndings {
+    TTMLineIndex *lineIndex;
+    NSArray *lines = [self linesOfString:@"first\nsecond\r\nthird\r\r\nfourth" lineIndex:&lineIndex];
+    XCTAssertEqualObjects(lines, (@[@"first", @"second", @"third", @"fourth"]));
+    XCTAssertTrue(lineIndex.hasWindowsLineEndings);
+}
+
+- (void)testLastLineWithoutLineEnding {
+    NSArray *lines = [self linesOfString:@"first\nsecond" lineIndex:NULL];
+    XCTAssertEqualObjects(lines, (@[@"first", @"second"]));
+}
+
+- (void)testCarriageReturnsInsideLinesAreKept {
+    TTMLineIndex *lineIndex;
+    NSArray *lines = [self linesOfString:@"fir\rst\nsecond\r" lineIndex:&lineIndex];
+    XCTAssertEqualObjects(lines, (@[@"fir\rst", @"second\r"]));
+    XCTAssertFalse(lineIndex.hasWindowsLineEndings);
+}
+
+- (void)testByteOrderMarkIsSkipped {
+    NSArray *lines = [self linesOfString:@"\uFEFFfirst\nsecond" lineIndex:NULL];
+    XCTAssertEqualObjects(lines, (@[@"first", @"second"]));
+}
+
+- (void)testEmptyBuffer {
+    TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:[NSData data]];
+    XCTAssertEqual(lineIndex.lineCount, 0);
+    XCTAssertFalse(lineIndex.hasWindowsLineEndings);
+}
+
+- (void)testMultibyteCharacters {
+    NSArray *lines = [self linesOfString:@"café +Café\r\n日本 @東京\n" lineIndex:NULL];
+    XCTAssertEqualObjects(lines, (@[@"café +Café", @"日本 @東京"]));
+}
+
+- (void)testLinesLongerThanOneBlock {
+    NSString *longLine = [@"" stringByPaddingToLength:37 withString:@"abc " startingAtIndex:0];
+    NSString *string = [NSString stringWithFormat:@"%@\n%@\r\n\n%@", longLine, longLine, longLine];
+    NSArray *lines = [self linesOfString:string lineIndex:NULL];
+    XCTAssertEqualObjects(lines, (@[longLine, longLine, @"", longLine]));
+}
+
+- (void)testRangeOfLineWithEnding_ShouldCoverWholeBuffer {
+    NSData *data = [@"\uFEFFfirst\r\nsecond\nthird" dataUsingEncoding:NSUTF8StringEncoding];
+    TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:data];
+    XCTAssertEqual(lineIndex.lineCount, 3);
+    XCTAssertTrue(NSEqualRanges([lineIndex rangeOfLineWithEndingAtIndex:0], NSMakeRange(3, 7)));
+    XCTAssertTrue(NSEqualRanges([lineIndex rangeOfLineWithEndingAtIndex:1], NSMakeRange(10, 7)));
+    XCTAssertTrue(NSEqualRanges([lineIndex rangeOfLineWithEndingAtIndex:2], NSMakeRange(17, 5)));
+}
+
+- (void)testASCII {
+    NSData *ascii = [@"(A) call mom\nx 2016-01-01 pay bills\n" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertTrue([[TTMLineIndex alloc] initWithData:ascii].isASCII);
+    XCTAssertTrue([[TTMLineIndex alloc] initWithData:ascii].isValidUTF8);
+    NSData *accented = [@"(A) call mom about the café\n" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertFalse([[TTMLineIndex alloc] initWithData:accented].isASCII);
+    XCTAssertTrue([[TTMLineIndex alloc] initWithData:accented].isValidUTF8);
+    NSData *byteOrderMark = [@"\uFEFFcall mom\n" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertTrue([[TTMLineIndex alloc] initWithData:byteOrderMark].isASCII);
+}
+
+- (BOOL)isValidUTF8:(const char*)bytes {
+    return [[TTMLineIndex alloc] initWithBytes:bytes length:strlen(bytes)].isValidUTF8;
+}
+
+- (void)testUTF8Validation {
+    // Multi-byte sequences, including ones that straddle the 16-byte blocks.
+    XCTAssertTrue([self isValidUTF8:"0123456789abcd\xC3\xA9 and \xE6\x97\xA5\xE6\x9C\xAC"]);
+    XCTAssertTrue([self isValidUTF8:"0123456789abc\xF0\x9F\x98\x80 smile\n"]);
+    XCTAssertTrue([self isValidUTF8:"\xF4\x8F\xBF\xBF is the highest code point"]);
+    // Invalid bytes, truncated sequences, overlong encodings, surrogates, and code points
+    // above U+10FFFF.
+    XCTAssertFalse([self isValidUTF8:"bad \xFF byte"]);
+    XCTAssertFalse([self isValidUTF8:"stray \x80 continuation byte"]);
+    XCTAssertFalse([self isValidUTF8:"truncated at the end \xE6\x97"]);
+    XCTAssertFalse([self isValidUTF8:"0123456789abcde\xE6 then ASCII in the next block"]);
+    XCTAssertFalse([self isValidUTF8:"overlong \xC0\xAF slash"]);
+    XCTAssertFalse([self isValidUTF8:"overlong \xE0\x80\xAF slash"]);
+    XCTAssertFalse([self isValidUTF8:"surrogate \xED\xA0\x80 half"]);
+    XCTAssertFalse([self isValidUTF8:"too high \xF4\x90\x80\x80 code point"]);
+}
+
+@end
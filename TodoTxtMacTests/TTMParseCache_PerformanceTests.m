@@ -0,0 +1,134 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMParseCache.h"
+#import "TTMTaskLoader.h"
+#import "TTMLineIndex.h"
+#import "TTMSymbolTable.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger LineCount = 100000;
+
+@interface TTMParseCache_PerformanceTests : XCTestCase
+
+@property NSURL *directoryURL;
+@property NSURL *fileURL;
+@property TTMParseCache *parseCache;
+
+@end
+
+@implementation TTMParseCache_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    self.directoryURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()]
+                         URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtURL:self.directoryURL
+                             withIntermediateDirectories:YES
+                                              attributes:nil
+                                                   error:nil];
+    self.fileURL = [self.directoryURL URLByAppendingPathComponent:@"todo.txt"];
+    self.parseCache = [[TTMParseCache alloc] initWithDirectoryURL:
+                       [self.directoryURL URLByAppendingPathComponent:@"ParseCache"]];
+    
+    NSArray *lines = [TTMTestTasks rawTextsWithCount:LineCount];
+    NSString *contents = [[lines componentsJoinedByString:@"\n"] stringByAppendingString:@"\n"];
+    [[contents dataUsingEncoding:NSUTF8StringEncoding] writeToURL:self.fileURL atomically:NO];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+    [super tearDown];
+}
+
+- (NSArray*)openFileUsingCache:(BOOL)useCache {
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL
+                                         options:NSDataReadingMappedIfSafe
+                                           error:nil];
+    TTMLineIndex *lineIndex = [[TTMLineIndex alloc] initWithData:data];
+    TTMSymbolTable *symbolTable = [[TTMSymbolTable alloc] init];
+    NSArray *tasks = useCache ? [self.parseCache tasksFromData:data
+                                                     lineIndex:lineIndex
+                                                       fileURL:self.fileURL
+                                                   firstTaskId:0
+                                                   symbolTable:symbolTable] : nil;
+    if (!tasks) {
+        tasks = [TTMTaskLoader tasksFromData:data
+                                   lineIndex:lineIndex
+                                 firstTaskId:0
+                                 symbolTable:symbolTable];
+        if (useCache) {
+            [self.parseCache storeEntry:[self.parseCache entryForTasks:tasks fileData:data]
+                             forFileURL:self.fileURL];
+            [self.parseCache waitForPendingWrites];
+        }
+    }
+    return tasks;
+}
+
+- (void)test_Performance_ColdOpen {
+    [self measureBlock:^{
+        XCTAssertEqual([self openFileUsingCache:NO].count, LineCount);
+    }];
+}
+
+- (void)test_Performance_WarmOpen {
+    [self openFileUsingCache:YES];
+    [self measureBlock:^{
+        XCTAssertEqual([self openFileUsingCache:YES].count, LineCount);
+    }];
+}
+
+- (void)test_Performance_ColdOpenWritingCache {
+    [self measureBlock:^{
+        [[NSFileManager defaultManager] removeItemAtURL:self.parseCache.directoryURL error:nil];
+        XCTAssertEqual([self openFileUsingCache:YES].count, LineCount);
+    }];
+}
+
+@end
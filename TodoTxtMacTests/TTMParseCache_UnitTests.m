@@ -0,0 +1,252 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMParseCache.h"
+#import "TTMTaskLoader.h"
+#import "TTMLineIndex.h"
+#import "TTMSymbolTable.h"
+#import "TTMTask.h"
+
+@interface TTMParseCache_UnitTests : XCTestCase
+
+@property NSURL *directoryURL;
+@property NSURL *fileURL;
+@property TTMParseCache *parseCache;
+
+@end
+
+@implementation TTMParseCache_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.directoryURL = [[NSURL fileURLWithPath:NSTemporaryDirectory()]
+                         URLByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtURL:self.directoryURL
+                             withIntermediateDirectories:YES
+                                              attributes:nil
+                                                   error:nil];
+    self.fileURL = [self.directoryURL URLByAppendingPathComponent:@"todo.txt"];
+    self.parseCache = [[TTMParseCache alloc] initWithDirectoryURL:
+                       [self.directoryURL URLByAppendingPathComponent:@"ParseCache"]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:nil];
+    [super tearDown];
+}
+
+- (NSData*)writeFileWithContents:(NSString*)contents {
+    NSData *data = [contents dataUsingEncoding:NSUTF8StringEncoding];
+    [data writeToURL:self.fileURL atomically:NO];
+    return data;
+}
+
+- (NSArray*)parseAndCacheData:(NSData*)data {
+    NSArray *tasks = [TTMTaskLoader tasksFromData:data
+                                        lineIndex:[[TTMLineIndex alloc] initWithData:data]
+                                      firstTaskId:0
+                                      symbolTable:[[TTMSymbolTable alloc] init]];
+    [self.parseCache storeEntry:[self.parseCache entryForTasks:tasks fileData:data]
+                     forFileURL:self.fileURL];
+    [self.parseCache waitForPendingWrites];
+    return tasks;
+}
+
+- (NSArray*)cachedTasksFromData:(NSData*)data symbolTable:(TTMSymbolTable*)symbolTable {
+    return [self.parseCache tasksFromData:data
+                                lineIndex:[[TTMLineIndex alloc] initWithData:data]
+                                  fileURL:self.fileURL
+                              firstTaskId:0
+                              symbolTable:symbolTable];
+}
+
+- (void)testCachedTasks_ShouldMatchParsedTasks {
+    NSData *data = [self writeFileWithContents:
+                    @"(A) 2016-01-02 call mom +Family @Phone due:2016-02-03\r\n"
+                    @"\n"
+                    @"x 2016-01-05 2016-01-01 file taxes +Finance +Home @Computer\n"
+                    @"water the plants @Home rec:+1w t:2016-03-01 h:1\n"
+                    @"réserver le café +Réunion @Bureau due:2016-04-01"];
+    NSArray *parsedTasks = [self parseAndCacheData:data];
+    TTMSymbolTable *symbolTable = [[TTMSymbolTable alloc] init];
+    [symbolTable internSymbol:@"+Unrelated"];
+    NSArray *cachedTasks = [self cachedTasksFromData:data symbolTable:symbolTable];
+    
+    XCTAssertEqual(cachedTasks.count, 4);
+    XCTAssertEqual(cachedTasks.count, parsedTasks.count);
+    for (NSUInteger i = 0; i < parsedTasks.count; i++) {
+        TTMTask *parsedTask = parsedTasks[i];
+        TTMTask *cachedTask = cachedTasks[i];
+        XCTAssertEqualObjects(cachedTask.rawText, parsedTask.rawText);
+        XCTAssertEqual(cachedTask.taskId, parsedTask.taskId);
+        XCTAssertEqual(cachedTask.isCompleted, parsedTask.isCompleted);
+        XCTAssertEqual(cachedTask.priority, parsedTask.priority);
+        XCTAssertEqualObjects(cachedTask.completionDateText, parsedTask.completionDateText);
+        XCTAssertEqualObjects(cachedTask.creationDateText, parsedTask.creationDateText);
+        XCTAssertEqual(cachedTask.creationDay, parsedTask.creationDay);
+        XCTAssertEqualObjects(cachedTask.dueDateText, parsedTask.dueDateText);
+        XCTAssertEqual(cachedTask.dueDay, parsedTask.dueDay);
+        XCTAssertEqual(cachedTask.dueState, parsedTask.dueState);
+        XCTAssertEqualObjects(cachedTask.thresholdDateText, parsedTask.thresholdDateText);
+        XCTAssertEqual(cachedTask.thresholdDay, parsedTask.thresholdDay);
+        XCTAssertEqualObjects(cachedTask.projectsArray, parsedTask.projectsArray);
+        XCTAssertEqualObjects(cachedTask.projects, parsedTask.projects);
+        XCTAssertEqualObjects(cachedTask.contextsArray, parsedTask.contextsArray);
+        XCTAssertEqualObjects(cachedTask.contexts, parsedTask.contexts);
+        XCTAssertEqual(cachedTask.isRecurring, parsedTask.isRecurring);
+        XCTAssertEqualObjects(cachedTask.recurrencePattern, parsedTask.recurrencePattern);
+        XCTAssertEqual(cachedTask.isHidden, parsedTask.isHidden);
+        XCTAssertEqual(cachedTask.symbolTable, symbolTable);
+    }
+    XCTAssertEqual([cachedTasks[1] projectIDs][0], [symbolTable internSymbol:@"+Finance"]);
+}
+
+- (void)testCachedTasks_WhenNoEntry_ShouldReturnNil {
+    NSData *data = [self writeFileWithContents:@"call mom\n"];
+    XCTAssertNil([self cachedTasksFromData:data symbolTable:[[TTMSymbolTable alloc] init]]);
+}
+
+- (void)testCachedTasks_WhenContentChangesButSizeAndDateDoNot_ShouldReturnNil {
+    NSData *data = [self writeFileWithContents:@"call mom +Family\n"];
+    [self parseAndCacheData:data];
+    NSDate *modificationDate = [[[NSFileManager defaultManager]
+                                 attributesOfItemAtPath:[self.fileURL path] error:nil]
+                                fileModificationDate];
+    NSData *changedData = [self writeFileWithContents:@"call dad +Family\n"];
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: modificationDate}
+                                     ofItemAtPath:[self.fileURL path]
+                                            error:nil];
+    XCTAssertNil([self cachedTasksFromData:changedData symbolTable:[[TTMSymbolTable alloc] init]]);
+}
+
+- (void)testCachedTasks_WhenModificationDateChanges_ShouldReturnNil {
+    NSData *data = [self writeFileWithContents:@"call mom +Family\n"];
+    [self parseAndCacheData:data];
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: [NSDate dateWithTimeIntervalSinceNow:60]}
+                                     ofItemAtPath:[self.fileURL path]
+                                            error:nil];
+    XCTAssertNil([self cachedTasksFromData:data symbolTable:[[TTMSymbolTable alloc] init]]);
+}
+
+- (void)testCachedTasks_WhenEntryIsTruncated_ShouldReturnNil {
+    NSData *data = [self writeFileWithContents:@"call mom +Family\nwater plants @Home\n"];
+    [self parseAndCacheData:data];
+    NSArray *entryURLs = [[NSFileManager defaultManager]
+                          contentsOfDirectoryAtURL:self.parseCache.directoryURL
+                          includingPropertiesForKeys:nil
+                          options:0
+                          error:nil];
+    XCTAssertEqual(entryURLs.count, 1);
+    NSData *entry = [NSData dataWithContentsOfURL:entryURLs[0]];
+    [[entry subdataWithRange:NSMakeRange(0, entry.length - 1)] writeToURL:entryURLs[0] atomically:YES];
+    XCTAssertNil([self cachedTasksFromData:data symbolTable:[[TTMSymbolTable alloc] init]]);
+}
+
+- (NSUInteger)entryCount {
+    return [[[NSFileManager defaultManager] contentsOfDirectoryAtURL:self.parseCache.directoryURL
+                                          includingPropertiesForKeys:nil
+                                                             options:0
+                                                               error:nil] count];
+}
+
+- (void)testStoreEntry_WhenOverByteLimit_ShouldEvictOlderEntries {
+    NSURL *firstFileURL = self.fileURL;
+    NSData *firstData = [self writeFileWithContents:@"call mom +Family\n"];
+    [self parseAndCacheData:firstData];
+    XCTAssertEqual([self entryCount], 1);
+    
+    // Leave room for the first entry, but not for a second.
+    NSNumber *entrySize = nil;
+    NSURL *entryURL = [[[NSFileManager defaultManager]
+                        contentsOfDirectoryAtURL:self.parseCache.directoryURL
+                        includingPropertiesForKeys:@[NSURLFileSizeKey]
+                        options:0
+                        error:nil] firstObject];
+    [entryURL getResourceValue:&entrySize forKey:NSURLFileSizeKey error:nil];
+    self.parseCache.byteLimit = [entrySize unsignedLongLongValue];
+    
+    self.fileURL = [self.directoryURL URLByAppendingPathComponent:@"done.txt"];
+    NSData *secondData = [self writeFileWithContents:@"x 2016-01-02 water plants @Home\n"];
+    [self parseAndCacheData:secondData];
+    XCTAssertEqual([self entryCount], 1);
+    XCTAssertNotNil([self cachedTasksFromData:secondData symbolTable:[[TTMSymbolTable alloc] init]]);
+    
+    self.fileURL = firstFileURL;
+    XCTAssertNil([self cachedTasksFromData:firstData symbolTable:[[TTMSymbolTable alloc] init]]);
+}
+
+- (void)testStoreEntry_WhenUnderByteLimit_ShouldKeepEveryEntry {
+    [self parseAndCacheData:[self writeFileWithContents:@"call mom +Family\n"]];
+    self.fileURL = [self.directoryURL URLByAppendingPathComponent:@"done.txt"];
+    [self parseAndCacheData:[self writeFileWithContents:@"x 2016-01-02 water plants @Home\n"]];
+    XCTAssertEqual([self entryCount], 2);
+}
+
+- (void)testStoreEntry_WhenTasksChangeAfterEntryIsMade_ShouldCacheTheSavedTasks {
+    NSData *data = [self writeFileWithContents:@"call mom +Family @Phone\n"];
+    NSArray *tasks = [TTMTaskLoader tasksFromData:data
+                                        lineIndex:[[TTMLineIndex alloc] initWithData:data]
+                                      firstTaskId:0
+                                      symbolTable:[[TTMSymbolTable alloc] init]];
+    TTMParseCacheEntry *entry = [self.parseCache entryForTasks:tasks fileData:data];
+    [tasks[0] setRawText:@"call dad +Work"];
+    [self.parseCache storeEntry:entry forFileURL:self.fileURL];
+    [self.parseCache waitForPendingWrites];
+    
+    TTMTask *cachedTask = [[self cachedTasksFromData:data
+                                         symbolTable:[[TTMSymbolTable alloc] init]] firstObject];
+    XCTAssertEqualObjects(cachedTask.rawText, @"call mom +Family @Phone");
+    XCTAssertEqualObjects(cachedTask.projectsArray, @[@"+Family"]);
+    XCTAssertEqualObjects(cachedTask.contextsArray, @[@"@Phone"]);
+}
+
+- (void)testEntryForTasks_WhenTasksAreNil_ShouldReturnNil {
+    XCTAssertNil([self.parseCache entryForTasks:nil fileData:[NSData data]]);
+}
+
+@end
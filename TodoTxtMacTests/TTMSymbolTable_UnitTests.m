@@ -0,0 +1,154 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMSymbolTable.h"
+#import "TTMTask.h"
+#import "TTMTasklistMetadata.h"
+
+@interface TTMSymbolTable_UnitTests : XCTestCase
+
+@property TTMSymbolTable *symbolTable;
+
+@end
+
+@implementation TTMSymbolTable_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.symbolTable = [[TTMSymbolTable alloc] init];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)testInternSymbol_ShouldAssignSequentialIDs {
+    XCTAssertEqual([self.symbolTable internSymbol:@"+Chores"], 0);
+    XCTAssertEqual([self.symbolTable internSymbol:@"@Home"], 1);
+    XCTAssertEqual([self.symbolTable internSymbol:@"+Chores"], 0);
+    XCTAssertEqual([self.symbolTable count], 2);
+}
+
+- (void)testInternSymbol_ShouldBeCaseSensitive {
+    TTMSymbolID lower = [self.symbolTable internSymbol:@"+chores"];
+    TTMSymbolID upper = [self.symbolTable internSymbol:@"+Chores"];
+    XCTAssertNotEqual(lower, upper);
+}
+
+- (void)testSymbolForID_ShouldReturnTheSameInstance {
+    NSMutableString *symbol = [NSMutableString stringWithString:@"+Chores"];
+    TTMSymbolID symbolID = [self.symbolTable internSymbol:symbol];
+    [symbol appendString:@"Changed"];
+    XCTAssertEqualObjects([self.symbolTable symbolForID:symbolID], @"+Chores");
+    XCTAssertEqual([self.symbolTable symbolForID:symbolID],
+                   [self.symbolTable symbolForID:symbolID]);
+}
+
+- (void)testInternString_ShouldReturnSharedInstance {
+    NSString *first = [self.symbolTable internString:[@"+A, " stringByAppendingString:@"+B"]];
+    NSString *second = [self.symbolTable internString:[@"+A, +" stringByAppendingString:@"B"]];
+    XCTAssertEqual(first, second);
+    XCTAssertEqual([self.symbolTable count], 0);
+}
+
+- (void)testTasks_WithSameProjects_ShouldShareIDsAndStrings {
+    TTMTask *first = [[TTMTask alloc] initWithRawText:@"call mom +Family @Phone" withTaskId:0];
+    TTMTask *second = [[TTMTask alloc] initWithRawText:@"visit mom @Car +Family" withTaskId:1];
+    first.symbolTable = self.symbolTable;
+    second.symbolTable = self.symbolTable;
+    XCTAssertEqual(first.projectIDCount, 1);
+    XCTAssertEqual(second.projectIDCount, 1);
+    XCTAssertEqual(first.projectIDs[0], second.projectIDs[0]);
+    XCTAssertEqual(first.projects, second.projects);
+    XCTAssertNotEqual(first.contextIDs[0], second.contextIDs[0]);
+    XCTAssertEqualObjects(first.projectsArray, @[@"+Family"]);
+    XCTAssertEqualObjects(second.contextsArray, @[@"@Car"]);
+}
+
+- (void)testTask_WhenSymbolTableChanges_ShouldReinternSymbols {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +Family @Phone" withTaskId:0];
+    [self.symbolTable internSymbol:@"+Other"];
+    XCTAssertEqualObjects(task.projectsArray, @[@"+Family"]);
+    task.symbolTable = self.symbolTable;
+    XCTAssertEqual(task.projectIDs[0], [self.symbolTable internSymbol:@"+Family"]);
+    XCTAssertEqualObjects(task.projectsArray, @[@"+Family"]);
+}
+
+- (void)testTaskCopy_ShouldKeepSymbolTable {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +Family" withTaskId:0];
+    task.symbolTable = self.symbolTable;
+    TTMTask *copy = [task copy];
+    XCTAssertEqual(copy.symbolTable, self.symbolTable);
+}
+
+- (void)testMetadata_WhenTasksUseDifferentSymbolTables_ShouldCountByString {
+    TTMTask *first = [[TTMTask alloc] initWithRawText:@"(A) call mom +Family @Phone" withTaskId:0];
+    TTMTask *second = [[TTMTask alloc] initWithRawText:@"(B) visit mom +Family @Car" withTaskId:1];
+    TTMTask *third = [[TTMTask alloc] initWithRawText:@"(A) write mom +Family +Letters" withTaskId:2];
+    first.symbolTable = self.symbolTable;
+    third.symbolTable = [[TTMSymbolTable alloc] init];
+    TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+    [metadata updateMetadataFromTaskArray:@[first, second, third]];
+    XCTAssertEqualObjects(metadata.projectsArray, (@[@"+Family", @"+Letters"]));
+    XCTAssertEqualObjects(metadata.contextsArray, (@[@"@Car", @"@Phone"]));
+    XCTAssertEqualObjects(metadata.projectTaskCounts[@"+Family"], @3);
+    XCTAssertEqualObjects(metadata.projectTaskCounts[@"+Letters"], @1);
+    XCTAssertEqualObjects(metadata.priorityTaskCounts[@"A"], @2);
+    XCTAssertEqualObjects(metadata.priorityTaskCounts[@"B"], @1);
+    XCTAssertEqual(metadata.prioritiesCount, 2);
+}
+
+- (void)testMetadata_WhenTaskArrayIsEmpty_ShouldBeEmpty {
+    TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+    [metadata updateMetadataFromTaskArray:@[]];
+    XCTAssertEqual(metadata.allTaskCount, 0);
+    XCTAssertEqual(metadata.projectsCount, 0);
+    XCTAssertEqualObjects(metadata.projectsArray, @[]);
+}
+
+@end
@@ -0,0 +1,116 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTableViewDelegate.h"
+#import "TTMDisplayTextCache.h"
+#import "TTMLatencyHistogram.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger TaskCount = 10000;
+static const NSUInteger VisibleRowCount = 50;
+static const NSUInteger RowsScrolledPerFrame = 5;
+
+@interface TTMTableViewDelegate_PerformanceTests : XCTestCase
+
+@property NSArray *tasks;
+@property NSFont *font;
+
+@end
+
+@implementation TTMTableViewDelegate_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    self.tasks = [TTMTestTasks tasksWithCount:TaskCount
+                                    templates:[TTMTestTasks manyProjectsTemplates]];
+    self.font = [NSFont systemFontOfSize:13];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)scrollWithDelegate:(TTMTableViewDelegate*)delegate description:(NSString*)description {
+    // Scroll a window of rows down a stretch of the list and back up, drawing every visible
+    // row each frame, as the table view does.
+    NSUInteger lastFirstRow = 2000;
+    TTMLatencyHistogram *frameTimes = [[TTMLatencyHistogram alloc] init];
+    NSMutableArray *firstRows = [NSMutableArray array];
+    for (NSUInteger firstRow = 0; firstRow <= lastFirstRow; firstRow += RowsScrolledPerFrame) {
+        [firstRows addObject:@(firstRow)];
+    }
+    [firstRows addObjectsFromArray:[[firstRows reverseObjectEnumerator] allObjects]];
+    for (NSNumber *firstRow in firstRows) {
+        NSDate *frameStart = [NSDate date];
+        for (NSUInteger row = firstRow.unsignedIntegerValue;
+             row < firstRow.unsignedIntegerValue + VisibleRowCount; row++) {
+            [delegate displayTextOfTask:self.tasks[row] selected:(row == 10) font:self.font];
+        }
+        [frameTimes recordLatency:-[frameStart timeIntervalSinceNow]];
+    }
+    NSLog(@"Scrolled %lu frames of %lu rows %@: %@", (unsigned long)frameTimes.count,
+          (unsigned long)VisibleRowCount, description, frameTimes);
+}
+
+- (void)test_Performance_ScrollWithDisplayTextCache {
+    TTMTableViewDelegate *delegate = [[TTMTableViewDelegate alloc] init];
+    [self measureBlock:^{
+        [self scrollWithDelegate:delegate description:@"with the display text cache"];
+    }];
+}
+
+- (void)test_Performance_ScrollWithoutDisplayTextCache {
+    TTMTableViewDelegate *delegate = [[TTMTableViewDelegate alloc] init];
+    delegate.displayTextCache.byteLimit = 0;
+    [self measureBlock:^{
+        [self scrollWithDelegate:delegate description:@"without the display text cache"];
+    }];
+}
+
+@end
@@ -0,0 +1,99 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskArrayController.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger TaskCount = 100000;
+
+@interface TTMTaskArrayController_PerformanceTests : XCTestCase
+
+@property TTMTaskArrayController *arrayController;
+@property NSArray *tasks;
+
+@end
+
+@implementation TTMTaskArrayController_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    NSArray *tasks = [TTMTestTasks tasksWithCount:TaskCount];
+    self.tasks = tasks;
+    self.arrayController = [[TTMTaskArrayController alloc] initWithContent:tasks];
+    self.arrayController.sortType = TTMSortProject;
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)test_Performance_RearrangeOneChangedTask {
+    TTMTask *task = self.tasks[TaskCount / 2];
+    __block unichar priority = 'A';
+    [self measureBlock:^{
+        [task setPriority:priority];
+        priority = (priority == 'Z') ? 'A' : priority + 1;
+        NSDate *start = [NSDate date];
+        [self.arrayController rearrangeChangedTasks:@[task]];
+        NSLog(@"Rearranged one changed task of %lu in %.1f ms", (unsigned long)TaskCount,
+              -[start timeIntervalSinceNow] * 1000);
+    }];
+}
+
+- (void)test_Performance_RearrangeAllTasks {
+    TTMTask *task = self.tasks[TaskCount / 2];
+    __block unichar priority = 'A';
+    [self measureBlock:^{
+        [task setPriority:priority];
+        priority = (priority == 'Z') ? 'A' : priority + 1;
+        [self.arrayController rearrangeObjects];
+    }];
+}
+
+@end
@@ -0,0 +1,218 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskArrayController.h"
+#import "TTMTaskIndex.h"
+
+@interface TTMTaskArrayController_UnitTests : XCTestCase
+
+@property NSMutableArray *tasks;
+@property TTMTaskArrayController *arrayController;
+
+@end
+
+@implementation TTMTaskArrayController_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    NSArray *rawTexts = @[@"(B) call mom +Family due:2016-02-01",
+                          @"(A) file taxes +Finance",
+                          @"x 2016-01-05 renew passport +Travel",
+                          @"water the plants @Home",
+                          @"(C) pay rent +Finance due:2016-02-01",
+                          @"read a book +Reading"];
+    self.tasks = [NSMutableArray array];
+    [rawTexts enumerateObjectsUsingBlock:^(NSString *rawText, NSUInteger i, BOOL *stop) {
+        [self.tasks addObject:[[TTMTask alloc] initWithRawText:rawText withTaskId:i]];
+    }];
+    self.arrayController = [[TTMTaskArrayController alloc] initWithContent:self.tasks];
+    self.arrayController.sortType = TTMSortPriority;
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSArray*)fullyArrangedTasks {
+    TTMTaskArrayController *arrayController =
+        [[TTMTaskArrayController alloc] initWithContent:self.tasks];
+    arrayController.filterPredicate = self.arrayController.filterPredicate;
+    arrayController.sortType = self.arrayController.sortType;
+    return arrayController.arrangedObjects;
+}
+
+- (void)testSortTypeArrangesTasks {
+    NSArray *arranged = self.arrayController.arrangedObjects;
+    XCTAssertEqualObjects([arranged valueForKey:@"taskId"], (@[@1, @0, @4, @3, @5, @2]));
+}
+
+- (void)testChangedTaskMovesToItsNewRow {
+    TTMTask *task = self.tasks[5];
+    [task setPriority:'A'];
+    NSIndexSet *changedRows = [self.arrayController rearrangeChangedTasks:@[task]];
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks]);
+    // The task moved from row 4 to row 1; rows 1 to 4 changed.
+    XCTAssertEqualObjects(changedRows, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 4)]);
+}
+
+- (void)testUnmovedTaskChangesOneRow {
+    TTMTask *task = self.tasks[3];
+    [task appendText:@"today"];
+    NSIndexSet *changedRows = [self.arrayController rearrangeChangedTasks:@[task]];
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks]);
+    XCTAssertEqualObjects(changedRows, [NSIndexSet indexSetWithIndex:3]);
+}
+
+- (void)testSeveralChangedTasks {
+    for (TTMTaskListSortType sortType = TTMSortOrderInFile; sortType <= TTMSortAlphabetical;
+         sortType++) {
+        self.arrayController.sortType = sortType;
+        TTMTask *task1 = self.tasks[0];
+        TTMTask *task2 = self.tasks[4];
+        task1.rawText = [NSString stringWithFormat:@"(D) zzz +Zoo @Zoo %lu", (unsigned long)sortType];
+        task2.rawText = [NSString stringWithFormat:@"2016-01-01 aaa +Apple due:2015-01-01 %lu",
+                         (unsigned long)sortType];
+        [self.arrayController rearrangeChangedTasks:@[task1, task2]];
+        XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks],
+                              @"sort type %lu", (unsigned long)sortType);
+    }
+}
+
+- (void)testChangedTasksAreFiltered {
+    self.arrayController.filterPredicate = [NSPredicate predicateWithFormat:@"isCompleted == NO"];
+    TTMTask *completedTask = self.tasks[0];
+    TTMTask *reopenedTask = self.tasks[2];
+    [completedTask markComplete];
+    [reopenedTask markIncomplete];
+    [self.arrayController rearrangeChangedTasks:@[completedTask, reopenedTask]];
+    NSArray *arranged = self.arrayController.arrangedObjects;
+    XCTAssertFalse([arranged containsObject:completedTask]);
+    XCTAssertTrue([arranged containsObject:reopenedTask]);
+    XCTAssertEqualObjects(arranged, [self fullyArrangedTasks]);
+}
+
+- (void)testSearchRefinementWithTaskIndex {
+    TTMTaskIndex *taskIndex = [[TTMTaskIndex alloc] init];
+    [taskIndex addTasks:self.tasks];
+    self.arrayController.taskIndex = taskIndex;
+    
+    // Type a search one character at a time, then delete back to the start.
+    NSPredicate *preset = [NSPredicate predicateWithFormat:@"isCompleted == NO"];
+    NSArray *queries = @[@"p", @"pa", @"pay", @"pa", @"p", @"pl", @"pla", @"p"];
+    for (NSString *query in queries) {
+        NSPredicate *search = [NSPredicate predicateWithFormat:@"rawText CONTAINS[cd] %@", query];
+        self.arrayController.filterPredicate = [NSCompoundPredicate
+                                                andPredicateWithSubpredicates:@[preset, search]];
+        XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks],
+                              @"%@", query);
+    }
+    
+    // An edit drops the results the edited task was filtered into.
+    TTMTask *task = self.tasks[1];
+    task.rawText = @"(A) file taxes on paper +Finance";
+    [self.arrayController rearrangeObjects];
+    XCTAssertTrue([self.arrayController.arrangedObjects containsObject:task]);
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks]);
+    
+    // So do added tasks.
+    TTMTask *newTask = [[TTMTask alloc] initWithRawText:@"pack for the trip" withTaskId:6];
+    [self.tasks addObject:newTask];
+    [taskIndex addTasks:@[newTask]];
+    [self.arrayController rearrangeObjects];
+    XCTAssertTrue([self.arrayController.arrangedObjects containsObject:newTask]);
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks]);
+}
+
+- (void)waitForBackgroundArrangement {
+    [self expectationForNotification:TTMTaskArrayControllerDidArrangeInBackgroundNotification
+                              object:self.arrayController
+                             handler:nil];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testBackgroundArrangementIsSwappedIn {
+    self.arrayController.arrangesInBackground = YES;
+    NSArray *oldArrangement = self.arrayController.arrangedObjects;
+    self.arrayController.filterPredicate = [NSPredicate predicateWithFormat:@"isCompleted == NO"];
+    // The old arrangement is shown until the new one is ready.
+    XCTAssertTrue(self.arrayController.isArrangingInBackground);
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, oldArrangement);
+    [self waitForBackgroundArrangement];
+    XCTAssertFalse(self.arrayController.isArrangingInBackground);
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks]);
+}
+
+- (void)testNewFilterCancelsBackgroundArrangement {
+    TTMTaskIndex *taskIndex = [[TTMTaskIndex alloc] init];
+    [taskIndex addTasks:self.tasks];
+    self.arrayController.taskIndex = taskIndex;
+    self.arrayController.arrangesInBackground = YES;
+    for (NSString *query in @[@"p", @"pa", @"pay"]) {
+        self.arrayController.filterPredicate =
+            [NSPredicate predicateWithFormat:@"rawText CONTAINS[cd] %@", query];
+    }
+    [self waitForBackgroundArrangement];
+    XCTAssertEqualObjects([self.arrayController.arrangedObjects valueForKey:@"taskId"], (@[@4]));
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks]);
+}
+
+- (void)testTasksEditedWhileArrangingInBackground {
+    TTMTaskIndex *taskIndex = [[TTMTaskIndex alloc] init];
+    [taskIndex addTasks:self.tasks];
+    self.arrayController.taskIndex = taskIndex;
+    self.arrayController.arrangesInBackground = YES;
+    self.arrayController.filterPredicate = [NSPredicate predicateWithFormat:@"isCompleted == NO"];
+    TTMTask *task = self.tasks[0];
+    [task markComplete];
+    [self waitForBackgroundArrangement];
+    XCTAssertFalse([self.arrayController.arrangedObjects containsObject:task]);
+    XCTAssertEqualObjects(self.arrayController.arrangedObjects, [self fullyArrangedTasks]);
+}
+
+@end
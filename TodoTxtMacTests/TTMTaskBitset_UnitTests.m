@@ -0,0 +1,187 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTaskBitset.h"
+
+@interface TTMTaskBitset_UnitTests : XCTestCase
+
+@end
+
+@implementation TTMTaskBitset_UnitTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+#pragma mark - Helper Methods
+
+- (NSIndexSet*)indexSetOfBitset:(TTMTaskBitset*)bitset {
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    [bitset enumerateIndexesUsingBlock:^(uint32_t index, BOOL *stop) {
+        [indexes addIndex:index];
+    }];
+    return indexes;
+}
+
+- (void)fillBitset:(TTMTaskBitset*)bitset
+          indexSet:(NSMutableIndexSet*)indexes
+             count:(NSUInteger)count
+            stride:(uint32_t)stride
+             start:(uint32_t)start {
+    for (NSUInteger i = 0; i < count; i++) {
+        uint32_t index = start + (uint32_t)i * stride;
+        [bitset addIndex:index];
+        [indexes addIndex:index];
+    }
+}
+
+#pragma mark - Membership Tests
+
+- (void)testAddRemoveContains {
+    TTMTaskBitset *bitset = [[TTMTaskBitset alloc] init];
+    XCTAssertEqual(bitset.count, 0);
+    [bitset addIndex:5];
+    [bitset addIndex:5];
+    [bitset addIndex:70000];
+    XCTAssertEqual(bitset.count, 2);
+    XCTAssertTrue([bitset containsIndex:5]);
+    XCTAssertTrue([bitset containsIndex:70000]);
+    XCTAssertFalse([bitset containsIndex:6]);
+    [bitset removeIndex:5];
+    [bitset removeIndex:5];
+    XCTAssertFalse([bitset containsIndex:5]);
+    XCTAssertEqual(bitset.count, 1);
+}
+
+- (void)testDenseContainers {
+    // More than 4096 indexes in one 65536-wide block are stored as a bitmap.
+    TTMTaskBitset *bitset = [[TTMTaskBitset alloc] init];
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    [self fillBitset:bitset indexSet:indexes count:10000 stride:3 start:1];
+    XCTAssertEqual(bitset.count, indexes.count);
+    XCTAssertEqualObjects([self indexSetOfBitset:bitset], indexes);
+    
+    // Removing indexes turns it back into an array.
+    for (uint32_t index = 1; index < 30000; index += 6) {
+        [bitset removeIndex:index];
+        [indexes removeIndex:index];
+    }
+    XCTAssertEqual(bitset.count, indexes.count);
+    XCTAssertEqualObjects([self indexSetOfBitset:bitset], indexes);
+}
+
+- (void)testCopyIsIndependent {
+    TTMTaskBitset *bitset = [[TTMTaskBitset alloc] init];
+    [bitset addIndex:1];
+    TTMTaskBitset *copy = [bitset copy];
+    [copy addIndex:2];
+    XCTAssertEqual(bitset.count, 1);
+    XCTAssertEqual(copy.count, 2);
+}
+
+#pragma mark - Set Operation Tests
+
+- (void)testSetOperationsAgreeWithIndexSets {
+    NSArray *shapes = @[@[@100, @7, @0], @[@6000, @2, @1], @[@20000, @5, @60000], @[@0, @1, @0]];
+    for (NSArray *shape1 in shapes) {
+        for (NSArray *shape2 in shapes) {
+            TTMTaskBitset *bitset1 = [[TTMTaskBitset alloc] init];
+            TTMTaskBitset *bitset2 = [[TTMTaskBitset alloc] init];
+            NSMutableIndexSet *indexes1 = [NSMutableIndexSet indexSet];
+            NSMutableIndexSet *indexes2 = [NSMutableIndexSet indexSet];
+            [self fillBitset:bitset1 indexSet:indexes1 count:[shape1[0] unsignedIntegerValue]
+                      stride:[shape1[1] unsignedIntValue] start:[shape1[2] unsignedIntValue]];
+            [self fillBitset:bitset2 indexSet:indexes2 count:[shape2[0] unsignedIntegerValue]
+                      stride:[shape2[1] unsignedIntValue] start:[shape2[2] unsignedIntValue]];
+            
+            NSMutableIndexSet *expectedUnion = [indexes1 mutableCopy];
+            [expectedUnion addIndexes:indexes2];
+            NSMutableIndexSet *expectedDifference = [indexes1 mutableCopy];
+            [expectedDifference removeIndexes:indexes2];
+            NSIndexSet *expectedIntersection = [indexes1 indexesPassingTest:
+                                                ^BOOL(NSUInteger index, BOOL *stop) {
+                return [indexes2 containsIndex:index];
+            }];
+            
+            TTMTaskBitset *unionSet = [bitset1 copy];
+            [unionSet unionWithBitset:bitset2];
+            XCTAssertEqualObjects([self indexSetOfBitset:unionSet], expectedUnion);
+            XCTAssertEqual(unionSet.count, expectedUnion.count);
+            
+            TTMTaskBitset *intersection = [bitset1 copy];
+            [intersection intersectWithBitset:bitset2];
+            XCTAssertEqualObjects([self indexSetOfBitset:intersection], expectedIntersection);
+            XCTAssertEqual(intersection.count, expectedIntersection.count);
+            XCTAssertEqual([bitset1 countOfIntersectionWithBitset:bitset2],
+                           expectedIntersection.count);
+            
+            TTMTaskBitset *difference = [bitset1 copy];
+            [difference subtractBitset:bitset2];
+            XCTAssertEqualObjects([self indexSetOfBitset:difference], expectedDifference);
+            XCTAssertEqual(difference.count, expectedDifference.count);
+        }
+    }
+}
+
+- (void)testOperationsWithSelf {
+    TTMTaskBitset *bitset = [[TTMTaskBitset alloc] init];
+    [bitset addIndex:3];
+    [bitset addIndex:100000];
+    [bitset unionWithBitset:bitset];
+    XCTAssertEqual(bitset.count, 2);
+    [bitset intersectWithBitset:bitset];
+    XCTAssertEqual(bitset.count, 2);
+    [bitset subtractBitset:bitset];
+    XCTAssertEqual(bitset.count, 0);
+}
+
+@end
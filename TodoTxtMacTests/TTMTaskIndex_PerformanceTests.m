@@ -0,0 +1,168 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskIndex.h"
+#import "TTMCompiledPredicate.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger TaskCount = 100000;
+
+@interface TTMTaskIndex_PerformanceTests : XCTestCase
+
+@property NSArray *tasks;
+@property TTMTaskIndex *taskIndex;
+@property NSPredicate *predicate;
+
+@end
+
+@implementation TTMTaskIndex_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    NSArray *tasks = [TTMTestTasks tasksWithCount:TaskCount
+                                        templates:[TTMTestTasks manyProjectsTemplates]];
+    self.tasks = tasks;
+    self.taskIndex = [[TTMTaskIndex alloc] init];
+    [self.taskIndex addTasks:tasks];
+    
+    // What the Project and Context row templates build.
+    self.predicate = [NSPredicate predicateWithFormat:
+                      @"(projects CONTAINS[cd] 'family' OR projects CONTAINS[cd] 'reading') "
+                      @"AND NOT contexts CONTAINS[cd] 'kindle'"];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)test_Performance_FilterWithTaskIndex {
+    // Index the tasks before measuring.
+    [self.taskIndex tasksWithToken:@"" ofKind:TTMTaskIndexProject];
+    [self measureBlock:^{
+        NSDate *start = [NSDate date];
+        TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc]
+                                                   initWithPredicate:self.predicate
+                                                   taskIndex:self.taskIndex];
+        NSArray *filteredTasks = [compiledPredicate filteredTasks:self.tasks];
+        NSLog(@"Filtered %lu tasks to %lu with the task index in %.1f ms",
+              (unsigned long)TaskCount, (unsigned long)filteredTasks.count,
+              -[start timeIntervalSinceNow] * 1000);
+    }];
+}
+
+- (void)test_Performance_FilterWithoutTaskIndex {
+    [self measureBlock:^{
+        NSDate *start = [NSDate date];
+        TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc]
+                                                   initWithPredicate:self.predicate];
+        NSArray *filteredTasks = [compiledPredicate filteredTasks:self.tasks];
+        NSLog(@"Filtered %lu tasks to %lu by searching strings in %.1f ms",
+              (unsigned long)TaskCount, (unsigned long)filteredTasks.count,
+              -[start timeIntervalSinceNow] * 1000);
+    }];
+}
+
+- (void)typeSearchQuery:(NSString*)query withTaskIndex:(TTMTaskIndex*)taskIndex {
+    // The search field filters again as each character is typed, on top of the preset.
+    NSPredicate *preset = [NSPredicate predicateWithFormat:@"isCompleted == 0 AND isHidden == 0"];
+    NSTimeInterval slowestKeystroke = 0;
+    NSDate *start = [NSDate date];
+    for (NSUInteger length = 1; length <= query.length; length++) {
+        NSDate *keystrokeStart = [NSDate date];
+        NSPredicate *search = [NSPredicate predicateWithFormat:@"rawText contains[cd] %@",
+                               [query substringToIndex:length]];
+        NSPredicate *predicate = [NSCompoundPredicate andPredicateWithSubpredicates:
+                                  @[preset, search]];
+        TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc]
+                                                   initWithPredicate:predicate
+                                                   taskIndex:taskIndex];
+        [compiledPredicate filteredTasks:self.tasks];
+        slowestKeystroke = MAX(slowestKeystroke, -[keystrokeStart timeIntervalSinceNow]);
+    }
+    NSLog(@"Typed \"%@\" over %lu tasks %@ in %.1f ms, slowest keystroke %.1f ms",
+          query, (unsigned long)TaskCount,
+          (taskIndex != nil) ? @"with the task index" : @"without an index",
+          -[start timeIntervalSinceNow] * 1000, slowestKeystroke * 1000);
+}
+
+- (void)test_Performance_TypeSearchWithTaskIndex {
+    // Index the trigrams before measuring, as the first search in a document does.
+    [self.taskIndex candidateTasksWithTextContaining:@"mom"];
+    [self measureBlock:^{
+        [self typeSearchQuery:@"renew passport" withTaskIndex:self.taskIndex];
+        [self typeSearchQuery:@"chapter 12" withTaskIndex:self.taskIndex];
+    }];
+}
+
+- (void)test_Performance_TypeSearchWithoutTaskIndex {
+    [self measureBlock:^{
+        [self typeSearchQuery:@"renew passport" withTaskIndex:nil];
+        [self typeSearchQuery:@"chapter 12" withTaskIndex:nil];
+    }];
+}
+
+- (void)test_Performance_IndexTrigrams {
+    [self measureBlock:^{
+        TTMTaskIndex *taskIndex = [[TTMTaskIndex alloc] init];
+        [taskIndex addTasks:self.tasks];
+        [taskIndex candidateTasksWithTextContaining:@"mom"];
+    }];
+}
+
+- (void)test_Performance_CountProjectsWithTaskIndex {
+    [self.taskIndex tasksWithToken:@"" ofKind:TTMTaskIndexProject];
+    NSArray *someTasks = [self.tasks subarrayWithRange:NSMakeRange(0, TaskCount / 2)];
+    [self measureBlock:^{
+        TTMTaskBitset *tasks = [TTMTaskIndex bitsetOfTasks:someTasks];
+        [self.taskIndex taskCountsOfTokensOfKind:TTMTaskIndexProject inTasks:tasks];
+        [self.taskIndex taskCountsOfTokensOfKind:TTMTaskIndexContext inTasks:tasks];
+    }];
+}
+
+@end
@@ -0,0 +1,307 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskBitset.h"
+#import "TTMTaskIndex.h"
+#import "TTMCompiledPredicate.h"
+
+@interface TTMTaskIndex_UnitTests : XCTestCase
+
+@property NSMutableArray *tasks;
+@property TTMTaskIndex *taskIndex;
+
+@end
+
+@implementation TTMTaskIndex_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    NSArray *rawTexts = @[@"(B) call mom +Family @Phone due:2016-02-01",
+                          @"(A) file taxes +Finance @Computer t:2016-03-01",
+                          @"x 2016-01-05 renew passport +Travel @Errands",
+                          @"water the plants @Home rec:+1w",
+                          @"read a book +reading +Reading",
+                          @"Réad a böok +Réading",
+                          @"",
+                          @"plan trip +Travel +Family @Computer @Phone"];
+    self.tasks = [NSMutableArray array];
+    [rawTexts enumerateObjectsUsingBlock:^(NSString *rawText, NSUInteger i, BOOL *stop) {
+        [self.tasks addObject:[[TTMTask alloc] initWithRawText:rawText withTaskId:i]];
+    }];
+    self.taskIndex = [[TTMTaskIndex alloc] init];
+    [self.taskIndex addTasks:self.tasks];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+#pragma mark - Helper Methods
+
+- (TTMTaskBitset*)bitsetOfTasksAtIndexes:(NSArray*)indexes {
+    NSMutableArray *tasks = [NSMutableArray array];
+    for (NSNumber *index in indexes) {
+        [tasks addObject:self.tasks[index.unsignedIntegerValue]];
+    }
+    return [TTMTaskIndex bitsetOfTasks:tasks];
+}
+
+- (void)assertBitset:(TTMTaskBitset*)bitset equalsTasksAtIndexes:(NSArray*)indexes {
+    TTMTaskBitset *expected = [self bitsetOfTasksAtIndexes:indexes];
+    XCTAssertEqual(bitset.count, expected.count);
+    XCTAssertEqual([bitset countOfIntersectionWithBitset:expected], expected.count);
+}
+
+#pragma mark - Token Tests
+
+- (void)testTokensOfEachKind {
+    XCTAssertEqual(self.taskIndex.count, self.tasks.count);
+    [self assertBitset:[self.taskIndex tasksWithToken:@"+Family" ofKind:TTMTaskIndexProject]
+  equalsTasksAtIndexes:@[@0, @7]];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"@Phone" ofKind:TTMTaskIndexContext]
+  equalsTasksAtIndexes:@[@0, @7]];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"due:2016-02-01" ofKind:TTMTaskIndexTag]
+  equalsTasksAtIndexes:@[@0]];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"t" ofKind:TTMTaskIndexTagKey]
+  equalsTasksAtIndexes:@[@1]];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"+Missing" ofKind:TTMTaskIndexProject]
+  equalsTasksAtIndexes:@[]];
+    [self assertBitset:[self.taskIndex allTasks]
+  equalsTasksAtIndexes:@[@0, @1, @2, @3, @4, @5, @6, @7]];
+}
+
+- (void)testTokensContainingString {
+    [self assertBitset:[self.taskIndex tasksWithTokenOfKind:TTMTaskIndexProject
+                                                 containing:@"read"
+                                                    options:NSCaseInsensitiveSearch |
+                                                            NSDiacriticInsensitiveSearch]
+  equalsTasksAtIndexes:@[@4, @5]];
+    [self assertBitset:[self.taskIndex tasksWithTokenOfKind:TTMTaskIndexProject
+                                                 containing:@"read"
+                                                    options:0]
+  equalsTasksAtIndexes:@[@4]];
+    [self assertBitset:[self.taskIndex tasksWithTokenOfKind:TTMTaskIndexContext
+                                                 containing:@"COMP"
+                                                    options:NSCaseInsensitiveSearch]
+  equalsTasksAtIndexes:@[@1, @7]];
+}
+
+- (void)testReturnedBitsetsAreCopies {
+    TTMTaskBitset *tasks = [self.taskIndex tasksWithToken:@"+Travel" ofKind:TTMTaskIndexProject];
+    [tasks removeIndex:(uint32_t)[self.tasks[2] uniqueId]];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"+Travel" ofKind:TTMTaskIndexProject]
+  equalsTasksAtIndexes:@[@2, @7]];
+}
+
+- (void)testTaskCounts {
+    NSDictionary *counts = [self.taskIndex taskCountsOfTokensOfKind:TTMTaskIndexProject inTasks:nil];
+    XCTAssertEqualObjects(counts[@"+Family"], @2);
+    XCTAssertEqualObjects(counts[@"+Finance"], @1);
+    XCTAssertNil(counts[@"+Missing"]);
+    
+    TTMTaskBitset *someTasks = [self bitsetOfTasksAtIndexes:@[@0, @1]];
+    counts = [self.taskIndex taskCountsOfTokensOfKind:TTMTaskIndexProject inTasks:someTasks];
+    XCTAssertEqualObjects(counts, (@{@"+Family" : @1, @"+Finance" : @1}));
+}
+
+#pragma mark - Update Tests
+
+- (void)testEditedTasksAreReindexed {
+    TTMTask *task = self.tasks[3];
+    [task appendText:@"+Garden"];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"+Garden" ofKind:TTMTaskIndexProject]
+  equalsTasksAtIndexes:@[@3]];
+    
+    task.rawText = @"water the lawn";
+    [self assertBitset:[self.taskIndex tasksWithToken:@"+Garden" ofKind:TTMTaskIndexProject]
+  equalsTasksAtIndexes:@[]];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"@Home" ofKind:TTMTaskIndexContext]
+  equalsTasksAtIndexes:@[]];
+    [self assertBitset:[self.taskIndex tasksWithToken:@"rec" ofKind:TTMTaskIndexTagKey]
+  equalsTasksAtIndexes:@[]];
+}
+
+- (void)testRemoveTasks {
+    [self.taskIndex removeTasks:@[self.tasks[0]]];
+    XCTAssertEqual(self.taskIndex.count, self.tasks.count - 1);
+    [self assertBitset:[self.taskIndex tasksWithToken:@"+Family" ofKind:TTMTaskIndexProject]
+  equalsTasksAtIndexes:@[@7]];
+    XCTAssertFalse([[self.taskIndex allTasks] containsIndex:(uint32_t)[self.tasks[0] uniqueId]]);
+    
+    [self.taskIndex removeAllTasks];
+    XCTAssertEqual(self.taskIndex.count, 0);
+    XCTAssertEqual([self.taskIndex allTasks].count, 0);
+}
+
+- (void)testCopyReplacesTaskWithSameUniqueId {
+    // Undo puts copies of tasks back; the copy keeps the original's unique ID.
+    TTMTask *original = self.tasks[0];
+    TTMTask *copy = [original copy];
+    copy.rawText = @"call dad +Family";
+    [self.taskIndex addTasks:@[copy]];
+    XCTAssertEqual(self.taskIndex.count, self.tasks.count);
+    [self assertBitset:[self.taskIndex tasksWithToken:@"@Phone" ofKind:TTMTaskIndexContext]
+  equalsTasksAtIndexes:@[@7]];
+    
+    // Removing the replaced original leaves the copy in place.
+    [self.taskIndex removeTasks:@[original]];
+    XCTAssertEqual(self.taskIndex.count, self.tasks.count);
+    XCTAssertTrue([[self.taskIndex tasksWithToken:@"+Family" ofKind:TTMTaskIndexProject]
+                   containsIndex:(uint32_t)copy.uniqueId]);
+}
+
+#pragma mark - Text Search Tests
+
+- (void)testCandidateTasksWithTextContaining {
+    XCTAssertTrue([TTMTaskIndex canNarrowTextSearchForString:@"mom"]);
+    XCTAssertFalse([TTMTaskIndex canNarrowTextSearchForString:@"mo"]);
+    
+    // Candidates have every trigram, even where the string itself does not occur.
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"PASSPORT"]
+  equalsTasksAtIndexes:@[@2]];
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"böok"]
+  equalsTasksAtIndexes:@[@4, @5]];
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"zzz"]
+  equalsTasksAtIndexes:@[]];
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"a bo"]
+  equalsTasksAtIndexes:@[@4, @5]];
+}
+
+- (void)testTextSearchSeesEditedTasks {
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"lawn"]
+  equalsTasksAtIndexes:@[]];
+    
+    // Tasks are indexed, added and removed after the trigrams were first indexed.
+    [self.tasks[3] setRawText:@"water the lawn"];
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"mow the LAWN" withTaskId:8];
+    [self.taskIndex addTasks:@[task]];
+    [self.tasks addObject:task];
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"lawn"]
+  equalsTasksAtIndexes:@[@3, @8]];
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"plants"]
+  equalsTasksAtIndexes:@[]];
+    
+    [self.taskIndex removeTasks:@[task]];
+    [self assertBitset:[self.taskIndex candidateTasksWithTextContaining:@"lawn"]
+  equalsTasksAtIndexes:@[@3]];
+}
+
+#pragma mark - Compiled Predicate Tests
+
+- (void)testCompiledPredicateWithIndexAgreesWithPredicate {
+    NSArray *formats = @[@"projects CONTAINS[cd] 'family'",
+                         @"projects CONTAINS[cd] 'READING'",
+                         @"projects CONTAINS 'Read'",
+                         @"NOT contexts CONTAINS[cd] 'phone'",
+                         @"projects CONTAINS[cd] 'travel' AND contexts CONTAINS[cd] 'computer'",
+                         @"projects CONTAINS[cd] 'finance' OR contexts CONTAINS[cd] 'home'",
+                         @"projects CONTAINS[cd] 'family' AND rawText CONTAINS[cd] 'mom'",
+                         @"projects CONTAINS[cd] 'travel, +family'",
+                         @"rawText CONTAINS[cd] 'MOM'",
+                         @"rawText CONTAINS[cd] 'réad a'",
+                         @"rawText CONTAINS[cd] 'read a book'",
+                         @"rawText CONTAINS[cd] 'ca'",
+                         @"rawText CONTAINS[cd] 'no such text'",
+                         @"rawText BEGINSWITH[cd] 'x 2016'",
+                         @"rawText ENDSWITH[cd] '@phone'",
+                         @"NOT rawText CONTAINS[cd] 'book'",
+                         @"rawText CONTAINS[cd] 'plants' OR projects CONTAINS[cd] 'travel'",
+                         @"contexts CONTAINS[cd] 'phone' AND rawText CONTAINS[cd] 'trip'"];
+    for (NSString *format in formats) {
+        NSPredicate *predicate = [NSPredicate predicateWithFormat:format];
+        TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc]
+                                                   initWithPredicate:predicate
+                                                   taskIndex:self.taskIndex];
+        XCTAssertEqualObjects([compiledPredicate filteredTasks:self.tasks],
+                              [self.tasks filteredArrayUsingPredicate:predicate], @"%@", format);
+        for (TTMTask *task in self.tasks) {
+            XCTAssertEqual([compiledPredicate evaluateWithTask:task],
+                           [predicate evaluateWithObject:task], @"%@ on \"%@\"", format, task.rawText);
+        }
+    }
+}
+
+- (void)testCompiledPredicateUsesIndex {
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:
+                              @"NOT projects CONTAINS[cd] 'family' OR contexts CONTAINS[cd] 'phone'"];
+    XCTAssertTrue([[TTMCompiledPredicate alloc] initWithPredicate:predicate
+                                                       taskIndex:self.taskIndex].usesTaskIndex);
+    XCTAssertFalse([[TTMCompiledPredicate alloc] initWithPredicate:predicate].usesTaskIndex);
+    
+    // Strings with separators can span two tokens of the joined property.
+    predicate = [NSPredicate predicateWithFormat:@"projects CONTAINS[cd] 'travel, +family'"];
+    XCTAssertFalse([[TTMCompiledPredicate alloc] initWithPredicate:predicate
+                                                        taskIndex:self.taskIndex].usesTaskIndex);
+    predicate = [NSPredicate predicateWithFormat:@"rawText CONTAINS[cd] 'mo'"];
+    XCTAssertFalse([[TTMCompiledPredicate alloc] initWithPredicate:predicate
+                                                        taskIndex:self.taskIndex].usesTaskIndex);
+    predicate = [NSPredicate predicateWithFormat:@"rawText CONTAINS 'mom'"];
+    XCTAssertFalse([[TTMCompiledPredicate alloc] initWithPredicate:predicate
+                                                        taskIndex:self.taskIndex].usesTaskIndex);
+    predicate = [NSPredicate predicateWithFormat:@"rawText CONTAINS[cd] 'mom'"];
+    XCTAssertTrue([[TTMCompiledPredicate alloc] initWithPredicate:predicate
+                                                       taskIndex:self.taskIndex].usesTaskIndex);
+    
+    // The complement of candidates is not answered by the index.
+    predicate = [NSPredicate predicateWithFormat:@"NOT rawText CONTAINS[cd] 'mom'"];
+    XCTAssertFalse([[TTMCompiledPredicate alloc] initWithPredicate:predicate
+                                                        taskIndex:self.taskIndex].usesTaskIndex);
+}
+
+- (void)testCompiledPredicateSeesEditedTasks {
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"projects CONTAINS[cd] 'garden'"];
+    TTMCompiledPredicate *compiledPredicate = [[TTMCompiledPredicate alloc]
+                                               initWithPredicate:predicate
+                                               taskIndex:self.taskIndex];
+    XCTAssertEqual([compiledPredicate filteredTasks:self.tasks].count, 0);
+    [self.tasks[3] appendText:@"+Garden"];
+    XCTAssertEqualObjects([compiledPredicate filteredTasks:self.tasks], @[self.tasks[3]]);
+}
+
+@end
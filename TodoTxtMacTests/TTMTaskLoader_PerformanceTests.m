@@ -0,0 +1,130 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTaskLoader.h"
+#import "TTMSymbolTable.h"
+#import "TTMTestTasks.h"
+
+@interface TTMTaskLoader_PerformanceTests : XCTestCase
+
+@end
+
+@implementation TTMTaskLoader_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)measureLoadOfLineCount:(NSUInteger)lineCount workerCount:(NSUInteger)workerCount {
+    NSArray *lines = [TTMTestTasks rawTextsWithCount:lineCount];
+    [self measureBlock:^{
+        (void)[TTMTaskLoader tasksFromRawTextStrings:lines
+                                         firstTaskId:0
+                                         symbolTable:[[TTMSymbolTable alloc] init]
+                                         workerCount:workerCount];
+    }];
+}
+
+- (NSUInteger)allCores {
+    return [[NSProcessInfo processInfo] activeProcessorCount];
+}
+
+- (void)test_Performance_Load10kLines_OneCore {
+    [self measureLoadOfLineCount:10000 workerCount:1];
+}
+
+- (void)test_Performance_Load10kLines_AllCores {
+    [self measureLoadOfLineCount:10000 workerCount:[self allCores]];
+}
+
+- (void)test_Performance_Load100kLines_OneCore {
+    [self measureLoadOfLineCount:100000 workerCount:1];
+}
+
+- (void)test_Performance_Load100kLines_AllCores {
+    [self measureLoadOfLineCount:100000 workerCount:[self allCores]];
+}
+
+- (void)test_Performance_Load1MLines_OneCore {
+    [self measureLoadOfLineCount:1000000 workerCount:1];
+}
+
+- (void)test_Performance_Load1MLines_AllCores {
+    [self measureLoadOfLineCount:1000000 workerCount:[self allCores]];
+}
+
+- (void)test_Performance_LoadScalingByCoreCount {
+    // Logs load time for 1, 2, 4, ... cores so the speedup at each size can be compared.
+    for (NSNumber *lineCount in @[@10000, @100000, @1000000]) {
+        NSArray *lines = [TTMTestTasks rawTextsWithCount:[lineCount unsignedIntegerValue]];
+        NSTimeInterval oneCoreTime = 0;
+        for (NSUInteger workerCount = 1; ; workerCount = MIN(workerCount * 2, [self allCores])) {
+            NSDate *start = [NSDate date];
+            NSArray *tasks = [TTMTaskLoader tasksFromRawTextStrings:lines
+                                                        firstTaskId:0
+                                                        symbolTable:[[TTMSymbolTable alloc] init]
+                                                        workerCount:workerCount];
+            NSTimeInterval elapsed = -[start timeIntervalSinceNow];
+            if (workerCount == 1) {
+                oneCoreTime = elapsed;
+            }
+            NSLog(@"Load %@ lines on %lu cores: %.3f s (%.2fx)", lineCount,
+                  (unsigned long)workerCount, elapsed, oneCoreTime / elapsed);
+            XCTAssertEqual(tasks.count, [lineCount unsignedIntegerValue]);
+            if (workerCount == [self allCores]) {
+                break;
+            }
+        }
+    }
+}
+
+@end
@@ -0,0 +1,157 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTaskLoader.h"
+#import "TTMTask.h"
+#import "TTMSymbolTable.h"
+#import "TTMLineIndex.h"
+
+@interface TTMTaskLoader_UnitTests : XCTestCase
+
+@property NSArray *lines;
+
+@end
+
+@implementation TTMTaskLoader_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    NSMutableArray *lines = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 5000; i++) {
+        if (i % 7 == 3) {
+            [lines addObject:@""];
+        } else {
+            [lines addObject:[NSString stringWithFormat:
+                              @"(B) task %lu +Project%lu @Context%lu due:2016-02-%02lu",
+                              (unsigned long)i, (unsigned long)(i % 13),
+                              (unsigned long)(i % 5), (unsigned long)(i % 28 + 1)]];
+        }
+    }
+    self.lines = lines;
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)testTasksFromRawTextStrings_ShouldSkipBlankLinesAndNumberTasksInOrder {
+    NSArray *tasks = [TTMTaskLoader tasksFromRawTextStrings:@[@"first", @"", @"second", @"", @"third"]
+                                                firstTaskId:10
+                                                symbolTable:[[TTMSymbolTable alloc] init]];
+    XCTAssertEqual(tasks.count, 3);
+    XCTAssertEqualObjects([tasks[0] rawText], @"first");
+    XCTAssertEqualObjects([tasks[1] rawText], @"second");
+    XCTAssertEqualObjects([tasks[2] rawText], @"third");
+    XCTAssertEqual([tasks[0] taskId], 10);
+    XCTAssertEqual([tasks[1] taskId], 11);
+    XCTAssertEqual([tasks[2] taskId], 12);
+}
+
+- (void)testTasksFromRawTextStrings_WhenEmpty_ShouldReturnEmptyArray {
+    NSArray *tasks = [TTMTaskLoader tasksFromRawTextStrings:@[]
+                                                firstTaskId:0
+                                                symbolTable:[[TTMSymbolTable alloc] init]];
+    XCTAssertEqualObjects(tasks, @[]);
+}
+
+- (void)testTasksFromRawTextStrings_InParallel_ShouldMatchSerialLoad {
+    NSArray *serialTasks = [TTMTaskLoader tasksFromRawTextStrings:self.lines
+                                                      firstTaskId:0
+                                                      symbolTable:[[TTMSymbolTable alloc] init]
+                                                      workerCount:1];
+    TTMSymbolTable *symbolTable = [[TTMSymbolTable alloc] init];
+    NSArray *parallelTasks = [TTMTaskLoader tasksFromRawTextStrings:self.lines
+                                                        firstTaskId:0
+                                                        symbolTable:symbolTable
+                                                        workerCount:8];
+    XCTAssertEqual(parallelTasks.count, serialTasks.count);
+    for (NSUInteger i = 0; i < serialTasks.count; i++) {
+        TTMTask *serialTask = serialTasks[i];
+        TTMTask *parallelTask = parallelTasks[i];
+        XCTAssertEqual(parallelTask.taskId, i);
+        XCTAssertEqual(parallelTask.taskId, serialTask.taskId);
+        XCTAssertEqualObjects(parallelTask.rawText, serialTask.rawText);
+        XCTAssertEqualObjects(parallelTask.projectsArray, serialTask.projectsArray);
+        XCTAssertEqualObjects(parallelTask.contextsArray, serialTask.contextsArray);
+        XCTAssertEqual(parallelTask.dueDay, serialTask.dueDay);
+        XCTAssertEqual(parallelTask.symbolTable, symbolTable);
+    }
+    // 13 projects and 5 contexts, each interned once even though workers raced to add them.
+    XCTAssertEqual([symbolTable count], 18);
+}
+
+- (void)testTasksFromData_ShouldMatchTasksFromRawTextStrings {
+    NSString *fileContents = [[self.lines componentsJoinedByString:@"\r\n"]
+                              stringByAppendingString:@"\nlast line"];
+    NSData *data = [fileContents dataUsingEncoding:NSUTF8StringEncoding];
+    NSArray *dataTasks = [TTMTaskLoader tasksFromData:data
+                                            lineIndex:[[TTMLineIndex alloc] initWithData:data]
+                                          firstTaskId:0
+                                          symbolTable:[[TTMSymbolTable alloc] init]];
+    NSArray *stringTasks = [TTMTaskLoader
+                            tasksFromRawTextStrings:[self.lines arrayByAddingObject:@"last line"]
+                            firstTaskId:0
+                            symbolTable:[[TTMSymbolTable alloc] init]];
+    XCTAssertEqual(dataTasks.count, stringTasks.count);
+    for (NSUInteger i = 0; i < stringTasks.count; i++) {
+        XCTAssertEqualObjects([dataTasks[i] rawText], [stringTasks[i] rawText]);
+        XCTAssertEqual([dataTasks[i] taskId], [stringTasks[i] taskId]);
+    }
+}
+
+- (void)testTasksFromData_WhenNotUTF8_ShouldReturnNil {
+    const char bytes[] = "first task\nsecond \xFF task\n";
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes) - 1];
+    NSArray *tasks = [TTMTaskLoader tasksFromData:data
+                                        lineIndex:[[TTMLineIndex alloc] initWithData:data]
+                                      firstTaskId:0
+                                      symbolTable:[[TTMSymbolTable alloc] init]];
+    XCTAssertNil(tasks);
+}
+
+@end
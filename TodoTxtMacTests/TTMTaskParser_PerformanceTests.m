@@ -0,0 +1,141 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskParser.h"
+#import "RegExCategories.h"
+#import "TTMTestTasks.h"
+
+// The regular expression cascade TTMTask ran in setRawText: before TTMTaskParser.
+static NSString * const CompletedPattern = @"^x[ ]((\\d{4})-(\\d{2})-(\\d{2}))[ ]";
+static NSString * const CompletionDatePattern = @"(?<=^x[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const PriorityTextPattern = @"^(\\([A-Z]\\)[ ])";
+static NSString * const CreationDatePatternIncomplete = @"(?<=^|\\([A-Z]\\)[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const CreationDatePatternCompleted = @"(?<=^x[ ]((\\d{4})-(\\d{2})-(\\d{2}))[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const DueDatePattern = @"(?<=(^|[ ])due:)((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const ThresholdDatePattern = @"(?<=(^|[ ])t:)((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const ProjectPattern = @"(?<=^|[ ])(\\+[^[ ]]+)";
+static NSString * const ContextPattern = @"(?<=^|[ ])(\\@[^[ ]]+)";
+static NSString * const RecurrencePattern = @"(?<=(^|[ ])rec:)((\\+?)\\d+[dDwWmMyYbB])";
+static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
+
+static const NSUInteger LineCount = 40000;
+
+@interface TTMTaskParser_PerformanceTests : XCTestCase
+
+@property NSArray *lines;
+
+@end
+
+@implementation TTMTaskParser_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    self.lines = [TTMTestTasks rawTextsWithCount:LineCount];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)logLinesPerSecondForLabel:(NSString*)label block:(void (^)(void))block {
+    NSDate *start = [NSDate date];
+    block();
+    NSTimeInterval elapsed = -[start timeIntervalSinceNow];
+    NSLog(@"%@: %lu lines in %.3f s (%.0f lines/sec)", label, (unsigned long)LineCount,
+          elapsed, LineCount / elapsed);
+}
+
+- (void)test_Performance_RegularExpressionCascade {
+    [self measureBlock:^{
+        [self logLinesPerSecondForLabel:@"Regular expression cascade" block:^{
+            for (NSString *line in self.lines) {
+                [line isMatch:RX(CompletedPattern)];
+                [line firstMatch:RX(CompletionDatePattern)];
+                [line isMatch:RX(PriorityTextPattern)];
+                [line firstMatch:RX(PriorityTextPattern)];
+                [line matches:RX(ProjectPattern)];
+                [line matches:RX(ContextPattern)];
+                [line firstMatch:RX(DueDatePattern)];
+                [line firstMatch:RX(CreationDatePatternIncomplete)];
+                [line firstMatch:RX(CreationDatePatternCompleted)];
+                [line firstMatch:RX(ThresholdDatePattern)];
+                [line isMatch:RX(RecurrencePattern)];
+                [line firstMatch:RX(RecurrencePattern)];
+                [line isMatch:RX(HiddenPattern)];
+            }
+        }];
+    }];
+}
+
+- (void)test_Performance_TaskParser {
+    [self measureBlock:^{
+        [self logLinesPerSecondForLabel:@"TTMTaskParser" block:^{
+            for (NSString *line in self.lines) {
+                TTMTaskScanResult scan;
+                NSMutableArray *projects = [[NSMutableArray alloc] init];
+                NSMutableArray *contexts = [[NSMutableArray alloc] init];
+                [TTMTaskParser scanString:line result:&scan
+                                 projects:projects contexts:contexts tags:nil];
+            }
+        }];
+    }];
+}
+
+- (void)test_Performance_TaskInit {
+    [self measureBlock:^{
+        [self logLinesPerSecondForLabel:@"TTMTask initWithRawText:" block:^{
+            NSUInteger taskId = 0;
+            for (NSString *line in self.lines) {
+                (void)[[TTMTask alloc] initWithRawText:line withTaskId:taskId++];
+            }
+        }];
+    }];
+}
+
+@end
@@ -0,0 +1,223 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTaskParser.h"
+#import "RegExCategories.h"
+
+// The regular expressions TTMTask used before TTMTaskParser. The scanner must agree with them.
+static NSString * const CompletedPattern = @"^x[ ]((\\d{4})-(\\d{2})-(\\d{2}))[ ]";
+static NSString * const CompletionDatePattern = @"(?<=^x[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const PriorityTextPattern = @"^(\\([A-Z]\\)[ ])";
+static NSString * const CreationDatePatternIncomplete = @"(?<=^|\\([A-Z]\\)[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const CreationDatePatternCompleted = @"(?<=^x[ ]((\\d{4})-(\\d{2})-(\\d{2}))[ ])((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const DueDatePattern = @"(?<=(^|[ ])due:)((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const ThresholdDatePattern = @"(?<=(^|[ ])t:)((\\d{4})-(\\d{2})-(\\d{2}))(?=[ ]|$)";
+static NSString * const ProjectPattern = @"(?<=^|[ ])(\\+[^[ ]]+)";
+static NSString * const ContextPattern = @"(?<=^|[ ])(\\@[^[ ]]+)";
+static NSString * const TagPattern = @"(?<=^|[ ])([:graph:]+:[:graph:]+)";
+static NSString * const RecurrencePattern = @"(?<=(^|[ ])rec:)((\\+?)\\d+[dDwWmMyYbB])";
+static NSString * const HiddenPattern = @"(?<=^|[ ])(h:1)(?=[ ]|$)";
+
+@interface TTMTaskParser_UnitTests : XCTestCase
+
+@property NSArray *lines;
+
+@end
+
+@implementation TTMTaskParser_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.lines = @[@"",
+                   @" ",
+                   @"pick up groceries",
+                   @"(A) pick up groceries",
+                   @"(A)pick up groceries",
+                   @"(a) pick up groceries",
+                   @"(A) 2020-01-01 pick up groceries +Chores @Store",
+                   @"(A)2020-01-01 pick up groceries",
+                   @"(A) 2020-01-01test pick up groceries",
+                   @"2020-01-01 pick up groceries",
+                   @"2020-01-01",
+                   @"2020-1-01 pick up groceries",
+                   @"pick up (B) 2020-01-01 groceries",
+                   @"x 2020-01-01 pick up groceries",
+                   @"x 2020-01-01",
+                   @"x 2020-01-01 ",
+                   @"x 2020-01-01 2019-12-31 pick up groceries",
+                   @"x 2020-01-01 2019-12-31",
+                   @"x 2020-01-012019-12-31 pick up groceries",
+                   @"x 2020-01-01 2019-12-31test pick up groceries",
+                   @"x 2020-13-45 pick up groceries",
+                   @"X 2020-01-01 pick up groceries",
+                   @"x  2020-01-01 pick up groceries",
+                   @"pick up groceries due:2020-01-01",
+                   @"due:2020-01-01 pick up groceries",
+                   @"pick up groceries due:2020-01-01 due:2021-01-01",
+                   @"pick up groceries due:2020-01-01x due:2021-01-01",
+                   @"pick up groceries xdue:2020-01-01",
+                   @"pick up groceries due:due:2020-01-01",
+                   @"pick up groceries DUE:2020-01-01",
+                   @"pick up groceries t:2020-01-01",
+                   @"t:2020-01-01 pick up groceries",
+                   @"pick up groceries st:2020-01-01 t:2021-01-01",
+                   @"pick up groceries rec:1d",
+                   @"pick up groceries rec:+2W",
+                   @"pick up groceries rec:+w",
+                   @"pick up groceries rec:12bfoo",
+                   @"pick up groceries rec:1x rec:3m",
+                   @"pick up groceries arec:1d",
+                   @"pick up groceries h:1",
+                   @"h:1 pick up groceries",
+                   @"pick up groceries h:12",
+                   @"pick up groceries xh:1",
+                   @"pick up groceries +Shopping; +Chores+Personal +-Errands- +",
+                   @"pick up groceries @Home @Phone@Work @ @@",
+                   @"pick up groceries  +DoubleSpace  @DoubleSpace",
+                   @"pick up groceries\t+Tab @Tab\tafter",
+                   @"key:value a:b:c :lead trail: a::b http://example.com",
+                   @"tab\tkey:value key:\tvalue",
+                   @"pick up groceries due:2020-01-01 ",
+                   @"pick up groceries h:1 ",
+                   @"٢٠٢٠-٠١-٠١ arabic-indic digits",
+                   @"pick up groceries +café @über tag:été"];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (NSRange)rangeOfFirstMatchOfPattern:(NSString*)pattern inString:(NSString*)string {
+    return [RX(pattern) rangeOfFirstMatchInString:string
+                                          options:0
+                                            range:NSMakeRange(0, string.length)];
+}
+
+- (void)assertRange:(NSRange)range equalsFirstMatchOfPattern:(NSString*)pattern
+           inString:(NSString*)string {
+    NSRange expected = [self rangeOfFirstMatchOfPattern:pattern inString:string];
+    XCTAssertEqual(range.location, expected.location, @"%@ in \"%@\"", pattern, string);
+    if (expected.location != NSNotFound) {
+        XCTAssertEqual(range.length, expected.length, @"%@ in \"%@\"", pattern, string);
+    }
+}
+
+- (void)test_ScanString_ShouldMatchRegularExpressions {
+    for (NSString *line in self.lines) {
+        TTMTaskScanResult scan;
+        NSMutableArray *projects = [NSMutableArray array];
+        NSMutableArray *contexts = [NSMutableArray array];
+        NSMutableArray *tags = [NSMutableArray array];
+        [TTMTaskParser scanString:line result:&scan projects:projects contexts:contexts tags:tags];
+
+        XCTAssertEqual(scan.hasCompletedPrefix, [line isMatch:RX(CompletedPattern)], @"%@", line);
+        XCTAssertEqual(scan.isHidden, [line isMatch:RX(HiddenPattern)], @"%@", line);
+        [self assertRange:scan.completionDateRange
+            equalsFirstMatchOfPattern:CompletionDatePattern inString:line];
+        [self assertRange:scan.priorityRange
+            equalsFirstMatchOfPattern:PriorityTextPattern inString:line];
+        [self assertRange:scan.creationDateRange
+            equalsFirstMatchOfPattern:CreationDatePatternIncomplete inString:line];
+        [self assertRange:scan.completedCreationDateRange
+            equalsFirstMatchOfPattern:CreationDatePatternCompleted inString:line];
+        [self assertRange:scan.dueDateRange
+            equalsFirstMatchOfPattern:DueDatePattern inString:line];
+        [self assertRange:scan.thresholdDateRange
+            equalsFirstMatchOfPattern:ThresholdDatePattern inString:line];
+        [self assertRange:scan.recurrenceRange
+            equalsFirstMatchOfPattern:RecurrencePattern inString:line];
+        XCTAssertEqualObjects(projects, [line matches:RX(ProjectPattern)], @"%@", line);
+        XCTAssertEqualObjects(contexts, [line matches:RX(ContextPattern)], @"%@", line);
+        XCTAssertEqualObjects(tags, [line matches:RX(TagPattern)], @"%@", line);
+    }
+}
+
+- (void)test_ScanString_WhenArraysAreNil_ShouldStillFillResult {
+    NSString *line = @"(B) 2020-01-01 pick up groceries +Chores due:2020-02-01 rec:1w";
+    TTMTaskScanResult scan;
+    [TTMTaskParser scanString:line result:&scan projects:nil contexts:nil tags:nil];
+    XCTAssertEqual(scan.priorityRange.location, 0);
+    XCTAssertEqual(scan.creationDateRange.location, 4);
+    XCTAssertEqualObjects([line substringWithRange:scan.dueDateRange], @"2020-02-01");
+    XCTAssertEqualObjects([line substringWithRange:scan.recurrenceRange], @"1w");
+}
+
+- (void)test_ScanString_WhenLineIsLong_ShouldScanWholeLine {
+    NSString *padding = [@"" stringByPaddingToLength:1000 withString:@"word " startingAtIndex:0];
+    NSString *line = [NSString stringWithFormat:@"%@+Project due:2020-01-01", padding];
+    TTMTaskScanResult scan;
+    NSMutableArray *projects = [NSMutableArray array];
+    [TTMTaskParser scanString:line result:&scan projects:projects contexts:nil tags:nil];
+    XCTAssertEqualObjects(projects, @[@"+Project"]);
+    XCTAssertEqualObjects([line substringWithRange:scan.dueDateRange], @"2020-01-01");
+}
+
+- (void)test_ScanHeaderOfString_ShouldMatchFullScan {
+    NSMutableArray *lines = [NSMutableArray arrayWithArray:self.lines];
+    [lines addObjectsFromArray:@[@"x 2020-01-01 2019-12-31 pick up groceries",
+                                 @"x 2020-01-01 2019-12-31x pick up groceries",
+                                 @"x 2020-01-01 2019-12-31\v",
+                                 @"x 2020-01-01 2019-12-31\vx",
+                                 @"x 2020-01-01 2019-12-3"]];
+    for (NSString *line in lines) {
+        TTMTaskScanResult full;
+        TTMTaskScanResult header;
+        [TTMTaskParser scanString:line result:&full projects:nil contexts:nil tags:nil];
+        [TTMTaskParser scanHeaderOfString:line result:&header];
+        XCTAssertEqual(header.hasCompletedPrefix, full.hasCompletedPrefix, @"%@", line);
+        XCTAssertTrue(NSEqualRanges(header.completionDateRange, full.completionDateRange),
+                      @"%@", line);
+        XCTAssertTrue(NSEqualRanges(header.completedCreationDateRange,
+                                    full.completedCreationDateRange), @"%@", line);
+        XCTAssertTrue(NSEqualRanges(header.priorityRange, full.priorityRange), @"%@", line);
+        XCTAssertEqual(header.dueDateRange.location, NSNotFound, @"%@", line);
+        XCTAssertEqual(header.creationDateRange.location, NSNotFound, @"%@", line);
+    }
+}
+
+@end
@@ -0,0 +1,110 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskSorter.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger TaskCount = 100000;
+
+@interface TTMTaskSorter_PerformanceTests : XCTestCase
+
+@property NSArray *tasks;
+
+@end
+
+@implementation TTMTaskSorter_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    NSMutableArray *tasks = [[TTMTestTasks tasksWithCount:TaskCount] mutableCopy];
+    [tasks makeObjectsPerformSelector:@selector(decodeSortAndFilterFields)];
+    // Shuffle deterministically, so that no sort starts out in order.
+    srand48(14);
+    for (NSUInteger i = TaskCount - 1; i > 0; i--) {
+        [tasks exchangeObjectAtIndex:i withObjectAtIndex:(NSUInteger)(drand48() * (i + 1))];
+    }
+    self.tasks = tasks;
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)test_Performance_SortAllSortTypes {
+    [self measureBlock:^{
+        for (TTMTaskListSortType sortType = TTMSortOrderInFile; sortType <= TTMSortAlphabetical;
+             sortType++) {
+            NSDate *start = [NSDate date];
+            [TTMTaskSorter sortedTasks:self.tasks sortType:sortType];
+            NSLog(@"Sort type %lu: %lu tasks in %.3f s", (unsigned long)sortType,
+                  (unsigned long)TaskCount, -[start timeIntervalSinceNow]);
+        }
+    }];
+}
+
+- (void)test_Performance_SortDescriptorsPriority {
+    NSArray *sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:@"isPrioritized" ascending:NO],
+                                 [NSSortDescriptor sortDescriptorWithKey:@"priority" ascending:YES],
+                                 [NSSortDescriptor sortDescriptorWithKey:@"isCompleted" ascending:YES],
+                                 [NSSortDescriptor sortDescriptorWithKey:@"dueState" ascending:YES],
+                                 [NSSortDescriptor sortDescriptorWithKey:@"dueDay" ascending:YES],
+                                 [NSSortDescriptor sortDescriptorWithKey:@"thresholdDay" ascending:YES],
+                                 [NSSortDescriptor sortDescriptorWithKey:@"taskId" ascending:YES]];
+    [self measureBlock:^{
+        [self.tasks sortedArrayUsingDescriptors:sortDescriptors];
+    }];
+}
+
+- (void)test_Performance_SortPriority {
+    [self measureBlock:^{
+        [TTMTaskSorter sortedTasks:self.tasks sortType:TTMSortPriority];
+    }];
+}
+
+@end
@@ -0,0 +1,181 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskSorter.h"
+
+@interface TTMTaskSorter_UnitTests : XCTestCase
+
+@property NSArray *tasks;
+
+@end
+
+@implementation TTMTaskSorter_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    NSArray *rawTexts = @[@"(B) call mom +Family @Phone due:2016-02-01",
+                          @"(A) file taxes +Finance @Computer t:2016-03-01",
+                          @"x 2016-01-05 2016-01-01 renew passport +Travel @Errands",
+                          @"water the plants @Home rec:+1w due:2016-01-20",
+                          @"2015-12-01 read a book +reading",
+                          @"2015-12-01 Read a book +Reading",
+                          @"(A) 2016-01-02 pay rent +Finance due:2016-02-01 t:2016-01-25",
+                          @"",
+                          @"x 2016-01-03 buy milk @Errands",
+                          @"(C) plan trip +Travel +Family @Computer @Phone due:2015-12-31",
+                          @"due:2016-02-01 unprioritized with a due date",
+                          @"(B) call mom +Family @Phone due:2016-02-01"];
+    NSMutableArray *tasks = [NSMutableArray array];
+    [rawTexts enumerateObjectsUsingBlock:^(NSString *rawText, NSUInteger i, BOOL *stop) {
+        [tasks addObject:[[TTMTask alloc] initWithRawText:rawText withTaskId:i]];
+    }];
+    // Sorting must not depend on the order tasks are passed in.
+    self.tasks = [[tasks reverseObjectEnumerator] allObjects];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+// The sort descriptors the document used before sorting by packed keys.
+- (NSArray*)sortDescriptorsForSortType:(TTMTaskListSortType)sortType {
+    NSSortDescriptor *isPrioritized = [NSSortDescriptor sortDescriptorWithKey:@"isPrioritized" ascending:NO];
+    NSSortDescriptor *priority = [NSSortDescriptor sortDescriptorWithKey:@"priority" ascending:YES];
+    NSSortDescriptor *hasProjects = [NSSortDescriptor sortDescriptorWithKey:@"hasProjects" ascending:NO];
+    NSSortDescriptor *projects = [NSSortDescriptor sortDescriptorWithKey:@"projects" ascending:YES
+        selector:@selector(localizedCaseInsensitiveCompare:)];
+    NSSortDescriptor *hasContexts = [NSSortDescriptor sortDescriptorWithKey:@"hasContexts" ascending:NO];
+    NSSortDescriptor *contexts = [NSSortDescriptor sortDescriptorWithKey:@"contexts" ascending:YES
+        selector:@selector(localizedCaseInsensitiveCompare:)];
+    NSSortDescriptor *dueState = [NSSortDescriptor sortDescriptorWithKey:@"dueState" ascending:YES];
+    NSSortDescriptor *dueDay = [NSSortDescriptor sortDescriptorWithKey:@"dueDay" ascending:YES];
+    NSSortDescriptor *creationDay = [NSSortDescriptor sortDescriptorWithKey:@"creationDay" ascending:YES];
+    NSSortDescriptor *completionDay = [NSSortDescriptor sortDescriptorWithKey:@"completionDay" ascending:YES];
+    NSSortDescriptor *taskId = [NSSortDescriptor sortDescriptorWithKey:@"taskId" ascending:YES];
+    NSSortDescriptor *completed = [NSSortDescriptor sortDescriptorWithKey:@"isCompleted" ascending:YES];
+    NSSortDescriptor *thresholdDay = [NSSortDescriptor sortDescriptorWithKey:@"thresholdDay" ascending:YES];
+    NSSortDescriptor *rawText = [NSSortDescriptor sortDescriptorWithKey:@"rawText" ascending:YES
+        selector:@selector(localizedCaseInsensitiveCompare:)];
+    switch (sortType) {
+        case TTMSortPriority:
+            return @[isPrioritized, priority, completed, dueState, dueDay, thresholdDay, taskId];
+        case TTMSortProject:
+            return @[hasProjects, projects, priority, completed, dueDay, thresholdDay, taskId];
+        case TTMSortContext:
+            return @[hasContexts, contexts, isPrioritized, priority, completed, dueDay,
+                     thresholdDay, taskId];
+        case TTMSortDueDate:
+            return @[dueDay, isPrioritized, priority, thresholdDay, taskId];
+        case TTMSortCreationDate:
+            return @[creationDay, taskId];
+        case TTMSortCompletionDate:
+            return @[completionDay, taskId];
+        case TTMSortThresholdDate:
+            return @[thresholdDay, isPrioritized, priority, completed, dueState, dueDay, taskId];
+        case TTMSortAlphabetical:
+            return @[rawText, taskId];
+        default:
+            return @[taskId];
+    }
+}
+
+- (void)testSortMatchesSortDescriptorsForEverySortType {
+    for (TTMTaskListSortType sortType = TTMSortOrderInFile; sortType <= TTMSortAlphabetical;
+         sortType++) {
+        NSArray *expected =
+            [self.tasks sortedArrayUsingDescriptors:[self sortDescriptorsForSortType:sortType]];
+        NSArray *sorted = [TTMTaskSorter sortedTasks:self.tasks sortType:sortType];
+        XCTAssertEqualObjects([sorted valueForKey:@"taskId"], [expected valueForKey:@"taskId"],
+                              @"sort type %lu", (unsigned long)sortType);
+    }
+}
+
+- (void)testCompareTaskAgreesWithSort {
+    for (TTMTaskListSortType sortType = TTMSortOrderInFile; sortType <= TTMSortAlphabetical;
+         sortType++) {
+        NSArray *sorted = [TTMTaskSorter sortedTasks:self.tasks sortType:sortType];
+        for (NSUInteger i = 1; i < sorted.count; i++) {
+            XCTAssertEqual([TTMTaskSorter compareTask:sorted[i - 1] toTask:sorted[i] sortType:sortType],
+                           NSOrderedAscending, @"sort type %lu, row %lu",
+                           (unsigned long)sortType, (unsigned long)i);
+        }
+    }
+}
+
+- (void)testPermutationIndexesIntoTasks {
+    NSUInteger permutation[12];
+    [TTMTaskSorter sortTasks:self.tasks sortType:TTMSortOrderInFile permutation:permutation];
+    for (NSUInteger i = 0; i < 12; i++) {
+        XCTAssertEqual(permutation[i], 11 - i);
+    }
+}
+
+- (void)testCaseInsensitiveProjectsShareRank {
+    NSArray *sorted = [TTMTaskSorter sortedTasks:self.tasks sortType:TTMSortProject];
+    NSUInteger reading = [sorted indexOfObject:self.tasks[11 - 4]];
+    NSUInteger capitalReading = [sorted indexOfObject:self.tasks[11 - 5]];
+    // Same project ignoring case, same other fields, so the task ID decides.
+    XCTAssertEqual(capitalReading, reading + 1);
+}
+
+- (void)testSortEmptyList {
+    XCTAssertEqualObjects([TTMTaskSorter sortedTasks:@[] sortType:TTMSortPriority], @[]);
+}
+
+- (void)testSortSeesEdits {
+    TTMTask *task = self.tasks[0];
+    TTMTask *oldestTask = self.tasks[11 - 4];
+    NSArray *sorted = [TTMTaskSorter sortedTasks:self.tasks sortType:TTMSortCreationDate];
+    XCTAssertGreaterThan([sorted indexOfObject:task], [sorted indexOfObject:oldestTask]);
+    task.rawText = @"(A) 2000-01-01 now older";
+    sorted = [TTMTaskSorter sortedTasks:self.tasks sortType:TTMSortCreationDate];
+    XCTAssertLessThan([sorted indexOfObject:task], [sorted indexOfObject:oldestTask]);
+}
+
+@end
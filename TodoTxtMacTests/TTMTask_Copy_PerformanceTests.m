@@ -0,0 +1,107 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import <malloc/malloc.h>
+#import "TTMTask.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger TaskCount = 40000;
+
+@interface TTMTask_Copy_PerformanceTests : XCTestCase
+
+@property NSArray *tasks;
+
+@end
+
+@implementation TTMTask_Copy_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    self.tasks = [TTMTestTasks tasksWithCount:TaskCount];
+    [self.tasks makeObjectsPerformSelector:@selector(decodeSortAndFilterFields)];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (size_t)allocatedBlockCount {
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    return statistics.blocks_in_use;
+}
+
+- (void)test_CopyAllocatesOnlyTheCopy {
+    __strong TTMTask **copies = (__strong TTMTask **)calloc(TaskCount, sizeof(TTMTask*));
+    size_t blockCountBefore = [self allocatedBlockCount];
+    NSUInteger i = 0;
+    for (TTMTask *task in self.tasks) {
+        copies[i++] = [task copy];
+    }
+    size_t blockCountAfter = [self allocatedBlockCount];
+    NSLog(@"Copying %lu tasks allocated %zu blocks", (unsigned long)TaskCount,
+          blockCountAfter - blockCountBefore);
+    // One block per copy, plus a little slack for unrelated allocations on other threads.
+    XCTAssertLessThanOrEqual(blockCountAfter - blockCountBefore, TaskCount + TaskCount / 100);
+    for (i = 0; i < TaskCount; i++) {
+        copies[i] = nil;
+    }
+    free(copies);
+}
+
+- (void)test_Performance_Copy {
+    [self measureBlock:^{
+        NSDate *start = [NSDate date];
+        NSArray *copies = [[NSArray alloc] initWithArray:self.tasks copyItems:YES];
+        NSTimeInterval elapsed = -[start timeIntervalSinceNow];
+        NSLog(@"TTMTask copy: %lu tasks in %.3f s (%.0f tasks/sec)",
+              (unsigned long)copies.count, elapsed, copies.count / elapsed);
+    }];
+}
+
+@end
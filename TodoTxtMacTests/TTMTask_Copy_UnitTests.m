@@ -0,0 +1,176 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMSymbolTable.h"
+
+@interface TTMTask_Copy_UnitTests : XCTestCase
+
+@end
+
+@implementation TTMTask_Copy_UnitTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)testCopyHasSameProperties {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:
+                     @"(B) 2016-01-01 call mom +Family @Phone due:2016-02-01 t:2016-01-15 rec:1w h:1"
+                                          withTaskId:4];
+    TTMTask *copy = [task copy];
+    XCTAssertEqualObjects(copy.rawText, task.rawText);
+    XCTAssertEqual(copy.taskId, task.taskId);
+    XCTAssertEqual(copy.priority, task.priority);
+    XCTAssertEqual(copy.dueDay, task.dueDay);
+    XCTAssertEqual(copy.creationDay, task.creationDay);
+    XCTAssertEqual(copy.thresholdDay, task.thresholdDay);
+    XCTAssertEqualObjects(copy.projectsArray, task.projectsArray);
+    XCTAssertEqualObjects(copy.contextsArray, task.contextsArray);
+    XCTAssertEqualObjects(copy.recurrencePattern, task.recurrencePattern);
+    XCTAssertEqual(copy.isHidden, task.isHidden);
+}
+
+- (void)testCopySharesParsedFields {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"(A) call mom +Family @Phone due:2016-02-01"
+                                          withTaskId:0];
+    [task dueDay];
+    [task projects];
+    TTMTask *copy = [task copy];
+    XCTAssertEqual(copy.rawText, task.rawText);
+    XCTAssertEqual(copy.dueDateText, task.dueDateText);
+    XCTAssertEqual(copy.projects, task.projects);
+    XCTAssertEqual(copy.projectIDs, task.projectIDs);
+    XCTAssertEqual(copy.contextIDs, task.contextIDs);
+}
+
+- (void)testCopyKeepsSymbolTable {
+    TTMSymbolTable *symbolTable = [[TTMSymbolTable alloc] init];
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +Family" withTaskId:0];
+    task.symbolTable = symbolTable;
+    TTMTask *copy = [task copy];
+    XCTAssertEqual(copy.symbolTable, symbolTable);
+    XCTAssertEqualObjects(copy.projectsArray, @[@"+Family"]);
+}
+
+- (void)testChangingOriginalLeavesCopyUnchanged {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"(A) call mom +Family @Phone due:2016-02-01"
+                                          withTaskId:0];
+    [task projects];
+    TTMTask *copy = [task copy];
+    task.rawText = @"(C) call dad +Work @Office due:2016-03-01";
+    XCTAssertEqualObjects(copy.rawText, @"(A) call mom +Family @Phone due:2016-02-01");
+    XCTAssertEqual(copy.priority, 'A');
+    XCTAssertEqualObjects(copy.dueDateText, @"2016-02-01");
+    XCTAssertEqualObjects(copy.projectsArray, @[@"+Family"]);
+    XCTAssertEqualObjects(copy.contextsArray, @[@"@Phone"]);
+    XCTAssertEqualObjects(task.projectsArray, @[@"+Work"]);
+    XCTAssertEqualObjects(task.contextsArray, @[@"@Office"]);
+}
+
+- (void)testChangingCopyLeavesOriginalUnchanged {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +Family @Phone" withTaskId:0];
+    TTMTask *copy = [task copy];
+    [copy markComplete];
+    [copy appendText:@"+Work"];
+    XCTAssertTrue(copy.isCompleted);
+    XCTAssertFalse(task.isCompleted);
+    XCTAssertEqualObjects(task.projectsArray, @[@"+Family"]);
+    XCTAssertEqualObjects(task.rawText, @"call mom +Family @Phone");
+}
+
+- (void)testCopyOfCopyOutlivesOriginal {
+    TTMTask *copy;
+    @autoreleasepool {
+        TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +Family @Phone" withTaskId:0];
+        [task projects];
+        copy = [[task copy] copy];
+    }
+    XCTAssertEqualObjects(copy.projectsArray, @[@"+Family"]);
+    XCTAssertEqualObjects(copy.contextsArray, @[@"@Phone"]);
+}
+
+- (void)testCopyOfBlankTask {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"" withTaskId:0];
+    TTMTask *copy = [task copy];
+    XCTAssertTrue(copy.isBlank);
+    XCTAssertNil(copy.projectsArray);
+    XCTAssertEqual(copy.projectIDCount, 0);
+}
+
+
+- (void)testArrangementCopyIsReusedUntilTaskChanges {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +Family @Phone" withTaskId:0];
+    TTMTask *arrangementCopy = [task arrangementCopy];
+    XCTAssertNotEqual(arrangementCopy, task);
+    XCTAssertEqual([task arrangementCopy], arrangementCopy);
+    
+    task.taskId = 1;
+    TTMTask *renumberedCopy = [task arrangementCopy];
+    XCTAssertNotEqual(renumberedCopy, arrangementCopy);
+    XCTAssertEqual(renumberedCopy.taskId, 1);
+    
+    task.rawText = @"call dad +Work";
+    XCTAssertNotEqual([task arrangementCopy], renumberedCopy);
+    XCTAssertEqualObjects([task arrangementCopy].projectsArray, @[@"+Work"]);
+}
+
+- (void)testArrangementCopySharesFieldsDecodedOnOriginal {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom +Family @Phone due:2016-02-01"
+                                          withTaskId:0];
+    TTMTask *arrangementCopy = [task arrangementCopy];
+    XCTAssertEqual(arrangementCopy.projects, task.projects);
+    XCTAssertEqual(arrangementCopy.projectIDs, task.projectIDs);
+    XCTAssertEqual(arrangementCopy.dueDateText, task.dueDateText);
+}
+
+@end
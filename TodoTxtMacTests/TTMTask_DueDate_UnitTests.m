@@ -108,4 +108,31 @@
     XCTAssertEqualObjects(task.dueDate, self.highDate);
 }
 
+- (void)test_DueDate_WhenInvalidDate_ShouldBeHighDate {
+    NSString *rawText = @"pick up groceries due:2020-02-30";
+    TTMTask *task = [[TTMTask alloc] initWithRawText:rawText withTaskId:self.taskId];
+    XCTAssertEqualObjects(task.dueDate, self.highDate);
+    XCTAssertEqualObjects(task.dueDateText, @"");
+    XCTAssertEqual(task.dueState, NoDueDate);
+}
+
+- (void)test_DueDay_ShouldMatchDueDate {
+    NSString *rawText = @"pick up groceries due:2020-01-31";
+    TTMTask *task = [[TTMTask alloc] initWithRawText:rawText withTaskId:self.taskId];
+    XCTAssertEqual(task.dueDay, [TTMDateUtility dayNumberFromString:@"2020-01-31"]);
+    XCTAssertEqual([TTMDateUtility dayNumberFromDate:task.dueDate], task.dueDay);
+}
+
+- (void)test_DueDay_WhenNoDueDate_ShouldBeHighDay {
+    NSString *rawText = @"pick up groceries";
+    TTMTask *task = [[TTMTask alloc] initWithRawText:rawText withTaskId:self.taskId];
+    XCTAssertEqual(task.dueDay, TTMHighDayNumber);
+}
+
+- (void)test_DueDay_WhenBlank_ShouldBeNoDayNumber {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"" withTaskId:self.taskId];
+    XCTAssertEqual(task.dueDay, TTMNoDayNumber);
+    XCTAssertNil(task.dueDate);
+}
+
 @end
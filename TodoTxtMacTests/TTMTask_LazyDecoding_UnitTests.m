@@ -0,0 +1,166 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMDateUtility.h"
+
+@interface TTMTask_LazyDecoding_UnitTests : XCTestCase
+
+@property NSString *rawText;
+@property NSUInteger taskId;
+@property NSMutableArray *changedKeyPaths;
+@property NSDictionary *lastChange;
+
+@end
+
+@implementation TTMTask_LazyDecoding_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.rawText = @"(B) 2020-01-01 call mom +Family @Phone due:2020-01-31 t:2020-01-15 rec:+1w h:1";
+    self.taskId = 10;
+    self.changedKeyPaths = [NSMutableArray array];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath
+                      ofObject:(id)object
+                        change:(NSDictionary *)change
+                       context:(void *)context {
+    [self.changedKeyPaths addObject:keyPath];
+    self.lastChange = change;
+}
+
+- (void)test_Properties_WhenReadInAnyOrder_ShouldBeTheSame {
+    TTMTask *projectsFirst = [[TTMTask alloc] initWithRawText:self.rawText withTaskId:self.taskId];
+    XCTAssertEqualObjects(projectsFirst.projects, @"+Family");
+    XCTAssertEqualObjects(projectsFirst.contexts, @"@Phone");
+    XCTAssertEqualObjects(projectsFirst.dueDateText, @"2020-01-31");
+    XCTAssertEqualObjects(projectsFirst.recurrencePattern, @"+1w");
+    XCTAssertTrue(projectsFirst.isHidden);
+
+    TTMTask *datesFirst = [[TTMTask alloc] initWithRawText:self.rawText withTaskId:self.taskId];
+    XCTAssertTrue(datesFirst.isHidden);
+    XCTAssertEqualObjects(datesFirst.recurrencePattern, @"+1w");
+    XCTAssertEqualObjects(datesFirst.dueDateText, @"2020-01-31");
+    XCTAssertEqualObjects(datesFirst.contexts, @"@Phone");
+    XCTAssertEqualObjects(datesFirst.projects, @"+Family");
+
+    XCTAssertEqual(projectsFirst.dueDay, datesFirst.dueDay);
+    XCTAssertEqual(projectsFirst.thresholdDay, datesFirst.thresholdDay);
+    XCTAssertEqual(projectsFirst.creationDay, datesFirst.creationDay);
+    XCTAssertEqual(projectsFirst.dueState, datesFirst.dueState);
+    XCTAssertEqual(projectsFirst.thresholdState, datesFirst.thresholdState);
+    XCTAssertEqualObjects(projectsFirst.creationDateText, @"2020-01-01");
+    XCTAssertEqualObjects(projectsFirst.thresholdDateText, @"2020-01-15");
+    XCTAssertTrue(projectsFirst.isRecurring);
+    XCTAssertEqual(projectsFirst.priority, 'B');
+}
+
+- (void)test_Properties_WhenRawTextChangesAfterDecoding_ShouldBeDecodedAgain {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:self.rawText withTaskId:self.taskId];
+    XCTAssertEqualObjects(task.projects, @"+Family");
+    XCTAssertEqualObjects(task.dueDateText, @"2020-01-31");
+    XCTAssertTrue(task.isRecurring);
+    XCTAssertTrue(task.isHidden);
+
+    task.rawText = @"call mom +Work @Office due:2021-06-30";
+    XCTAssertEqualObjects(task.projects, @"+Work");
+    XCTAssertEqualObjects(task.contexts, @"@Office");
+    XCTAssertEqualObjects(task.dueDateText, @"2021-06-30");
+    XCTAssertNil(task.thresholdDateText);
+    XCTAssertNil(task.creationDateText);
+    XCTAssertFalse(task.isRecurring);
+    XCTAssertNil(task.recurrencePattern);
+    XCTAssertFalse(task.isHidden);
+    XCTAssertFalse(task.isPrioritized);
+}
+
+- (void)test_Properties_WhenRawTextBecomesBlank_ShouldBeBlank {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:self.rawText withTaskId:self.taskId];
+    task.rawText = @"";
+    XCTAssertTrue(task.isBlank);
+    XCTAssertEqualObjects(task.projects, @"");
+    XCTAssertNil(task.projectsArray);
+    XCTAssertEqualObjects(task.dueDateText, @"");
+    XCTAssertNil(task.dueDate);
+    XCTAssertEqual(task.dueState, NotDue);
+    XCTAssertFalse(task.isRecurring);
+    XCTAssertFalse(task.isHidden);
+}
+
+- (void)test_KVO_WhenRawTextChanges_ShouldNotifyDerivedProperties {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:self.rawText withTaskId:self.taskId];
+    NSArray *keyPaths = @[@"projects", @"dueDate", @"dueState", @"isHidden", @"priority"];
+    for (NSString *keyPath in keyPaths) {
+        [task addObserver:self forKeyPath:keyPath options:NSKeyValueObservingOptionNew context:nil];
+    }
+    task.rawText = @"call mom +Work";
+    for (NSString *keyPath in keyPaths) {
+        [task removeObserver:self forKeyPath:keyPath];
+    }
+    XCTAssertEqualObjects([NSSet setWithArray:self.changedKeyPaths], [NSSet setWithArray:keyPaths]);
+}
+
+- (void)test_KVO_WhenObservingWithOldValue_ShouldSeeOldAndNewValues {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:self.rawText withTaskId:self.taskId];
+    [task addObserver:self
+           forKeyPath:@"projects"
+              options:NSKeyValueObservingOptionOld|NSKeyValueObservingOptionNew
+              context:nil];
+    task.rawText = @"call mom +Work";
+    [task removeObserver:self forKeyPath:@"projects"];
+    XCTAssertEqualObjects(self.changedKeyPaths, @[@"projects"]);
+    XCTAssertEqualObjects(self.lastChange[NSKeyValueChangeOldKey], @"+Family");
+    XCTAssertEqualObjects(self.lastChange[NSKeyValueChangeNewKey], @"+Work");
+}
+
+@end
@@ -0,0 +1,112 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskLoader.h"
+#import "TTMSymbolTable.h"
+
+@interface TTMTask_UniqueId_UnitTests : XCTestCase
+
+@end
+
+@implementation TTMTask_UniqueId_UnitTests
+
+- (void)setUp {
+    [super setUp];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)testTasksWithSameTextHaveDifferentIds {
+    TTMTask *task1 = [[TTMTask alloc] initWithRawText:@"call mom" withTaskId:0];
+    TTMTask *task2 = [[TTMTask alloc] initWithRawText:@"call mom" withTaskId:0];
+    XCTAssertNotEqual(task1.uniqueId, 0);
+    XCTAssertNotEqual(task1.uniqueId, task2.uniqueId);
+}
+
+- (void)testIdSurvivesEdits {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"(A) call mom" withTaskId:3];
+    NSUInteger uniqueId = task.uniqueId;
+    [task markComplete];
+    task.rawText = @"call dad";
+    task.taskId = 7;
+    XCTAssertEqual(task.uniqueId, uniqueId);
+}
+
+- (void)testCopyKeepsId {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"call mom" withTaskId:0];
+    XCTAssertEqual([task copy].uniqueId, task.uniqueId);
+}
+
+- (void)testRecurringTaskGetsNewId {
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"water the plants due:2016-01-01 rec:+1w"
+                                          withTaskId:0];
+    TTMTask *newTask = [task newRecurringTask];
+    XCTAssertNotNil(newTask);
+    XCTAssertNotEqual(newTask.uniqueId, task.uniqueId);
+}
+
+- (void)testLoadedTasksHaveDistinctIds {
+    NSMutableArray *rawTextStrings = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 2000; i++) {
+        [rawTextStrings addObject:@"duplicate task +project"];
+    }
+    NSArray *tasks = [TTMTaskLoader tasksFromRawTextStrings:rawTextStrings
+                                                firstTaskId:0
+                                                symbolTable:[[TTMSymbolTable alloc] init]
+                                                workerCount:4];
+    NSMutableIndexSet *uniqueIds = [NSMutableIndexSet indexSet];
+    for (TTMTask *task in tasks) {
+        [uniqueIds addIndex:task.uniqueId];
+    }
+    XCTAssertEqual([uniqueIds count], [tasks count]);
+}
+
+@end
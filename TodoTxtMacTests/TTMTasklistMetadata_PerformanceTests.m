@@ -0,0 +1,133 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMTask.h"
+#import "TTMTaskIndex.h"
+#import "TTMTasklistMetadata.h"
+#import "TTMTestTasks.h"
+
+static const NSUInteger TaskCount = 100000;
+
+@interface TTMTasklistMetadata_PerformanceTests : XCTestCase
+
+@property NSArray *tasks;
+@property NSArray *filteredTasks;
+
+@end
+
+@implementation TTMTasklistMetadata_PerformanceTests
+
+- (void)setUp {
+    [super setUp];
+    NSArray *tasks = [TTMTestTasks tasksWithCount:TaskCount
+                                        templates:[TTMTestTasks manyProjectsTemplates]];
+    self.tasks = tasks;
+    self.filteredTasks = [tasks filteredArrayUsingPredicate:
+                          [NSPredicate predicateWithFormat:@"isCompleted == NO"]];
+}
+
+- (void)tearDown {
+    [super tearDown];
+}
+
+- (void)test_Performance_FullCountInOnePass {
+    TTMTaskBitset *filteredTasks = [TTMTaskIndex bitsetOfTasks:self.filteredTasks];
+    [self measureBlock:^{
+        NSDate *start = [NSDate date];
+        TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+        TTMTasklistMetadata *filteredMetadata = [[TTMTasklistMetadata alloc] init];
+        [TTMTasklistMetadata countTasks:self.tasks
+                             inMetadata:metadata
+                          filteredTasks:filteredTasks
+                       filteredMetadata:filteredMetadata];
+        NSLog(@"Counted %lu tasks and %lu filtered tasks in one pass in %.1f ms",
+              (unsigned long)TaskCount, (unsigned long)self.filteredTasks.count,
+              -[start timeIntervalSinceNow] * 1000);
+    }];
+}
+
+- (void)test_Performance_FullCountInTwoPasses {
+    [self measureBlock:^{
+        NSDate *start = [NSDate date];
+        TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+        TTMTasklistMetadata *filteredMetadata = [[TTMTasklistMetadata alloc] init];
+        [metadata updateMetadataFromTaskArray:self.tasks];
+        [filteredMetadata updateMetadataFromTaskArray:self.filteredTasks];
+        NSLog(@"Counted %lu tasks and %lu filtered tasks in two passes in %.1f ms",
+              (unsigned long)TaskCount, (unsigned long)self.filteredTasks.count,
+              -[start timeIntervalSinceNow] * 1000);
+    }];
+}
+
+- (void)testFullCountInParallelMatchesTwoPasses {
+    TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+    TTMTasklistMetadata *filteredMetadata = [[TTMTasklistMetadata alloc] init];
+    [TTMTasklistMetadata countTasks:self.tasks
+                         inMetadata:metadata
+                      filteredTasks:[TTMTaskIndex bitsetOfTasks:self.filteredTasks]
+                   filteredMetadata:filteredMetadata];
+    TTMTasklistMetadata *expectedMetadata = [[TTMTasklistMetadata alloc] init];
+    TTMTasklistMetadata *expectedFilteredMetadata = [[TTMTasklistMetadata alloc] init];
+    [expectedMetadata updateMetadataFromTaskArray:self.tasks];
+    [expectedFilteredMetadata updateMetadataFromTaskArray:self.filteredTasks];
+    
+    XCTAssertEqual(metadata.allTaskCount, expectedMetadata.allTaskCount);
+    XCTAssertEqual(metadata.completedTaskCount, expectedMetadata.completedTaskCount);
+    XCTAssertEqual(metadata.overdueTaskCount, expectedMetadata.overdueTaskCount);
+    XCTAssertEqualObjects(metadata.projectTaskCounts, expectedMetadata.projectTaskCounts);
+    XCTAssertEqualObjects(metadata.contextTaskCounts, expectedMetadata.contextTaskCounts);
+    XCTAssertEqualObjects(metadata.priorityTaskCounts, expectedMetadata.priorityTaskCounts);
+    XCTAssertEqualObjects(metadata.projectsArray, expectedMetadata.projectsArray);
+    XCTAssertEqual(filteredMetadata.allTaskCount, expectedFilteredMetadata.allTaskCount);
+    XCTAssertEqual(filteredMetadata.hiddenCount, expectedFilteredMetadata.hiddenCount);
+    XCTAssertEqualObjects(filteredMetadata.projectTaskCounts,
+                          expectedFilteredMetadata.projectTaskCounts);
+    XCTAssertEqualObjects(filteredMetadata.contextsArray, expectedFilteredMetadata.contextsArray);
+}
+
+@end
@@ -9,6 +9,7 @@
 #import <XCTest/XCTest.h>
 #import "TTMTask.h"
 #import "TTMTasklistMetadata.h"
+#import "TTMTaskIndex.h"
 
 @interface TTMTasklistMetadataTests : XCTestCase
 
@@ -153,5 +154,109 @@
     XCTAssertEqual(self.tasklistMetadata.prioritiesCount, 2);
 }
 
+- (void)testRemovedTasksAreUncounted
+{
+    [self.tasklistMetadata removeTasks:@[self.taskList[3], self.taskList[4]]];
+    [self.tasklistMetadata updateChangedTasks];
+    XCTAssertEqual(self.tasklistMetadata.allTaskCount, 3);
+    XCTAssertEqual(self.tasklistMetadata.overdueTaskCount, 1);
+    XCTAssertEqualObjects(self.tasklistMetadata.projectsArray, @[@"+Project1"]);
+    XCTAssertEqualObjects(self.tasklistMetadata.contextsArray, @[@"@Context1"]);
+    XCTAssertEqualObjects(self.tasklistMetadata.priorityTaskCounts, (@{@"A" : @1, @"C" : @1}));
+}
+
+- (void)testAddedTasksAreCounted
+{
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"(B) Task 6 +Project3 +Project3" withTaskId:5];
+    [self.tasklistMetadata addTasks:@[task]];
+    [self.tasklistMetadata updateChangedTasks];
+    XCTAssertEqual(self.tasklistMetadata.allTaskCount, 6);
+    XCTAssertEqual(self.tasklistMetadata.noDueDateTaskCount, 2);
+    NSArray *projects = @[@"+Project1", @"+Project2", @"+Project3"];
+    XCTAssertEqualObjects(self.tasklistMetadata.projectsArray, projects);
+    // A project named twice in a task is counted twice.
+    XCTAssertEqualObjects(self.tasklistMetadata.projectTaskCounts[@"+Project3"], @2);
+    XCTAssertEqualObjects(self.tasklistMetadata.prioritiesArray, (@[@"A", @"B", @"C"]));
+}
+
+- (void)testEditedTasksAreRecounted
+{
+    TTMTask *task = self.taskList[0];
+    task.rawText = @"x 2014-10-02 Task 1 @Context3 +Project1";
+    [self.tasklistMetadata updateChangedTasks];
+    XCTAssertEqual(self.tasklistMetadata.allTaskCount, 5);
+    XCTAssertEqual(self.tasklistMetadata.completedTaskCount, 2);
+    NSArray *contexts = @[@"@Context1", @"@Context2", @"@Context3"];
+    XCTAssertEqualObjects(self.tasklistMetadata.contextsArray, contexts);
+    XCTAssertEqualObjects(self.tasklistMetadata.contextTaskCounts[@"@Context1"], @1);
+    XCTAssertEqualObjects(self.tasklistMetadata.priorityTaskCounts[@"A"], @1);
+}
+
+- (void)testUpdatingFromAnotherArrayMatchesCountingFromScratch
+{
+    NSArray *filteredTasks = @[self.taskList[1], self.taskList[2]];
+    [self.tasklistMetadata updateMetadataFromTaskArray:filteredTasks];
+    TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+    [metadata updateMetadataFromTaskArray:filteredTasks];
+    XCTAssertEqual(self.tasklistMetadata.allTaskCount, metadata.allTaskCount);
+    XCTAssertEqual(self.tasklistMetadata.overdueTaskCount, metadata.overdueTaskCount);
+    XCTAssertEqualObjects(self.tasklistMetadata.projectTaskCounts, metadata.projectTaskCounts);
+    XCTAssertEqualObjects(self.tasklistMetadata.contextsArray, metadata.contextsArray);
+    XCTAssertEqualObjects(self.tasklistMetadata.prioritiesArray, metadata.prioritiesArray);
+    XCTAssertEqual(self.tasklistMetadata.contextsCount, 1);
+}
+
+- (void)testFullCountMatchesUpdating
+{
+    NSArray *filteredTasks = @[self.taskList[0], self.taskList[2], self.taskList[4]];
+    TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+    TTMTasklistMetadata *filteredMetadata = [[TTMTasklistMetadata alloc] init];
+    XCTAssertTrue(metadata.needsFullCount);
+    [TTMTasklistMetadata countTasks:self.taskList
+                         inMetadata:metadata
+                      filteredTasks:[TTMTaskIndex bitsetOfTasks:filteredTasks]
+                   filteredMetadata:filteredMetadata];
+    XCTAssertFalse(metadata.needsFullCount);
+    XCTAssertEqual(metadata.allTaskCount, 5);
+    XCTAssertEqual(metadata.overdueTaskCount, 2);
+    XCTAssertEqualObjects(metadata.projectTaskCounts, self.tasklistMetadata.projectTaskCounts);
+    XCTAssertEqualObjects(metadata.contextsArray, self.tasklistMetadata.contextsArray);
+    XCTAssertEqualObjects(metadata.priorityTaskCounts, self.tasklistMetadata.priorityTaskCounts);
+    XCTAssertEqual(filteredMetadata.allTaskCount, 3);
+    XCTAssertEqual(filteredMetadata.notDueTaskCount, 1);
+    XCTAssertEqualObjects(filteredMetadata.contextTaskCounts, (@{@"@Context1" : @2,
+                                                                @"@Context2" : @1}));
+    
+    // Both keep counting edits afterwards.
+    TTMTask *task = self.taskList[2];
+    task.rawText = @"(B) Task 3 +Project3";
+    [metadata updateChangedTasks];
+    [filteredMetadata updateChangedTasks];
+    XCTAssertEqualObjects(metadata.prioritiesArray, (@[@"A", @"B", @"C"]));
+    XCTAssertEqualObjects(filteredMetadata.projectsArray, (@[@"+Project1", @"+Project2",
+                                                             @"+Project3"]));
+    XCTAssertEqual(filteredMetadata.noDueDateTaskCount, 2);
+}
+
+- (void)testFullCountCountsRepeatedProjectsLikeUpdating
+{
+    TTMTask *task = [[TTMTask alloc] initWithRawText:@"Task 6 +Project3 +Project3 @Context1"
+                                          withTaskId:5];
+    NSArray *tasks = [self.taskList arrayByAddingObject:task];
+    [self.tasklistMetadata addTasks:@[task]];
+    [self.tasklistMetadata updateChangedTasks];
+    TTMTasklistMetadata *metadata = [[TTMTasklistMetadata alloc] init];
+    TTMTasklistMetadata *filteredMetadata = [[TTMTasklistMetadata alloc] init];
+    [TTMTasklistMetadata countTasks:tasks
+                         inMetadata:metadata
+                      filteredTasks:[TTMTaskIndex bitsetOfTasks:@[task]]
+                   filteredMetadata:filteredMetadata];
+    XCTAssertEqualObjects(metadata.projectTaskCounts, self.tasklistMetadata.projectTaskCounts);
+    XCTAssertEqualObjects(filteredMetadata.projectTaskCounts, @{@"+Project3" : @2});
+    
+    // Taking the task away again takes away both counts.
+    [metadata removeTasks:@[task]];
+    XCTAssertNil(metadata.projectTaskCounts[@"+Project3"]);
+}
 
 @end
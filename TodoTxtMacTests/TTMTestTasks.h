@@ -0,0 +1,101 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*!
+ * @class TTMTestTasks
+ * @abstract TTMTestTasks builds the large task lists that the performance tests share.
+ * @discussion Each line comes from a template with two %02lu fields. Line i uses template
+ * i modulo the template count, with (i % 28 + 1) and ((i / 28) % 28 + 1) as the fields,
+ * so the dates stay valid and numbered projects and contexts repeat.
+ */
+@interface TTMTestTasks : NSObject
+
+/*!
+ * @method templates
+ * @abstract Templates for a mix of priorities, dates, completed tasks, and recurrence.
+ */
++ (NSArray*)templates;
+
+/*!
+ * @method manyProjectsTemplates
+ * @abstract Templates that number their projects and contexts, so a list has hundreds of
+ * distinct ones.
+ */
++ (NSArray*)manyProjectsTemplates;
+
+/*!
+ * @method rawTextsWithCount:
+ * @abstract Builds lines from the default templates.
+ * @param count The number of lines to build.
+ */
++ (NSArray*)rawTextsWithCount:(NSUInteger)count;
+
+/*!
+ * @method rawTextsWithCount:templates:
+ * @abstract Builds lines from the given templates.
+ * @param count The number of lines to build.
+ * @param templates Format strings that each take two unsigned long arguments.
+ */
++ (NSArray*)rawTextsWithCount:(NSUInteger)count templates:(NSArray*)templates;
+
+/*!
+ * @method tasksWithCount:
+ * @abstract Builds tasks from the default templates, with task IDs 0 through count - 1.
+ * @param count The number of tasks to build.
+ */
++ (NSArray*)tasksWithCount:(NSUInteger)count;
+
+/*!
+ * @method tasksWithCount:templates:
+ * @abstract Builds tasks from the given templates, with task IDs 0 through count - 1.
+ * @param count The number of tasks to build.
+ * @param templates Format strings that each take two unsigned long arguments.
+ */
++ (NSArray*)tasksWithCount:(NSUInteger)count templates:(NSArray*)templates;
+
+@end
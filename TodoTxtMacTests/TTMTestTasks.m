@@ -0,0 +1,95 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "TTMTestTasks.h"
+#import "TTMTask.h"
+
+@implementation TTMTestTasks
+
++ (NSArray*)templates {
+    return @[@"(A) 2016-01-%02lu call mom about +Family dinner @Phone due:2016-02-%02lu",
+             @"x 2016-01-%02lu 2015-12-%02lu file taxes +Finance @Computer",
+             @"(C) renew passport +Travel @Errands t:2016-03-%02lu due:2016-04-%02lu",
+             @"2016-01-%02lu water the plants @Home rec:+1w h:1 id:%02lu",
+             @"read chapter %02lu of the book +Reading%02lu @Kindle"];
+}
+
++ (NSArray*)manyProjectsTemplates {
+    return @[@"(A) call mom about dinner +Family%02lu @Phone due:2016-02-%02lu",
+             @"x 2016-01-%02lu file taxes +Finance @Computer%02lu",
+             @"(C) renew passport +Travel @Errands t:2016-03-%02lu id:%02lu",
+             @"water the plants @Home%02lu rec:+%02lud",
+             @"read chapter %02lu of the book +Reading%02lu @Kindle"];
+}
+
++ (NSArray*)rawTextsWithCount:(NSUInteger)count {
+    return [self rawTextsWithCount:count templates:[self templates]];
+}
+
++ (NSArray*)rawTextsWithCount:(NSUInteger)count templates:(NSArray*)templates {
+    NSMutableArray *rawTexts = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        NSString *template = templates[i % templates.count];
+        [rawTexts addObject:[NSString stringWithFormat:template,
+                             (unsigned long)(i % 28 + 1), (unsigned long)((i / 28) % 28 + 1)]];
+    }
+    return rawTexts;
+}
+
++ (NSArray*)tasksWithCount:(NSUInteger)count {
+    return [self tasksWithCount:count templates:[self templates]];
+}
+
++ (NSArray*)tasksWithCount:(NSUInteger)count templates:(NSArray*)templates {
+    NSArray *rawTexts = [self rawTextsWithCount:count templates:templates];
+    NSMutableArray *tasks = [NSMutableArray arrayWithCapacity:count];
+    [rawTexts enumerateObjectsUsingBlock:^(NSString *rawText, NSUInteger i, BOOL *stop) {
+        [tasks addObject:[[TTMTask alloc] initWithRawText:rawText withTaskId:i]];
+    }];
+    return tasks;
+}
+
+@end
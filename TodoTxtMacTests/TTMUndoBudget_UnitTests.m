@@ -0,0 +1,156 @@
+/**
+ * @author Michael Descy
+ * @copyright 2014-2016 Michael Descy
+ * @discussion Dual-licensed under the GNU General Public License and the MIT License
+ *
+ *
+ *
+ * @license GNU General Public License http://www.gnu.org/licenses/gpl.html
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *
+ *
+ * @license The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Cocoa/Cocoa.h>
+#import <XCTest/XCTest.h>
+#import "TTMUndoBudget.h"
+
+@interface TTMUndoBudget_UnitTests : XCTestCase
+
+@property NSUndoManager *undoManager;
+@property TTMUndoBudget *budget;
+@property NSUInteger value;
+
+@end
+
+@implementation TTMUndoBudget_UnitTests
+
+- (void)setUp {
+    [super setUp];
+    self.undoManager = [[NSUndoManager alloc] init];
+    self.undoManager.groupsByEvent = NO;
+    self.budget = [[TTMUndoBudget alloc] initWithUndoManager:self.undoManager];
+    self.value = 0;
+}
+
+- (void)tearDown {
+    self.budget = nil;
+    self.undoManager = nil;
+    [super tearDown];
+}
+
+// Sets the value, and registers the undo action that restores it, charging it 100 bytes.
+- (void)setValueUndoably:(NSNumber*)value {
+    [[self.undoManager prepareWithInvocationTarget:self] setValueUndoably:@(self.value)];
+    [self.budget addBytes:100];
+    self.value = [value unsignedIntegerValue];
+}
+
+- (void)changeValueTo:(NSUInteger)value {
+    [self.undoManager beginUndoGrouping];
+    [self setValueUndoably:@(value)];
+    [self.undoManager endUndoGrouping];
+}
+
+- (void)testGroupsAreCharged {
+    [self changeValueTo:1];
+    [self changeValueTo:2];
+    XCTAssertEqual(self.budget.byteCount, 200);
+}
+
+- (void)testUndoAndRedoMoveCharges {
+    [self changeValueTo:1];
+    [self changeValueTo:2];
+    [self.undoManager undo];
+    XCTAssertEqual(self.value, 1);
+    XCTAssertEqual(self.budget.byteCount, 200);
+    [self.undoManager redo];
+    XCTAssertEqual(self.value, 2);
+    XCTAssertEqual(self.budget.byteCount, 200);
+    
+    // A new change clears the redo stack.
+    [self.undoManager undo];
+    [self changeValueTo:3];
+    XCTAssertEqual(self.budget.byteCount, 200);
+}
+
+- (void)testOldestGroupsAreDiscardedOverLimit {
+    self.budget.byteLimit = 250;
+    for (NSUInteger i = 1; i <= 5; i++) {
+        [self changeValueTo:i];
+    }
+    XCTAssertEqual(self.budget.byteCount, 200);
+    
+    // Only the two most recent changes can be undone.
+    [self.undoManager undo];
+    [self.undoManager undo];
+    XCTAssertEqual(self.value, 3);
+    XCTAssertFalse(self.undoManager.canUndo);
+    XCTAssertEqual(self.undoManager.levelsOfUndo, 0);
+}
+
+- (void)testMostRecentGroupIsKept {
+    self.budget.byteLimit = 10;
+    [self changeValueTo:1];
+    [self changeValueTo:2];
+    XCTAssertEqual(self.budget.byteCount, 100);
+    XCTAssertTrue(self.undoManager.canUndo);
+}
+
+- (void)testLevelsOfUndoAreRestored {
+    self.undoManager.levelsOfUndo = 3;
+    self.budget.levelsOfUndo = 3;
+    self.budget.byteLimit = 150;
+    [self changeValueTo:1];
+    [self changeValueTo:2];
+    XCTAssertEqual(self.undoManager.levelsOfUndo, 3);
+    XCTAssertEqual(self.budget.byteCount, 100);
+}
+
+- (void)testRemoveAllActionsIsNoticed {
+    [self changeValueTo:1];
+    [self.undoManager removeAllActions];
+    [self changeValueTo:2];
+    XCTAssertEqual(self.budget.byteCount, 100);
+}
+
+- (void)testByteCountOfStrings {
+    NSUInteger empty = [TTMUndoBudget byteCountOfStrings:@[@""]];
+    XCTAssertEqual([TTMUndoBudget byteCountOfStrings:@[@"abc", @"é"]], 2 * empty + 5);
+    XCTAssertEqual([TTMUndoBudget byteCountOfStrings:@[]], 0);
+}
+
+@end